@@ -15,6 +15,7 @@ void FreeAppBindingSet(AppBindingSet* bindings)
 	if (bindings->arena != nullptr)
 	{
 		FreeVarArray(&bindings->bindings);
+		if (bindings->comboBindings != nullptr) { FreeMem(bindings->arena, bindings->comboBindings, sizeof(uxx) * bindings->comboBindingsAllocLength); }
 	}
 	ClearPointer(bindings);
 }
@@ -40,19 +41,79 @@ AppBinding* FindAppBindingById(AppBindingSet* bindings, uxx bindingId)
 	return nullptr;
 }
 
-AppBinding* FindAppBinding(AppBindingSet* bindings, u8 modifierKeys, Key key)
+uxx GetModifierComboIndex(u8 modifierKeys)
+{
+	if (modifierKeys == ModifierKey_Any) { return APP_BINDING_ANY_MODIFIER_COMBO; }
+	uxx result = 0;
+	if (IsFlagSet(modifierKeys, ModifierKey_Control)) { result |= 0x01; }
+	if (IsFlagSet(modifierKeys, ModifierKey_Alt))     { result |= 0x02; }
+	if (IsFlagSet(modifierKeys, ModifierKey_Shift))   { result |= 0x04; }
+	if (IsFlagSet(modifierKeys, ModifierKey_Command)) { result |= 0x08; }
+	if (IsFlagSet(modifierKeys, ModifierKey_Option))  { result |= 0x10; }
+	return result;
+}
+
+u8 GetHeldModifierKeys()
+{
+	u8 result = ModifierKey_None;
+	if (IsKeyDownRaw(Key_Control)) { result |= ModifierKey_Control; }
+	if (IsKeyDownRaw(Key_Alt))     { result |= ModifierKey_Alt;     }
+	if (IsKeyDownRaw(Key_Shift))   { result |= ModifierKey_Shift;   }
+	if (IsKeyDownRaw(Key_Command)) { result |= ModifierKey_Command; }
+	if (IsKeyDownRaw(Key_Option))  { result |= ModifierKey_Option;  }
+	return result;
+}
+
+void RebuildAppBindingTables(AppBindingSet* bindings)
 {
 	NotNull(bindings);
 	NotNull(bindings->arena);
+	for (uxx kIndex = 0; kIndex < Key_Count; kIndex++) { bindings->keyBoundIndex[kIndex] = 0; }
+	for (uxx cIndex = 0; cIndex < AppCommand_Count; cIndex++) { bindings->commandFirstBinding[cIndex] = 0; }
+	bindings->numBoundKeys = 0;
+	
 	VarArrayLoop(&bindings->bindings, bIndex)
 	{
 		VarArrayLoopGet(AppBinding, binding, &bindings->bindings, bIndex);
-		if (binding->id != APP_BINDING_ID_INVALID && binding->modifierKeys == modifierKeys && binding->key == key)
-		{
-			return binding;
-		}
+		if (binding->id == APP_BINDING_ID_INVALID || bindings->keyBoundIndex[binding->key] != 0) { continue; }
+		bindings->boundKeys[bindings->numBoundKeys] = binding->key;
+		bindings->numBoundKeys++;
+		bindings->keyBoundIndex[binding->key] = bindings->numBoundKeys;
 	}
-	return nullptr;
+	
+	uxx numComboSlots = bindings->numBoundKeys * APP_BINDING_NUM_MODIFIER_COMBOS;
+	if (numComboSlots > bindings->comboBindingsAllocLength)
+	{
+		if (bindings->comboBindings != nullptr) { FreeMem(bindings->arena, bindings->comboBindings, sizeof(uxx) * bindings->comboBindingsAllocLength); }
+		bindings->comboBindings = AllocArray(uxx, bindings->arena, numComboSlots);
+		NotNull(bindings->comboBindings);
+		bindings->comboBindingsAllocLength = numComboSlots;
+	}
+	if (numComboSlots > 0) { MyMemSet(bindings->comboBindings, 0x00, sizeof(uxx) * numComboSlots); }
+	
+	//NOTE: We walk backwards and insert at the head of each chain so the chains end up in array order
+	for (uxx bIndex = bindings->bindings.length; bIndex > 0; bIndex--)
+	{
+		AppBinding* binding = VarArrayGetHard(AppBinding, &bindings->bindings, bIndex-1);
+		binding->nextForCommand = 0;
+		if (binding->id == APP_BINDING_ID_INVALID) { continue; }
+		binding->nextForCommand = bindings->commandFirstBinding[binding->command];
+		bindings->commandFirstBinding[binding->command] = bIndex;
+		uxx boundIndex = bindings->keyBoundIndex[binding->key]-1;
+		bindings->comboBindings[boundIndex * APP_BINDING_NUM_MODIFIER_COMBOS + GetModifierComboIndex(binding->modifierKeys)] = bIndex;
+	}
+	
+	bindings->tablesAreStale = false;
+}
+
+AppBinding* FindAppBinding(AppBindingSet* bindings, u8 modifierKeys, Key key)
+{
+	NotNull(bindings);
+	NotNull(bindings->arena);
+	if (bindings->tablesAreStale) { RebuildAppBindingTables(bindings); }
+	if (bindings->keyBoundIndex[key] == 0) { return nullptr; }
+	uxx bindingIndex = bindings->comboBindings[(bindings->keyBoundIndex[key]-1) * APP_BINDING_NUM_MODIFIER_COMBOS + GetModifierComboIndex(modifierKeys)];
+	return (bindingIndex != 0) ? VarArrayGetHard(AppBinding, &bindings->bindings, bindingIndex-1) : nullptr;
 }
 AppCommand FindAppBindingCommand(AppBindingSet* bindings, u8 modifierKeys, Key key)
 {
@@ -64,15 +125,14 @@ AppBinding* FindBindingForAppCommand(AppBindingSet* bindings, AppCommand command
 {
 	NotNull(bindings);
 	NotNull(bindings->arena);
+	if (bindings->tablesAreStale) { RebuildAppBindingTables(bindings); }
 	uxx foundIndex = 0;
-	VarArrayLoop(&bindings->bindings, bIndex)
+	for (uxx bindingIndex = bindings->commandFirstBinding[command]; bindingIndex != 0; )
 	{
-		VarArrayLoopGet(AppBinding, binding, &bindings->bindings, bIndex);
-		if (binding->command == command)
-		{
-			if (foundIndex >= skipCount) { return binding; }
-			foundIndex++;
-		}
+		AppBinding* binding = VarArrayGetHard(AppBinding, &bindings->bindings, bindingIndex-1);
+		if (foundIndex >= skipCount) { return binding; }
+		foundIndex++;
+		bindingIndex = binding->nextForCommand;
 	}
 	return nullptr;
 }
@@ -129,6 +189,7 @@ void RemoveAppBinding(AppBindingSet* bindings, u8 modifierKeys, Key key)
 	}
 	
 	bindings->isKeyModifierSensitive[key] = foundBindingWithSameKeyButDifferentMods;
+	bindings->tablesAreStale = true;
 }
 
 AppBinding* AddAppBinding(AppBindingSet* bindings, u8 modifierKeys, Key key, AppCommand command)
@@ -179,6 +240,7 @@ AppBinding* AddAppBinding(AppBindingSet* bindings, u8 modifierKeys, Key key, App
 	result->command = command;
 	
 	bindings->isKeyModifierSensitive[key] = foundBindingWithSameKeyButDifferentMods;
+	bindings->tablesAreStale = true;
 	
 	return result;
 }
@@ -188,49 +250,113 @@ AppBinding* AddAppBindingRef(AppBindingSet* bindings, const AppBinding* bindingP
 	return AddAppBinding(bindings, bindingPntr->modifierKeys, bindingPntr->key, bindingPntr->command);
 }
 
+// These keys move the cursor or edit the text of the options filter textbox while it has focus, so bindings on them are skipped.
+// Up/Down/Enter still get through so SelectMoveUp/SelectMoveDown/ToggleSelected step through and toggle the filtered results, and Escape still unfocuses it
+bool IsOptionsFilterNavigationKey(Key key)
+{
+	switch (key)
+	{
+		case Key_Left:
+		case Key_Right:
+		case Key_Home:
+		case Key_End:
+		case Key_Backspace:
+		case Key_Delete:
+			return true;
+		default: return false;
+	}
+}
+
+bool DidAppBindingTrigger(AppBindingSet* bindings, AppBinding* binding)
+{
+	bool followOsRepeatedEvent = DoesAppCommandTriggerOnOsLevelKeyRepeatEvents(binding->command);
+	//TODO: We need to somehow know if the key press was an OS-level repeat press and pass that info on to RunAppCommand for stuff like AppCommand_SelectMoveDown to not loop around when holding the Down arrow key
+	
+	if (bindings->isKeyModifierSensitive[binding->key] || (binding->modifierKeys != ModifierKey_None && binding->modifierKeys != ModifierKey_Any))
+	{
+		if (WasKeyComboPressed(binding->modifierKeys, binding->key, followOsRepeatedEvent))
+		{
+			if (!followOsRepeatedEvent) { appInputHandling->keyboard.keyHandledUntilReleased[binding->key] = true; } //TODO: Enable this always once we figure out how we prevent suppressing key repeated frames
+			return true;
+		}
+	}
+	else
+	{
+		if (WasKeyPressed(binding->key, followOsRepeatedEvent))
+		{
+			if (!followOsRepeatedEvent) { appInputHandling->keyboard.keyHandledUntilReleased[binding->key] = true; } //TODO: Enable this always once we figure out how we prevent suppressing key repeated frames
+			return true;
+		}
+	}
+	return false;
+}
+
 void RunAppBindingCommands(AppBindingSet* bindings)
 {
 	if (!appIn->isFocused) { return; }
+	ProfZoneBegin(_funcZone, "RunAppBindingCommands");
+	ScratchBegin(scratch);
+	if (bindings->tablesAreStale) { RebuildAppBindingTables(bindings); }
 	
-	VarArrayLoop(&bindings->bindings, bIndex)
+	//NOTE: Commands are run after we are done walking the tables since a command like AppCommand_ReloadBindings can replace the whole AppBindingSet
+	uxx numTriggered = 0;
+	uxx* triggeredIndices = AllocArray(uxx, scratch, MaxUXX(bindings->bindings.length, 1));
+	NotNull(triggeredIndices);
+	
+	uxx heldComboIndex = GetModifierComboIndex(GetHeldModifierKeys());
+	for (uxx kIndex = 0; kIndex < bindings->numBoundKeys; kIndex++)
 	{
-		VarArrayLoopGet(AppBinding, binding, &bindings->bindings, bIndex);
-		if (binding->id != APP_BINDING_ID_INVALID)
+		Key key = bindings->boundKeys[kIndex];
+		//NOTE: This raw check includes OS-level repeats so it's true whenever any binding for this key could trigger. On most frames it's false for every key
+		if (!WasKeyPressedRaw(key, true)) { continue; }
+		if (app->optionsFilter.isFocused && IsOptionsFilterNavigationKey(key)) { continue; }
+		
+		//NOTE: A binding with modifiers can only trigger when exactly those modifiers are held, so the held combo's slot is the only one of those we look at.
+		// Bindings with no modifiers (or ModifierKey_Any) can trigger with anything held, unless the key is modifier sensitive (DidAppBindingTrigger checks that)
+		const uxx* keyCombos = &bindings->comboBindings[kIndex * APP_BINDING_NUM_MODIFIER_COMBOS];
+		uxx candidates[3] = { keyCombos[heldComboIndex], 0, keyCombos[APP_BINDING_ANY_MODIFIER_COMBO] };
+		if (heldComboIndex != GetModifierComboIndex(ModifierKey_None)) { candidates[1] = keyCombos[GetModifierComboIndex(ModifierKey_None)]; }
+		for (uxx cIndex = 0; cIndex < ArrayCount(candidates); cIndex++)
 		{
-			bool runCommand = false;
-			bool followOsRepeatedEvent = DoesAppCommandTriggerOnOsLevelKeyRepeatEvents(binding->command);
-			//TODO: We need to somehow know if the key press was an OS-level repeat press and pass that info on to RunAppCommand for stuff like AppCommand_SelectMoveDown to not loop around when holding the Down arrow key
-			
-			if (bindings->isKeyModifierSensitive[binding->key] || (binding->modifierKeys != ModifierKey_None && binding->modifierKeys != ModifierKey_Any))
-			{
-				if (WasKeyComboPressed(binding->modifierKeys, binding->key, followOsRepeatedEvent))
-				{
-					if (!followOsRepeatedEvent) { appInputHandling->keyboard.keyHandledUntilReleased[binding->key] = true; } //TODO: Enable this always once we figure out how we prevent suppressing key repeated frames
-					runCommand = true;
-				}
-			}
-			else
-			{
-				if (WasKeyPressed(binding->key, followOsRepeatedEvent))
-				{
-					if (!followOsRepeatedEvent) { appInputHandling->keyboard.keyHandledUntilReleased[binding->key] = true; } //TODO: Enable this always once we figure out how we prevent suppressing key repeated frames
-					runCommand = true;
-				}
-			}
-			
-			if (runCommand)
+			if (candidates[cIndex] == 0) { continue; }
+			AppBinding* binding = VarArrayGetHard(AppBinding, &bindings->bindings, candidates[cIndex]-1);
+			if (DidAppBindingTrigger(bindings, binding))
 			{
-				#if DEBUG_BUILD
-				ScratchBegin(scratch);
-				Str8 bindingStr = GetBindingStr(scratch, binding->modifierKeys, binding->key);
-				PrintLine_O("%.*s -> AppCommand_%s", StrPrint(bindingStr), GetAppCommandStr(binding->command));
-				ScratchEnd(scratch);
-				#endif
-				
-				RunAppCommand(binding->command);
+				triggeredIndices[numTriggered] = candidates[cIndex]-1;
+				numTriggered++;
 			}
 		}
 	}
+	
+	//NOTE: Commands run in the order their bindings appear in the bindings array (i.e. binding file order), not in key order.
+	// Usually only one binding triggers on a frame so a simple insertion sort is plenty
+	for (uxx tIndex = 1; tIndex < numTriggered; tIndex++)
+	{
+		uxx bindingIndex = triggeredIndices[tIndex];
+		uxx insertIndex = tIndex;
+		while (insertIndex > 0 && triggeredIndices[insertIndex-1] > bindingIndex) { triggeredIndices[insertIndex] = triggeredIndices[insertIndex-1]; insertIndex--; }
+		triggeredIndices[insertIndex] = bindingIndex;
+	}
+	
+	AppCommand* commandsToRun = AllocArray(AppCommand, scratch, MaxUXX(numTriggered, 1));
+	NotNull(commandsToRun);
+	for (uxx tIndex = 0; tIndex < numTriggered; tIndex++)
+	{
+		AppBinding* binding = VarArrayGetHard(AppBinding, &bindings->bindings, triggeredIndices[tIndex]);
+		#if DEBUG_BUILD
+		Str8 bindingStr = GetBindingStr(scratch, binding->modifierKeys, binding->key);
+		PrintLine_O("%.*s -> AppCommand_%s", StrPrint(bindingStr), GetAppCommandStr(binding->command));
+		#endif
+		commandsToRun[tIndex] = binding->command;
+	}
+	
+	for (uxx cIndex = 0; cIndex < numTriggered; cIndex++)
+	{
+		RunAppCommand(commandsToRun[cIndex]);
+	}
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
 }
 
 Result TryParseBindingFile(Str8 fileContents, AppBindingSet* bindingsOut)
@@ -316,12 +442,7 @@ Result TryParseBindingFile(Str8 fileContents, AppBindingSet* bindingsOut)
 				else if (allModifiersValid)
 				{
 					Key key = Key_None;
-					for (uxx keyIndex = 1; keyIndex < Key_Count; keyIndex++)
-					{
-						Key keyEnumValue = (Key)keyIndex;
-						Str8 keyEnumName = MakeStr8Nt(GetKeyStr(keyEnumValue));
-						if (StrAnyCaseEquals(keyName, keyEnumName)) { key = keyEnumValue; break; }
-					}
+					TryParseKeyName(keyName, &key);
 					
 					if (key == Key_None)
 					{
@@ -330,16 +451,7 @@ Result TryParseBindingFile(Str8 fileContents, AppBindingSet* bindingsOut)
 					else
 					{
 						AppCommand command = AppCommand_None;
-						for (uxx cIndex = 1; cIndex < AppCommand_Count; cIndex++)
-						{
-							AppCommand commandEnumValue = (AppCommand)cIndex;
-							Str8 commandEnumName = MakeStr8Nt(GetAppCommandStr(commandEnumValue));
-							if (StrAnyCaseEquals(token.value, commandEnumName))
-							{
-								command = commandEnumValue;
-								break;
-							}
-						}
+						TryParseAppCommand(token.value, &command);
 						
 						if (StrAnyCaseEquals(token.value, StrLit("None")))
 						{
@@ -367,6 +479,9 @@ Result TryParseBindingFile(Str8 fileContents, AppBindingSet* bindingsOut)
 		}
 	}
 	
+	//NOTE: The lookup tables are built once for the whole file here, rather than after every AddAppBinding/RemoveAppBinding above
+	if (bindingsOut->tablesAreStale) { RebuildAppBindingTables(bindingsOut); }
+	
 	if (numValidBindingsFound == 0 && result == Result_None)
 	{
 		if (foundInvalidBindings || foundInvalidSyntax) { Notify_E("All bindings in file were invalid!"); result = Result_InvalidSyntax; }
@@ -11,6 +11,10 @@ Date:   02\01\2026
 
 #define APP_BINDING_ID_INVALID 0
 
+//Index into the per-key combo slots in AppBindingSet::comboBindings. 5 modifier flags give 32 combos, plus one slot for ModifierKey_Any
+#define APP_BINDING_NUM_MODIFIER_COMBOS 33
+#define APP_BINDING_ANY_MODIFIER_COMBO  32
+
 typedef plex AppBinding AppBinding;
 plex AppBinding
 {
@@ -18,6 +22,8 @@ plex AppBinding
 	u8 modifierKeys;
 	Key key;
 	AppCommand command;
+	
+	uxx nextForCommand; //index+1 of the next binding with the same command (0 = end of chain)
 };
 
 typedef plex AppBindingSet AppBindingSet;
@@ -27,6 +33,32 @@ plex AppBindingSet
 	uxx nextBindingId;
 	VarArray bindings; //AppBinding
 	bool isKeyModifierSensitive[Key_Count];
+	
+	//These tables are rebuilt by RebuildAppBindingTables after a whole bindings file is parsed.
+	//AddAppBinding and RemoveAppBinding only mark them stale, lookups rebuild them first if needed
+	bool tablesAreStale;
+	uxx commandFirstBinding[AppCommand_Count]; //index+1 into bindings (0 = no bindings for this command), chain is in the same order as the bindings array
+	uxx numBoundKeys;
+	Key boundKeys[Key_Count]; //every key that has at least one binding, so RunAppBindingCommands doesn't need to look at every binding
+	uxx keyBoundIndex[Key_Count]; //index+1 into boundKeys (0 = key has no bindings)
+	uxx* comboBindings; //[numBoundKeys * APP_BINDING_NUM_MODIFIER_COMBOS] index+1 into bindings (0 = no binding for that key+modifiers)
+	uxx comboBindingsAllocLength;
 };
 
+static NameTable KeyNameTable = ZEROED;
+void InitKeyNameTable()
+{
+	const char* names[Key_Count];
+	names[Key_None] = nullptr;
+	for (uxx keyIndex = 1; keyIndex < Key_Count; keyIndex++) { names[keyIndex] = GetKeyStr((Key)keyIndex); }
+	if (!InitNameTable(&KeyNameTable, Key_Count, &names[0])) { AssertMsg(false, "Failed to build Key NameTable!"); }
+}
+bool TryParseKeyName(Str8 keyName, Key* keyOut)
+{
+	uxx keyIndex = FindNameTableIndex(&KeyNameTable, keyName);
+	if (keyIndex == UINTXX_MAX) { return false; }
+	SetOptionalOutPntr(keyOut, (Key)keyIndex);
+	return true;
+}
+
 #endif //  _APP_BINDINGS_H
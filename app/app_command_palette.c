@@ -0,0 +1,536 @@
+/*
+File:   app_command_palette.c
+Description:
+	** The command palette is a popup with a single textbox that searches AppCommands, the options
+	** in every open tab, the recent files list, and the presets. The searchable items are flattened into
+	** palette->items (with their char masks packed in palette->itemMasks) in that order. Each source has its own
+	** generation, and when one changes only the items from that source onward are re-added, so re-parsing the last
+	** tab or adding a preset doesn't touch the thousands of options in the other tabs.
+	** Each FileOption's mask is calculated when its tab is parsed.
+	** When the new query is an extension of the previous one we only re-check the previous matches.
+*/
+
+void FreeCommandPalette(CommandPalette* palette)
+{
+	NotNull(palette);
+	if (palette->input.arena != nullptr)
+	{
+		FreeStr8(palette->input.arena, &palette->prevQuery);
+		FreeVarArray(&palette->items);
+		FreeVarArray(&palette->itemMasks);
+		FreeVarArray(&palette->candidates);
+		FreeVarArray(&palette->tabSections);
+		FreeEditableText(&palette->input);
+	}
+	ClearPointer(palette);
+}
+
+void InitCommandPalette(Arena* arena, CommandPalette* paletteOut)
+{
+	NotNull(arena);
+	NotNull(paletteOut);
+	ClearPointer(paletteOut);
+	InitEditableText(arena, PALETTE_MAX_QUERY_LENGTH, &paletteOut->input);
+	InitVarArray(PaletteItem, &paletteOut->items, arena);
+	InitVarArray(u64, &paletteOut->itemMasks, arena);
+	InitVarArray(uxx, &paletteOut->candidates, arena);
+	InitVarArray(PaletteTabSection, &paletteOut->tabSections, arena);
+	paletteOut->indexGeneration = UINT64_MAX; //forces a rebuild the first time the palette is opened
+	paletteOut->clickedResult = UINTXX_MAX;
+}
+
+void AddCommandPaletteItem(CommandPalette* palette, PaletteItemType type, Str8 searchStr, u64 charMask, uxx index, uxx tabIndex)
+{
+	PaletteItem* newItem = VarArrayAdd(PaletteItem, &palette->items);
+	NotNull(newItem);
+	ClearPointer(newItem);
+	newItem->type = type;
+	newItem->searchStr = searchStr;
+	newItem->index = index;
+	newItem->tabIndex = tabIndex;
+	u64* newMask = VarArrayAdd(u64, &palette->itemMasks);
+	NotNull(newMask);
+	*newMask = charMask;
+}
+
+bool IsAppCommandShownInPalette(AppCommand command)
+{
+	switch (command)
+	{
+		case AppCommand_None:               return false;
+		case AppCommand_OpenCommandPalette: return false;
+		#if !BUILD_WITH_CLAY
+		case AppCommand_ToggleClayDebug:    return false;
+		#endif
+		default: return true;
+	}
+}
+
+// Drops every item from numItems onward. The results point at items, so they are cleared too
+void TruncateCommandPaletteItems(CommandPalette* palette, uxx numItems)
+{
+	NotNull(palette);
+	Assert(numItems <= palette->items.length);
+	palette->items.length = numItems;
+	palette->itemMasks.length = numItems;
+	VarArrayClear(&palette->candidates);
+	palette->numResults = 0;
+	palette->selectedIndex = 0;
+}
+
+void AddCommandPaletteTabItems(CommandPalette* palette, uxx firstTabIndex)
+{
+	Assert(palette->tabSections.length == firstTabIndex);
+	for (uxx tIndex = firstTabIndex; tIndex < app->tabs.length; tIndex++)
+	{
+		VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+		PaletteTabSection* newSection = VarArrayAdd(PaletteTabSection, &palette->tabSections);
+		NotNull(newSection);
+		newSection->tabGeneration = tab->paletteGeneration;
+		newSection->firstItem = palette->items.length;
+		VarArrayLoop(&tab->fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+			AddCommandPaletteItem(palette, PaletteItemType_Option, option->name, option->nameCharMask, oIndex, tIndex);
+		}
+	}
+}
+
+void AddCommandPaletteRecentFileItems(CommandPalette* palette)
+{
+	palette->recentFilesFirstItem = palette->items.length;
+	//NOTE: The most recent file is at the end of the list, but it should show up first
+	for (uxx rIndex = app->recentFiles.length; rIndex > 0; rIndex--)
+	{
+		VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex-1);
+		if (!recentFile->fileExists) { continue; }
+		AddCommandPaletteItem(palette, PaletteItemType_RecentFile, recentFile->path, GetFuzzyCharMask(recentFile->path), rIndex-1, 0);
+	}
+	palette->recentFilesGeneration = app->paletteRecentFilesGeneration;
+}
+
+void AddCommandPalettePresetItems(CommandPalette* palette)
+{
+	palette->presetsFirstItem = palette->items.length;
+	VarArrayLoop(&app->presets, pIndex)
+	{
+		VarArrayLoopGet(Preset, preset, &app->presets, pIndex);
+		AddCommandPaletteItem(palette, PaletteItemType_Preset, preset->name, preset->nameCharMask, pIndex, 0);
+	}
+	palette->presetsGeneration = app->palettePresetsGeneration;
+}
+
+void RebuildCommandPaletteItems(CommandPalette* palette)
+{
+	NotNull(palette);
+	ProfZoneBegin(_funcZone, "RebuildCommandPaletteItems");
+	TruncateCommandPaletteItems(palette, 0);
+	VarArrayClear(&palette->tabSections);
+	
+	for (uxx cIndex = 1; cIndex < AppCommand_Count; cIndex++)
+	{
+		if (!IsAppCommandShownInPalette((AppCommand)cIndex)) { continue; }
+		Str8 commandName = MakeStr8Nt(GetAppCommandStr((AppCommand)cIndex));
+		AddCommandPaletteItem(palette, PaletteItemType_Command, commandName, GetFuzzyCharMask(commandName), cIndex, 0);
+	}
+	
+	AddCommandPaletteTabItems(palette, 0);
+	AddCommandPaletteRecentFileItems(palette);
+	AddCommandPalettePresetItems(palette);
+	
+	palette->indexGeneration = app->paletteIndexGeneration;
+	ProfZoneEnd(_funcZone);
+}
+
+// Brings palette->items up to date with the tabs, recent files and presets. Only the items from the first out of date
+// source onward are re-added (recent files and presets come after the tabs so they are always re-added with them). Returns true if any items changed
+bool UpdateCommandPaletteItems(CommandPalette* palette)
+{
+	NotNull(palette);
+	if (palette->indexGeneration != app->paletteIndexGeneration) { RebuildCommandPaletteItems(palette); return true; }
+	
+	uxx firstStaleTab = UINTXX_MAX;
+	for (uxx tIndex = 0; tIndex < MaxUXX(app->tabs.length, palette->tabSections.length); tIndex++)
+	{
+		if (tIndex >= app->tabs.length || tIndex >= palette->tabSections.length ||
+			VarArrayGetHard(PaletteTabSection, &palette->tabSections, tIndex)->tabGeneration != VarArrayGetHard(FileTab, &app->tabs, tIndex)->paletteGeneration)
+		{
+			firstStaleTab = tIndex;
+			break;
+		}
+	}
+	bool recentFilesStale = (firstStaleTab != UINTXX_MAX || palette->recentFilesGeneration != app->paletteRecentFilesGeneration);
+	bool presetsStale = (recentFilesStale || palette->presetsGeneration != app->palettePresetsGeneration);
+	if (!presetsStale) { return false; }
+	
+	ProfZoneBegin(_funcZone, "UpdateCommandPaletteItems");
+	if (firstStaleTab != UINTXX_MAX)
+	{
+		TruncateCommandPaletteItems(palette, (firstStaleTab < palette->tabSections.length) ? VarArrayGetHard(PaletteTabSection, &palette->tabSections, firstStaleTab)->firstItem : palette->recentFilesFirstItem);
+		palette->tabSections.length = firstStaleTab;
+		AddCommandPaletteTabItems(palette, firstStaleTab);
+	}
+	else { TruncateCommandPaletteItems(palette, recentFilesStale ? palette->recentFilesFirstItem : palette->presetsFirstItem); }
+	if (recentFilesStale) { AddCommandPaletteRecentFileItems(palette); }
+	AddCommandPalettePresetItems(palette);
+	ProfZoneEnd(_funcZone);
+	return true;
+}
+
+// Inserts the match into palette->results (sorted by score, ties keep item order) if it's good enough to be in the top PALETTE_MAX_RESULTS
+void AddCommandPaletteResult(CommandPalette* palette, uxx itemIndex, i32 score)
+{
+	uxx insertIndex = palette->numResults;
+	while (insertIndex > 0 && palette->results[insertIndex-1].score < score) { insertIndex--; }
+	if (insertIndex >= PALETTE_MAX_RESULTS) { return; }
+	uxx numToMove = MinUXX(palette->numResults, PALETTE_MAX_RESULTS-1) - insertIndex;
+	if (numToMove > 0) { MyMemMove(&palette->results[insertIndex+1], &palette->results[insertIndex], sizeof(PaletteMatch) * numToMove); }
+	palette->results[insertIndex].itemIndex = itemIndex;
+	palette->results[insertIndex].score = score;
+	if (palette->numResults < PALETTE_MAX_RESULTS) { palette->numResults++; }
+}
+
+void UpdateCommandPaletteResults(CommandPalette* palette, bool forceFullScan)
+{
+	NotNull(palette);
+	ProfZoneBegin(_funcZone, "UpdateCommandPaletteResults");
+	ScratchBegin(scratch);
+	
+	Str8 query = palette->input.str;
+	u64 queryMask = GetFuzzyCharMask(query);
+	u64* itemMasks = (u64*)palette->itemMasks.items;
+	bool canNarrow = (!forceFullScan && StrAnyCaseStartsWith(query, palette->prevQuery));
+	
+	// +==============================+
+	// |     Char Mask Prefilter      |
+	// +==============================+
+	uxx numPassed = 0;
+	uxx* passedIndices = AllocArray(uxx, scratch, MaxUXX(palette->items.length, 1));
+	NotNull(passedIndices);
+	if (canNarrow)
+	{
+		uxx* prevCandidates = (uxx*)palette->candidates.items;
+		for (uxx cIndex = 0; cIndex < palette->candidates.length; cIndex++)
+		{
+			uxx itemIndex = prevCandidates[cIndex];
+			passedIndices[numPassed] = itemIndex;
+			numPassed += ((itemMasks[itemIndex] & queryMask) == queryMask) ? 1 : 0;
+		}
+	}
+	else
+	{
+		//NOTE: This loop is written without branches over the packed masks so the compiler can vectorize it. With thousands of options it's the only part of a full scan that touches every item
+		for (uxx itemIndex = 0; itemIndex < palette->items.length; itemIndex++)
+		{
+			passedIndices[numPassed] = itemIndex;
+			numPassed += ((itemMasks[itemIndex] & queryMask) == queryMask) ? 1 : 0;
+		}
+	}
+	
+	// +==============================+
+	// |       Score Candidates       |
+	// +==============================+
+	VarArrayClear(&palette->candidates);
+	palette->numResults = 0;
+	for (uxx pIndex = 0; pIndex < numPassed; pIndex++)
+	{
+		uxx itemIndex = passedIndices[pIndex];
+		PaletteItem* item = VarArrayGetHard(PaletteItem, &palette->items, itemIndex);
+		i32 score = 0;
+		if (FuzzyMatch(item->searchStr, query, &score))
+		{
+			uxx* newCandidate = VarArrayAdd(uxx, &palette->candidates);
+			NotNull(newCandidate);
+			*newCandidate = itemIndex;
+			AddCommandPaletteResult(palette, itemIndex, score);
+		}
+	}
+	
+	FreeStr8(palette->input.arena, &palette->prevQuery);
+	palette->prevQuery = AllocStr8(palette->input.arena, query);
+	palette->selectedIndex = 0;
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+void OpenCommandPalette(CommandPalette* palette)
+{
+	NotNull(palette);
+	NotNull(palette->input.arena);
+	palette->isOpen = true;
+	palette->input.isFocused = true;
+	EditTextDeleteRange(&palette->input, 0, palette->input.str.length);
+	palette->input.cursorStart = 0;
+	palette->input.cursorEnd = 0;
+	palette->input.textChanged = false;
+	EditTextResetCursorBlink(&palette->input);
+	
+	palette->clickedResult = UINTXX_MAX;
+	UpdateCommandPaletteItems(palette);
+	UpdateCommandPaletteResults(palette, true);
+	
+	app->isFileMenuOpen = false;
+	app->isOpenRecentSubmenuOpen = false;
+	app->isViewMenuOpen = false;
+}
+
+void CloseCommandPalette(CommandPalette* palette)
+{
+	NotNull(palette);
+	palette->isOpen = false;
+	palette->input.isFocused = false;
+}
+
+void RunCommandPaletteResult(CommandPalette* palette, uxx resultIndex)
+{
+	NotNull(palette);
+	Assert(resultIndex < palette->numResults);
+	ScratchBegin(scratch);
+	//NOTE: We copy the item since running it can change the things the items point to
+	PaletteItem item = *VarArrayGetHard(PaletteItem, &palette->items, palette->results[resultIndex].itemIndex);
+	CloseCommandPalette(palette);
+	
+	switch (item.type)
+	{
+		case PaletteItemType_Command:
+		{
+			RunAppCommand((AppCommand)item.index);
+		} break;
+		
+		case PaletteItemType_Option:
+		{
+			if (item.tabIndex < app->tabs.length)
+			{
+				AppChangeTab(item.tabIndex);
+				if (item.index < app->currentTab->fileOptions.length)
+				{
+					FileOption* option = VarArrayGetHard(FileOption, &app->currentTab->fileOptions, item.index);
+					ToggleOption(app->currentTab, option);
+					app->currentTab->selectedOptionIndex = (ixx)item.index;
+					app->usingKeyboardToSelect = true;
+					app->scrollToSelectedOption = true;
+				}
+			}
+		} break;
+		
+		case PaletteItemType_RecentFile:
+		{
+			AppOpenFileTab(AllocStr8(scratch, item.searchStr));
+		} break;
+		
+		case PaletteItemType_Preset:
+		{
+			if (item.index < app->presets.length) { AppQueuePreset(item.index); }
+		} break;
+		
+		default: DebugAssertMsg(false, "Unhandled PaletteItemType!"); break;
+	}
+	
+	ScratchEnd(scratch);
+}
+
+void UpdateCommandPalette(CommandPalette* palette)
+{
+	NotNull(palette);
+	if (!palette->isOpen) { return; }
+	ProfZoneBegin(_funcZone, "UpdateCommandPalette");
+	
+	bool itemsChanged = UpdateCommandPaletteItems(palette);
+	
+	//NOTE: The click was recorded by last frame's RenderCommandPalette. If the items changed since then the results were cleared and the click is dropped
+	if (palette->clickedResult != UINTXX_MAX)
+	{
+		uxx clickedResult = palette->clickedResult;
+		palette->clickedResult = UINTXX_MAX;
+		if (clickedResult < palette->numResults)
+		{
+			RunCommandPaletteResult(palette, clickedResult);
+			ProfZoneEnd(_funcZone);
+			return;
+		}
+	}
+	
+	//NOTE: Bindings are suspended while the palette is open, so the binding that opened it is checked here to close it again
+	for (uxx bIndex = 0; ; bIndex++)
+	{
+		AppBinding* binding = FindBindingForAppCommand(&app->bindings, AppCommand_OpenCommandPalette, bIndex);
+		if (binding == nullptr) { break; }
+		if (WasKeyComboPressed(binding->modifierKeys, binding->key, false))
+		{
+			appInputHandling->keyboard.keyHandledUntilReleased[binding->key] = true;
+			CloseCommandPalette(palette);
+			ProfZoneEnd(_funcZone);
+			return;
+		}
+	}
+	
+	EditTextHandleKeyboardInput(&palette->input);
+	if (palette->input.textChanged || itemsChanged)
+	{
+		palette->input.textChanged = false;
+		UpdateCommandPaletteResults(palette, itemsChanged);
+	}
+	
+	if (palette->numResults > 0)
+	{
+		if (WasKeyPressed(Key_Up, true))
+		{
+			palette->selectedIndex = (palette->selectedIndex > 0) ? palette->selectedIndex-1 : palette->numResults-1;
+		}
+		if (WasKeyPressed(Key_Down, true))
+		{
+			palette->selectedIndex = (palette->selectedIndex+1 < palette->numResults) ? palette->selectedIndex+1 : 0;
+		}
+	}
+	
+	//NOTE: These keys are marked handled so the same press doesn't trigger bindings once the palette is closed
+	if (WasKeyPressed(Key_Escape, false))
+	{
+		appInputHandling->keyboard.keyHandledUntilReleased[Key_Escape] = true;
+		CloseCommandPalette(palette);
+	}
+	else if (WasKeyPressed(Key_Enter, false))
+	{
+		appInputHandling->keyboard.keyHandledUntilReleased[Key_Enter] = true;
+		if (palette->numResults > 0) { RunCommandPaletteResult(palette, palette->selectedIndex); }
+	}
+	
+	ProfZoneEnd(_funcZone);
+}
+
+#if BUILD_WITH_PIG_UI
+void RenderCommandPalette(CommandPalette* palette)
+{
+	NotNull(palette);
+	if (!palette->isOpen) { return; }
+	
+	UiId overlayId = UiIdLit("CommandPaletteOverlay");
+	UiId paletteId = UiIdLit("CommandPalette");
+	r32 screenWidth = appIn->screenSize.width / GetUiCtx()->scale;
+	r32 screenHeight = appIn->screenSize.height / GetUiCtx()->scale;
+	Color32 textColor = GetThemeColor(ConfirmDialogText);
+	
+	UIELEM({ .id = overlayId,
+		.depth = PALETTE_DEPTH,
+		.direction = UiLayoutDir_TopDown,
+		.sizing = UI_FIXED2(screenWidth, screenHeight),
+		.alignment = UI_ALIGN_TOP_LEFT(),
+		.padding = { .inner = { .left=RoundR32(screenWidth * (1.0f - PALETTE_WIDTH_PERCENT) / 2.0f), .top=8 } },
+		.floating = {
+			.type = UiFloatingType_Parent,
+			.parentSide = UiSide_TopLeft,
+			.elemSide = UiSide_TopLeft,
+		},
+		.color = GetThemeColor(ConfirmDialogDarken),
+	})
+	{
+		UIELEM({ .id = paletteId,
+			.direction = UiLayoutDir_TopDown,
+			.sizing = { .width=UI_FIXED(screenWidth * PALETTE_WIDTH_PERCENT), .height=UI_FIT() },
+			.padding = { .inner=FillV4(6), .child=2 },
+			.color = GetThemeColor(DropdownBack),
+			.borderColor = GetThemeColor(DropdownBorder),
+			.borderThickness = FillV4(2),
+			.cornerRadius = FillV4(6),
+		})
+		{
+			// +==============================+
+			// |           Textbox            |
+			// +==============================+
+			UiEditableText(UiIdLit("CommandPaletteInput"), &palette->input, StrLit("Search commands, options and recent files"));
+			
+			// +==============================+
+			// |           Results            |
+			// +==============================+
+			//NOTE: Only a window of results around the selection is shown so the palette never needs to scroll
+			uxx firstVisibleIndex = 0;
+			if (palette->selectedIndex >= PALETTE_MAX_VISIBLE) { firstVisibleIndex = palette->selectedIndex - (PALETTE_MAX_VISIBLE-1); }
+			uxx numVisible = MinUXX(palette->numResults - firstVisibleIndex, PALETTE_MAX_VISIBLE);
+			for (uxx rIndex = firstVisibleIndex; rIndex < firstVisibleIndex + numVisible; rIndex++)
+			{
+				PaletteItem* item = VarArrayGetHard(PaletteItem, &palette->items, palette->results[rIndex].itemIndex);
+				UiId resultId = UiIdLitIndex("CommandPaletteResult", rIndex);
+				bool isHovered = IsUiElementHovered(resultId);
+				bool isSelected = (rIndex == palette->selectedIndex);
+				ThemeState resultThemeState = (isHovered && IsMouseDownRaw(MouseBtn_Left)) ? ThemeState_Pressed : ((isSelected || isHovered) ? ThemeState_Hovered : ThemeState_Default);
+				
+				Str8 detailStr = Str8_Empty;
+				if (item->type == PaletteItemType_Command)
+				{
+					detailStr = GetBindingStrForAppCommand(&app->bindings, (AppCommand)item->index, uiArena, 0);
+				}
+				else if (item->type == PaletteItemType_Option)
+				{
+					FileTab* tab = VarArrayGetHard(FileTab, &app->tabs, item->tabIndex);
+					FileOption* option = VarArrayGetHard(FileOption, &tab->fileOptions, item->index);
+					bool isEnabled = (option->type == FileOptionType_Bool) ? option->valueBool : option->isUncommented;
+					detailStr = PrintInArenaStr(uiArena, "%s - %.*s", isEnabled ? "On" : "Off", StrPrint(GetFileNamePart(tab->filePath, true)));
+				}
+				else if (item->type == PaletteItemType_RecentFile)
+				{
+					detailStr = StrLit("Recent File");
+				}
+				else if (item->type == PaletteItemType_Preset)
+				{
+					Preset* preset = VarArrayGetHard(Preset, &app->presets, item->index);
+					detailStr = PrintInArenaStr(uiArena, "Preset - %llu option%s", (u64)preset->entries.length, Plural(preset->entries.length, "s"));
+				}
+				
+				UIELEM({ .id = resultId,
+					.direction = UiLayoutDir_LeftToRight,
+					.sizing = { .width=UI_EXPAND(), .height=UI_FIT() },
+					.alignment = UI_ALIGN_LEFT_CENTER(),
+					.padding = { .inner=MakeV4(4,2,4,2), .child=8 },
+					.color = GetThemeColorEx(DropdownBtnBack, resultThemeState),
+					.borderColor = GetThemeColorEx(DropdownBtnBorder, resultThemeState),
+					.borderThickness = FillV4(1),
+					.cornerRadius = FillV4(4),
+				})
+				{
+					UIELEM_LEAF({
+						.text = item->searchStr,
+						.font = &app->uiFont,
+						.fontSize = app->uiFontSize,
+						.fontStyle = UI_FONT_STYLE,
+						.textColor = GetThemeColorEx(DropdownBtnText, resultThemeState),
+						.sizing = UI_TEXT_CLIP(0),
+						.renderer = { .textContraction = (item->type == PaletteItemType_RecentFile) ? TextContraction_EllipseFilePath : TextContraction_EllipseRight },
+					});
+					UIEXPANDER_HORI();
+					if (!IsEmptyStr(detailStr))
+					{
+						UIELEM_LEAF({
+							.text = detailStr,
+							.font = &app->uiFont,
+							.fontSize = app->uiFontSize,
+							.fontStyle = UI_FONT_STYLE,
+							.textColor = GetThemeColorEx(HotkeyText, ThemeState_Default),
+							.sizing = UI_TEXT_FULL(),
+						});
+					}
+				}
+				
+				if (isHovered && MouseLeftClicked()) { palette->clickedResult = rIndex; }
+			}
+			
+			if (palette->numResults == 0)
+			{
+				UIELEM_LEAF({
+					.text = StrLit("No matches"),
+					.font = &app->uiFont,
+					.fontSize = app->uiFontSize,
+					.fontStyle = UI_FONT_STYLE,
+					.textColor = ColorWithAlpha(textColor, 0.5f),
+					.sizing = UI_TEXT_FULL(),
+				});
+			}
+		}
+	}
+	
+	if (palette->isOpen && IsUiElementHovered(overlayId) && !IsUiElementHovered(paletteId) && MouseLeftClicked())
+	{
+		CloseCommandPalette(palette);
+	}
+}
+#endif //BUILD_WITH_PIG_UI
@@ -7,10 +7,11 @@ Description:
 	** Many of these have a corresponding button in the topbar menus.
 */
 
-void SelectAnOption()
+// Returns the visible option index to select when moving with nothing selected
+ixx SelectAnOption()
 {
 	//TODO: Could we somehow choose the option thats near the middle of the screen?
-	app->currentTab->selectedOptionIndex = 0;
+	return 0;
 }
 
 // +==================================+
@@ -22,7 +23,7 @@ POPUP_DIALOG_CALLBACK_DEF(AppResetCurrentFilePopupCallback)
 	UNUSED(dialog); UNUSED(selectedButton); UNUSED(contextPntr);
 	if (result == PopupDialogResult_Yes && app->currentTab != nullptr)
 	{
-		bool writeSuccess = OsWriteTextFile(app->currentTab->filePath, app->currentTab->originalFileContents);
+		bool writeSuccess = AppWriteTextFile(app->currentTab->filePath, app->currentTab->originalFileContents);
 		if (!writeSuccess) { NotifyPrint_E("Failed to write to file at \"%.*s\"!", StrPrint(app->currentTab->filePath)); }
 		else
 		{
@@ -72,6 +73,10 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			{
 				ClosePopupDialog(&app->popup, nullptr);
 			}
+			else if (app->folderScan.isOpen)
+			{
+				CloseFolderScan(&app->folderScan);
+			}
 			else if (app->isFileMenuOpen)
 			{
 				app->isFileMenuOpen = false;
@@ -81,6 +86,14 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			{
 				app->isViewMenuOpen = false;
 			}
+			else if (app->optionsFilter.isFocused)
+			{
+				app->optionsFilter.isFocused = false;
+			}
+			else if (IsOptionsFilterActive())
+			{
+				ClearOptionsFilter();
+			}
 			else if (DismissNotification(&app->notificationQueue, appIn->programTime, false))
 			{
 			}
@@ -104,6 +117,7 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			{
 				#if (TARGET_IS_WINDOWS || TARGET_IS_LINUX)
 				app->openFileDialogIsForTheme = false;
+				app->openFileDialogIsForFolder = false;
 				OsDoOpenFileDialogAsync(stdHeap, true, &app->openFileDialog);
 				Assert(app->openFileDialog.arena != nullptr || app->openFileDialog.error == Result_Canceled);
 				#else //!(TARGET_IS_WINDOWS || TARGET_IS_LINUX)
@@ -175,10 +189,7 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 					: ThemeMode_Dark
 				)
 			);
-			app->currentThemeMode = otherThemeMode;
-			SetAppSettingStr8Pntr(&app->settings, &app->settings.themeMode, MakeStr8Nt(GetThemeModeStr(app->currentThemeMode)));
-			SaveAppSettings();
-			AppBakeTheme(false);
+			AppSetThemeMode(otherThemeMode);
 		} break;
 		
 		// +===============================+
@@ -258,6 +269,7 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			{
 				#if (TARGET_IS_WINDOWS || TARGET_IS_LINUX)
 				app->openFileDialogIsForTheme = true;
+				app->openFileDialogIsForFolder = false;
 				OsDoOpenFileDialogAsync(stdHeap, true, &app->openFileDialog);
 				Assert(app->openFileDialog.arena != nullptr || app->openFileDialog.error == Result_Canceled);
 				#else //!(TARGET_IS_WINDOWS || TARGET_IS_LINUX)
@@ -461,7 +473,7 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			r32 buttonWidthVarName = app->currentTab->longestAbbreviationWidth + (r32)UI_U16(SMALL_BTN_PADDING_X)*2;                                        \
 			i32 numColumnsVarName = FloorR32i((optionsAreaWidthVarName - (r32)buttonMarginVarName) / (buttonWidthVarName + (r32)buttonMarginVarName));      \
 			if (numColumnsVarName <= 0) { numColumnsVarName = 1; }                                                                                          \
-			i32 numRowsVarName = CeilDivI32((i32)app->currentTab->fileOptions.length, numColumnsVarName)
+			i32 numRowsVarName = CeilDivI32((i32)numVisible, numColumnsVarName)
 		#endif // BUILD_WITH_CLAY
 		
 		// +==============================+
@@ -472,16 +484,16 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			app->usingKeyboardToSelect = true;
 			if (app->currentTab != nullptr)
 			{
-				if (app->currentTab->selectedOptionIndex == -1 && app->currentTab->fileOptions.length > 0)
+				//NOTE: Movement happens in terms of the options that pass the filter, selectedIndex is an index into those
+				uxx numVisible = GetNumVisibleOptions();
+				ixx selectedIndex = FindVisibleIndexOfOption(app->currentTab->selectedOptionIndex);
+				
+				if (selectedIndex == -1 && numVisible > 0)
 				{
-					SelectAnOption();
-					#if BUILD_WITH_CLAY
-					AutoScrollToSelectedOptionAfterMove();
-					#elif BUILD_WITH_PIG_UI
+					selectedIndex = SelectAnOption();
 					app->scrollToSelectedOption = true;
-					#endif //BUILD_WITH_CLAY
 				}
-				else if (app->currentTab->selectedOptionIndex >= 0)
+				else if (selectedIndex >= 0)
 				{
 					if (app->settings.smallButtons)
 					{
@@ -489,51 +501,45 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 						CALC_SMALL_OPTION_GRID_SPECS(optionsAreaWidth, buttonMargin, buttonWidth, numColumns, numRows);
 						UNUSED(numRows);
 						
-						if (app->currentTab->selectedOptionIndex >= numColumns)
+						if (selectedIndex >= numColumns)
 						{
-							app->currentTab->selectedOptionIndex -= numColumns;
-							AutoScrollToSelectedOptionAfterMove();
+							selectedIndex -= numColumns;
+							app->scrollToSelectedOption = true;
 						}
 						else if (true /*upPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 						{
-							app->currentTab->selectedOptionIndex = (ixx)(app->currentTab->fileOptions.length-1) - ((ixx)numColumns - app->currentTab->selectedOptionIndex);
-							AutoScrollToSelectedOptionAfterMove();
+							selectedIndex = (ixx)(numVisible-1) - ((ixx)numColumns - selectedIndex);
+							app->scrollToSelectedOption = true;
 						}
 						#elif BUILD_WITH_PIG_UI
-						if (app->currentTab->selectedOptionIndex >= (ixx)app->smallBtnNumColumns)
+						if (selectedIndex >= (ixx)app->smallBtnNumColumns)
 						{
-							app->currentTab->selectedOptionIndex -= app->smallBtnNumColumns;
+							selectedIndex -= app->smallBtnNumColumns;
 							app->scrollToSelectedOption = true;
 						}
 						else if (true /*upPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 						{
-							app->currentTab->selectedOptionIndex = (ixx)(app->currentTab->fileOptions.length-1) - ((ixx)app->smallBtnNumColumns - app->currentTab->selectedOptionIndex);
+							selectedIndex = (ixx)(numVisible-1) - ((ixx)app->smallBtnNumColumns - selectedIndex);
 							app->scrollToSelectedOption = true;
 						}
 						#endif //BUILD_WITH_CLAY
 					}
 					else
 					{
-						if (app->currentTab->selectedOptionIndex > 0)
+						if (selectedIndex > 0)
 						{
-							app->currentTab->selectedOptionIndex--;
-							#if BUILD_WITH_CLAY
-							AutoScrollToSelectedOptionAfterMove();
-							#elif BUILD_WITH_PIG_UI
+							selectedIndex--;
 							app->scrollToSelectedOption = true;
-							#endif //BUILD_WITH_CLAY
 						}
 						else if (true /*upPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 						{
-							app->currentTab->selectedOptionIndex = (ixx)app->currentTab->fileOptions.length-1;
-							#if BUILD_WITH_CLAY
-							AutoScrollToSelectedOptionAfterMove();
-							#elif BUILD_WITH_PIG_UI
+							selectedIndex = (ixx)numVisible-1;
 							app->scrollToSelectedOption = true;
-							#endif //BUILD_WITH_CLAY
 						}
 					}
 				}
+				
+				if (selectedIndex >= 0) { app->currentTab->selectedOptionIndex = (ixx)GetVisibleOptionIndex((uxx)selectedIndex); }
 			}
 		} break;
 		
@@ -545,75 +551,68 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			app->usingKeyboardToSelect = true;
 			if (app->currentTab != nullptr)
 			{
-				if (app->currentTab->selectedOptionIndex == -1 && app->currentTab->fileOptions.length > 0)
+				uxx numVisible = GetNumVisibleOptions();
+				ixx selectedIndex = FindVisibleIndexOfOption(app->currentTab->selectedOptionIndex);
+				
+				if (selectedIndex == -1 && numVisible > 0)
 				{
-					SelectAnOption();
-					#if BUILD_WITH_CLAY
-					AutoScrollToSelectedOptionAfterMove();
-					#elif BUILD_WITH_PIG_UI
+					selectedIndex = SelectAnOption();
 					app->scrollToSelectedOption = true;
-					#endif //BUILD_WITH_CLAY
 				}
-				else if (app->currentTab->selectedOptionIndex >= 0)
+				else if (selectedIndex >= 0)
 				{
 					if (app->settings.smallButtons)
 					{
 						#if BUILD_WITH_CLAY
 						CALC_SMALL_OPTION_GRID_SPECS(optionsAreaWidth, buttonMargin, buttonWidth, numColumns, numRows);
 						
-						if (((i32)app->currentTab->selectedOptionIndex / numColumns) < numRows-1)
+						if (((i32)selectedIndex / numColumns) < numRows-1)
 						{
-							app->currentTab->selectedOptionIndex += numColumns;
-							if ((uxx)app->currentTab->selectedOptionIndex >= app->currentTab->fileOptions.length)
+							selectedIndex += numColumns;
+							if ((uxx)selectedIndex >= numVisible)
 							{
-								app->currentTab->selectedOptionIndex = (ixx)app->currentTab->fileOptions.length-1;
+								selectedIndex = (ixx)numVisible-1;
 							}
-							AutoScrollToSelectedOptionAfterMove();
+							app->scrollToSelectedOption = true;
 						}
 						else if (true /*downPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 						{
-							app->currentTab->selectedOptionIndex = (app->currentTab->selectedOptionIndex + numColumns) % (ixx)app->currentTab->fileOptions.length;
-							AutoScrollToSelectedOptionAfterMove();
+							selectedIndex = (selectedIndex + numColumns) % (ixx)numVisible;
+							app->scrollToSelectedOption = true;
 						}
 						#elif BUILD_WITH_PIG_UI
-						if (((i32)app->currentTab->selectedOptionIndex / app->smallBtnNumColumns) < app->smallBtnNumRows-1)
+						if (((i32)selectedIndex / app->smallBtnNumColumns) < app->smallBtnNumRows-1)
 						{
-							app->currentTab->selectedOptionIndex += app->smallBtnNumColumns;
-							if ((uxx)app->currentTab->selectedOptionIndex >= app->currentTab->fileOptions.length)
+							selectedIndex += app->smallBtnNumColumns;
+							if ((uxx)selectedIndex >= numVisible)
 							{
-								app->currentTab->selectedOptionIndex = (ixx)app->currentTab->fileOptions.length-1;
+								selectedIndex = (ixx)numVisible-1;
 							}
 							app->scrollToSelectedOption = true;
 						}
 						else if (true /*downPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 						{
-							app->currentTab->selectedOptionIndex = (app->currentTab->selectedOptionIndex + app->smallBtnNumColumns) % (ixx)app->currentTab->fileOptions.length;
+							selectedIndex = (selectedIndex + app->smallBtnNumColumns) % (ixx)numVisible;
 							app->scrollToSelectedOption = true;
 						}
 						#endif //BUILD_WITH_CLAY
 					}
 					else
 					{
-						if ((uxx)app->currentTab->selectedOptionIndex < app->currentTab->fileOptions.length-1)
+						if ((uxx)selectedIndex < numVisible-1)
 						{
-							app->currentTab->selectedOptionIndex++;
-							#if BUILD_WITH_CLAY
-							AutoScrollToSelectedOptionAfterMove();
-							#elif BUILD_WITH_PIG_UI
+							selectedIndex++;
 							app->scrollToSelectedOption = true;
-							#endif //BUILD_WITH_CLAY
 						}
 						else if (true /*downPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 						{
-							app->currentTab->selectedOptionIndex = 0;
-							#if BUILD_WITH_CLAY
-							AutoScrollToSelectedOptionAfterMove();
-							#elif BUILD_WITH_PIG_UI
+							selectedIndex = 0;
 							app->scrollToSelectedOption = true;
-							#endif //BUILD_WITH_CLAY
 						}
 					}
 				}
+				
+				if (selectedIndex >= 0) { app->currentTab->selectedOptionIndex = (ixx)GetVisibleOptionIndex((uxx)selectedIndex); }
 			}
 		} break;
 		
@@ -625,36 +624,29 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			app->usingKeyboardToSelect = true;
 			if (app->currentTab != nullptr)
 			{
-				if (app->currentTab->selectedOptionIndex == -1 && app->currentTab->fileOptions.length > 0)
+				uxx numVisible = GetNumVisibleOptions();
+				ixx selectedIndex = FindVisibleIndexOfOption(app->currentTab->selectedOptionIndex);
+				
+				if (selectedIndex == -1 && numVisible > 0)
 				{
-					SelectAnOption();
-					#if BUILD_WITH_CLAY
-					AutoScrollToSelectedOptionAfterMove();
-					#elif BUILD_WITH_PIG_UI
+					selectedIndex = SelectAnOption();
 					app->scrollToSelectedOption = true;
-					#endif //BUILD_WITH_CLAY
 				}
-				else if (app->currentTab->selectedOptionIndex >= 0 && app->settings.smallButtons)
+				else if (selectedIndex >= 0 && app->settings.smallButtons)
 				{
-					if (app->currentTab->selectedOptionIndex > 0)
+					if (selectedIndex > 0)
 					{
-						app->currentTab->selectedOptionIndex--;
-						#if BUILD_WITH_CLAY
-						AutoScrollToSelectedOptionAfterMove();
-						#elif BUILD_WITH_PIG_UI
+						selectedIndex--;
 						app->scrollToSelectedOption = true;
-						#endif //BUILD_WITH_CLAY
 					}
 					else if (true /*leftPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 					{
-						app->currentTab->selectedOptionIndex = (ixx)app->currentTab->fileOptions.length-1;
-						#if BUILD_WITH_CLAY
-						AutoScrollToSelectedOptionAfterMove();
-						#elif BUILD_WITH_PIG_UI
+						selectedIndex = (ixx)numVisible-1;
 						app->scrollToSelectedOption = true;
-						#endif //BUILD_WITH_CLAY
 					}
 				}
+				
+				if (selectedIndex >= 0) { app->currentTab->selectedOptionIndex = (ixx)GetVisibleOptionIndex((uxx)selectedIndex); }
 			}
 		} break;
 		
@@ -666,36 +658,29 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			app->usingKeyboardToSelect = true;
 			if (app->currentTab != nullptr)
 			{
-				if (app->currentTab->selectedOptionIndex == -1 && app->currentTab->fileOptions.length > 0)
+				uxx numVisible = GetNumVisibleOptions();
+				ixx selectedIndex = FindVisibleIndexOfOption(app->currentTab->selectedOptionIndex);
+				
+				if (selectedIndex == -1 && numVisible > 0)
 				{
-					SelectAnOption();
-					#if BUILD_WITH_CLAY
-					AutoScrollToSelectedOptionAfterMove();
-					#elif BUILD_WITH_PIG_UI
+					selectedIndex = SelectAnOption();
 					app->scrollToSelectedOption = true;
-					#endif //BUILD_WITH_CLAY
 				}
-				else if (app->currentTab->selectedOptionIndex >= 0 && app->settings.smallButtons)
+				else if (selectedIndex >= 0 && app->settings.smallButtons)
 				{
-					if ((uxx)app->currentTab->selectedOptionIndex < app->currentTab->fileOptions.length-1)
+					if ((uxx)selectedIndex < numVisible-1)
 					{
-						app->currentTab->selectedOptionIndex++;
-						#if BUILD_WITH_CLAY
-						AutoScrollToSelectedOptionAfterMove();
-						#elif BUILD_WITH_PIG_UI
+						selectedIndex++;
 						app->scrollToSelectedOption = true;
-						#endif //BUILD_WITH_CLAY
 					}
 					else if (true /*rightPressed*/) //TODO: Re-enable this distinction somehow? We only wanna loop around if the key was pressed, not when it was held down and OS-level repeated
 					{
-						app->currentTab->selectedOptionIndex = 0;
-						#if BUILD_WITH_CLAY
-						AutoScrollToSelectedOptionAfterMove();
-						#elif BUILD_WITH_PIG_UI
+						selectedIndex = 0;
 						app->scrollToSelectedOption = true;
-						#endif //BUILD_WITH_CLAY
 					}
 				}
+				
+				if (selectedIndex >= 0) { app->currentTab->selectedOptionIndex = (ixx)GetVisibleOptionIndex((uxx)selectedIndex); }
 			}
 		} break;
 		
@@ -730,6 +715,94 @@ void RunAppCommand(AppCommand command) //pre-declared in app_commands.h
 			}
 		} break;
 		
+		// +================================+
+		// | AppCommand_OpenCommandPalette  |
+		// +================================+
+		case AppCommand_OpenCommandPalette:
+		{
+			//NOTE: Bindings are suspended while the palette is open, so closing it with the same binding is handled in UpdateCommandPalette
+			if (!app->palette.isOpen && !app->popup.isOpen) { OpenCommandPalette(&app->palette); }
+		} break;
+		
+		// +================================+
+		// | AppCommand_FocusOptionsFilter  |
+		// +================================+
+		case AppCommand_FocusOptionsFilter:
+		{
+			if (app->currentTab != nullptr && !app->popup.isOpen) { FocusOptionsFilter(); }
+		} break;
+		
+		// +==============================+
+		// |    AppCommand_OpenFolder     |
+		// +==============================+
+		case AppCommand_OpenFolder:
+		{
+			if (app->openFileDialog.arena == nullptr)
+			{
+				#if (TARGET_IS_WINDOWS || TARGET_IS_LINUX)
+				//NOTE: We don't have a folder picker so the user picks any file and we scan the folder it lives in
+				app->openFileDialogIsForTheme = false;
+				app->openFileDialogIsForFolder = true;
+				OsDoOpenFileDialogAsync(stdHeap, true, &app->openFileDialog);
+				Assert(app->openFileDialog.arena != nullptr || app->openFileDialog.error == Result_Canceled);
+				#else //!(TARGET_IS_WINDOWS || TARGET_IS_LINUX)
+				Notify_W("Open File dialog is not implemented on OSX currently! Please drag-and-drop a folder or pass the folder path as a command-line argument!");
+				#endif
+			}
+		} break;
+		
+		// +==============================+
+		// |    AppCommand_SavePreset     |
+		// +==============================+
+		case AppCommand_SavePreset:
+		{
+			AppSavePresetFromOpenTabs();
+		} break;
+		
+		// +==============================+
+		// |   AppCommand_CaptureFrames   |
+		// +==============================+
+		case AppCommand_CaptureFrames:
+		{
+			if (app->profiler.captureMode != ProfilerCaptureMode_None) { StopProfilerCapture(&app->profiler); Notify_I("Capture canceled"); }
+			else if (app->profiler.ticksPerMs == 0) { Notify_W("The profiler is still calibrating, try again in a moment"); }
+			else
+			{
+				StartProfilerCapture(&app->profiler, ProfilerCaptureMode_Frames, (uxx)app->settings.captureFrameCount, 0.0f);
+				NotifyPrint_I("Capturing the next %u frames", app->settings.captureFrameCount);
+			}
+		} break;
+		
+		// +==============================+
+		// | AppCommand_CaptureNextStall  |
+		// +==============================+
+		case AppCommand_CaptureNextStall:
+		{
+			if (app->profiler.captureMode != ProfilerCaptureMode_None) { StopProfilerCapture(&app->profiler); Notify_I("Capture canceled"); }
+			else if (app->profiler.ticksPerMs == 0) { Notify_W("The profiler is still calibrating, try again in a moment"); }
+			else
+			{
+				StartProfilerCapture(&app->profiler, ProfilerCaptureMode_NextStall, 0, app->settings.captureStallThreshold);
+				NotifyPrint_I("Waiting for a frame that takes longer than %.1fms", app->settings.captureStallThreshold);
+			}
+		} break;
+		
+		// +==============================+
+		// | AppCommand_ToggleMemoryStats |
+		// +==============================+
+		case AppCommand_ToggleMemoryStats:
+		{
+			app->showMemoryStats = !app->showMemoryStats;
+		} break;
+		
+		// +==============================+
+		// |  AppCommand_DumpMemoryStats  |
+		// +==============================+
+		case AppCommand_DumpMemoryStats:
+		{
+			DumpMemoryStats();
+		} break;
+		
 		default:
 		{
 			DebugAssertMsg(false, "Unimplemented AppCommand!");
@@ -49,6 +49,14 @@ enum AppCommand
 	AppCommand_SelectMoveRight,
 	AppCommand_ToggleSelected,
 	AppCommand_ClearRecentFiles,
+	AppCommand_OpenCommandPalette,
+	AppCommand_FocusOptionsFilter,
+	AppCommand_OpenFolder,
+	AppCommand_SavePreset,
+	AppCommand_CaptureFrames,
+	AppCommand_CaptureNextStall,
+	AppCommand_ToggleMemoryStats,
+	AppCommand_DumpMemoryStats,
 	AppCommand_Count,
 };
 
@@ -95,9 +103,32 @@ const char* GetAppCommandStr(AppCommand enumValue)
 		case AppCommand_SelectMoveRight:       return "SelectMoveRight";
 		case AppCommand_ToggleSelected:        return "ToggleSelected";
 		case AppCommand_ClearRecentFiles:      return "ClearRecentFiles";
+		case AppCommand_OpenCommandPalette:    return "OpenCommandPalette";
+		case AppCommand_FocusOptionsFilter:    return "FocusOptionsFilter";
+		case AppCommand_OpenFolder:            return "OpenFolder";
+		case AppCommand_SavePreset:            return "SavePreset";
+		case AppCommand_CaptureFrames:         return "CaptureFrames";
+		case AppCommand_CaptureNextStall:      return "CaptureNextStall";
+		case AppCommand_ToggleMemoryStats:     return "ToggleMemoryStats";
+		case AppCommand_DumpMemoryStats:       return "DumpMemoryStats";
 		default: return UNKNOWN_STR;
 	}
 }
+static NameTable AppCommandNameTable = ZEROED;
+void InitAppCommandNameTable()
+{
+	const char* names[AppCommand_Count];
+	names[AppCommand_None] = nullptr;
+	for (uxx cIndex = 1; cIndex < AppCommand_Count; cIndex++) { names[cIndex] = GetAppCommandStr((AppCommand)cIndex); }
+	if (!InitNameTable(&AppCommandNameTable, AppCommand_Count, &names[0])) { AssertMsg(false, "Failed to build AppCommand NameTable!"); }
+}
+bool TryParseAppCommand(Str8 commandStr, AppCommand* commandOut)
+{
+	uxx commandIndex = FindNameTableIndex(&AppCommandNameTable, commandStr);
+	if (commandIndex == UINTXX_MAX) { return false; }
+	SetOptionalOutPntr(commandOut, (AppCommand)commandIndex);
+	return true;
+}
 
 bool DoesAppCommandTriggerOnOsLevelKeyRepeatEvents(AppCommand command)
 {
@@ -0,0 +1,530 @@
+/*
+File:   app_conditionals.c
+Description:
+	** Finds the #if/#ifdef/#ifndef/#elif/#else/#endif blocks in a tab's file and works out which options sit in a
+	** block that is turned off, so we don't show a #define inside "#if 0" as if it does anything.
+	** One pass over the file builds the list of blocks (one per branch, in file order, so the blocks nested in a branch
+	** always directly follow it) with a stack of the chains that are open. The condition of each branch is evaluated by
+	** a small constant expression evaluator that looks names up in the options that come before the directive.
+	** Names that aren't options in this file (compiler defines, other headers) are "unknown", and any branch whose
+	** outcome depends on an unknown is never marked dead. We would rather miss a dead option than hide a live one.
+	** Each block remembers which names its expression looked at, so toggling an option only re-evaluates the blocks
+	** that depend on its name and refreshes the options in those chains (see UpdateFileTabConditionals)
+	** NOTE: The value of a name is the last option with that name above the directive, even if that option is itself
+	** inside a dead block. Non-option #defines are not tracked and are always unknown
+*/
+
+// +--------------------------------------------------------------+
+// |                     Expression Evaluator                     |
+// +--------------------------------------------------------------+
+#define UnknownConditionalValue       ((ConditionalValue){ .isKnown=false, .value=0 })
+#define KnownConditionalValue(number) ((ConditionalValue){ .isKnown=true, .value=(i64)(number) })
+
+typedef plex ConditionalEvaluator ConditionalEvaluator;
+plex ConditionalEvaluator
+{
+	Str8 expression;
+	uxx index;
+	uxx depth;
+	const VarArray* options; //FileOption
+	uxx numOptionsBefore; //only options[0..numOptionsBefore) are visible to the expression
+	VarArray* dependenciesOut; //Str8, nullable
+	uxx firstDependency; //dependencies before this index belong to other blocks
+};
+
+bool IsConditionalIdentifierChar(char c, bool isFirstChar)
+{
+	if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_') { return true; }
+	return (!isFirstChar && c >= '0' && c <= '9');
+}
+
+void SkipConditionalWhitespace(ConditionalEvaluator* eval)
+{
+	while (eval->index < eval->expression.length && IsCharWhitespace(eval->expression.chars[eval->index], true)) { eval->index++; }
+}
+
+bool ConsumeConditionalStr(ConditionalEvaluator* eval, Str8 str)
+{
+	SkipConditionalWhitespace(eval);
+	if (!StrExactStartsWith(StrSliceFrom(eval->expression, eval->index), str)) { return false; }
+	eval->index += str.length;
+	return true;
+}
+
+Str8 ConsumeConditionalIdentifier(ConditionalEvaluator* eval)
+{
+	SkipConditionalWhitespace(eval);
+	uxx nameStart = eval->index;
+	if (eval->index >= eval->expression.length || !IsConditionalIdentifierChar(eval->expression.chars[eval->index], true)) { return Str8_Empty; }
+	while (eval->index < eval->expression.length && IsConditionalIdentifierChar(eval->expression.chars[eval->index], false)) { eval->index++; }
+	return StrSlice(eval->expression, nameStart, eval->index);
+}
+
+void AddConditionalDependency(ConditionalEvaluator* eval, Str8 name)
+{
+	if (eval->dependenciesOut == nullptr) { return; }
+	for (uxx dIndex = eval->firstDependency; dIndex < eval->dependenciesOut->length; dIndex++)
+	{
+		if (StrExactEquals(*VarArrayGetHard(Str8, eval->dependenciesOut, dIndex), name)) { return; }
+	}
+	*VarArrayAdd(Str8, eval->dependenciesOut) = name;
+}
+
+// What we know about a name at this point in the file. isDefined and the value are separately known/unknown since "#define X" (with no value) is defined but has no numeric value
+void LookupConditionalName(ConditionalEvaluator* eval, Str8 name, ConditionalValue* isDefinedOut, ConditionalValue* valueOut)
+{
+	AddConditionalDependency(eval, name);
+	*isDefinedOut = UnknownConditionalValue;
+	*valueOut = UnknownConditionalValue;
+	for (uxx oIndex = eval->numOptionsBefore; oIndex > 0; oIndex--)
+	{
+		const FileOption* option = VarArrayGetHard(FileOption, eval->options, oIndex-1);
+		if (!StrExactEquals(option->name, name)) { continue; }
+		if (option->type == FileOptionType_Bool)
+		{
+			*isDefinedOut = KnownConditionalValue(1);
+			*valueOut = KnownConditionalValue(option->valueBool ? 1 : 0);
+		}
+		else if (option->type == FileOptionType_CommentDefine)
+		{
+			*isDefinedOut = KnownConditionalValue(option->isUncommented ? 1 : 0);
+			//NOTE: An undefined name is 0 in an #if, but a define with no value is a compile error there so we leave it unknown
+			if (!option->isUncommented) { *valueOut = KnownConditionalValue(0); }
+		}
+		return;
+	}
+}
+
+ConditionalValue EvaluateConditionalTernary(ConditionalEvaluator* eval);
+
+ConditionalValue EvaluateConditionalNumber(ConditionalEvaluator* eval)
+{
+	Str8 expression = eval->expression;
+	u64 base = 10;
+	if (eval->index+1 < expression.length && expression.chars[eval->index] == '0' && (expression.chars[eval->index+1] == 'x' || expression.chars[eval->index+1] == 'X')) { base = 16; eval->index += 2; }
+	else if (eval->index+1 < expression.length && expression.chars[eval->index] == '0' && (expression.chars[eval->index+1] == 'b' || expression.chars[eval->index+1] == 'B')) { base = 2; eval->index += 2; }
+	else if (expression.chars[eval->index] == '0') { base = 8; }
+	u64 value = 0;
+	bool isValid = true;
+	while (eval->index < expression.length)
+	{
+		char c = expression.chars[eval->index];
+		u64 digit = 0;
+		if (c >= '0' && c <= '9') { digit = (u64)(c - '0'); }
+		else if (base == 16 && c >= 'a' && c <= 'f') { digit = (u64)(c - 'a' + 10); }
+		else if (base == 16 && c >= 'A' && c <= 'F') { digit = (u64)(c - 'A' + 10); }
+		else if (c == '\'') { eval->index++; continue; } //digit separator
+		else { break; }
+		if (digit >= base) { isValid = false; }
+		value = (value * base) + digit;
+		eval->index++;
+	}
+	while (eval->index < expression.length && (expression.chars[eval->index] == 'u' || expression.chars[eval->index] == 'U' || expression.chars[eval->index] == 'l' || expression.chars[eval->index] == 'L')) { eval->index++; }
+	//Floating point (or anything else glued to the number) isn't valid in an #if
+	if (eval->index < expression.length && (expression.chars[eval->index] == '.' || IsConditionalIdentifierChar(expression.chars[eval->index], false))) { isValid = false; }
+	while (eval->index < expression.length && (expression.chars[eval->index] == '.' || IsConditionalIdentifierChar(expression.chars[eval->index], false))) { eval->index++; }
+	return isValid ? KnownConditionalValue(value) : UnknownConditionalValue;
+}
+
+ConditionalValue EvaluateConditionalUnary(ConditionalEvaluator* eval)
+{
+	SkipConditionalWhitespace(eval);
+	if (eval->index >= eval->expression.length) { return UnknownConditionalValue; }
+	char c = eval->expression.chars[eval->index];
+	
+	if (c == '!' || c == '~' || c == '-' || c == '+')
+	{
+		eval->index++;
+		ConditionalValue operand = EvaluateConditionalUnary(eval);
+		if (!operand.isKnown) { return operand; }
+		if (c == '!') { return KnownConditionalValue(operand.value == 0 ? 1 : 0); }
+		if (c == '~') { return KnownConditionalValue(~operand.value); }
+		if (c == '-') { return KnownConditionalValue(-operand.value); }
+		return operand;
+	}
+	else if (c == '(')
+	{
+		eval->index++;
+		ConditionalValue result = EvaluateConditionalTernary(eval);
+		if (!ConsumeConditionalStr(eval, StrLit(")"))) { return UnknownConditionalValue; }
+		return result;
+	}
+	else if (c >= '0' && c <= '9')
+	{
+		return EvaluateConditionalNumber(eval);
+	}
+	else if (c == '\'')
+	{
+		//Character literals are rare enough in #if that we don't bother with their value
+		eval->index++;
+		while (eval->index < eval->expression.length && eval->expression.chars[eval->index] != '\'') { eval->index += (eval->expression.chars[eval->index] == '\\') ? 2 : 1; }
+		eval->index++;
+		return UnknownConditionalValue;
+	}
+	else if (IsConditionalIdentifierChar(c, true))
+	{
+		Str8 name = ConsumeConditionalIdentifier(eval);
+		if (StrExactEquals(name, StrLit("defined")))
+		{
+			bool hasParens = ConsumeConditionalStr(eval, StrLit("("));
+			Str8 definedName = ConsumeConditionalIdentifier(eval);
+			if (IsEmptyStr(definedName) || (hasParens && !ConsumeConditionalStr(eval, StrLit(")")))) { return UnknownConditionalValue; }
+			ConditionalValue isDefined, value;
+			LookupConditionalName(eval, definedName, &isDefined, &value);
+			return isDefined;
+		}
+		if (StrExactEquals(name, StrLit("true"))) { return KnownConditionalValue(1); }
+		if (StrExactEquals(name, StrLit("false"))) { return KnownConditionalValue(0); }
+		
+		//Function-like macros and __has_include(...) are unknown, skip their arguments
+		SkipConditionalWhitespace(eval);
+		if (eval->index < eval->expression.length && eval->expression.chars[eval->index] == '(')
+		{
+			uxx parenDepth = 0;
+			while (eval->index < eval->expression.length)
+			{
+				char argChar = eval->expression.chars[eval->index++];
+				if (argChar == '(') { parenDepth++; }
+				else if (argChar == ')') { parenDepth--; if (parenDepth == 0) { break; } }
+			}
+			return UnknownConditionalValue;
+		}
+		
+		ConditionalValue isDefined, value;
+		LookupConditionalName(eval, name, &isDefined, &value);
+		return value;
+	}
+	
+	eval->index = eval->expression.length; //something we don't understand, give up on the rest of the expression
+	return UnknownConditionalValue;
+}
+
+// Ordered so two character operators are matched before their one character prefixes
+typedef plex ConditionalBinaryOp ConditionalBinaryOp;
+plex ConditionalBinaryOp { const char* str; u8 precedence; };
+static const ConditionalBinaryOp ConditionalBinaryOps[] = {
+	{ "||", 1 }, { "&&", 2 }, { "==", 6 }, { "!=", 6 }, { "<=", 7 }, { ">=", 7 }, { "<<", 8 }, { ">>", 8 },
+	{ "|", 3 }, { "^", 4 }, { "&", 5 }, { "<", 7 }, { ">", 7 }, { "+", 9 }, { "-", 9 }, { "*", 10 }, { "/", 10 }, { "%", 10 },
+};
+
+ConditionalValue ApplyConditionalBinaryOp(Str8 op, ConditionalValue left, ConditionalValue right)
+{
+	//&& and || can be known even when one side isn't
+	if (StrExactEquals(op, StrLit("&&")))
+	{
+		if ((left.isKnown && left.value == 0) || (right.isKnown && right.value == 0)) { return KnownConditionalValue(0); }
+		if (left.isKnown && right.isKnown) { return KnownConditionalValue(1); }
+		return UnknownConditionalValue;
+	}
+	if (StrExactEquals(op, StrLit("||")))
+	{
+		if ((left.isKnown && left.value != 0) || (right.isKnown && right.value != 0)) { return KnownConditionalValue(1); }
+		if (left.isKnown && right.isKnown) { return KnownConditionalValue(0); }
+		return UnknownConditionalValue;
+	}
+	if (!left.isKnown || !right.isKnown) { return UnknownConditionalValue; }
+	i64 a = left.value;
+	i64 b = right.value;
+	switch (op.chars[0])
+	{
+		case '=': return KnownConditionalValue(a == b);
+		case '!': return KnownConditionalValue(a != b);
+		case '<': return (op.length == 1) ? KnownConditionalValue(a < b) : ((op.chars[1] == '=') ? KnownConditionalValue(a <= b) : KnownConditionalValue((b >= 0 && b < 64) ? (i64)((u64)a << b) : 0));
+		case '>': return (op.length == 1) ? KnownConditionalValue(a > b) : ((op.chars[1] == '=') ? KnownConditionalValue(a >= b) : KnownConditionalValue((b >= 0 && b < 64) ? (a >> b) : 0));
+		case '|': return KnownConditionalValue(a | b);
+		case '^': return KnownConditionalValue(a ^ b);
+		case '&': return KnownConditionalValue(a & b);
+		case '+': return KnownConditionalValue(a + b);
+		case '-': return KnownConditionalValue(a - b);
+		case '*': return KnownConditionalValue(a * b);
+		case '/': return (b != 0) ? KnownConditionalValue(a / b) : UnknownConditionalValue;
+		case '%': return (b != 0) ? KnownConditionalValue(a % b) : UnknownConditionalValue;
+		default: return UnknownConditionalValue;
+	}
+}
+
+ConditionalValue EvaluateConditionalBinary(ConditionalEvaluator* eval, u8 minPrecedence)
+{
+	ConditionalValue left = EvaluateConditionalUnary(eval);
+	while (true)
+	{
+		SkipConditionalWhitespace(eval);
+		Str8 remaining = StrSliceFrom(eval->expression, eval->index);
+		const ConditionalBinaryOp* foundOp = nullptr;
+		for (uxx opIndex = 0; opIndex < ArrayCount(ConditionalBinaryOps); opIndex++)
+		{
+			if (StrExactStartsWith(remaining, MakeStr8Nt(ConditionalBinaryOps[opIndex].str))) { foundOp = &ConditionalBinaryOps[opIndex]; break; }
+		}
+		if (foundOp == nullptr || foundOp->precedence < minPrecedence) { break; }
+		Str8 opStr = MakeStr8Nt(foundOp->str);
+		eval->index += opStr.length;
+		ConditionalValue right = EvaluateConditionalBinary(eval, foundOp->precedence+1);
+		left = ApplyConditionalBinaryOp(opStr, left, right);
+	}
+	return left;
+}
+
+ConditionalValue EvaluateConditionalTernary(ConditionalEvaluator* eval)
+{
+	if (eval->depth >= CONDITIONAL_MAX_EXPRESSION_DEPTH) { eval->index = eval->expression.length; return UnknownConditionalValue; }
+	eval->depth++;
+	ConditionalValue result = EvaluateConditionalBinary(eval, 1);
+	if (ConsumeConditionalStr(eval, StrLit("?")))
+	{
+		ConditionalValue trueValue = EvaluateConditionalTernary(eval);
+		ConditionalValue falseValue = ConsumeConditionalStr(eval, StrLit(":")) ? EvaluateConditionalTernary(eval) : UnknownConditionalValue;
+		if (result.isKnown) { result = (result.value != 0) ? trueValue : falseValue; }
+		else if (trueValue.isKnown && falseValue.isKnown && trueValue.value == falseValue.value) { result = trueValue; }
+		else { result = UnknownConditionalValue; }
+	}
+	eval->depth--;
+	return result;
+}
+
+ConditionalValue EvaluateConditionalExpression(Str8 expression, const VarArray* options, uxx numOptionsBefore, VarArray* dependenciesOut)
+{
+	ConditionalEvaluator eval = ZEROED;
+	eval.expression = expression;
+	eval.options = options;
+	eval.numOptionsBefore = numOptionsBefore;
+	eval.dependenciesOut = dependenciesOut;
+	eval.firstDependency = (dependenciesOut != nullptr) ? dependenciesOut->length : 0;
+	ConditionalValue result = EvaluateConditionalTernary(&eval);
+	SkipConditionalWhitespace(&eval);
+	if (eval.index < eval.expression.length) { result = UnknownConditionalValue; } //trailing junk means we didn't really understand it
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                            Blocks                            |
+// +--------------------------------------------------------------+
+void FreeFileConditionals(FileConditionals* conditionals)
+{
+	NotNull(conditionals);
+	if (conditionals->arena != nullptr)
+	{
+		VarArrayLoop(&conditionals->blocks, bIndex)
+		{
+			VarArrayLoopGet(ConditionalBlock, block, &conditionals->blocks, bIndex);
+			FreeStr8(conditionals->arena, &block->expression);
+		}
+		FreeVarArray(&conditionals->blocks);
+		FreeVarArray(&conditionals->dependencies);
+	}
+	ClearPointer(conditionals);
+}
+
+// Works out which branches of the chain starting at chainStartIndex are skipped. A branch is only skipped if we know for sure
+// that it is: its own condition is known false, or a branch before it is known true
+void ResolveConditionalChain(FileConditionals* conditionals, uxx chainStartIndex)
+{
+	bool isEarlierTaken = false;
+	uxx bIndex = chainStartIndex;
+	while (bIndex < conditionals->blocks.length)
+	{
+		ConditionalBlock* block = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, bIndex);
+		if (block->chainStartIndex != chainStartIndex) { break; }
+		if (isEarlierTaken) { block->isSkipped = true; }
+		else if (block->condition.isKnown && block->condition.value == 0) { block->isSkipped = true; }
+		else if (block->condition.isKnown) { block->isSkipped = false; isEarlierTaken = true; } //even if an unknown branch before us is the one that's taken, nothing after us can be
+		else { block->isSkipped = false; }
+		bIndex = block->endBlockIndex;
+	}
+}
+
+// Recalculates isDead for blocks[startIndex..endIndex) and isInactive for the options they cover. startIndex must be the start of a chain (or 0)
+void ResolveConditionalBlocks(FileTab* tab, uxx startIndex, uxx endIndex)
+{
+	FileConditionals* conditionals = &tab->conditionals;
+	if (startIndex >= endIndex) { return; }
+	for (uxx bIndex = startIndex; bIndex < endIndex; bIndex++)
+	{
+		ConditionalBlock* block = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, bIndex);
+		if (block->chainStartIndex == bIndex) { ResolveConditionalChain(conditionals, bIndex); }
+		bool isParentDead = (block->parentIndex >= 0 && VarArrayGetHard(ConditionalBlock, &conditionals->blocks, (uxx)block->parentIndex)->isDead);
+		block->isDead = (block->isSkipped || isParentDead);
+	}
+	
+	uxx firstOption = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, startIndex)->firstOption;
+	uxx endOption = firstOption;
+	for (uxx bIndex = startIndex; bIndex < endIndex; bIndex++) { endOption = MaxUXX(endOption, VarArrayGetHard(ConditionalBlock, &conditionals->blocks, bIndex)->endOption); }
+	for (uxx oIndex = firstOption; oIndex < endOption && oIndex < tab->fileOptions.length; oIndex++)
+	{
+		FileOption* option = VarArrayGetHard(FileOption, &tab->fileOptions, oIndex);
+		bool isInactive = (option->conditionalIndex >= 0 && VarArrayGetHard(ConditionalBlock, &conditionals->blocks, (uxx)option->conditionalIndex)->isDead);
+		if (option->isInactive != isInactive)
+		{
+			option->isInactive = isInactive;
+			if (isInactive) { conditionals->numInactiveOptions++; }
+			else { conditionals->numInactiveOptions--; }
+		}
+	}
+}
+
+// One past the last block of the chain that starts at chainStartIndex, including everything nested in it
+uxx GetConditionalChainEnd(FileConditionals* conditionals, uxx chainStartIndex)
+{
+	uxx bIndex = chainStartIndex;
+	while (bIndex < conditionals->blocks.length && VarArrayGetHard(ConditionalBlock, &conditionals->blocks, bIndex)->chainStartIndex == chainStartIndex)
+	{
+		bIndex = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, bIndex)->endBlockIndex;
+	}
+	return bIndex;
+}
+
+// Single pass over tab->fileContents that finds every conditional block and marks the options in dead ones. Needs tab->fileOptions to be in file order (which ParseFileOptions gives us)
+void BuildFileTabConditionals(FileTab* tab)
+{
+	NotNull(tab);
+	ProfZoneBegin(_funcZone, "BuildFileTabConditionals");
+	ScratchBegin(scratch);
+	FileConditionals* conditionals = &tab->conditionals;
+	FreeFileConditionals(conditionals);
+	conditionals->arena = stdHeap;
+	InitVarArray(ConditionalBlock, &conditionals->blocks, stdHeap);
+	InitVarArray(Str8, &conditionals->dependencies, stdHeap);
+	
+	VarArray openBlocks; //uxx, the current branch of each chain that hasn't hit its #endif yet
+	InitVarArray(uxx, &openBlocks, scratch);
+	uxx optionCursor = 0;
+	LineParser lineParser = MakeLineParser(tab->fileContents);
+	Str8 fullLine = Str8_Empty;
+	while (LineParserGetLine(&lineParser, &fullLine))
+	{
+		Str8 line = TrimWhitespace(fullLine);
+		if (line.length == 0 || line.chars[0] != '#') { continue; }
+		uxx dIndex = 1;
+		while (dIndex < line.length && IsCharWhitespace(line.chars[dIndex], false)) { dIndex++; }
+		uxx directiveStart = dIndex;
+		while (dIndex < line.length && IsConditionalIdentifierChar(line.chars[dIndex], false)) { dIndex++; }
+		Str8 directive = StrSlice(line, directiveStart, dIndex);
+		
+		bool isIf = (StrExactEquals(directive, StrLit("if")) || StrExactEquals(directive, StrLit("ifdef")) || StrExactEquals(directive, StrLit("ifndef")));
+		bool isElse = (StrExactEquals(directive, StrLit("elif")) || StrExactEquals(directive, StrLit("elifdef")) || StrExactEquals(directive, StrLit("elifndef")) || StrExactEquals(directive, StrLit("else")));
+		bool isEndif = StrExactEquals(directive, StrLit("endif"));
+		if (!isIf && !isElse && !isEndif) { continue; }
+		if ((isElse || isEndif) && openBlocks.length == 0) { continue; } //unbalanced, probably closes something from an #include
+		
+		//The options above this directive belong to whatever block was open
+		ixx currentBlockIndex = (openBlocks.length > 0) ? (ixx)*VarArrayGetHard(uxx, &openBlocks, openBlocks.length-1) : -1;
+		while (optionCursor < tab->fileOptions.length && VarArrayGetHard(FileOption, &tab->fileOptions, optionCursor)->fileContentsStartIndex < lineParser.lineBeginByteIndex)
+		{
+			VarArrayGetHard(FileOption, &tab->fileOptions, optionCursor)->conditionalIndex = currentBlockIndex;
+			optionCursor++;
+		}
+		
+		if (isElse || isEndif)
+		{
+			ConditionalBlock* closingBlock = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, (uxx)currentBlockIndex);
+			closingBlock->endOption = optionCursor;
+			closingBlock->endBlockIndex = conditionals->blocks.length;
+			if (isEndif) { VarArrayRemoveAt(uxx, &openBlocks, openBlocks.length-1); continue; }
+		}
+		
+		//Gather the expression, following '\' continuations onto the next lines
+		uxx scratchMark = ArenaGetMark(scratch);
+		Str8 expression = TrimWhitespace(StrSliceFrom(line, dIndex));
+		while (expression.length > 0 && expression.chars[expression.length-1] == '\\')
+		{
+			Str8 nextLine = Str8_Empty;
+			if (!LineParserGetLine(&lineParser, &nextLine)) { break; }
+			expression = JoinStringsInArenaWithChar(scratch, StrSlice(expression, 0, expression.length-1), ' ', TrimWhitespace(nextLine), false);
+		}
+		uxx commentIndex = MinUXX(StrExactFind(expression, StrLit("//")), StrExactFind(expression, StrLit("/*")));
+		expression = TrimWhitespace(StrSlice(expression, 0, MinUXX(commentIndex, expression.length)));
+		if (StrExactEquals(directive, StrLit("ifdef")) || StrExactEquals(directive, StrLit("elifdef"))) { expression = JoinStringsInArena(scratch, StrLit("defined "), expression, false); }
+		else if (StrExactEquals(directive, StrLit("ifndef")) || StrExactEquals(directive, StrLit("elifndef"))) { expression = JoinStringsInArena(scratch, StrLit("!defined "), expression, false); }
+		
+		uxx newBlockIndex = conditionals->blocks.length;
+		ConditionalBlock* newBlock = VarArrayAdd(ConditionalBlock, &conditionals->blocks);
+		NotNull(newBlock);
+		ClearPointer(newBlock);
+		if (isIf)
+		{
+			newBlock->parentIndex = currentBlockIndex;
+			newBlock->chainStartIndex = newBlockIndex;
+			*VarArrayAdd(uxx, &openBlocks) = newBlockIndex;
+		}
+		else
+		{
+			ConditionalBlock* prevBranch = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, (uxx)currentBlockIndex);
+			newBlock->parentIndex = prevBranch->parentIndex;
+			newBlock->chainStartIndex = prevBranch->chainStartIndex;
+			*VarArrayGetHard(uxx, &openBlocks, openBlocks.length-1) = newBlockIndex;
+		}
+		newBlock->firstOption = optionCursor;
+		newBlock->endOption = tab->fileOptions.length;
+		newBlock->endBlockIndex = newBlockIndex+1;
+		if (StrExactEquals(directive, StrLit("else")))
+		{
+			newBlock->condition = KnownConditionalValue(1);
+		}
+		else
+		{
+			newBlock->expression = AllocStr8(stdHeap, expression);
+			newBlock->firstDependency = conditionals->dependencies.length;
+			newBlock->condition = EvaluateConditionalExpression(newBlock->expression, &tab->fileOptions, optionCursor, &conditionals->dependencies);
+			newBlock->numDependencies = conditionals->dependencies.length - newBlock->firstDependency;
+		}
+		ArenaResetToMark(scratch, scratchMark);
+	}
+	
+	//Anything left after the last directive, and chains that never saw their #endif
+	ixx lastBlockIndex = (openBlocks.length > 0) ? (ixx)*VarArrayGetHard(uxx, &openBlocks, openBlocks.length-1) : -1;
+	for (; optionCursor < tab->fileOptions.length; optionCursor++) { VarArrayGetHard(FileOption, &tab->fileOptions, optionCursor)->conditionalIndex = lastBlockIndex; }
+	VarArrayLoop(&openBlocks, bIndex)
+	{
+		VarArrayLoopGet(uxx, openBlockIndex, &openBlocks, bIndex);
+		VarArrayGetHard(ConditionalBlock, &conditionals->blocks, *openBlockIndex)->endBlockIndex = conditionals->blocks.length;
+	}
+	
+	VarArrayLoop(&tab->fileOptions, oIndex) { VarArrayGetHard(FileOption, &tab->fileOptions, oIndex)->isInactive = false; }
+	ResolveConditionalBlocks(tab, 0, conditionals->blocks.length);
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// Called after the value of an option changed. Only the blocks whose expression mentions the name are re-evaluated, and only the chains they are part of get resolved again
+void UpdateFileTabConditionals(FileTab* tab, Str8 optionName)
+{
+	NotNull(tab);
+	FileConditionals* conditionals = &tab->conditionals;
+	if (conditionals->arena == nullptr || conditionals->blocks.length == 0) { return; }
+	ProfZoneBegin(_funcZone, "UpdateFileTabConditionals");
+	
+	bool anyChanged = false;
+	VarArrayLoop(&conditionals->blocks, bIndex)
+	{
+		VarArrayLoopGet(ConditionalBlock, block, &conditionals->blocks, bIndex);
+		bool dependsOnName = false;
+		for (uxx dIndex = block->firstDependency; dIndex < block->firstDependency + block->numDependencies; dIndex++)
+		{
+			if (StrExactEquals(*VarArrayGetHard(Str8, &conditionals->dependencies, dIndex), optionName)) { dependsOnName = true; break; }
+		}
+		if (!dependsOnName) { continue; }
+		ConditionalValue newCondition = EvaluateConditionalExpression(block->expression, &tab->fileOptions, block->firstOption, nullptr);
+		if (newCondition.isKnown != block->condition.isKnown || newCondition.value != block->condition.value)
+		{
+			block->condition = newCondition;
+			VarArrayGetHard(ConditionalBlock, &conditionals->blocks, block->chainStartIndex)->needsResolve = true;
+			anyChanged = true;
+		}
+	}
+	
+	if (anyChanged)
+	{
+		uxx bIndex = 0;
+		while (bIndex < conditionals->blocks.length)
+		{
+			ConditionalBlock* block = VarArrayGetHard(ConditionalBlock, &conditionals->blocks, bIndex);
+			if (!block->needsResolve) { bIndex++; continue; }
+			uxx chainEndIndex = GetConditionalChainEnd(conditionals, bIndex);
+			ResolveConditionalBlocks(tab, bIndex, chainEndIndex);
+			for (uxx cIndex = bIndex; cIndex < chainEndIndex; cIndex++) { VarArrayGetHard(ConditionalBlock, &conditionals->blocks, cIndex)->needsResolve = false; }
+			bIndex = chainEndIndex;
+		}
+	}
+	
+	ProfZoneEnd(_funcZone);
+}
@@ -0,0 +1,704 @@
+/*
+File:   app_define_resolver.c
+Description:
+	** The define resolver works out the effective value of every option in the current tab by following its #includes.
+	** Our switches are often given a default in a base header and then #undef'd and redefined in a platform header
+	** that is included later, so what is written in the open file isn't always what the compiler sees.
+	** Files are loaded by DEFINE_RESOLVER_NUM_THREADS workers that share one queue. A worker reads a file, finds its
+	** #define/#undef/#include lines (DefineEvents), resolves the includes (next to the including file for "quoted"
+	** includes, then through the IncludePaths setting) and queues every file it hasn't seen yet. The events are cached
+	** by content hash so a header that didn't change is only read, not parsed again, on the next resolve.
+	** Once every file is loaded the main thread walks the events in the order the preprocessor would (each file is
+	** entered once, like #pragma once or an include guard would do) and remembers the last definition of each name.
+	** Options whose last definition isn't in the open file show where it comes from.
+	** Every file a resolve went through gets a FileWatch, the tab is only resolved again when one of them (or the tab's
+	** own file) changes on disk.
+	** A #define inside an #ifndef of the same name is treated as a default that only applies if the name isn't defined.
+	** NOTE: Other #if blocks in included files are not evaluated, every #define in them counts
+*/
+
+// +--------------------------------------------------------------+
+// |                            Events                            |
+// +--------------------------------------------------------------+
+bool IsDefineResolverIdentifierChar(char c, bool isFirstChar)
+{
+	if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_') { return true; }
+	return (!isFirstChar && c >= '0' && c <= '9');
+}
+
+// Returns the name X if the expression of an #if/#ifndef is just "not defined X" (ifndef, !defined(X) or !defined X)
+Str8 GetDefineResolverGuardName(Str8 directive, Str8 expression)
+{
+	if (StrExactEquals(directive, StrLit("ifndef"))) { return expression; }
+	if (!StrExactEquals(directive, StrLit("if")) || !StrExactStartsWith(expression, StrLit("!"))) { return Str8_Empty; }
+	Str8 rest = TrimWhitespace(StrSliceFrom(expression, 1));
+	if (!StrExactStartsWith(rest, StrLit("defined"))) { return Str8_Empty; }
+	rest = TrimWhitespace(StrSliceFrom(rest, StrLit("defined").length));
+	bool hasParens = StrExactStartsWith(rest, StrLit("("));
+	if (hasParens)
+	{
+		if (!StrExactEndsWith(rest, StrLit(")"))) { return Str8_Empty; }
+		rest = TrimWhitespace(StrSlice(rest, 1, rest.length-1));
+	}
+	if (!IsValidIdentifier(rest.length, rest.chars, false, false, false)) { return Str8_Empty; }
+	return rest;
+}
+
+// Finds every #define, #undef and #include in fileContents. The strings in eventsOut are slices of fileContents.
+// Nothing here touches app state so the workers call this from their threads
+void ParseDefineEvents(Arena* arena, Str8 fileContents, VarArray* eventsOut)
+{
+	NotNull(eventsOut);
+	ScratchBegin1(scratch, arena);
+	VarArray guardNames; //Str8, one for each #if that is open, empty unless it's an #ifndef style guard
+	InitVarArray(Str8, &guardNames, scratch);
+	u32 lineNum = 0;
+	LineParser lineParser = MakeLineParser(fileContents);
+	Str8 fullLine = Str8_Empty;
+	while (LineParserGetLine(&lineParser, &fullLine))
+	{
+		lineNum++;
+		Str8 line = TrimWhitespace(fullLine);
+		if (line.length == 0 || line.chars[0] != '#') { continue; }
+		uxx dIndex = 1;
+		while (dIndex < line.length && IsCharWhitespace(line.chars[dIndex], false)) { dIndex++; }
+		uxx directiveStart = dIndex;
+		while (dIndex < line.length && IsDefineResolverIdentifierChar(line.chars[dIndex], false)) { dIndex++; }
+		Str8 directive = StrSlice(line, directiveStart, dIndex);
+		Str8 rest = StrSliceFrom(line, dIndex);
+		uxx commentIndex = MinUXX(StrExactFind(rest, StrLit("//")), StrExactFind(rest, StrLit("/*")));
+		rest = TrimWhitespace(StrSlice(rest, 0, MinUXX(commentIndex, rest.length)));
+		if (StrExactEndsWith(rest, StrLit("\\"))) { rest = TrimWhitespace(StrSlice(rest, 0, rest.length-1)); } //we only keep the first line of multi-line values
+		
+		if (StrExactEquals(directive, StrLit("if")) || StrExactEquals(directive, StrLit("ifdef")) || StrExactEquals(directive, StrLit("ifndef")))
+		{
+			*VarArrayAdd(Str8, &guardNames) = GetDefineResolverGuardName(directive, rest);
+		}
+		else if (StrExactStartsWith(directive, StrLit("el")) && guardNames.length > 0)
+		{
+			*VarArrayGetHard(Str8, &guardNames, guardNames.length-1) = Str8_Empty;
+		}
+		else if (StrExactEquals(directive, StrLit("endif")) && guardNames.length > 0)
+		{
+			VarArrayRemoveAt(Str8, &guardNames, guardNames.length-1);
+		}
+		else if (StrExactEquals(directive, StrLit("define")) || StrExactEquals(directive, StrLit("undef")))
+		{
+			uxx nameEnd = 0;
+			while (nameEnd < rest.length && IsDefineResolverIdentifierChar(rest.chars[nameEnd], nameEnd == 0)) { nameEnd++; }
+			if (nameEnd == 0) { continue; }
+			DefineEvent* newEvent = VarArrayAdd(DefineEvent, eventsOut);
+			NotNull(newEvent);
+			ClearPointer(newEvent);
+			newEvent->kind = StrExactEquals(directive, StrLit("undef")) ? DefineEventKind_Undef : DefineEventKind_Define;
+			newEvent->name = StrSlice(rest, 0, nameEnd);
+			newEvent->valueStr = TrimWhitespace(StrSliceFrom(rest, nameEnd));
+			newEvent->lineNum = lineNum;
+			if (newEvent->kind == DefineEventKind_Define)
+			{
+				VarArrayLoop(&guardNames, gIndex)
+				{
+					VarArrayLoopGet(Str8, guardName, &guardNames, gIndex);
+					if (StrExactEquals(*guardName, newEvent->name)) { newEvent->kind = DefineEventKind_Default; break; }
+				}
+			}
+		}
+		else if (StrExactEquals(directive, StrLit("include")))
+		{
+			char closeChar = (rest.length > 0 && rest.chars[0] == '<') ? '>' : '"';
+			if (rest.length == 0 || (rest.chars[0] != '<' && rest.chars[0] != '"')) { continue; } //macro includes are skipped
+			uxx closeIndex = 1;
+			while (closeIndex < rest.length && rest.chars[closeIndex] != closeChar) { closeIndex++; }
+			if (closeIndex >= rest.length || closeIndex <= 1) { continue; }
+			DefineEvent* newEvent = VarArrayAdd(DefineEvent, eventsOut);
+			NotNull(newEvent);
+			ClearPointer(newEvent);
+			newEvent->kind = DefineEventKind_Include;
+			newEvent->name = StrSlice(rest, 0, closeIndex);
+			newEvent->lineNum = lineNum;
+		}
+	}
+	ScratchEnd(scratch);
+}
+
+// +--------------------------------------------------------------+
+// |                           Workers                            |
+// +--------------------------------------------------------------+
+// Must be called with the mutex locked (or while there is no job running)
+void RebuildDefineFileCacheBuckets(DefineResolver* resolver)
+{
+	ResetHashBuckets(&resolver->cacheBuckets, resolver->cache.length, DEFINE_RESOLVER_MIN_NUM_BUCKETS);
+	VarArrayLoop(&resolver->cache, cIndex)
+	{
+		VarArrayLoopGet(DefineFileCacheEntry, entry, &resolver->cache, cIndex);
+		uxx* bucket = GetHashBucket(&resolver->cacheBuckets, entry->contentHash);
+		entry->nextInBucket = *bucket;
+		*bucket = cIndex+1;
+	}
+}
+
+// Must be called with the mutex locked
+void RebuildDefineResolverFileBuckets(DefineResolver* resolver)
+{
+	ResetHashBuckets(&resolver->fileBuckets, resolver->files.length, DEFINE_RESOLVER_MIN_NUM_BUCKETS);
+	VarArrayLoop(&resolver->files, fIndex)
+	{
+		VarArrayLoopGet(DefineResolverFile, file, &resolver->files, fIndex);
+		uxx* bucket = GetHashBucket(&resolver->fileBuckets, HashStr8FnvAnyCase(file->path));
+		file->nextInBucket = *bucket;
+		*bucket = fIndex+1;
+	}
+}
+
+// Must be called with the mutex locked
+ixx FindDefineFileCacheEntry(DefineResolver* resolver, u64 contentHash)
+{
+	if (resolver->cacheBuckets.length == 0) { return -1; }
+	uxx entryIndexPlusOne = *GetHashBucket(&resolver->cacheBuckets, contentHash);
+	while (entryIndexPlusOne != 0)
+	{
+		DefineFileCacheEntry* entry = VarArrayGetHard(DefineFileCacheEntry, &resolver->cache, entryIndexPlusOne-1);
+		if (entry->contentHash == contentHash) { return (ixx)(entryIndexPlusOne-1); }
+		entryIndexPlusOne = entry->nextInBucket;
+	}
+	return -1;
+}
+
+// Must be called with the mutex locked
+uxx FindOrAddDefineResolverFile(DefineResolver* resolver, FilePath normalizedPath)
+{
+	u64 pathHash = HashStr8FnvAnyCase(normalizedPath);
+	if (resolver->fileBuckets.length > 0)
+	{
+		uxx fileIndexPlusOne = *GetHashBucket(&resolver->fileBuckets, pathHash);
+		while (fileIndexPlusOne != 0)
+		{
+			DefineResolverFile* file = VarArrayGetHard(DefineResolverFile, &resolver->files, fileIndexPlusOne-1);
+			if (StrAnyCaseEquals(file->path, normalizedPath)) { return fileIndexPlusOne-1; }
+			fileIndexPlusOne = file->nextInBucket;
+		}
+	}
+	uxx newFileIndex = resolver->files.length;
+	DefineResolverFile* newFile = VarArrayAdd(DefineResolverFile, &resolver->files);
+	NotNull(newFile);
+	ClearPointer(newFile);
+	newFile->path = AllocStr8(&resolver->jobHeap, normalizedPath);
+	newFile->cacheIndex = -1;
+	InitVarArray(ixx, &newFile->includeTargets, &resolver->jobHeap);
+	if (resolver->files.length > resolver->fileBuckets.length) { RebuildDefineResolverFileBuckets(resolver); }
+	else
+	{
+		uxx* bucket = GetHashBucket(&resolver->fileBuckets, pathHash);
+		newFile->nextInBucket = *bucket;
+		*bucket = newFileIndex+1;
+	}
+	*VarArrayAdd(uxx, &resolver->queue) = newFileIndex;
+	AtomicIncrement(&resolver->numPendingFiles);
+	return newFileIndex;
+}
+
+FilePath ResolveDefineResolverInclude(Arena* arena, const DefineResolver* resolver, FilePath includerPath, Str8 include)
+{
+	Str8 name = StrSliceFrom(include, 1);
+	if (include.chars[0] == '"')
+	{
+		Str8 folderPath = includerPath;
+		while (folderPath.length > 0 && folderPath.chars[folderPath.length-1] != '/') { folderPath.length--; }
+		FilePath candidate = JoinIncludeGraphPath(arena, folderPath, name);
+		if (OsDoesFileExist(candidate)) { return candidate; }
+	}
+	VarArrayLoop(&resolver->includeDirs, dIndex)
+	{
+		VarArrayLoopGet(Str8, includeDir, &resolver->includeDirs, dIndex);
+		FilePath candidate = JoinIncludeGraphPath(arena, *includeDir, name);
+		if (OsDoesFileExist(candidate)) { return candidate; }
+	}
+	return Str8_Empty;
+}
+
+void LoadDefineResolverFile(DefineResolver* resolver, uxx fileIndex, FilePath filePath)
+{
+	ScratchBegin(scratch);
+	Str8 fileContents = Str8_Empty;
+	if (!AppReadTextFile(filePath, scratch, &fileContents) || fileContents.length > FOLDER_SCAN_MAX_FILE_SIZE)
+	{
+		ScratchEnd(scratch);
+		return;
+	}
+	u64 contentHash = HashStr8Fnv(fileContents);
+	
+	//Parse the file if the cache doesn't know these contents yet. Either way we end up with a copy of the events in scratch
+	VarArray events;
+	InitVarArray(DefineEvent, &events, scratch);
+	LockMutex(&resolver->mutex, TIMEOUT_FOREVER);
+	ixx cacheIndex = FindDefineFileCacheEntry(resolver, contentHash);
+	if (cacheIndex >= 0)
+	{
+		DefineFileCacheEntry* entry = VarArrayGetHard(DefineFileCacheEntry, &resolver->cache, (uxx)cacheIndex);
+		VarArrayLoop(&entry->events, eIndex)
+		{
+			VarArrayLoopGet(DefineEvent, event, &entry->events, eIndex);
+			DefineEvent* eventCopy = VarArrayAdd(DefineEvent, &events);
+			*eventCopy = *event;
+			eventCopy->name = AllocStr8(scratch, event->name);
+		}
+	}
+	UnlockMutex(&resolver->mutex);
+	if (cacheIndex >= 0) { AtomicIncrement(&resolver->numCacheHits); }
+	else { ParseDefineEvents(scratch, fileContents, &events); }
+	
+	FilePath* includePaths = AllocArray(FilePath, scratch, MaxUXX(events.length, 1));
+	VarArrayLoop(&events, eIndex)
+	{
+		VarArrayLoopGet(DefineEvent, event, &events, eIndex);
+		includePaths[eIndex] = (event->kind == DefineEventKind_Include) ? ResolveDefineResolverInclude(scratch, resolver, filePath, event->name) : Str8_Empty;
+	}
+	
+	LockMutex(&resolver->mutex, TIMEOUT_FOREVER);
+	if (cacheIndex < 0) { cacheIndex = FindDefineFileCacheEntry(resolver, contentHash); } //another worker might have added the same contents
+	if (cacheIndex < 0)
+	{
+		cacheIndex = (ixx)resolver->cache.length;
+		DefineFileCacheEntry* newEntry = VarArrayAdd(DefineFileCacheEntry, &resolver->cache);
+		NotNull(newEntry);
+		ClearPointer(newEntry);
+		newEntry->contentHash = contentHash;
+		InitVarArrayWithInitial(DefineEvent, &newEntry->events, &resolver->cacheHeap, events.length);
+		if (resolver->cache.length > resolver->cacheBuckets.length) { RebuildDefineFileCacheBuckets(resolver); }
+		else
+		{
+			uxx* bucket = GetHashBucket(&resolver->cacheBuckets, contentHash);
+			newEntry->nextInBucket = *bucket;
+			*bucket = (uxx)cacheIndex+1;
+		}
+		VarArrayLoop(&events, eIndex)
+		{
+			VarArrayLoopGet(DefineEvent, event, &events, eIndex);
+			DefineEvent* newEvent = VarArrayAdd(DefineEvent, &newEntry->events);
+			*newEvent = *event;
+			newEvent->name = AllocStr8(&resolver->cacheHeap, event->name);
+			newEvent->valueStr = AllocStr8(&resolver->cacheHeap, event->valueStr);
+		}
+	}
+	VarArrayGetHard(DefineFileCacheEntry, &resolver->cache, (uxx)cacheIndex)->lastUsedJobId = resolver->jobId;
+	ixx* includeTargets = AllocArray(ixx, scratch, MaxUXX(events.length, 1));
+	for (uxx eIndex = 0; eIndex < events.length; eIndex++)
+	{
+		includeTargets[eIndex] = IsEmptyStr(includePaths[eIndex]) ? -1 : (ixx)FindOrAddDefineResolverFile(resolver, includePaths[eIndex]);
+	}
+	DefineResolverFile* file = VarArrayGetHard(DefineResolverFile, &resolver->files, fileIndex);
+	file->cacheIndex = cacheIndex;
+	ixx* fileTargets = VarArrayAddMulti(ixx, &file->includeTargets, events.length);
+	if (events.length > 0) { MyMemCopy(fileTargets, includeTargets, sizeof(ixx) * events.length); }
+	UnlockMutex(&resolver->mutex);
+	ScratchEnd(scratch);
+}
+
+void RunDefineResolverWorker(DefineResolver* resolver)
+{
+	NotNull(resolver);
+	ProfZoneBeginEx(_funcZone, "DefineResolverWorker", ProfilerCategory_Job);
+	ScratchBegin(scratch);
+	while (true)
+	{
+		uxx scratchMark = ArenaGetMark(scratch);
+		bool foundWork = false;
+		uxx fileIndex = 0;
+		FilePath filePath = Str8_Empty;
+		LockMutex(&resolver->mutex, TIMEOUT_FOREVER);
+		if (resolver->queue.length > 0)
+		{
+			foundWork = true;
+			fileIndex = *VarArrayGetHard(uxx, &resolver->queue, resolver->queue.length-1);
+			VarArrayRemoveAt(uxx, &resolver->queue, resolver->queue.length-1);
+			filePath = AllocStr8(scratch, VarArrayGetHard(DefineResolverFile, &resolver->files, fileIndex)->path);
+		}
+		UnlockMutex(&resolver->mutex);
+		
+		if (foundWork)
+		{
+			LoadDefineResolverFile(resolver, fileIndex, filePath);
+			AtomicAdd(&resolver->numPendingFiles, -1);
+		}
+		else if (AtomicRead(&resolver->numPendingFiles) <= 0) { break; }
+		else { OsSleepMs(1); } //another worker might still find more includes
+		ArenaResetToMark(scratch, scratchMark);
+	}
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// +==============================+
+// |   DefineResolverWorkerMain   |
+// +==============================+
+// DWORD DefineResolverWorkerMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(DefineResolverWorkerMain)
+{
+	NotNull(contextPntr);
+	DefineResolverWorkerContext* context = (DefineResolverWorkerContext*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	RunDefineResolverWorker(context->resolver);
+	AtomicWrite(&context->isRunning, false);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+// +--------------------------------------------------------------+
+// |                           Results                            |
+// +--------------------------------------------------------------+
+void FreeFileTabOptionSources(FileTab* tab)
+{
+	NotNull(tab);
+	if (tab->optionSources.arena != nullptr)
+	{
+		VarArrayLoop(&tab->optionSources, sIndex)
+		{
+			VarArrayLoopGet(Str8, sourceStr, &tab->optionSources, sIndex);
+			FreeStr8(stdHeap, sourceStr);
+		}
+		FreeVarArray(&tab->optionSources);
+	}
+}
+
+typedef plex DefineResolverFinal DefineResolverFinal;
+plex DefineResolverFinal
+{
+	Str8 name;
+	uxx fileIndex;
+	const DefineEvent* event;
+};
+
+// Walks the events starting at files[0] in preprocessor order and fills tab->optionSources from the last definition of each name
+void ApplyDefineResolverResults(DefineResolver* resolver, FileTab* tab)
+{
+	NotNull(resolver);
+	NotNull(tab);
+	ProfZoneBegin(_funcZone, "ApplyDefineResolverResults");
+	ScratchBegin(scratch);
+	uxx numFiles = resolver->files.length;
+	
+	uxx numSlots = USAGE_INDEX_MIN_SLOTS;
+	uxx numEvents = 0;
+	VarArrayLoop(&resolver->cache, cIndex) { numEvents += VarArrayGetHard(DefineFileCacheEntry, &resolver->cache, cIndex)->events.length; }
+	while (numSlots < numEvents*2) { numSlots *= 2; }
+	DefineResolverFinal* slots = AllocArray(DefineResolverFinal, scratch, numSlots);
+	MyMemSet(slots, 0x00, sizeof(DefineResolverFinal) * numSlots);
+	bool* isVisited = AllocArray(bool, scratch, MaxUXX(numFiles, 1));
+	MyMemSet(isVisited, 0x00, sizeof(bool) * MaxUXX(numFiles, 1));
+	uxx* stackFiles = AllocArray(uxx, scratch, DEFINE_RESOLVER_MAX_INCLUDE_DEPTH);
+	uxx* stackEvents = AllocArray(uxx, scratch, DEFINE_RESOLVER_MAX_INCLUDE_DEPTH);
+	uxx stackSize = 0;
+	uxx numSkippedIncludes = 0; //includes we didn't follow because the stack was already DEFINE_RESOLVER_MAX_INCLUDE_DEPTH files deep
+	if (numFiles > 0) { stackFiles[0] = 0; stackEvents[0] = 0; stackSize = 1; isVisited[0] = true; }
+	while (stackSize > 0)
+	{
+		uxx fileIndex = stackFiles[stackSize-1];
+		DefineResolverFile* file = VarArrayGetHard(DefineResolverFile, &resolver->files, fileIndex);
+		const VarArray* events = (file->cacheIndex >= 0) ? &VarArrayGetHard(DefineFileCacheEntry, &resolver->cache, (uxx)file->cacheIndex)->events : nullptr;
+		if (events == nullptr || stackEvents[stackSize-1] >= events->length) { stackSize--; continue; }
+		uxx eventIndex = stackEvents[stackSize-1]++;
+		const DefineEvent* event = VarArrayGetHard(DefineEvent, events, eventIndex);
+		if (event->kind == DefineEventKind_Include)
+		{
+			ixx targetIndex = *VarArrayGetHard(ixx, &file->includeTargets, eventIndex);
+			if (targetIndex >= 0 && !isVisited[targetIndex] && stackSize >= DEFINE_RESOLVER_MAX_INCLUDE_DEPTH) { numSkippedIncludes++; }
+			else if (targetIndex >= 0 && !isVisited[targetIndex])
+			{
+				isVisited[targetIndex] = true;
+				stackFiles[stackSize] = (uxx)targetIndex;
+				stackEvents[stackSize] = 0;
+				stackSize++;
+			}
+			continue;
+		}
+		
+		uxx slotIndex = (u32)HashStr8Fnv(event->name) & (numSlots-1);
+		while (slots[slotIndex].event != nullptr && !StrExactEquals(slots[slotIndex].name, event->name)) { slotIndex = (slotIndex+1) & (numSlots-1); }
+		DefineResolverFinal* finalDefine = &slots[slotIndex];
+		bool isCurrentlyDefined = (finalDefine->event != nullptr && finalDefine->event->kind != DefineEventKind_Undef);
+		if (event->kind == DefineEventKind_Default && isCurrentlyDefined) { continue; }
+		finalDefine->name = event->name;
+		finalDefine->fileIndex = fileIndex;
+		finalDefine->event = event;
+	}
+	
+	if (numSkippedIncludes > 0)
+	{
+		PrintLine_W("Includes of \"%.*s\" go deeper than %llu files, %llu #include%s past that were not followed so some options might show the wrong source",
+			StrPrint(tab->filePath), (u64)DEFINE_RESOLVER_MAX_INCLUDE_DEPTH, (u64)numSkippedIncludes, Plural(numSkippedIncludes, "s")
+		);
+	}
+	
+	FreeFileTabOptionSources(tab);
+	InitVarArrayWithInitial(Str8, &tab->optionSources, stdHeap, tab->fileOptions.length);
+	uxx numOverridden = 0;
+	VarArrayLoop(&tab->fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+		Str8* sourceStr = VarArrayAdd(Str8, &tab->optionSources);
+		*sourceStr = Str8_Empty;
+		uxx slotIndex = (u32)HashStr8Fnv(option->name) & (numSlots-1);
+		while (slots[slotIndex].event != nullptr && !StrExactEquals(slots[slotIndex].name, option->name)) { slotIndex = (slotIndex+1) & (numSlots-1); }
+		const DefineResolverFinal* finalDefine = &slots[slotIndex];
+		if (finalDefine->event == nullptr || finalDefine->fileIndex == 0) { continue; }
+		Str8 fileName = GetFileNamePart(VarArrayGetHard(DefineResolverFile, &resolver->files, finalDefine->fileIndex)->path, true);
+		if (finalDefine->event->kind == DefineEventKind_Undef) { *sourceStr = PrintInArenaStr(stdHeap, "%.*s:%u #undef", StrPrint(fileName), finalDefine->event->lineNum); }
+		else if (IsEmptyStr(finalDefine->event->valueStr)) { *sourceStr = PrintInArenaStr(stdHeap, "%.*s:%u", StrPrint(fileName), finalDefine->event->lineNum); }
+		else { *sourceStr = PrintInArenaStr(stdHeap, "%.*s:%u = %.*s", StrPrint(fileName), finalDefine->event->lineNum, StrPrint(finalDefine->event->valueStr)); }
+		numOverridden++;
+	}
+	PrintLine_D("Resolved defines of \"%.*s\" through %llu file%s (%llu cached), %llu option%s come from elsewhere",
+		StrPrint(tab->filePath), (u64)numFiles, Plural(numFiles, "s"), (u64)AtomicRead(&resolver->numCacheHits), (u64)numOverridden, Plural(numOverridden, "s")
+	);
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+void RemoveFileTabIncludeWatches(FileTab* tab)
+{
+	NotNull(tab);
+	if (tab->includeWatchIds.arena != nullptr)
+	{
+		VarArrayLoop(&tab->includeWatchIds, wIndex)
+		{
+			VarArrayLoopGet(uxx, watchId, &tab->includeWatchIds, wIndex);
+			RemoveFileWatch(&app->fileWatches, *watchId);
+		}
+		FreeVarArray(&tab->includeWatchIds);
+	}
+}
+
+// Watches every file the resolve went through so UpdateDefineResolver knows when the tab needs to be resolved again
+void SetFileTabIncludeWatches(DefineResolver* resolver, FileTab* tab)
+{
+	NotNull(resolver);
+	NotNull(tab);
+	VarArray newWatchIds;
+	InitVarArrayWithInitial(uxx, &newWatchIds, stdHeap, resolver->files.length);
+	//NOTE: We add the new watches before removing the old ones so files that are still included keep their watch (and its state)
+	for (uxx fIndex = 1; fIndex < resolver->files.length; fIndex++)
+	{
+		DefineResolverFile* file = VarArrayGetHard(DefineResolverFile, &resolver->files, fIndex);
+		*VarArrayAdd(uxx, &newWatchIds) = AddFileWatch(&app->fileWatches, file->path, DEFINE_RESOLVER_INCLUDE_CHECK_PERIOD);
+	}
+	RemoveFileTabIncludeWatches(tab);
+	tab->includeWatchIds = newWatchIds;
+}
+
+// True if one of the files the last resolve went through changed on disk since that resolve started.
+//NOTE: Tabs share watches for the headers they have in common (and with a tab that has the header open), so we look at
+//      when the watch last changed instead of clearing its changed flag out from under the others
+bool HaveFileTabIncludesChanged(const FileTab* tab)
+{
+	NotNull(tab);
+	VarArrayLoop(&tab->includeWatchIds, wIndex)
+	{
+		VarArrayLoopGet(uxx, watchId, &tab->includeWatchIds, wIndex);
+		u64 changeTime = GetFileWatchLastChangeTime(&app->fileWatches, *watchId);
+		if (changeTime != 0 && changeTime >= tab->optionSourcesTime && TimeSinceBy(appIn->programTime, changeTime) >= FILE_RELOAD_DELAY) { return true; }
+	}
+	return false;
+}
+
+// +--------------------------------------------------------------+
+// |                           Resolver                           |
+// +--------------------------------------------------------------+
+void InitDefineResolver(Arena* arena, DefineResolver* resolverOut)
+{
+	NotNull(arena);
+	NotNull(resolverOut);
+	ClearPointer(resolverOut);
+	resolverOut->arena = arena;
+	InitMutex(&resolverOut->mutex);
+	InitArenaStdHeap(&resolverOut->cacheHeap);
+	InitVarArray(DefineFileCacheEntry, &resolverOut->cache, &resolverOut->cacheHeap);
+	InitVarArray(uxx, &resolverOut->cacheBuckets, &resolverOut->cacheHeap);
+	RebuildDefineFileCacheBuckets(resolverOut);
+	InitArenaStdHeap(&resolverOut->jobHeap);
+}
+
+void FreeDefineFileCacheEntry(DefineResolver* resolver, DefineFileCacheEntry* entry)
+{
+	VarArrayLoop(&entry->events, eIndex)
+	{
+		VarArrayLoopGet(DefineEvent, event, &entry->events, eIndex);
+		FreeStr8(&resolver->cacheHeap, &event->name);
+		FreeStr8(&resolver->cacheHeap, &event->valueStr);
+	}
+	FreeVarArray(&entry->events);
+}
+
+void FreeDefineResolverJob(DefineResolver* resolver)
+{
+	VarArrayLoop(&resolver->files, fIndex)
+	{
+		VarArrayLoopGet(DefineResolverFile, file, &resolver->files, fIndex);
+		FreeStr8(&resolver->jobHeap, &file->path);
+		FreeVarArray(&file->includeTargets);
+	}
+	FreeVarArray(&resolver->files);
+	FreeVarArray(&resolver->fileBuckets);
+	FreeVarArray(&resolver->queue);
+	VarArrayLoop(&resolver->includeDirs, dIndex)
+	{
+		VarArrayLoopGet(Str8, includeDir, &resolver->includeDirs, dIndex);
+		FreeStr8(&resolver->jobHeap, includeDir);
+	}
+	FreeVarArray(&resolver->includeDirs);
+	FreeStr8(resolver->arena, &resolver->jobTabPath);
+}
+
+// Returns true if the job was finished and its results were applied. If wait is true we block until the workers are done
+bool FinishDefineResolverJob(DefineResolver* resolver, bool wait)
+{
+	NotNull(resolver);
+	if (!resolver->hasJob) { return false; }
+	for (uxx tIndex = 0; tIndex < DEFINE_RESOLVER_NUM_THREADS; tIndex++)
+	{
+		DefineResolverWorkerContext* worker = &resolver->workers[tIndex];
+		if (wait)
+		{
+			ProfZoneBegin(Zone_WaitForDefineResolver, "WaitForDefineResolver");
+			while (AtomicRead(&worker->isRunning)) { OsSleepMs(1); }
+			ProfZoneEnd(Zone_WaitForDefineResolver);
+		}
+		if (AtomicRead(&worker->isRunning)) { return false; }
+	}
+	for (uxx tIndex = 0; tIndex < DEFINE_RESOLVER_NUM_THREADS; tIndex++)
+	{
+		DefineResolverWorkerContext* worker = &resolver->workers[tIndex];
+		if (worker->thread.isFilled) { OsCloseThread(&worker->thread); }
+		ClearStruct(worker->thread);
+	}
+	resolver->hasJob = false;
+	
+	FileTab* tab = AppFindTabForPath(resolver->jobTabPath);
+	if (tab != nullptr)
+	{
+		ApplyDefineResolverResults(resolver, tab);
+		SetFileTabIncludeWatches(resolver, tab);
+	}
+	FreeDefineResolverJob(resolver);
+	
+	//Forget the contents we didn't see this time once the cache gets big
+	if (resolver->cache.length > DEFINE_RESOLVER_CACHE_MAX_FILES)
+	{
+		for (uxx cIndex = resolver->cache.length; cIndex > 0; cIndex--)
+		{
+			DefineFileCacheEntry* entry = VarArrayGetHard(DefineFileCacheEntry, &resolver->cache, cIndex-1);
+			if (entry->lastUsedJobId == resolver->jobId) { continue; }
+			FreeDefineFileCacheEntry(resolver, entry);
+			VarArrayRemoveAt(DefineFileCacheEntry, &resolver->cache, cIndex-1);
+		}
+		RebuildDefineFileCacheBuckets(resolver);
+	}
+	return (tab != nullptr);
+}
+
+void FreeDefineResolver(DefineResolver* resolver)
+{
+	NotNull(resolver);
+	if (resolver->arena != nullptr)
+	{
+		if (resolver->hasJob)
+		{
+			FinishDefineResolverJob(resolver, true);
+		}
+		VarArrayLoop(&resolver->cache, cIndex)
+		{
+			VarArrayLoopGet(DefineFileCacheEntry, entry, &resolver->cache, cIndex);
+			FreeDefineFileCacheEntry(resolver, entry);
+		}
+		FreeVarArray(&resolver->cache);
+		FreeVarArray(&resolver->cacheBuckets);
+		DestroyMutex(&resolver->mutex);
+	}
+	ClearPointer(resolver);
+}
+
+void StartDefineResolverJob(DefineResolver* resolver, FileTab* tab)
+{
+	NotNull(resolver);
+	NotNull(tab);
+	if (resolver->hasJob) { return; }
+	ProfZoneBegin(_funcZone, "StartDefineResolverJob");
+	ScratchBegin(scratch);
+	resolver->hasJob = true;
+	resolver->jobId = ++resolver->nextJobId;
+	resolver->jobTabPath = AllocStr8(resolver->arena, tab->filePath);
+	AtomicWrite(&resolver->numPendingFiles, 0);
+	AtomicWrite(&resolver->numCacheHits, 0);
+	InitVarArray(DefineResolverFile, &resolver->files, &resolver->jobHeap);
+	InitVarArray(uxx, &resolver->fileBuckets, &resolver->jobHeap);
+	RebuildDefineResolverFileBuckets(resolver);
+	InitVarArray(uxx, &resolver->queue, &resolver->jobHeap);
+	InitVarArray(Str8, &resolver->includeDirs, &resolver->jobHeap);
+	
+	//Relative include paths are relative to the open file's folder
+	FilePath tabPath = NormalizeIncludeGraphPath(scratch, OsGetFullPath(scratch, tab->filePath));
+	Str8 tabFolder = tabPath;
+	while (tabFolder.length > 0 && tabFolder.chars[tabFolder.length-1] != '/') { tabFolder.length--; }
+	Str8 includePathsStr = app->settings.includePaths;
+	uxx partStart = 0;
+	for (uxx cIndex = 0; cIndex <= includePathsStr.length; cIndex++)
+	{
+		if (cIndex < includePathsStr.length && includePathsStr.chars[cIndex] != ';') { continue; }
+		Str8 part = TrimWhitespace(StrSlice(includePathsStr, partStart, cIndex));
+		partStart = cIndex+1;
+		if (IsEmptyStr(part)) { continue; }
+		*VarArrayAdd(Str8, &resolver->includeDirs) = AllocStr8(&resolver->jobHeap, JoinIncludeGraphPath(scratch, tabFolder, part));
+	}
+	FindOrAddDefineResolverFile(resolver, tabPath); //files[0] is always the open file
+	
+	uxx numThreadsStarted = 0;
+	for (uxx tIndex = 0; tIndex < DEFINE_RESOLVER_NUM_THREADS; tIndex++)
+	{
+		DefineResolverWorkerContext* worker = &resolver->workers[tIndex];
+		worker->resolver = resolver;
+		AtomicWrite(&worker->isRunning, true);
+		worker->thread = OsCreateThread(DefineResolverWorkerMain, worker, true);
+		if (worker->thread.isFilled) { numThreadsStarted++; }
+		else { AtomicWrite(&worker->isRunning, false); }
+	}
+	if (numThreadsStarted == 0)
+	{
+		WriteLine_W("Failed to start any define resolver threads! Resolving on the main thread");
+		RunDefineResolverWorker(resolver);
+	}
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// Called once a frame. Resolves the current tab when it hasn't been resolved yet or one of the files it includes changed.
+// Returns true if new results were applied
+bool UpdateDefineResolver(DefineResolver* resolver)
+{
+	NotNull(resolver);
+	if (resolver->arena == nullptr) { return false; }
+	if (resolver->hasJob) { return FinishDefineResolverJob(resolver, false); }
+	FileTab* tab = app->currentTab;
+	if (tab == nullptr || tab->isFromSnapshot) { return false; }
+	if (tab->optionSourcesTime != 0 && !HaveFileTabIncludesChanged(tab)) { return false; }
+	tab->optionSourcesTime = (appIn->programTime > 0) ? appIn->programTime : 1;
+	StartDefineResolverJob(resolver, tab);
+	return false;
+}
+
+// Where the final value of the option comes from, or an empty string if it's the open file itself (or we don't know yet)
+Str8 GetOptionSourceStr(const FileTab* tab, uxx optionIndex)
+{
+	NotNull(tab);
+	if (tab->optionSources.length != tab->fileOptions.length || optionIndex >= tab->optionSources.length) { return Str8_Empty; }
+	return *VarArrayGetHard(Str8, &tab->optionSources, optionIndex);
+}
@@ -34,6 +34,9 @@ void UpdateFileWatches(VarArray* watches)
 		{
 			if (watch->checkPeriod == 0 || TimeSinceBy(programTime, watch->lastCheck) >= watch->checkPeriod)
 			{
+				ProfZoneBeginEx(Zone_CheckWatch, "CheckFileWatch", ProfilerCategory_FileWatch);
+				watch->lastCheck = programTime;
+				SetProfilerZoneDetail(watch->fullPath);
 				bool doesExist = OsDoesFileExist(watch->fullPath);
 				if (doesExist != watch->fileExists)
 				{
@@ -55,6 +58,7 @@ void UpdateFileWatches(VarArray* watches)
 					watch->gotWriteTime = true;
 				}
 				else { watch->gotWriteTime = false; }
+				ProfZoneEnd(Zone_CheckWatch);
 			}
 		}
 	}
@@ -164,6 +168,16 @@ bool HasFileWatchChanged(const VarArray* watches, uxx watchId)
 {
 	return HasFileWatchChangedWithDelay(watches, watchId, 0);
 }
+// programTime when we last saw the file change, 0 if it hasn't changed since the watch was added. Clearing the changed flag doesn't reset this
+u64 GetFileWatchLastChangeTime(const VarArray* watches, uxx watchId)
+{
+	NotNull(watches);
+	Assert(watchId != 0);
+	Assert(watchId <= watches->length);
+	const FileWatch* watch = VarArrayGetHard(FileWatch, watches, watchId-1);
+	Assert(watch->id == watchId);
+	return watch->lastChangeTime;
+}
 
 void ClearFileWatchChanged(VarArray* watches, uxx watchId)
 {
@@ -183,3 +197,13 @@ void ClearFileWatchChanged(VarArray* watches, uxx watchId)
 	watch->changed = false;
 	watch->lastCheck = (appIn != nullptr) ? appIn->programTime : 0;
 }
+// For when we wrote several watched files as one operation, so none of them look like an external change. Ids of 0 are skipped
+void ClearFileWatchesChanged(VarArray* watches, const uxx* watchIds, uxx numWatchIds)
+{
+	NotNull(watches);
+	Assert(watchIds != nullptr || numWatchIds == 0);
+	for (uxx wIndex = 0; wIndex < numWatchIds; wIndex++)
+	{
+		if (watchIds[wIndex] != 0) { ClearFileWatchChanged(watches, watchIds[wIndex]); }
+	}
+}
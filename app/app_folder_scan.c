@@ -0,0 +1,903 @@
+/*
+File:   app_folder_scan.c
+Description:
+	** "Open Folder" walks a folder recursively and lists the options of every source file inside it, grouped by file.
+	** The walk is done by FOLDER_SCAN_NUM_THREADS workers that each own a queue of work items (a folder to list or
+	** a file to parse). A worker pushes what it finds onto its own queue and pops from the back, so it walks depth
+	** first, and when it runs dry it steals from the front (queueHead) of another worker's queue, which is where the biggest
+	** untouched subtrees are. Files are parsed with the same ParseFileOptions that UpdateFileTabOptions uses.
+	** Finished files are handed to the main thread through pendingFiles and UpdateFolderScan merges them into the
+	** sorted list every frame, so results show up while the walk is still going. The panel only builds UI for the
+	** FOLDER_SCAN_MAX_VISIBLE rows that are on screen so it doesn't matter how many options the folder holds.
+	** Folders and files whose name (or path relative to the root) matches one of the FolderScanIgnore globs are skipped,
+	** and symlinked folders aren't followed.
+	** The workers also collect the #if mentions and #include targets of every file for the usage index (see app_usage_index.c)
+*/
+
+// Case-insensitive, supports * and ?
+bool DoesFolderScanGlobMatch(Str8 glob, Str8 str)
+{
+	uxx gIndex = 0;
+	uxx sIndex = 0;
+	uxx starGlobIndex = UINTXX_MAX;
+	uxx starStrIndex = 0;
+	while (sIndex < str.length)
+	{
+		if (gIndex < glob.length && glob.chars[gIndex] == '*')
+		{
+			starGlobIndex = gIndex;
+			starStrIndex = sIndex;
+			gIndex++;
+		}
+		else if (gIndex < glob.length && (glob.chars[gIndex] == '?' || FuzzyFoldChar(glob.chars[gIndex]) == FuzzyFoldChar(str.chars[sIndex])))
+		{
+			gIndex++;
+			sIndex++;
+		}
+		else if (starGlobIndex != UINTXX_MAX)
+		{
+			//Let the last * swallow one more character and try again
+			gIndex = starGlobIndex+1;
+			starStrIndex++;
+			sIndex = starStrIndex;
+		}
+		else { return false; }
+	}
+	while (gIndex < glob.length && glob.chars[gIndex] == '*') { gIndex++; }
+	return (gIndex == glob.length);
+}
+
+// Splits a ';' separated list, like the FolderScanIgnore setting, into listOut (allocated from arena)
+void SplitFolderScanList(Arena* arena, Str8 listStr, VarArray* listOut)
+{
+	uxx partStart = 0;
+	for (uxx cIndex = 0; cIndex <= listStr.length; cIndex++)
+	{
+		if (cIndex == listStr.length || listStr.chars[cIndex] == ';')
+		{
+			Str8 part = TrimWhitespace(StrSlice(listStr, partStart, cIndex));
+			if (!IsEmptyStr(part))
+			{
+				Str8* newPart = VarArrayAdd(Str8, listOut);
+				NotNull(newPart);
+				*newPart = AllocStr8(arena, part);
+			}
+			partStart = cIndex+1;
+		}
+	}
+}
+
+void FreeFolderScanList(Arena* arena, VarArray* list)
+{
+	VarArrayLoop(list, sIndex)
+	{
+		VarArrayLoopGet(Str8, str, list, sIndex);
+		FreeStr8(arena, str);
+	}
+	VarArrayClear(list);
+}
+
+Str8 GetPathRelativeToRoot(FilePath rootPath, FilePath fullPath)
+{
+	if (!StrAnyCaseStartsWith(fullPath, rootPath)) { return fullPath; }
+	Str8 result = StrSliceFrom(fullPath, rootPath.length);
+	while (result.length > 0 && (result.chars[0] == '/' || result.chars[0] == '\\')) { result = StrSliceFrom(result, 1); }
+	return result;
+}
+Str8 GetFolderScanRelativePath(const FolderScan* scan, FilePath fullPath)
+{
+	return GetPathRelativeToRoot(scan->rootPath, fullPath);
+}
+
+// The usage index keeps its own copy of the globs and extensions (see StartUsageIndexJob) so these don't take a FolderScan
+bool IsPathIgnoredByGlobs(const VarArray* ignoreGlobs, FilePath rootPath, FilePath fullPath)
+{
+	Str8 fileName = GetFileNamePart(fullPath, true);
+	Str8 relativePath = GetPathRelativeToRoot(rootPath, fullPath);
+	VarArrayLoop(ignoreGlobs, gIndex)
+	{
+		VarArrayLoopGet(Str8, glob, ignoreGlobs, gIndex);
+		if (DoesFolderScanGlobMatch(*glob, fileName) || DoesFolderScanGlobMatch(*glob, relativePath)) { return true; }
+	}
+	return false;
+}
+bool IsFolderScanPathIgnored(const FolderScan* scan, FilePath fullPath)
+{
+	return IsPathIgnoredByGlobs(&scan->ignoreGlobs, scan->rootPath, fullPath);
+}
+
+bool HasExtensionInList(const VarArray* extensions, FilePath fullPath)
+{
+	Str8 fileName = GetFileNamePart(fullPath, true);
+	uxx periodIndex = fileName.length;
+	for (uxx cIndex = fileName.length; cIndex > 0; cIndex--) { if (fileName.chars[cIndex-1] == '.') { periodIndex = cIndex-1; break; } }
+	if (periodIndex >= fileName.length) { return false; }
+	Str8 extension = StrSliceFrom(fileName, periodIndex+1);
+	VarArrayLoop(extensions, eIndex)
+	{
+		VarArrayLoopGet(Str8, allowedExtension, extensions, eIndex);
+		if (StrAnyCaseEquals(*allowedExtension, extension)) { return true; }
+	}
+	return false;
+}
+bool HasFolderScanExtension(const FolderScan* scan, FilePath fullPath)
+{
+	return HasExtensionInList(&scan->extensions, fullPath);
+}
+
+// +--------------------------------------------------------------+
+// |                       Work Item Queues                       |
+// +--------------------------------------------------------------+
+void PushFolderScanWorkItem(FolderScanWorker* worker, bool isFolder, FilePath path)
+{
+	NotNull(worker);
+	//NOTE: numPendingItems goes up before the item is visible to anyone so it can't hit 0 while this item is still waiting to be done
+	AtomicIncrement(&worker->scan->numPendingItems);
+	LockMutex(&worker->mutex, TIMEOUT_FOREVER);
+	if (worker->queueHead > 0 && worker->queueHead >= worker->queue.length/2)
+	{
+		//Shift the live items down over the stolen ones, this is rare enough that the copy doesn't matter
+		uxx numLiveItems = worker->queue.length - worker->queueHead;
+		for (uxx iIndex = 0; iIndex < numLiveItems; iIndex++)
+		{
+			*VarArrayGetHard(FolderScanWorkItem, &worker->queue, iIndex) = *VarArrayGetHard(FolderScanWorkItem, &worker->queue, worker->queueHead + iIndex);
+		}
+		while (worker->queue.length > numLiveItems) { VarArrayRemoveAt(FolderScanWorkItem, &worker->queue, worker->queue.length-1); }
+		worker->queueHead = 0;
+	}
+	FolderScanWorkItem* newItem = VarArrayAdd(FolderScanWorkItem, &worker->queue);
+	NotNull(newItem);
+	ClearPointer(newItem);
+	newItem->isFolder = isFolder;
+	newItem->path = AllocStr8(&worker->heap, path);
+	UnlockMutex(&worker->mutex);
+}
+
+// Removes an item from the back (our own work) or front (stealing) of the queue. The path is copied into arena
+bool TakeFolderScanWorkItem(FolderScanWorker* worker, bool fromBack, Arena* arena, FolderScanWorkItem* itemOut)
+{
+	NotNull(worker);
+	bool result = false;
+	LockMutex(&worker->mutex, TIMEOUT_FOREVER);
+	if (worker->queue.length > worker->queueHead)
+	{
+		uxx itemIndex = fromBack ? worker->queue.length-1 : worker->queueHead;
+		FolderScanWorkItem* item = VarArrayGetHard(FolderScanWorkItem, &worker->queue, itemIndex);
+		itemOut->isFolder = item->isFolder;
+		itemOut->path = AllocStr8(arena, item->path);
+		FreeStr8(&worker->heap, &item->path);
+		//NOTE: Both ends are O(1), the back is removed and the front just moves queueHead forward
+		if (fromBack) { VarArrayRemoveAt(FolderScanWorkItem, &worker->queue, itemIndex); }
+		else { worker->queueHead++; }
+		if (worker->queueHead >= worker->queue.length) { VarArrayClear(&worker->queue); worker->queueHead = 0; }
+		result = true;
+	}
+	UnlockMutex(&worker->mutex);
+	return result;
+}
+
+bool FindFolderScanWork(FolderScanWorker* worker, Arena* arena, FolderScanWorkItem* itemOut)
+{
+	if (TakeFolderScanWorkItem(worker, true, arena, itemOut)) { return true; }
+	for (uxx offset = 1; offset < FOLDER_SCAN_NUM_THREADS; offset++)
+	{
+		FolderScanWorker* victim = &worker->scan->workers[(worker->index + offset) % FOLDER_SCAN_NUM_THREADS];
+		if (victim->scan == nullptr) { continue; }
+		if (TakeFolderScanWorkItem(victim, false, arena, itemOut)) { return true; }
+	}
+	return false;
+}
+
+// +--------------------------------------------------------------+
+// |                           Workers                            |
+// +--------------------------------------------------------------+
+void ScanFolderScanFolder(FolderScanWorker* worker, FilePath folderPath)
+{
+	ScratchBegin(scratch);
+	OsFileIter fileIter = OsIterateFiles(scratch, folderPath, true, true);
+	bool isFolder = false;
+	FilePath childPath = Str8_Empty;
+	while (OsIterFileStepEx(&fileIter, &isFolder, &childPath, scratch, true))
+	{
+		if (AtomicRead(&worker->scan->stopRequested)) { break; }
+		if (IsFolderScanPathIgnored(worker->scan, childPath)) { continue; }
+		//NOTE: Symlinked folders (and junctions) are skipped, one that points back up the tree would keep the walk going forever
+		if (isFolder) { if (!AppIsSymbolicLink(childPath)) { PushFolderScanWorkItem(worker, true, childPath); } }
+		else if (HasFolderScanExtension(worker->scan, childPath)) { PushFolderScanWorkItem(worker, false, childPath); }
+	}
+	ScratchEnd(scratch);
+}
+
+void ScanFolderScanFile(FolderScanWorker* worker, FilePath filePath)
+{
+	FolderScan* scan = worker->scan;
+	ScratchBegin(scratch);
+	OsFileWriteTime writeTime = ZEROED;
+	if (OsGetFileWriteTime(filePath, &writeTime) != Result_Success) { ScratchEnd(scratch); return; }
+	Str8 fileContents = Str8_Empty;
+	if (!AppReadTextFile(filePath, scratch, &fileContents) || fileContents.length > FOLDER_SCAN_MAX_FILE_SIZE) { ScratchEnd(scratch); return; }
+	
+	VarArray fileOptions;
+	InitVarArray(FileOption, &fileOptions, scratch);
+	ParseFileOptions(scratch, fileContents, &fileOptions);
+	VarArray mentions;
+	InitVarArray(UsageIndexMention, &mentions, scratch);
+	VarArray includes;
+	InitVarArray(Str8, &includes, scratch);
+	TokenizePreprocessorLines(fileContents, &mentions, &includes);
+	AtomicIncrement(&scan->numFilesScanned);
+	
+	//NOTE: Files without options or mentions are still passed along so the usage index can notice if they gain some later
+	LockMutex(&scan->resultsMutex, TIMEOUT_FOREVER);
+	FolderScanFile* newFile = VarArrayAdd(FolderScanFile, &scan->pendingFiles);
+	NotNull(newFile);
+	ClearPointer(newFile);
+	newFile->path = AllocStr8(&scan->resultsHeap, filePath);
+	newFile->writeTime = writeTime;
+	InitVarArrayWithInitial(UsageIndexMention, &newFile->mentions, &scan->resultsHeap, mentions.length);
+	VarArrayLoop(&mentions, mIndex)
+	{
+		VarArrayLoopGet(UsageIndexMention, mention, &mentions, mIndex);
+		UsageIndexMention* newMention = VarArrayAdd(UsageIndexMention, &newFile->mentions);
+		NotNull(newMention);
+		newMention->name = AllocStr8(&scan->resultsHeap, mention->name);
+		newMention->lineNum = mention->lineNum;
+	}
+	InitVarArrayWithInitial(Str8, &newFile->includes, &scan->resultsHeap, includes.length);
+	VarArrayLoop(&includes, iIndex)
+	{
+		VarArrayLoopGet(Str8, include, &includes, iIndex);
+		*VarArrayAdd(Str8, &newFile->includes) = AllocStr8(&scan->resultsHeap, *include);
+	}
+	InitVarArrayWithInitial(FolderScanOption, &newFile->options, &scan->resultsHeap, fileOptions.length);
+	VarArrayLoop(&fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, &fileOptions, oIndex);
+		FolderScanOption* newOption = VarArrayAdd(FolderScanOption, &newFile->options);
+		NotNull(newOption);
+		newOption->name = AllocStr8(&scan->resultsHeap, option->name);
+		newOption->isEnabled = (option->type == FileOptionType_Bool) ? option->valueBool : option->isUncommented;
+	}
+	UnlockMutex(&scan->resultsMutex);
+	ScratchEnd(scratch);
+}
+
+void RunFolderScanWorker(FolderScanWorker* worker)
+{
+	NotNull(worker);
+	FolderScan* scan = worker->scan;
+	ProfZoneBeginEx(_funcZone, "FolderScanWorker", ProfilerCategory_Job);
+	ScratchBegin(scratch);
+	while (!AtomicRead(&scan->stopRequested))
+	{
+		uxx scratchMark = ArenaGetMark(scratch);
+		FolderScanWorkItem item = ZEROED;
+		if (FindFolderScanWork(worker, scratch, &item))
+		{
+			if (item.isFolder) { ScanFolderScanFolder(worker, item.path); }
+			else { ScanFolderScanFile(worker, item.path); }
+			AtomicAdd(&scan->numPendingItems, -1);
+		}
+		else if (AtomicRead(&scan->numPendingItems) <= 0) { break; }
+		else { OsSleepMs(1); } //someone else is still working on something that might give us more work
+		ArenaResetToMark(scratch, scratchMark);
+	}
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// +==============================+
+// |    FolderScanWorkerMain      |
+// +==============================+
+// DWORD FolderScanWorkerMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(FolderScanWorkerMain)
+{
+	NotNull(contextPntr);
+	FolderScanWorker* worker = (FolderScanWorker*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	RunFolderScanWorker(worker);
+	AtomicWrite(&worker->isRunning, false);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+// +--------------------------------------------------------------+
+// |                        Start and Stop                        |
+// +--------------------------------------------------------------+
+void FreeFolderScanFile(Arena* arena, FolderScanFile* file)
+{
+	NotNull(file);
+	VarArrayLoop(&file->options, oIndex)
+	{
+		VarArrayLoopGet(FolderScanOption, option, &file->options, oIndex);
+		FreeStr8(arena, &option->name);
+	}
+	FreeVarArray(&file->options);
+	if (file->mentions.arena != nullptr)
+	{
+		VarArrayLoop(&file->mentions, mIndex)
+		{
+			VarArrayLoopGet(UsageIndexMention, mention, &file->mentions, mIndex);
+			FreeStr8(arena, &mention->name);
+		}
+		FreeVarArray(&file->mentions);
+	}
+	if (file->includes.arena != nullptr)
+	{
+		VarArrayLoop(&file->includes, iIndex)
+		{
+			VarArrayLoopGet(Str8, include, &file->includes, iIndex);
+			FreeStr8(arena, include);
+		}
+		FreeVarArray(&file->includes);
+	}
+	FreeStr8(arena, &file->path);
+	ClearPointer(file);
+}
+
+// Blocks until every worker has stopped and frees everything the workers use. Results that were already merged are kept
+void StopFolderScan(FolderScan* scan)
+{
+	NotNull(scan);
+	if (!scan->isRunning) { return; }
+	ProfZoneBegin(_funcZone, "StopFolderScan");
+	AtomicWrite(&scan->stopRequested, true);
+	for (uxx wIndex = 0; wIndex < FOLDER_SCAN_NUM_THREADS; wIndex++)
+	{
+		FolderScanWorker* worker = &scan->workers[wIndex];
+		if (worker->scan == nullptr) { continue; }
+		while (AtomicRead(&worker->isRunning)) { OsSleepMs(1); }
+		if (worker->thread.isFilled) { OsCloseThread(&worker->thread); }
+		for (uxx iIndex = worker->queueHead; iIndex < worker->queue.length; iIndex++)
+		{
+			FolderScanWorkItem* item = VarArrayGetHard(FolderScanWorkItem, &worker->queue, iIndex);
+			FreeStr8(&worker->heap, &item->path);
+		}
+		FreeVarArray(&worker->queue);
+		DestroyMutex(&worker->mutex);
+		ClearPointer(worker);
+	}
+	VarArrayLoop(&scan->pendingFiles, fIndex)
+	{
+		VarArrayLoopGet(FolderScanFile, pendingFile, &scan->pendingFiles, fIndex);
+		FreeFolderScanFile(&scan->resultsHeap, pendingFile);
+	}
+	FreeVarArray(&scan->pendingFiles);
+	DestroyMutex(&scan->resultsMutex);
+	scan->isRunning = false;
+	EndUsageIndexBuild(&app->usageIndex);
+	ProfZoneEnd(_funcZone);
+}
+
+void ClearFolderScanResults(FolderScan* scan)
+{
+	NotNull(scan);
+	VarArrayLoop(&scan->files, fIndex)
+	{
+		VarArrayLoopGet(FolderScanFile, file, &scan->files, fIndex);
+		FreeFolderScanFile(scan->arena, file);
+	}
+	VarArrayClear(&scan->files);
+	VarArrayClear(&scan->rows);
+	scan->numOptions = 0;
+	scan->firstVisibleRow = 0;
+	scan->selectedRow = 0;
+	scan->selectedFileId = 0;
+	scan->selectedOptionIndex = -1;
+	scan->clickedRow = UINTXX_MAX;
+	scan->overlayClicked = false;
+	scan->numFilesWithRows = 0;
+}
+
+void FreeFolderScan(FolderScan* scan)
+{
+	NotNull(scan);
+	if (scan->arena != nullptr)
+	{
+		StopFolderScan(scan);
+		ClearFolderScanResults(scan);
+		FreeVarArray(&scan->files);
+		FreeVarArray(&scan->rows);
+		FreeFolderScanList(scan->arena, &scan->ignoreGlobs);
+		FreeFolderScanList(scan->arena, &scan->extensions);
+		FreeVarArray(&scan->ignoreGlobs);
+		FreeVarArray(&scan->extensions);
+		FreeStr8(scan->arena, &scan->rootPath);
+	}
+	ClearPointer(scan);
+}
+
+void InitFolderScan(Arena* arena, FolderScan* scanOut)
+{
+	NotNull(arena);
+	NotNull(scanOut);
+	ClearPointer(scanOut);
+	scanOut->arena = arena;
+	scanOut->selectedOptionIndex = -1;
+	scanOut->clickedRow = UINTXX_MAX;
+	InitArenaStdHeap(&scanOut->resultsHeap);
+	InitVarArray(Str8, &scanOut->ignoreGlobs, arena);
+	InitVarArray(Str8, &scanOut->extensions, arena);
+	InitVarArray(FolderScanFile, &scanOut->files, arena);
+	InitVarArray(FolderScanRow, &scanOut->rows, arena);
+}
+
+void CloseFolderScan(FolderScan* scan)
+{
+	NotNull(scan);
+	StopFolderScan(scan);
+	ClearFolderScanResults(scan);
+	scan->isOpen = false;
+}
+
+// Stops any scan that is in progress, throws away its results, and starts walking folderPath
+void StartFolderScan(FolderScan* scan, FilePath folderPath)
+{
+	NotNull(scan);
+	NotNull(scan->arena);
+	ProfZoneBegin(_funcZone, "StartFolderScan");
+	StopFolderScan(scan);
+	ClearFolderScanResults(scan);
+	
+	ScratchBegin1(scratch, scan->arena);
+	FreeStr8(scan->arena, &scan->rootPath);
+	scan->rootPath = AllocStr8(scan->arena, OsGetFullPath(scratch, folderPath));
+	while (scan->rootPath.length > 1 && (scan->rootPath.chars[scan->rootPath.length-1] == '/' || scan->rootPath.chars[scan->rootPath.length-1] == '\\')) { scan->rootPath.length--; }
+	ScratchEnd(scratch);
+	FreeFolderScanList(scan->arena, &scan->ignoreGlobs);
+	FreeFolderScanList(scan->arena, &scan->extensions);
+	SplitFolderScanList(scan->arena, app->settings.folderScanIgnore, &scan->ignoreGlobs);
+	SplitFolderScanList(scan->arena, StrLit(FOLDER_SCAN_EXTENSIONS), &scan->extensions);
+	
+	AtomicWrite(&scan->stopRequested, false);
+	AtomicWrite(&scan->numPendingItems, 0);
+	AtomicWrite(&scan->numFilesScanned, 0);
+	InitMutex(&scan->resultsMutex);
+	InitVarArray(FolderScanFile, &scan->pendingFiles, &scan->resultsHeap);
+	for (uxx wIndex = 0; wIndex < FOLDER_SCAN_NUM_THREADS; wIndex++)
+	{
+		FolderScanWorker* worker = &scan->workers[wIndex];
+		ClearPointer(worker);
+		worker->scan = scan;
+		worker->index = wIndex;
+		InitMutex(&worker->mutex);
+		InitArenaStdHeap(&worker->heap);
+		InitVarArray(FolderScanWorkItem, &worker->queue, &worker->heap);
+	}
+	scan->isRunning = true;
+	scan->isOpen = true;
+	BeginUsageIndexBuild(&app->usageIndex, scan->rootPath);
+	PushFolderScanWorkItem(&scan->workers[0], true, scan->rootPath);
+	
+	uxx numThreadsStarted = 0;
+	for (uxx wIndex = 0; wIndex < FOLDER_SCAN_NUM_THREADS; wIndex++)
+	{
+		FolderScanWorker* worker = &scan->workers[wIndex];
+		AtomicWrite(&worker->isRunning, true);
+		worker->thread = OsCreateThread(FolderScanWorkerMain, worker, true);
+		if (worker->thread.isFilled) { numThreadsStarted++; }
+		else { AtomicWrite(&worker->isRunning, false); }
+	}
+	if (numThreadsStarted == 0)
+	{
+		//NOTE: Without any threads we walk the whole folder right here. Slow, but the user still gets their results
+		WriteLine_W("Failed to start any folder scan threads! Scanning on the main thread");
+		RunFolderScanWorker(&scan->workers[0]);
+	}
+	PrintLine_D("Scanning \"%.*s\" on %llu thread%s", StrPrint(scan->rootPath), (u64)numThreadsStarted, Plural(numThreadsStarted, "s"));
+	
+	app->isFileMenuOpen = false;
+	app->isOpenRecentSubmenuOpen = false;
+	app->isViewMenuOpen = false;
+	if (app->palette.isOpen) { CloseCommandPalette(&app->palette); }
+	ProfZoneEnd(_funcZone);
+}
+
+// +--------------------------------------------------------------+
+// |                           Results                            |
+// +--------------------------------------------------------------+
+i32 CompareFolderScanPaths(Str8 left, Str8 right)
+{
+	uxx minLength = (left.length < right.length) ? left.length : right.length;
+	for (uxx cIndex = 0; cIndex < minLength; cIndex++)
+	{
+		u8 leftChar = FuzzyFoldChar(left.chars[cIndex]);
+		u8 rightChar = FuzzyFoldChar(right.chars[cIndex]);
+		if (leftChar == '\\') { leftChar = '/'; }
+		if (rightChar == '\\') { rightChar = '/'; }
+		if (leftChar != rightChar) { return (leftChar < rightChar) ? -1 : 1; }
+	}
+	if (left.length == right.length) { return 0; }
+	return (left.length < right.length) ? -1 : 1;
+}
+
+// Sorts files by relativePath. temp needs room for numFiles entries
+void SortFolderScanFiles(FolderScanFile* files, uxx numFiles, FolderScanFile* temp)
+{
+	if (numFiles < 2) { return; }
+	uxx numLeft = numFiles/2;
+	SortFolderScanFiles(&files[0], numLeft, temp);
+	SortFolderScanFiles(&files[numLeft], numFiles - numLeft, temp);
+	uxx leftIndex = 0;
+	uxx rightIndex = numLeft;
+	for (uxx tIndex = 0; tIndex < numFiles; tIndex++)
+	{
+		bool takeLeft = (rightIndex >= numFiles || (leftIndex < numLeft && CompareFolderScanPaths(files[leftIndex].relativePath, files[rightIndex].relativePath) <= 0));
+		temp[tIndex] = takeLeft ? files[leftIndex++] : files[rightIndex++];
+	}
+	MyMemCopy(files, temp, sizeof(FolderScanFile) * numFiles);
+}
+
+// Moves everything the workers have finished into scan->files (kept sorted by relativePath). Returns true if anything was added.
+// The batch is sorted on its own and then merged into files in one pass from the back, so a batch costs O(files + batch*log(batch))
+bool MergeFolderScanResults(FolderScan* scan)
+{
+	NotNull(scan);
+	if (!scan->isRunning) { return false; }
+	ScratchBegin1(scratch, scan->arena);
+	LockMutex(&scan->resultsMutex, TIMEOUT_FOREVER);
+	uxx numNewFiles = 0;
+	FolderScanFile* newFiles = AllocArray(FolderScanFile, scratch, MaxUXX(scan->pendingFiles.length, 1));
+	NotNull(newFiles);
+	VarArrayLoop(&scan->pendingFiles, pIndex)
+	{
+		VarArrayLoopGet(FolderScanFile, pendingFile, &scan->pendingFiles, pIndex);
+		AddScannedFileToUsageIndex(&app->usageIndex, pendingFile->path, pendingFile->writeTime, &pendingFile->mentions, &pendingFile->includes);
+		if (pendingFile->options.length == 0) { FreeFolderScanFile(&scan->resultsHeap, pendingFile); continue; }
+		
+		FolderScanFile* newFile = &newFiles[numNewFiles];
+		numNewFiles++;
+		ClearPointer(newFile);
+		newFile->id = ++scan->nextFileId;
+		newFile->path = AllocStr8(scan->arena, pendingFile->path);
+		newFile->relativePath = GetFolderScanRelativePath(scan, newFile->path);
+		InitVarArrayWithInitial(FolderScanOption, &newFile->options, scan->arena, pendingFile->options.length);
+		VarArrayLoop(&pendingFile->options, oIndex)
+		{
+			VarArrayLoopGet(FolderScanOption, pendingOption, &pendingFile->options, oIndex);
+			FolderScanOption* newOption = VarArrayAdd(FolderScanOption, &newFile->options);
+			NotNull(newOption);
+			newOption->name = AllocStr8(scan->arena, pendingOption->name);
+			newOption->isEnabled = pendingOption->isEnabled;
+		}
+		scan->numOptions += newFile->options.length;
+		FreeFolderScanFile(&scan->resultsHeap, pendingFile);
+	}
+	VarArrayClear(&scan->pendingFiles);
+	UnlockMutex(&scan->resultsMutex);
+	
+	if (numNewFiles > 0)
+	{
+		FolderScanFile* sortTemp = AllocArray(FolderScanFile, scratch, numNewFiles);
+		NotNull(sortTemp);
+		SortFolderScanFiles(newFiles, numNewFiles, sortTemp);
+		
+		uxx numOldFiles = scan->files.length;
+		for (uxx nIndex = 0; nIndex < numNewFiles; nIndex++)
+		{
+			FolderScanFile* newSlot = VarArrayAdd(FolderScanFile, &scan->files);
+			NotNull(newSlot);
+		}
+		FolderScanFile* files = (FolderScanFile*)scan->files.items;
+		uxx oldIndex = numOldFiles;
+		uxx newIndex = numNewFiles;
+		uxx writeIndex = numOldFiles + numNewFiles;
+		while (newIndex > 0)
+		{
+			writeIndex--;
+			if (oldIndex > 0 && CompareFolderScanPaths(files[oldIndex-1].relativePath, newFiles[newIndex-1].relativePath) > 0) { files[writeIndex] = files[oldIndex-1]; oldIndex--; }
+			else { files[writeIndex] = newFiles[newIndex-1]; newIndex--; }
+		}
+		//NOTE: Everything before the first new file didn't move, so its rows are still good
+		if (oldIndex < scan->numFilesWithRows) { scan->numFilesWithRows = oldIndex; }
+	}
+	ScratchEnd(scratch);
+	return (numNewFiles > 0);
+}
+
+// Only the rows of files from numFilesWithRows onward are redone, the files before that kept their index when the new files were merged in.
+// The selection follows the file and option it was on, not the row index
+void RebuildFolderScanRows(FolderScan* scan)
+{
+	NotNull(scan);
+	if (scan->numFilesWithRows >= scan->files.length) { return; }
+	ProfZoneBegin(_funcZone, "RebuildFolderScanRows");
+	uxx firstFileIndex = scan->numFilesWithRows;
+	uxx firstRowIndex = 0;
+	if (firstFileIndex > 0)
+	{
+		FolderScanFile* prevFile = VarArrayGetHard(FolderScanFile, &scan->files, firstFileIndex-1);
+		firstRowIndex = prevFile->firstRow + 1 + prevFile->options.length;
+	}
+	Assert(firstRowIndex <= scan->rows.length);
+	bool foundSelection = (scan->selectedRow < firstRowIndex);
+	scan->rows.length = firstRowIndex;
+	VarArrayExpand(&scan->rows, scan->files.length + scan->numOptions);
+	for (uxx fIndex = firstFileIndex; fIndex < scan->files.length; fIndex++)
+	{
+		VarArrayLoopGet(FolderScanFile, file, &scan->files, fIndex);
+		file->firstRow = scan->rows.length;
+		for (ixx oIndex = -1; oIndex < (ixx)file->options.length; oIndex++)
+		{
+			if (!foundSelection && file->id == scan->selectedFileId && oIndex == scan->selectedOptionIndex)
+			{
+				scan->selectedRow = scan->rows.length;
+				foundSelection = true;
+			}
+			FolderScanRow* newRow = VarArrayAdd(FolderScanRow, &scan->rows);
+			NotNull(newRow);
+			newRow->fileIndex = fIndex;
+			newRow->optionIndex = oIndex;
+		}
+	}
+	if (!foundSelection) { scan->selectedRow = 0; }
+	scan->numFilesWithRows = scan->files.length;
+	ProfZoneEnd(_funcZone);
+}
+
+void SelectFolderScanRow(FolderScan* scan, uxx rowIndex)
+{
+	NotNull(scan);
+	if (scan->rows.length == 0) { return; }
+	if (rowIndex >= scan->rows.length) { rowIndex = scan->rows.length-1; }
+	FolderScanRow* row = VarArrayGetHard(FolderScanRow, &scan->rows, rowIndex);
+	scan->selectedRow = rowIndex;
+	scan->selectedFileId = VarArrayGetHard(FolderScanFile, &scan->files, row->fileIndex)->id;
+	scan->selectedOptionIndex = row->optionIndex;
+	if (scan->selectedRow < scan->firstVisibleRow) { scan->firstVisibleRow = scan->selectedRow; }
+	if (scan->selectedRow >= scan->firstVisibleRow + FOLDER_SCAN_MAX_VISIBLE) { scan->firstVisibleRow = scan->selectedRow - (FOLDER_SCAN_MAX_VISIBLE-1); }
+}
+
+// Opens the file in a tab and (for option rows) selects the option. Closes the panel
+void OpenFolderScanRow(FolderScan* scan, uxx rowIndex)
+{
+	NotNull(scan);
+	if (rowIndex >= scan->rows.length) { return; }
+	ScratchBegin(scratch);
+	FolderScanRow row = *VarArrayGetHard(FolderScanRow, &scan->rows, rowIndex);
+	FolderScanFile* file = VarArrayGetHard(FolderScanFile, &scan->files, row.fileIndex);
+	FilePath filePath = AllocStr8(scratch, file->path);
+	Str8 optionName = (row.optionIndex >= 0) ? AllocStr8(scratch, VarArrayGetHard(FolderScanOption, &file->options, (uxx)row.optionIndex)->name) : Str8_Empty;
+	CloseFolderScan(scan);
+	
+	FileTab* tab = AppOpenFileTab(filePath);
+	if (tab != nullptr && !IsEmptyStr(optionName))
+	{
+		VarArrayLoop(&tab->fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+			if (StrExactEquals(option->name, optionName))
+			{
+				ClearOptionsFilter();
+				tab->selectedOptionIndex = (ixx)oIndex;
+				app->usingKeyboardToSelect = true;
+				app->scrollToSelectedOption = true;
+				break;
+			}
+		}
+	}
+	ScratchEnd(scratch);
+}
+
+// Called once a frame. Returns true if the panel needs to be redrawn
+bool UpdateFolderScan(FolderScan* scan)
+{
+	NotNull(scan);
+	if (scan->arena == nullptr || (!scan->isOpen && !scan->isRunning)) { return false; }
+	ProfZoneBegin(_funcZone, "UpdateFolderScan");
+	bool needsRedraw = scan->isRunning;
+	
+	if (scan->isRunning)
+	{
+		MergeFolderScanResults(scan);
+		bool anyWorkerRunning = false;
+		for (uxx wIndex = 0; wIndex < FOLDER_SCAN_NUM_THREADS; wIndex++) { if (AtomicRead(&scan->workers[wIndex].isRunning)) { anyWorkerRunning = true; break; } }
+		if (!anyWorkerRunning)
+		{
+			MergeFolderScanResults(scan);
+			u64 numFilesScanned = (u64)AtomicRead(&scan->numFilesScanned);
+			StopFolderScan(scan);
+			NotifyPrint_I("Found %llu option%s in %llu of %llu file%s", (u64)scan->numOptions, Plural(scan->numOptions, "s"), (u64)scan->files.length, numFilesScanned, Plural(numFilesScanned, "s"));
+		}
+	}
+	RebuildFolderScanRows(scan);
+	
+	if (scan->isOpen && scan->overlayClicked)
+	{
+		CloseFolderScan(scan);
+		needsRedraw = true;
+	}
+	else if (scan->isOpen && scan->clickedRow != UINTXX_MAX)
+	{
+		OpenFolderScanRow(scan, scan->clickedRow);
+		needsRedraw = true;
+	}
+	scan->clickedRow = UINTXX_MAX;
+	scan->overlayClicked = false;
+	
+	if (scan->isOpen)
+	{
+		if (scan->rows.length > 0)
+		{
+			if (WasKeyPressed(Key_Up, true)) { SelectFolderScanRow(scan, (scan->selectedRow > 0) ? scan->selectedRow-1 : 0); needsRedraw = true; }
+			if (WasKeyPressed(Key_Down, true)) { SelectFolderScanRow(scan, scan->selectedRow+1); needsRedraw = true; }
+			if (WasKeyPressed(Key_PageUp, true)) { SelectFolderScanRow(scan, (scan->selectedRow > FOLDER_SCAN_MAX_VISIBLE) ? scan->selectedRow - FOLDER_SCAN_MAX_VISIBLE : 0); needsRedraw = true; }
+			if (WasKeyPressed(Key_PageDown, true)) { SelectFolderScanRow(scan, scan->selectedRow + FOLDER_SCAN_MAX_VISIBLE); needsRedraw = true; }
+			if (WasKeyPressed(Key_Home, false)) { SelectFolderScanRow(scan, 0); needsRedraw = true; }
+			if (WasKeyPressed(Key_End, false)) { SelectFolderScanRow(scan, scan->rows.length-1); needsRedraw = true; }
+		}
+		if (appIn->mouse.isOverWindow && appIn->mouse.scrollDelta.y != 0 && !IsKeyDownRaw(Key_CtrlOrCmd))
+		{
+			uxx maxFirstRow = (scan->rows.length > FOLDER_SCAN_MAX_VISIBLE) ? scan->rows.length - FOLDER_SCAN_MAX_VISIBLE : 0;
+			if (appIn->mouse.scrollDelta.y > 0) { scan->firstVisibleRow = (scan->firstVisibleRow > FOLDER_SCAN_WHEEL_ROWS) ? scan->firstVisibleRow - FOLDER_SCAN_WHEEL_ROWS : 0; }
+			else { scan->firstVisibleRow = MinUXX(scan->firstVisibleRow + FOLDER_SCAN_WHEEL_ROWS, maxFirstRow); }
+			needsRedraw = true;
+		}
+		
+		//NOTE: These keys are marked handled so the same press doesn't trigger bindings once the panel is closed
+		if (WasKeyPressed(Key_Escape, false))
+		{
+			appInputHandling->keyboard.keyHandledUntilReleased[Key_Escape] = true;
+			CloseFolderScan(scan);
+			needsRedraw = true;
+		}
+		else if (WasKeyPressed(Key_Enter, false))
+		{
+			appInputHandling->keyboard.keyHandledUntilReleased[Key_Enter] = true;
+			OpenFolderScanRow(scan, scan->selectedRow);
+			needsRedraw = true;
+		}
+	}
+	ProfZoneEnd(_funcZone);
+	return needsRedraw;
+}
+
+// +--------------------------------------------------------------+
+// |                            Panel                             |
+// +--------------------------------------------------------------+
+#if BUILD_WITH_PIG_UI
+void RenderFolderScan(FolderScan* scan)
+{
+	NotNull(scan);
+	if (!scan->isOpen) { return; }
+	
+	UiId overlayId = UiIdLit("FolderScanOverlay");
+	UiId panelId = UiIdLit("FolderScanPanel");
+	r32 screenWidth = appIn->screenSize.width / GetUiCtx()->scale;
+	r32 screenHeight = appIn->screenSize.height / GetUiCtx()->scale;
+	
+	UIELEM({ .id = overlayId,
+		.depth = FOLDER_SCAN_DEPTH,
+		.direction = UiLayoutDir_TopDown,
+		.sizing = UI_FIXED2(screenWidth, screenHeight),
+		.alignment = UI_ALIGN_TOP_LEFT(),
+		.padding = { .inner = { .left=RoundR32(screenWidth * (1.0f - PALETTE_WIDTH_PERCENT) / 2.0f), .top=8 } },
+		.floating = {
+			.type = UiFloatingType_Parent,
+			.parentSide = UiSide_TopLeft,
+			.elemSide = UiSide_TopLeft,
+		},
+		.color = GetThemeColor(ConfirmDialogDarken),
+	})
+	{
+		UIELEM({ .id = panelId,
+			.direction = UiLayoutDir_TopDown,
+			.sizing = { .width=UI_FIXED(screenWidth * PALETTE_WIDTH_PERCENT), .height=UI_FIT() },
+			.padding = { .inner=FillV4(6), .child=2 },
+			.color = GetThemeColor(DropdownBack),
+			.borderColor = GetThemeColor(DropdownBorder),
+			.borderThickness = FillV4(2),
+			.cornerRadius = FillV4(6),
+		})
+		{
+			// +==============================+
+			// |            Header            |
+			// +==============================+
+			Str8 statusStr = scan->isRunning
+				? PrintInArenaStr(uiArena, "Scanning... %llu file%s, %llu option%s so far", (u64)scan->files.length, Plural(scan->files.length, "s"), (u64)scan->numOptions, Plural(scan->numOptions, "s"))
+				: PrintInArenaStr(uiArena, "%llu file%s, %llu option%s", (u64)scan->files.length, Plural(scan->files.length, "s"), (u64)scan->numOptions, Plural(scan->numOptions, "s"));
+			UIELEM({ .id = UiIdLit("FolderScanHeader"),
+				.direction = UiLayoutDir_LeftToRight,
+				.sizing = { .width=UI_EXPAND(), .height=UI_FIT() },
+				.padding = { .inner=MakeV4(4,2,4,4), .child=8 },
+			})
+			{
+				UIELEM_LEAF({
+					.text = scan->rootPath,
+					.font = &app->uiFont,
+					.fontSize = app->uiFontSize,
+					.fontStyle = UI_FONT_STYLE,
+					.textColor = GetThemeColorEx(DropdownBtnText, ThemeState_Default),
+					.sizing = UI_TEXT_CLIP(0),
+					.renderer = { .textContraction = TextContraction_EllipseFilePath },
+				});
+				UIEXPANDER_HORI();
+				UIELEM_LEAF({
+					.text = statusStr,
+					.font = &app->uiFont,
+					.fontSize = app->uiFontSize,
+					.fontStyle = UI_FONT_STYLE,
+					.textColor = GetThemeColorEx(HotkeyText, ThemeState_Default),
+					.sizing = UI_TEXT_FULL(),
+				});
+			}
+			
+			// +==============================+
+			// |             Rows             |
+			// +==============================+
+			//NOTE: Only the rows in the visible window get UI elements, the rest of the list is never touched while rendering
+			uxx maxFirstRow = (scan->rows.length > FOLDER_SCAN_MAX_VISIBLE) ? scan->rows.length - FOLDER_SCAN_MAX_VISIBLE : 0;
+			if (scan->firstVisibleRow > maxFirstRow) { scan->firstVisibleRow = maxFirstRow; }
+			uxx numVisible = MinUXX(scan->rows.length - scan->firstVisibleRow, FOLDER_SCAN_MAX_VISIBLE);
+			for (uxx rIndex = scan->firstVisibleRow; rIndex < scan->firstVisibleRow + numVisible; rIndex++)
+			{
+				FolderScanRow* row = VarArrayGetHard(FolderScanRow, &scan->rows, rIndex);
+				FolderScanFile* file = VarArrayGetHard(FolderScanFile, &scan->files, row->fileIndex);
+				bool isFileRow = (row->optionIndex < 0);
+				FolderScanOption* option = isFileRow ? nullptr : VarArrayGetHard(FolderScanOption, &file->options, (uxx)row->optionIndex);
+				UiId rowId = UiIdLitIndex("FolderScanRow", rIndex);
+				bool isHovered = IsUiElementHovered(rowId);
+				bool isSelected = (rIndex == scan->selectedRow);
+				ThemeState rowThemeState = (isHovered && IsMouseDownRaw(MouseBtn_Left)) ? ThemeState_Pressed : ((isSelected || isHovered) ? ThemeState_Hovered : ThemeState_Default);
+				
+				UIELEM({ .id = rowId,
+					.direction = UiLayoutDir_LeftToRight,
+					.sizing = { .width=UI_EXPAND(), .height=UI_FIT() },
+					.alignment = UI_ALIGN_LEFT_CENTER(),
+					.padding = { .inner=MakeV4(isFileRow ? 4.0f : 20.0f, 2, 4, 2), .child=8 },
+					.color = (isFileRow || isSelected || isHovered) ? GetThemeColorEx(DropdownBtnBack, rowThemeState) : Transparent,
+					.borderColor = GetThemeColorEx(DropdownBtnBorder, rowThemeState),
+					.borderThickness = (isSelected || isHovered) ? FillV4(1) : FillV4(0),
+					.cornerRadius = FillV4(4),
+				})
+				{
+					UIELEM_LEAF({
+						.text = isFileRow ? file->relativePath : option->name,
+						.font = isFileRow ? &app->mainFont : &app->uiFont,
+						.fontSize = isFileRow ? app->mainFontSize : app->uiFontSize,
+						.fontStyle = isFileRow ? MAIN_FONT_STYLE : UI_FONT_STYLE,
+						.textColor = GetThemeColorEx(DropdownBtnText, rowThemeState),
+						.sizing = UI_TEXT_CLIP(0),
+						.renderer = { .textContraction = isFileRow ? TextContraction_EllipseFilePath : TextContraction_EllipseRight },
+					});
+					UIEXPANDER_HORI();
+					UIELEM_LEAF({
+						.text = isFileRow ? PrintInArenaStr(uiArena, "%llu", (u64)file->options.length) : (option->isEnabled ? StrLit("On") : StrLit("Off")),
+						.font = &app->uiFont,
+						.fontSize = app->uiFontSize,
+						.fontStyle = UI_FONT_STYLE,
+						.textColor = GetThemeColorEx(HotkeyText, ThemeState_Default),
+						.sizing = UI_TEXT_FULL(),
+					});
+				}
+				
+				if (isHovered && MouseLeftClicked()) { scan->clickedRow = rIndex; }
+			}
+			
+			if (scan->rows.length == 0)
+			{
+				UIELEM_LEAF({
+					.text = scan->isRunning ? StrLit("Scanning...") : StrLit("No options found"),
+					.font = &app->uiFont,
+					.fontSize = app->uiFontSize,
+					.fontStyle = UI_FONT_STYLE,
+					.textColor = GetThemeColorEx(HotkeyText, ThemeState_Default),
+					.sizing = UI_TEXT_FULL(),
+				});
+			}
+		}
+	}
+	
+	if (IsUiElementHovered(overlayId) && !IsUiElementHovered(panelId) && MouseLeftClicked()) { scan->overlayClicked = true; }
+}
+#endif //BUILD_WITH_PIG_UI
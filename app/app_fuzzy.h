@@ -0,0 +1,95 @@
+/*
+File:   app_fuzzy.h
+Description:
+	** Holds the fuzzy string matching that the command palette uses to search commands, options, and recent files
+	** A "char mask" has one bit for each kind of character that appears in a string (letters are case-folded).
+	** If a query has a bit that a candidate doesn't then the candidate can't possibly match, so the palette
+	** rejects most candidates with a single AND before ever looking at their characters.
+	** NOTE: Spaces in a query are treated as separators and are skipped, so "toggle light" matches "ToggleLightMode"
+*/
+
+#ifndef _APP_FUZZY_H
+#define _APP_FUZZY_H
+
+#define FUZZY_SCORE_MATCH        1
+#define FUZZY_SCORE_CONSECUTIVE  6
+#define FUZZY_SCORE_WORD_START   8
+#define FUZZY_SCORE_PREFIX       10
+#define FUZZY_MAX_GAP_PENALTY    4
+#define FUZZY_MAX_LENGTH_PENALTY 8
+
+u8 FuzzyFoldChar(char c)
+{
+	u8 result = (u8)c;
+	if (result >= 'A' && result <= 'Z') { result = (u8)(result - 'A' + 'a'); }
+	return result;
+}
+
+// Bits 0-25 are letters, 26-35 are digits, 36 is underscore and everything else shares the remaining bits
+u64 GetFuzzyCharMask(Str8 str)
+{
+	u64 result = 0;
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		u8 foldedChar = FuzzyFoldChar(str.chars[cIndex]);
+		if (foldedChar == ' ') { continue; }
+		else if (foldedChar >= 'a' && foldedChar <= 'z') { result |= (1ULL << (foldedChar - 'a')); }
+		else if (foldedChar >= '0' && foldedChar <= '9') { result |= (1ULL << (26 + (foldedChar - '0'))); }
+		else if (foldedChar == '_') { result |= (1ULL << 36); }
+		else { result |= (1ULL << (37 + (foldedChar % 27))); }
+	}
+	return result;
+}
+
+bool IsFuzzyWordStart(Str8 str, uxx index)
+{
+	if (index == 0) { return true; }
+	char prevChar = str.chars[index-1];
+	char thisChar = str.chars[index];
+	bool prevIsAlphaNum = IsCharAlphaNumeric(CharToU32(prevChar));
+	if (!prevIsAlphaNum) { return IsCharAlphaNumeric(CharToU32(thisChar)); }
+	if (IsCharLowercaseAlphabet(CharToU32(prevChar)) && IsCharUppercaseAlphabet(CharToU32(thisChar))) { return true; }
+	if (!IsCharNumeric(CharToU32(prevChar)) && IsCharNumeric(CharToU32(thisChar))) { return true; }
+	return false;
+}
+
+// Returns true if every (non-space) character of query appears in order in target, ignoring case.
+// The score rewards matches that are consecutive, land on word starts, or start at the beginning of target
+// NOTE: Any target that matches "abc" also matches "ab", which is what lets the palette narrow the previous results as the user types
+bool FuzzyMatch(Str8 target, Str8 query, i32* scoreOut)
+{
+	i32 score = 0;
+	uxx tIndex = 0;
+	uxx prevMatchIndex = UINTXX_MAX;
+	for (uxx qIndex = 0; qIndex < query.length; qIndex++)
+	{
+		u8 queryChar = FuzzyFoldChar(query.chars[qIndex]);
+		if (queryChar == ' ') { continue; }
+		
+		bool foundChar = false;
+		for (; tIndex < target.length; tIndex++)
+		{
+			if (FuzzyFoldChar(target.chars[tIndex]) == queryChar) { foundChar = true; break; }
+		}
+		if (!foundChar) { return false; }
+		
+		score += FUZZY_SCORE_MATCH;
+		if (prevMatchIndex != UINTXX_MAX)
+		{
+			if (tIndex == prevMatchIndex+1) { score += FUZZY_SCORE_CONSECUTIVE; }
+			else { score -= (i32)MinUXX(tIndex - prevMatchIndex - 1, FUZZY_MAX_GAP_PENALTY); }
+		}
+		else if (tIndex == 0) { score += FUZZY_SCORE_PREFIX; }
+		if (IsFuzzyWordStart(target, tIndex)) { score += FUZZY_SCORE_WORD_START; }
+		
+		prevMatchIndex = tIndex;
+		tIndex++;
+	}
+	
+	//Shorter targets are preferred when everything else is equal
+	score -= (i32)MinUXX(target.length / 8, FUZZY_MAX_LENGTH_PENALTY);
+	SetOptionalOutPntr(scoreOut, score);
+	return true;
+}
+
+#endif //  _APP_FUZZY_H
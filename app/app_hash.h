@@ -0,0 +1,128 @@
+/*
+File:   app_hash.h
+Description:
+	** The one string hash that the theme definitions, parse cache, session file, usage index and define resolver all use
+	** (with an any-case variant for file paths), plus the helpers for the power-of-2 bucket arrays they chain their entries into
+	** and a HashSet64 for when all we need to remember is the hashes themselves
+	** NOTE: parse_cache.bin and session.bin store these hashes, so changing this function invalidates those files
+*/
+
+#ifndef _APP_HASH_H
+#define _APP_HASH_H
+
+// FNV-1a over the exact bytes, so strings that are StrExactEquals hash the same
+u64 HashStr8Fnv(Str8 str)
+{
+	u64 result = 0xCBF29CE484222325ULL;
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		result ^= (u64)(u8)str.chars[cIndex];
+		result *= 0x00000100000001B3ULL;
+	}
+	return result;
+}
+// Same as HashStr8Fnv but ASCII letters hash the same in either case, so strings that are StrAnyCaseEquals hash the same
+u64 HashStr8FnvAnyCase(Str8 str)
+{
+	u64 result = 0xCBF29CE484222325ULL;
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		u8 c = (u8)str.chars[cIndex];
+		if (c >= 'A' && c <= 'Z') { c = (u8)(c + ('a' - 'A')); }
+		result ^= (u64)c;
+		result *= 0x00000100000001B3ULL;
+	}
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                         Hash Buckets                         |
+// +--------------------------------------------------------------+
+// A bucket array is a VarArray of uxx where each element is index+1 of the first entry in that bucket (0 = empty bucket).
+// Each entry holds the index+1 of the next entry in the same bucket. Length is always a power of 2 so we can mask the hash
+uxx* GetHashBucket(const VarArray* buckets, u64 hash)
+{
+	return VarArrayGetHard(uxx, buckets, (uxx)(hash & (buckets->length-1)));
+}
+
+// Empties the buckets and grows them so there are at least as many as numEntries (we stay at or below 1 entry per bucket on average)
+void ResetHashBuckets(VarArray* buckets, uxx numEntries, uxx minNumBuckets)
+{
+	NotNull(buckets);
+	uxx numBuckets = MaxUXX(buckets->length, minNumBuckets);
+	while (numBuckets < numEntries) { numBuckets *= 2; }
+	if (numBuckets > buckets->length) { VarArrayAddMulti(uxx, buckets, numBuckets - buckets->length); }
+	VarArrayLoop(buckets, bIndex) { VarArrayLoopGet(uxx, bucket, buckets, bIndex); *bucket = 0; }
+}
+
+// +--------------------------------------------------------------+
+// |                          HashSet64                           |
+// +--------------------------------------------------------------+
+typedef plex HashSet64Entry HashSet64Entry;
+plex HashSet64Entry
+{
+	u64 hash;
+	uxx nextInBucket; //index+1 of the next entry in the same bucket (0 = end of chain)
+};
+
+typedef plex HashSet64 HashSet64;
+plex HashSet64
+{
+	uxx minNumBuckets; //must be a power of 2
+	VarArray entries; //HashSet64Entry
+	VarArray buckets; //uxx, see GetHashBucket
+};
+
+void InitHashSet64(Arena* arena, HashSet64* setOut, uxx minNumBuckets)
+{
+	NotNull(arena);
+	NotNull(setOut);
+	ClearPointer(setOut);
+	setOut->minNumBuckets = minNumBuckets;
+	InitVarArray(HashSet64Entry, &setOut->entries, arena);
+	InitVarArrayWithInitial(uxx, &setOut->buckets, arena, minNumBuckets);
+	ResetHashBuckets(&setOut->buckets, 0, minNumBuckets);
+}
+
+bool HashSet64Contains(const HashSet64* set, u64 hash)
+{
+	NotNull(set);
+	uxx entryIndexPlusOne = *GetHashBucket(&set->buckets, hash);
+	while (entryIndexPlusOne != 0)
+	{
+		const HashSet64Entry* entry = VarArrayGetHard(HashSet64Entry, &set->entries, entryIndexPlusOne-1);
+		if (entry->hash == hash) { return true; }
+		entryIndexPlusOne = entry->nextInBucket;
+	}
+	return false;
+}
+
+// Returns false if the hash was already in the set
+bool HashSet64Add(HashSet64* set, u64 hash)
+{
+	NotNull(set);
+	if (HashSet64Contains(set, hash)) { return false; }
+	HashSet64Entry* newEntry = VarArrayAdd(HashSet64Entry, &set->entries);
+	NotNull(newEntry);
+	newEntry->hash = hash;
+	if (set->entries.length > set->buckets.length)
+	{
+		ResetHashBuckets(&set->buckets, set->entries.length, set->minNumBuckets);
+		VarArrayLoop(&set->entries, eIndex)
+		{
+			VarArrayLoopGet(HashSet64Entry, entry, &set->entries, eIndex);
+			uxx* bucket = GetHashBucket(&set->buckets, entry->hash);
+			entry->nextInBucket = *bucket;
+			*bucket = eIndex+1;
+		}
+	}
+	else
+	{
+		uxx* bucket = GetHashBucket(&set->buckets, hash);
+		newEntry->nextInBucket = *bucket;
+		*bucket = set->entries.length;
+	}
+	return true;
+}
+
+#endif //  _APP_HASH_H
@@ -6,6 +6,18 @@ Description:
 	** None
 */
 
+//NOTE: This needs to be called again after the app dll is reloaded since the tables point to string literals in the dll
+void InitAppNameTables()
+{
+	ProfZoneBegin(_funcZone, "InitAppNameTables");
+	InitKeyNameTable();
+	InitAppCommandNameTable();
+	InitAppSettingNameTable();
+	InitThemeColorNameTable();
+	InitThemeDefFuncNameTable();
+	ProfZoneEnd(_funcZone);
+}
+
 ImageData LoadImageData(Arena* arena, const char* path)
 {
 	ScratchBegin1(scratch, arena);
@@ -25,31 +37,26 @@ ImageData LoadImageData(Arena* arena, const char* path)
 	return imageData;
 }
 
-void LoadWindowIcon()
+//NOTE: Safe to call from a worker thread (see app_startup.c), it doesn't touch anything but the resources and arena
+void DecodeWindowIcons(Arena* arena, ImageData* imageDatasOut)
 {
-	ScratchBegin(scratch);
-	ImageData iconImageDatas[6];
-	iconImageDatas[0] = LoadImageData(scratch, "resources/image/icon_16.png");
-	iconImageDatas[1] = LoadImageData(scratch, "resources/image/icon_24.png");
-	iconImageDatas[2] = LoadImageData(scratch, "resources/image/icon_32.png");
-	iconImageDatas[3] = LoadImageData(scratch, "resources/image/icon_64.png");
-	iconImageDatas[4] = LoadImageData(scratch, "resources/image/icon_120.png");
-	iconImageDatas[5] = LoadImageData(scratch, "resources/image/icon_256.png");
-	platform->SetWindowIcon(ArrayCount(iconImageDatas), &iconImageDatas[0]);
-	ScratchEnd(scratch);
+	imageDatasOut[0] = LoadImageData(arena, "resources/image/icon_16.png");
+	imageDatasOut[1] = LoadImageData(arena, "resources/image/icon_24.png");
+	imageDatasOut[2] = LoadImageData(arena, "resources/image/icon_32.png");
+	imageDatasOut[3] = LoadImageData(arena, "resources/image/icon_64.png");
+	imageDatasOut[4] = LoadImageData(arena, "resources/image/icon_120.png");
+	imageDatasOut[5] = LoadImageData(arena, "resources/image/icon_256.png");
 }
 
-void LoadNotificationIcons()
+// Uploads the already decoded sheet and points the notification queue at the cells in it
+void LoadNotificationIconsFrom(ImageData imageData)
 {
 	{
-		ScratchBegin(scratch);
-		ImageData imageData = LoadImageData(scratch, NOTIFICATION_ICONS_TEXTURE_PATH);
 		AssertMsg(imageData.pixels != nullptr && imageData.size.width > 0 && imageData.size.height > 0, "Failed to load notification icons texture!");
 		Texture newTexture = InitTexture(stdHeap, StrLit("notificationIcons"), imageData.size, imageData.pixels, 0x00);
 		AssertMsg(newTexture.error == Result_Success, "Failed to init texture for notification icons!");
 		FreeTexture(&app->notificationIconsTexture);
 		app->notificationIconsTexture = newTexture;
-		ScratchEnd(scratch);
 	}
 	
 	const v2i sheetSize = MakeV2i(2, 2);
@@ -84,11 +91,9 @@ void LoadNotificationIcons()
 	}
 }
 
-void LoadAppIcons()
+//NOTE: InitSpriteSheet decodes the png itself, so the most a worker can do ahead of time is read the two files
+void LoadAppIconsFrom(Slice imageFileContents, Str8 metaFileContents)
 {
-	ScratchBegin(scratch);
-	Slice imageFileContents = ReadAppResource(&app->resources, scratch, StrLit(APP_ICONS_TEXTURE_PATH), false);
-	Str8 metaFileContents = ReadAppResource(&app->resources, scratch, StrLit(APP_ICONS_METADATA_PATH), true);
 	app->appIconsSheet = InitSpriteSheet(stdHeap, StrLit("appIcons"), StrLit(APP_ICONS_TEXTURE_PATH), imageFileContents, metaFileContents);
 	Assert(app->appIconsSheet.error == Result_Success);
 	for (uxx iIndex = 1; iIndex < AppIcon_Count; iIndex++)
@@ -99,7 +104,6 @@ void LoadAppIcons()
 		Assert(sheetCell != nullptr);
 		app->appIconSheetCell[iIndex] = sheetCell->cellPos;
 	}
-	ScratchEnd(scratch);
 }
 
 bool AppTryLoadBindings(bool assertOnFailure)
@@ -150,7 +154,7 @@ bool AppTryLoadBindings(bool assertOnFailure)
 		}
 		else
 		{
-			if (!OsWriteTextFile(userBindingsPath, commentedBindingsFileContents))
+			if (!AppWriteTextFile(userBindingsPath, commentedBindingsFileContents))
 			{
 				NotifyPrint_W("Failed to create %s at \"%.*s\"", USER_BINDINGS_FILENAME, StrPrint(userBindingsPath));
 			}
@@ -171,7 +175,7 @@ bool AppTryLoadBindings(bool assertOnFailure)
 	#endif
 	
 	Str8 userBindingsFileContents = Str8_Empty;
-	if (OsReadTextFile(userBindingsPath, scratch, &userBindingsFileContents))
+	if (AppReadTextFile(userBindingsPath, scratch, &userBindingsFileContents))
 	{
 		Result userBindingsParseResult = TryParseBindingFile(userBindingsFileContents, &newBindings);
 		if (userBindingsParseResult == Result_EmptyFile) { PrintLine_D("%s contains no bindings", USER_BINDINGS_FILENAME); }
@@ -190,7 +194,7 @@ bool AppTryLoadBindings(bool assertOnFailure)
 
 bool AppTryLoadDefaultTheme(bool assertOnFailure)
 {
-	TracyCZoneN(_funcZone, "LoadDefaultTheme", true);
+	ProfZoneBegin(_funcZone, "LoadDefaultTheme");
 	ScratchBegin(scratch);
 	
 	Str8 defaultThemeFileContents = Str8_Empty;
@@ -200,7 +204,7 @@ bool AppTryLoadDefaultTheme(bool assertOnFailure)
 		PrintLine_E("Failed to read default theme definition file from resources: %s", GetResultStr(readDefaultThemeResult));
 		if (assertOnFailure) { AssertMsg(readDefaultThemeResult == Result_Success, "Failed to read default theme definition file from resources!"); }
 		ScratchEnd(scratch);
-		TracyCZoneEnd(_funcZone);
+		ProfZoneEnd(_funcZone);
 		return false;
 	}
 	
@@ -221,51 +225,29 @@ bool AppTryLoadDefaultTheme(bool assertOnFailure)
 		if (assertOnFailure) { AssertMsg(parseResult == Result_Success, "Failed to parse default theme definition!"); }
 		FreeThemeDefinition(&newDefaultTheme);
 		ScratchEnd(scratch);
-		TracyCZoneEnd(_funcZone);
+		ProfZoneEnd(_funcZone);
 		return false;
 	}
 	
-	BakedTheme bakedDarkTheme = ZEROED;
-	Result bakeResultDark = BakeTheme(&newDefaultTheme, ThemeMode_Dark, &bakedDarkTheme);
-	if (bakeResultDark != Result_Success)
+	BakedTheme* bakedThemes = AllocArray(BakedTheme, scratch, ThemeMode_Count);
+	NotNull(bakedThemes);
+	Result bakeResult = BakeThemeAllModes(&newDefaultTheme, nullptr, bakedThemes);
+	if (bakeResult != Result_Success)
 	{
-		PrintLine_E("Failed to bake default theme definition in Dark mode: %s", GetResultStr(bakeResultDark));
-		if (assertOnFailure) { AssertMsg(bakeResultDark == Result_Success, "Failed to bake default theme definition in Dark mode!"); }
+		PrintLine_E("Failed to bake default theme definition: %s", GetResultStr(bakeResult));
+		if (assertOnFailure) { AssertMsg(bakeResult == Result_Success, "Failed to bake default theme definition!"); }
 		FreeThemeDefinition(&newDefaultTheme);
 		ScratchEnd(scratch);
-		TracyCZoneEnd(_funcZone);
+		ProfZoneEnd(_funcZone);
 		return false;
 	}
-	BakedTheme bakedLightTheme = ZEROED;
-	Result bakeResultLight = BakeTheme(&newDefaultTheme, ThemeMode_Light, &bakedLightTheme);
-	if (bakeResultLight != Result_Success)
-	{
-		PrintLine_E("Failed to bake default theme definition in Light mode: %s", GetResultStr(bakeResultLight));
-		if (assertOnFailure) { AssertMsg(bakeResultLight == Result_Success, "Failed to bake default theme definition in Light mode!"); }
-		FreeThemeDefinition(&newDefaultTheme);
-		ScratchEnd(scratch);
-		TracyCZoneEnd(_funcZone);
-		return false;
-	}
-	#if 0
-	BakedTheme bakedDebugTheme = ZEROED;
-	Result bakeResultDebug = BakeTheme(&newDefaultTheme, ThemeMode_Debug, &bakedDebugTheme);
-	if (bakeResultDebug != Result_Success)
-	{
-		PrintLine_E("Failed to bake default theme definition in Debug mode: %s", GetResultStr(bakeResultDebug));
-		if (assertOnFailure) { AssertMsg(bakeResultDebug == Result_Success, "Failed to bake default theme definition in Debug mode!"); }
-		FreeThemeDefinition(&newDefaultTheme);
-		ScratchEnd(scratch);
-		TracyCZoneEnd(_funcZone);
-		return false;
-	}
-	#endif //DEBUG_BUILD
 	
 	FreeThemeDefinition(&app->defaultTheme);
 	MyMemCopy(&app->defaultTheme, &newDefaultTheme, sizeof(ThemeDefinition));
+	app->defaultThemeSourceHash = HashStr8Fnv(defaultThemeFileContents);
 	
 	ScratchEnd(scratch);
-	TracyCZoneEnd(_funcZone);
+	ProfZoneEnd(_funcZone);
 	return true;
 }
 
@@ -295,18 +277,10 @@ FilePath GetAppSettingsSavePath(Arena* arena, bool addNullTerm)
 	ScratchEnd(scratch);
 	return result;
 }
+//NOTE: The write is deferred (see app_settings_writer.c), call FlushSettingsWriter if the settings need to be on disk right away
 void SaveAppSettings()
 {
-	ScratchBegin(scratch);
-	FilePath settingsFilePath = GetAppSettingsSavePath(scratch, false);
-	WriteLine_D("Saving settings...");
-	bool saveSuccess = TrySaveAppSettingsTo(&app->settings, settingsFilePath);
-	if (!saveSuccess)
-	{
-		NotifyPrint_E("Failed to save settings file! Make sure the folder has write permissions for the current user!\nPath: \"%.*s\"", StrPrint(settingsFilePath));
-		DebugAssert(saveSuccess);
-	}
-	ScratchEnd(scratch);
+	QueueSettingsWrite(&app->settingsWriter);
 }
 
 bool AppCreateFonts()
@@ -520,153 +494,6 @@ void LoadAppSettings()
 	ScratchEnd(scratch);
 }
 
-void FreeRecentFile(RecentFile* recentFile)
-{
-	NotNull(recentFile);
-	FreeStr8(stdHeap, &recentFile->path);
-	ClearPointer(recentFile);
-}
-
-void AppClearRecentFiles()
-{
-	VarArrayLoop(&app->recentFiles, rIndex)
-	{
-		VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
-		FreeRecentFile(recentFile);
-	}
-	VarArrayClear(&app->recentFiles);
-}
-
-void AppLoadRecentFilesList()
-{
-	ScratchBegin(scratch);
-	FilePath settingsFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), false);
-	FilePath savePath = PrintInArenaStr(scratch, "%.*s%s%s",
-		StrPrint(settingsFolderPath),
-		DoesPathHaveTrailingSlash(settingsFolderPath) ? "" : "/",
-		RECENT_FILES_SAVE_FILEPATH
-	);
-	
-	if (OsDoesFileExist(savePath))
-	{
-		Str8 fileContent = Str8_Empty;
-		if (OsReadTextFile(savePath, scratch, &fileContent))
-		{
-			AppClearRecentFiles();
-			LineParser parser = MakeLineParser(fileContent);
-			Str8 fileLine = ZEROED;
-			while (LineParserGetLine(&parser, &fileLine))
-			{
-				if (!IsEmptyStr(fileLine))
-				{
-					RecentFile* newFile = VarArrayAdd(RecentFile, &app->recentFiles);
-					NotNull(newFile);
-					newFile->path = AllocStr8(stdHeap, fileLine);
-					newFile->fileExists = OsDoesFileExist(newFile->path);
-				}
-			}
-			
-			PrintLine_D("Loaded %llu recent file%s from \"%.*s\"", app->recentFiles.length, Plural(app->recentFiles.length, "s"), StrPrint(savePath));
-			if (app->recentFilesWatchId == 0) { app->recentFilesWatchId = AddFileWatch(&app->fileWatches, savePath, CHECK_RECENT_FILES_WRITE_TIME_PERIOD); }
-			else { ClearFileWatchChanged(&app->fileWatches, app->recentFilesWatchId); }
-		}
-		else { PrintLine_W("No recent files save found at \"%.*s\"", StrPrint(savePath)); }
-	}
-	ScratchEnd(scratch);
-}
-
-void AppSaveRecentFilesList()
-{
-	ScratchBegin(scratch);
-	
-	FilePath settingsFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), true);
-	Result createSettingsFolderResult = OsCreateFolder(settingsFolderPath, true);
-	if (createSettingsFolderResult != Result_Success)
-	{
-		NotifyPrint_E("Failed to create settings folder at \"%.*s\": %s", StrPrint(settingsFolderPath), GetResultStr(createSettingsFolderResult));
-		return;
-	}
-	
-	FilePath savePath = PrintInArenaStr(scratch, "%.*s%s%s",
-		StrPrint(settingsFolderPath),
-		DoesPathHaveTrailingSlash(settingsFolderPath) ? "" : "/",
-		RECENT_FILES_SAVE_FILEPATH
-	);
-	
-	
-	OsFile fileHandle = ZEROED;
-	if (OsOpenFile(scratch, savePath, OsOpenFileMode_Write, false, &fileHandle))
-	{
-		VarArrayLoop(&app->recentFiles, rIndex)
-		{
-			VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
-			bool writeSuccess = OsWriteToOpenTextFile(&fileHandle, recentFile->path);
-			Assert(writeSuccess);
-			writeSuccess = OsWriteToOpenTextFile(&fileHandle, StrLit("\n"));
-			Assert(writeSuccess);
-		}
-		OsCloseFile(&fileHandle);
-		
-		if (app->recentFilesWatchId == 0)
-		{
-			app->recentFilesWatchId = AddFileWatch(&app->fileWatches, savePath, CHECK_RECENT_FILES_WRITE_TIME_PERIOD);
-		}
-		else
-		{
-			ClearFileWatchChanged(&app->fileWatches, app->recentFilesWatchId);
-		}
-	}
-	else { NotifyPrint_E("Failed to save recent files list to \"%.*s\"", StrPrint(savePath)); }
-	
-	ScratchEnd(scratch);
-}
-
-void AppRememberRecentFile(FilePath filePath)
-{
-	ScratchBegin(scratch);
-	Str8 fullPath = OsGetFullPath(scratch, filePath);
-	bool alreadyExists = false;
-	VarArrayLoop(&app->recentFiles, rIndex)
-	{
-		VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
-		if (StrAnyCaseEquals(recentFile->path, fullPath))
-		{
-			alreadyExists = true;
-			if (rIndex+1 < app->recentFiles.length)
-			{
-				//Move this path to the end of the array
-				RecentFile temp;
-				MyMemCopy(&temp, recentFile, sizeof(RecentFile));
-				VarArrayRemove(RecentFile, &app->recentFiles, recentFile);
-				RecentFile* newRecentFile = VarArrayAdd(RecentFile, &app->recentFiles);
-				MyMemCopy(newRecentFile, &temp, sizeof(RecentFile));
-				break;
-			}
-		}
-	}
-	
-	if (!alreadyExists)
-	{
-		RecentFile* newRecentFile = VarArrayAdd(RecentFile, &app->recentFiles);
-		NotNull(newRecentFile);
-		ClearPointer(newRecentFile);
-		newRecentFile->path = AllocStr8(stdHeap, fullPath);
-		newRecentFile->fileExists = true;
-		NotNull(newRecentFile->path.chars);
-		
-		while (app->recentFiles.length > RECENT_FILES_MAX_LENGTH)
-		{
-			RecentFile* firstFile = VarArrayGetFirst(RecentFile, &app->recentFiles);
-			FreeRecentFile(firstFile);
-			VarArrayRemoveFirst(RecentFile, &app->recentFiles);
-		}
-	}
-	
-	AppSaveRecentFilesList();
-	
-	ScratchEnd(scratch);
-}
-
 Str8 GetUniqueRecentFilePath(FilePath filePath)
 {
 	if (IsEmptyStr(filePath)) { return filePath; }
@@ -735,9 +562,11 @@ bool AppLoadUserTheme()
 		PrintLine_D("Loading user theme from \"%.*s\"", StrPrint(app->settings.userThemePath));
 		ThemeDefinition newUserTheme;
 		InitThemeDefinition(stdHeap, &newUserTheme, ThemeColor_Count);
-		Result parseResult = TryLoadThemeFile(app->settings.userThemePath, &newUserTheme);
+		u64 userThemeHash = 0;
+		Result parseResult = TryLoadThemeFile(app->settings.userThemePath, &newUserTheme, &userThemeHash);
 		if (parseResult == Result_Success)
 		{
+			app->userThemeSourceHash = userThemeHash;
 			FreeThemeDefinition(&app->userThemeOverrides);
 			MyMemCopy(&app->userThemeOverrides, &newUserTheme, sizeof(ThemeDefinition));
 			if (app->userThemeFileWatchId != 0) { RemoveFileWatch(&app->fileWatches, app->userThemeFileWatchId); }
@@ -769,30 +598,131 @@ bool AppLoadUserTheme()
 	return loadedSuccessfully;
 }
 
-void AppBakeTheme(bool clearUserThemeIfBakeFails)
+// +==============================+
+// |         Theme Cache          |
+// +==============================+
+FilePath GetThemeCachePath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = JoinStringsInArenaWithChar(arena, folderPath, '/', StrLit(THEME_CACHE_FILENAME), false);
+	ScratchEnd(scratch);
+	return result;
+}
+
+// Returns a pointer to the BakedTheme array following the header, or nullptr if the file is missing or doesn't match our current layout
+ThemeCacheHeader* TryReadThemeCache(Arena* arena, BakedTheme** bakedThemesOut)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath cachePath = GetThemeCachePath(scratch, false);
+	Slice cacheContents = Slice_Empty;
+	if (!OsDoesFileExist(cachePath) || !AppReadBinFile(cachePath, arena, &cacheContents)) { ScratchEnd(scratch); return nullptr; }
+	ScratchEnd(scratch);
+	if (cacheContents.length != sizeof(ThemeCacheHeader) + sizeof(BakedTheme)*ThemeMode_Count) { return nullptr; }
+	ThemeCacheHeader* header = (ThemeCacheHeader*)cacheContents.chars;
+	if (header->magic != THEME_CACHE_MAGIC || header->version != THEME_CACHE_VERSION || header->bakedThemeSize != sizeof(BakedTheme) || header->themeColorListHash != GetThemeColorListHash()) { return nullptr; }
+	SetOptionalOutPntr(bakedThemesOut, (BakedTheme*)(header + 1));
+	return header;
+}
+
+void AppSaveThemeCache(const BakedTheme* bakedThemes, u32 validModesMask, u64 userThemeHash)
+{
+	ScratchBegin(scratch);
+	uxx cacheSize = sizeof(ThemeCacheHeader) + sizeof(BakedTheme)*ThemeMode_Count;
+	ThemeCacheHeader* header = (ThemeCacheHeader*)AllocMem(scratch, cacheSize);
+	NotNull(header);
+	MyMemSet(header, 0x00, cacheSize);
+	header->magic = THEME_CACHE_MAGIC;
+	header->version = THEME_CACHE_VERSION;
+	header->bakedThemeSize = sizeof(BakedTheme);
+	header->validModesMask = validModesMask;
+	header->themeColorListHash = GetThemeColorListHash();
+	header->defaultThemeHash = app->defaultThemeSourceHash;
+	header->userThemeHash = userThemeHash;
+	MyMemCopy((BakedTheme*)(header + 1), bakedThemes, sizeof(BakedTheme)*ThemeMode_Count);
+	
+	//NOTE: The cache is only an optimization so we don't bother the user if this fails
+	if (!AppWriteBinFile(GetThemeCachePath(scratch, true), NewStr8(cacheSize, header))) { WriteLine_W("Failed to write theme cache file"); }
+	ScratchEnd(scratch);
+}
+
+// Checks the hashes of the default and user theme files against the cache and copies the BakedThemes directly into app->bakedThemes if they match.
+// Parsing the ThemeDefinitions is deferred until the next time AppBakeTheme is called (i.e. the theme mode changes or a theme file is edited)
+bool AppTryLoadThemeCache()
 {
+	ProfZoneBegin(_funcZone, "LoadThemeCache");
 	ScratchBegin(scratch);
+	BakedTheme* bakedThemes = nullptr;
+	ThemeCacheHeader* header = TryReadThemeCache(scratch, &bakedThemes);
+	if (header == nullptr || !IsFlagSet(header->validModesMask, (1u << app->currentThemeMode))) { ScratchEnd(scratch); ProfZoneEnd(_funcZone); return false; }
 	
-	ThemeDefinition combinedTheme = ZEROED;
-	bool haveUserThemeOverrides = (!IsEmptyStr(app->settings.userThemePath) && app->userThemeOverrides.arena != nullptr);
-	if (haveUserThemeOverrides)
+	Str8 defaultThemeFileContents = Str8_Empty;
+	if (TryReadAppResource(&app->resources, scratch, StrLit(DEFAULT_THEME_FILE_PATH), true, &defaultThemeFileContents) != Result_Success) { ScratchEnd(scratch); ProfZoneEnd(_funcZone); return false; }
+	u64 defaultThemeHash = HashStr8Fnv(defaultThemeFileContents);
+	u64 userThemeHash = 0;
+	if (!IsEmptyStr(app->settings.userThemePath))
 	{
-		InitThemeDefinition(scratch, &combinedTheme, MaxUXX(app->defaultTheme.entries.length, app->userThemeOverrides.entries.length));
-		CombineThemeDefinitions(&app->defaultTheme, &app->userThemeOverrides, &combinedTheme);
+		Str8 userThemeFileContents = Str8_Empty;
+		if (!AppReadTextFile(app->settings.userThemePath, scratch, &userThemeFileContents)) { ScratchEnd(scratch); ProfZoneEnd(_funcZone); return false; }
+		userThemeHash = HashStr8Fnv(userThemeFileContents);
 	}
-	else
+	if (header->defaultThemeHash != defaultThemeHash || header->userThemeHash != userThemeHash) { ScratchEnd(scratch); ProfZoneEnd(_funcZone); return false; }
+	
+	MyMemCopy(&app->bakedThemes[0], bakedThemes, sizeof(app->bakedThemes));
+	app->bakedThemeModesMask = (header->validModesMask & THEME_MODES_ALL_MASK);
+	app->theme = &app->bakedThemes[app->currentThemeMode];
+	app->defaultThemeSourceHash = defaultThemeHash;
+	app->userThemeSourceHash = userThemeHash;
+	app->themeDefinitionsDeferred = true;
+	#if !USE_EMBEDDED_RESOURCES_ZIP
+	if (app->defaultThemeFileWatchId == 0) { app->defaultThemeFileWatchId = AddFileWatch(&app->fileWatches, StrLit(DEFAULT_THEME_FILE_PATH), CHECK_DEFAULT_THEME_PERIOD); }
+	#endif
+	if (!IsEmptyStr(app->settings.userThemePath) && app->userThemeFileWatchId == 0)
 	{
-		MyMemCopy(&combinedTheme, &app->defaultTheme, sizeof(ThemeDefinition));
+		app->userThemeFileWatchId = AddFileWatch(&app->fileWatches, app->settings.userThemePath, CHECK_USER_THEME_PERIOD);
 	}
+	PrintLine_D("Loaded %s theme from cache", GetThemeModeStr(app->currentThemeMode));
 	
-	BakedTheme newBakedTheme = ZEROED;
-	Result bakeResult = BakeTheme(&combinedTheme, app->currentThemeMode, &newBakedTheme);
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+	return true;
+}
+
+void AppBakeTheme(bool clearUserThemeIfBakeFails)
+{
+	if (app->themeDefinitionsDeferred)
+	{
+		app->themeDefinitionsDeferred = false;
+		if (app->defaultTheme.arena == nullptr) { AppTryLoadDefaultTheme(false); }
+		if (app->userThemeOverrides.arena == nullptr) { AppLoadUserTheme(); }
+	}
+	
+	ProfZoneBegin(_funcZone, "AppBakeTheme");
+	ScratchBegin(scratch);
+	
+	//NOTE: The combined definition is kept in app->bakedThemeDef after a successful bake so it needs to be a deep copy, even when there are no user overrides
+	ThemeDefinition combinedTheme = ZEROED;
+	bool haveUserThemeOverrides = (!IsEmptyStr(app->settings.userThemePath) && app->userThemeOverrides.arena != nullptr);
+	InitThemeDefinition(stdHeap, &combinedTheme, app->defaultTheme.entries.length + (haveUserThemeOverrides ? app->userThemeOverrides.entries.length : 0));
+	CombineThemeDefinitions(&app->defaultTheme, haveUserThemeOverrides ? &app->userThemeOverrides : nullptr, &combinedTheme);
+	
+	BakedTheme* newBakedThemes = AllocArray(BakedTheme, scratch, ThemeMode_Count);
+	NotNull(newBakedThemes);
+	MyMemSet(newBakedThemes, 0x00, sizeof(BakedTheme) * ThemeMode_Count);
+	const ThemeDefinition* prevBakedDef = (app->bakedThemeDef.arena != nullptr) ? &app->bakedThemeDef : nullptr;
+	Result bakeResult = BakeThemeAllModes(&combinedTheme, prevBakedDef, newBakedThemes);
 	if (bakeResult == Result_Success)
 	{
-		MyMemCopy(&app->theme, &newBakedTheme, sizeof(BakedTheme));
+		FreeThemeDefinition(&app->bakedThemeDef);
+		MyMemCopy(&app->bakedThemeDef, &combinedTheme, sizeof(ThemeDefinition));
+		MyMemCopy(&app->bakedThemes[0], newBakedThemes, sizeof(app->bakedThemes));
+		app->bakedThemeModesMask = THEME_MODES_ALL_MASK;
+		app->theme = &app->bakedThemes[app->currentThemeMode];
+		AppSaveThemeCache(&app->bakedThemes[0], app->bakedThemeModesMask, haveUserThemeOverrides ? app->userThemeSourceHash : 0);
 	}
 	else
 	{
+		FreeThemeDefinition(&combinedTheme);
 		NotifyPrint_E("Failed to bake theme: %s", GetResultStr(bakeResult));
 		if (clearUserThemeIfBakeFails && haveUserThemeOverrides)
 		{
@@ -804,9 +734,22 @@ void AppBakeTheme(bool clearUserThemeIfBakeFails)
 	}
 	
 	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// Since every mode is baked together in AppBakeTheme, switching modes is usually just pointing app->theme at a different BakedTheme
+void AppSetThemeMode(ThemeMode mode)
+{
+	app->currentThemeMode = mode;
+	SetAppSettingStr8Pntr(&app->settings, &app->settings.themeMode, MakeStr8Nt(GetThemeModeStr(app->currentThemeMode)));
+	SaveAppSettings();
+	if (IsFlagSet(app->bakedThemeModesMask, ((u32)1 << mode))) { app->theme = &app->bakedThemes[mode]; }
+	else { AppBakeTheme(false); }
 }
 
 #if BUILD_WITH_PIG_UI
+bool IsOptionsFilterActive();
+
 void AppCalculateSmallButtonsGrid()
 {
 	UiElement* optionsListElem = GetUiElementByIdInPrevFrame(UiIdLit("OptionsList"), true);
@@ -819,7 +762,9 @@ void AppCalculateSmallButtonsGrid()
 	app->smallBtnNumColumns = FloorR32i((optionsAreaWidth - scaledMargin) / (buttonWidth + scaledMargin));
 	if (app->smallBtnNumColumns <= 0) { app->smallBtnNumColumns = 1; }
 	app->smallBtnWidth = FloorR32i((optionsAreaWidth - (SMALL_BTN_MARGIN * (app->smallBtnNumColumns-1))) / app->smallBtnNumColumns) / app->settings.uiScale;
-	u64 numOptions = (app->currentTab != nullptr) ? app->currentTab->fileOptions.length : 1;
+	//NOTE: visibleOptions was refreshed by UpdateOptionsFilter earlier in the frame (see GetNumVisibleOptions in app_tab.c)
+	u64 numOptions = 1;
+	if (app->currentTab != nullptr) { numOptions = IsOptionsFilterActive() ? app->visibleOptions.length : app->currentTab->fileOptions.length; }
 	app->smallBtnNumRows = CeilDivU64(numOptions, app->smallBtnNumColumns);
 }
 #endif //BUILD_WITH_PIG_UI
@@ -855,8 +800,7 @@ void AutoScrollToSelectedOptionAfterMove()
 		#elif BUILD_WITH_PIG_UI
 		UiElement* optionsListElem = GetUiElementByIdInPrevFrame(UiIdLit("OptionsList"), true);
 		FileOption* selectedOption = VarArrayGetHard(FileOption, &app->currentTab->fileOptions, (uxx)app->currentTab->selectedOptionIndex);
-		UiId btnId = UiIdStrIndex(selectedOption->name, (uxx)app->currentTab->selectedOptionIndex);
-		UiElement* optionBtnElem = GetUiElementByIdInPrevFrame(btnId, true);
+		UiElement* optionBtnElem = GetUiElementByIdInPrevFrame(selectedOption->btnId, true);
 		if (optionsListElem != nullptr && optionBtnElem != nullptr)
 		{
 			// r32 maxScroll = MaxR32(0, optionsListElem->contentSize.height - optionsListElem->layoutRec.height);
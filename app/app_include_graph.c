@@ -0,0 +1,695 @@
+/*
+File:   app_include_graph.c
+Description:
+	** The include graph estimates how expensive it is to touch a file: for every file in the folder that was last
+	** opened with Open Folder it counts how many translation units include it, directly or through other headers.
+	** The tabs show that count so you know a define lives in a header that half the project includes before you flip it.
+	** The #include lines themselves come from the usage index (see app_usage_index.c), which already reads every
+	** file in parallel during the folder scan and keeps them up to date as files change. Whenever its includes
+	** change (includesGeneration) a short-lived thread rebuilds the graph from those lines. Only the files whose
+	** #include lines changed get resolved again, the rest keep their edges from the last results, but the counts are
+	** always walked again since one edge can change many of them. Everything the thread needs is packed into
+	** jobStrings first so the usage index is free to keep changing while the thread works.
+	** Includes are resolved against the files we know about rather than the file system, first relative to the
+	** including file (for "quoted" includes) and then through the include directories. The include directories
+	** are the -I (and /I, -isystem, -iquote) arguments of every entry in compile_commands.json plus the root
+	** itself, and the result of searching them is cached per include name since most names are included many times.
+	** The translation units are the "file" entries of compile_commands.json, or every file with one of the
+	** INCLUDE_GRAPH_TU_EXTENSIONS if there isn't one. The CompileCommandsPath setting points at the json file,
+	** when it's empty we look for it in the root and root/build.
+	** NOTE: All entries share one set of include directories, which is close enough for an estimate
+*/
+
+// +--------------------------------------------------------------+
+// |                            Paths                             |
+// +--------------------------------------------------------------+
+// Forward slashes only, with "." and ".." segments collapsed. Paths are compared case-insensitively
+Str8 NormalizeIncludeGraphPath(Arena* arena, Str8 path)
+{
+	char* chars = (char*)AllocMem(arena, path.length+1);
+	NotNull(chars);
+	uxx length = 0;
+	if (path.length > 0 && (path.chars[0] == '/' || path.chars[0] == '\\')) { chars[length++] = '/'; }
+	uxx baseLength = length; //".." never removes the leading slash
+	uxx segmentStart = 0;
+	for (uxx cIndex = 0; cIndex <= path.length; cIndex++)
+	{
+		if (cIndex < path.length && path.chars[cIndex] != '/' && path.chars[cIndex] != '\\') { continue; }
+		Str8 segment = StrSlice(path, segmentStart, cIndex);
+		segmentStart = cIndex+1;
+		if (segment.length == 0 || StrExactEquals(segment, StrLit("."))) { continue; }
+		if (StrExactEquals(segment, StrLit("..")) && length > baseLength)
+		{
+			uxx lastSegmentStart = length;
+			while (lastSegmentStart > baseLength && chars[lastSegmentStart-1] != '/') { lastSegmentStart--; }
+			if (!StrExactEquals(NewStr8(length - lastSegmentStart, &chars[lastSegmentStart]), StrLit("..")))
+			{
+				length = (lastSegmentStart > baseLength) ? lastSegmentStart-1 : baseLength;
+				continue;
+			}
+		}
+		if (length > baseLength) { chars[length++] = '/'; }
+		MyMemCopy(&chars[length], segment.chars, segment.length);
+		length += segment.length;
+	}
+	return NewStr8(length, chars);
+}
+
+bool IsIncludeGraphPathAbsolute(Str8 path)
+{
+	if (path.length > 0 && (path.chars[0] == '/' || path.chars[0] == '\\')) { return true; }
+	return (path.length > 1 && path.chars[1] == ':');
+}
+
+Str8 JoinIncludeGraphPath(Arena* arena, Str8 folder, Str8 path)
+{
+	if (IsEmptyStr(folder) || IsIncludeGraphPathAbsolute(path)) { return NormalizeIncludeGraphPath(arena, path); }
+	ScratchBegin1(scratch, arena);
+	Str8 result = NormalizeIncludeGraphPath(arena, JoinStringsInArenaWithChar(scratch, folder, '/', path, false));
+	ScratchEnd(scratch);
+	return result;
+}
+
+// Returns the index of normalizedPath in results->paths, or -1
+ixx FindIncludeGraphPath(const IncludeGraphResults* results, Str8 normalizedPath)
+{
+	if (results->pathSlots.length == 0) { return -1; }
+	uxx slotMask = results->pathSlots.length-1;
+	uxx slotIndex = HashNameAnyCase(normalizedPath, 0) & slotMask;
+	for (uxx probe = 0; probe < results->pathSlots.length; probe++)
+	{
+		u32 slotValue = *VarArrayGetHard(u32, &results->pathSlots, slotIndex);
+		if (slotValue == 0) { return -1; }
+		if (StrAnyCaseEquals(*VarArrayGetHard(Str8, &results->paths, slotValue-1), normalizedPath)) { return (ixx)(slotValue-1); }
+		slotIndex = (slotIndex+1) & slotMask;
+	}
+	return -1;
+}
+
+bool IsIncludeGraphTuExtension(Str8 path)
+{
+	Str8 fileName = GetFileNamePart(path, true);
+	uxx periodIndex = fileName.length;
+	for (uxx cIndex = fileName.length; cIndex > 0; cIndex--) { if (fileName.chars[cIndex-1] == '.') { periodIndex = cIndex-1; break; } }
+	if (periodIndex >= fileName.length) { return false; }
+	Str8 extension = StrSliceFrom(fileName, periodIndex+1);
+	Str8 extensionList = StrLit(INCLUDE_GRAPH_TU_EXTENSIONS);
+	uxx partStart = 0;
+	for (uxx cIndex = 0; cIndex <= extensionList.length; cIndex++)
+	{
+		if (cIndex < extensionList.length && extensionList.chars[cIndex] != ';') { continue; }
+		if (StrAnyCaseEquals(StrSlice(extensionList, partStart, cIndex), extension)) { return true; }
+		partStart = cIndex+1;
+	}
+	return false;
+}
+
+// +--------------------------------------------------------------+
+// |                    compile_commands.json                     |
+// +--------------------------------------------------------------+
+// cIndex should be on the opening quote, it's left after the closing quote
+// Strings without escapes are sliced out of json, the rest only allocate as much as the string itself takes up
+Str8 ParseJsonStr(Arena* arena, Str8 json, uxx* cIndex)
+{
+	uxx startIndex = *cIndex + 1;
+	uxx endIndex = startIndex;
+	bool hasEscapes = false;
+	while (endIndex < json.length && json.chars[endIndex] != '"')
+	{
+		if (json.chars[endIndex] == '\\' && endIndex+1 < json.length) { hasEscapes = true; endIndex++; }
+		endIndex++;
+	}
+	*cIndex = endIndex+1;
+	if (!hasEscapes) { return StrSlice(json, startIndex, endIndex); }
+	
+	char* chars = (char*)AllocMem(arena, endIndex - startIndex);
+	NotNull(chars);
+	uxx length = 0;
+	for (uxx readIndex = startIndex; readIndex < endIndex; readIndex++)
+	{
+		char c = json.chars[readIndex];
+		if (c == '\\' && readIndex+1 < endIndex)
+		{
+			readIndex++;
+			char escapedChar = json.chars[readIndex];
+			if (escapedChar == 'n') { chars[length++] = '\n'; }
+			else if (escapedChar == 't') { chars[length++] = '\t'; }
+			else if (escapedChar == 'r') { chars[length++] = '\r'; }
+			else if (escapedChar == 'u') { chars[length++] = '?'; readIndex += MinUXX(4, endIndex - readIndex - 1); } //paths don't need unicode escapes to be exact
+			else { chars[length++] = escapedChar; } // \" \\ \/
+		}
+		else { chars[length++] = c; }
+	}
+	return NewStr8(length, chars);
+}
+
+// Splits the "command" form of an entry into arguments. Double quotes group and \" is a literal quote
+// Arguments without quotes are sliced out of command, the rest only allocate as much as the argument itself takes up
+void SplitCompileCommand(Arena* arena, Str8 command, VarArray* argumentsOut)
+{
+	uxx cIndex = 0;
+	while (cIndex < command.length)
+	{
+		while (cIndex < command.length && IsCharWhitespace(command.chars[cIndex], true)) { cIndex++; }
+		if (cIndex >= command.length) { break; }
+		uxx startIndex = cIndex;
+		bool hasQuotes = false;
+		bool inQuotes = false;
+		while (cIndex < command.length && (inQuotes || !IsCharWhitespace(command.chars[cIndex], true)))
+		{
+			char c = command.chars[cIndex];
+			if (c == '\\' && cIndex+1 < command.length && command.chars[cIndex+1] == '"') { hasQuotes = true; cIndex += 2; }
+			else if (c == '"') { hasQuotes = true; inQuotes = !inQuotes; cIndex++; }
+			else { cIndex++; }
+		}
+		if (!hasQuotes) { *VarArrayAdd(Str8, argumentsOut) = StrSlice(command, startIndex, cIndex); continue; }
+		
+		char* chars = (char*)AllocMem(arena, cIndex - startIndex);
+		NotNull(chars);
+		uxx length = 0;
+		for (uxx readIndex = startIndex; readIndex < cIndex; )
+		{
+			char c = command.chars[readIndex];
+			if (c == '\\' && readIndex+1 < cIndex && command.chars[readIndex+1] == '"') { chars[length++] = '"'; readIndex += 2; }
+			else if (c == '"') { readIndex++; }
+			else { chars[length++] = c; readIndex++; }
+		}
+		*VarArrayAdd(Str8, argumentsOut) = NewStr8(length, chars);
+	}
+}
+
+void AddCompileCommandsEntry(Arena* arena, Str8 directory, Str8 file, Str8 command, VarArray* arguments, VarArray* tuPathsOut, VarArray* includeDirsOut)
+{
+	if (IsEmptyStr(file)) { return; }
+	*VarArrayAdd(Str8, tuPathsOut) = JoinIncludeGraphPath(arena, directory, file);
+	if (arguments->length == 0 && !IsEmptyStr(command)) { SplitCompileCommand(arena, command, arguments); }
+	
+	Str8 separateFlags[] = { StrLit("-I"), StrLit("/I"), StrLit("-isystem"), StrLit("-iquote") };
+	VarArrayLoop(arguments, aIndex)
+	{
+		VarArrayLoopGet(Str8, argument, arguments, aIndex);
+		Str8 includeDir = Str8_Empty;
+		for (uxx fIndex = 0; fIndex < ArrayCount(separateFlags); fIndex++)
+		{
+			if (StrExactEquals(*argument, separateFlags[fIndex]))
+			{
+				if (aIndex+1 < arguments->length) { includeDir = *VarArrayGetHard(Str8, arguments, aIndex+1); aIndex++; }
+				break;
+			}
+			else if (StrExactStartsWith(*argument, separateFlags[fIndex]))
+			{
+				includeDir = StrSliceFrom(*argument, separateFlags[fIndex].length);
+				break;
+			}
+		}
+		if (IsEmptyStr(includeDir)) { continue; }
+		
+		Str8 fullIncludeDir = JoinIncludeGraphPath(arena, directory, includeDir);
+		bool alreadyAdded = false;
+		VarArrayLoop(includeDirsOut, dIndex)
+		{
+			VarArrayLoopGet(Str8, existingDir, includeDirsOut, dIndex);
+			if (StrAnyCaseEquals(*existingDir, fullIncludeDir)) { alreadyAdded = true; break; }
+		}
+		if (!alreadyAdded) { *VarArrayAdd(Str8, includeDirsOut) = fullIncludeDir; }
+	}
+}
+
+// Only understands as much JSON as compile_commands.json uses: an array of flat objects whose values are strings or arrays of strings
+void ParseCompileCommands(Arena* arena, Str8 json, VarArray* tuPathsOut, VarArray* includeDirsOut)
+{
+	uxx depth = 0;
+	bool expectingValue = false;
+	Str8 key = Str8_Empty;
+	Str8 directory = Str8_Empty;
+	Str8 file = Str8_Empty;
+	Str8 command = Str8_Empty;
+	VarArray arguments;
+	InitVarArray(Str8, &arguments, arena);
+	uxx cIndex = 0;
+	while (cIndex < json.length)
+	{
+		char c = json.chars[cIndex];
+		if (c == '{')
+		{
+			depth++;
+			if (depth == 2)
+			{
+				directory = Str8_Empty;
+				file = Str8_Empty;
+				command = Str8_Empty;
+				VarArrayClear(&arguments);
+			}
+			expectingValue = false;
+			cIndex++;
+		}
+		else if (c == '}')
+		{
+			if (depth == 2) { AddCompileCommandsEntry(arena, directory, file, command, &arguments, tuPathsOut, includeDirsOut); }
+			if (depth > 0) { depth--; }
+			expectingValue = false;
+			cIndex++;
+		}
+		else if (c == '[') { depth++; cIndex++; }
+		else if (c == ']') { if (depth > 0) { depth--; } expectingValue = false; cIndex++; }
+		else if (c == ':') { expectingValue = true; cIndex++; }
+		else if (c == ',') { expectingValue = false; cIndex++; }
+		else if (c == '"')
+		{
+			Str8 str = ParseJsonStr(arena, json, &cIndex);
+			if (depth == 2 && !expectingValue) { key = str; }
+			else if (depth == 2)
+			{
+				if (StrExactEquals(key, StrLit("directory"))) { directory = str; }
+				else if (StrExactEquals(key, StrLit("file"))) { file = str; }
+				else if (StrExactEquals(key, StrLit("command"))) { command = str; }
+				expectingValue = false;
+			}
+			else if (depth == 3 && StrExactEquals(key, StrLit("arguments"))) { *VarArrayAdd(Str8, &arguments) = str; }
+		}
+		else { cIndex++; }
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                             Job                              |
+// +--------------------------------------------------------------+
+void FreeIncludeGraphResults(IncludeGraph* graph, IncludeGraphResults* results)
+{
+	NotNull(graph);
+	NotNull(results);
+	FreeStr8(&graph->jobHeap, &results->pathChars);
+	FreeVarArray(&results->paths);
+	FreeVarArray(&results->pathSlots);
+	FreeVarArray(&results->tuCounts);
+	FreeVarArray(&results->includesHashes);
+	FreeVarArray(&results->edgeStarts);
+	FreeVarArray(&results->edges);
+	ClearPointer(results);
+}
+
+typedef plex IncludeSearchCacheEntry IncludeSearchCacheEntry;
+plex IncludeSearchCacheEntry
+{
+	Str8 name;
+	ixx fileIndex; //-1 if the name wasn't found in any include directory
+};
+
+// Folds one string hash into a running hash, the same way HashStr8Fnv folds in each byte
+u64 MixIncludeGraphHash(u64 hash, u64 valueHash)
+{
+	return (hash ^ valueHash) * 0x00000100000001B3ULL;
+}
+
+// Fills graph->jobResults from the job* inputs. This is run on the worker thread, or directly if the thread failed to start
+void DoIncludeGraphJob(IncludeGraph* graph)
+{
+	NotNull(graph);
+	ProfZoneBeginEx(_funcZone, "DoIncludeGraphJob", ProfilerCategory_Job);
+	ScratchBegin(scratch);
+	IncludeGraphResults* results = &graph->jobResults;
+	uxx numFiles = graph->jobFiles.length;
+	
+	// +==============================+
+	// |        Path Hash Table       |
+	// +==============================+
+	Str8* normalizedPaths = AllocArray(Str8, scratch, MaxUXX(numFiles, 1));
+	uxx totalPathLength = 0;
+	VarArrayLoop(&graph->jobFiles, fIndex)
+	{
+		VarArrayLoopGet(IncludeGraphJobFile, jobFile, &graph->jobFiles, fIndex);
+		normalizedPaths[fIndex] = NormalizeIncludeGraphPath(scratch, jobFile->path);
+		totalPathLength += normalizedPaths[fIndex].length;
+	}
+	results->pathChars.length = totalPathLength;
+	results->pathChars.chars = (char*)AllocMem(&graph->jobHeap, MaxUXX(totalPathLength, 1));
+	NotNull(results->pathChars.chars);
+	InitVarArrayWithInitial(Str8, &results->paths, &graph->jobHeap, numFiles);
+	uxx pathCharsIndex = 0;
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++)
+	{
+		MyMemCopy(&results->pathChars.chars[pathCharsIndex], normalizedPaths[fIndex].chars, normalizedPaths[fIndex].length);
+		*VarArrayAdd(Str8, &results->paths) = NewStr8(normalizedPaths[fIndex].length, &results->pathChars.chars[pathCharsIndex]);
+		pathCharsIndex += normalizedPaths[fIndex].length;
+	}
+	uxx numSlots = 16;
+	while (numSlots < numFiles*2) { numSlots *= 2; }
+	InitVarArrayWithInitial(u32, &results->pathSlots, &graph->jobHeap, numSlots);
+	u32* pathSlots = VarArrayAddMulti(u32, &results->pathSlots, numSlots);
+	NotNull(pathSlots);
+	MyMemSet(pathSlots, 0x00, sizeof(u32) * numSlots);
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++)
+	{
+		Str8 path = *VarArrayGetHard(Str8, &results->paths, fIndex);
+		if (FindIncludeGraphPath(results, path) >= 0) { continue; }
+		uxx slotIndex = HashNameAnyCase(path, 0) & (numSlots-1);
+		while (pathSlots[slotIndex] != 0) { slotIndex = (slotIndex+1) & (numSlots-1); }
+		pathSlots[slotIndex] = (u32)(fIndex+1);
+	}
+	
+	// +==============================+
+	// |  Include Dirs and TU List    |
+	// +==============================+
+	VarArray tuPaths;
+	InitVarArray(Str8, &tuPaths, scratch);
+	VarArray includeDirs;
+	InitVarArray(Str8, &includeDirs, scratch);
+	Str8 rootPath = NormalizeIncludeGraphPath(scratch, graph->jobRootPath);
+	FilePath compileCommandsPaths[] = {
+		graph->jobCompileCommandsPath,
+		JoinStringsInArenaWithChar(scratch, rootPath, '/', StrLit(COMPILE_COMMANDS_FILENAME), false),
+		JoinStringsInArenaWithChar(scratch, rootPath, '/', StrLit("build/" COMPILE_COMMANDS_FILENAME), false),
+	};
+	for (uxx pIndex = 0; pIndex < ArrayCount(compileCommandsPaths); pIndex++)
+	{
+		if (IsEmptyStr(compileCommandsPaths[pIndex])) { continue; }
+		Str8 json = Str8_Empty;
+		if (AppReadTextFile(compileCommandsPaths[pIndex], scratch, &json))
+		{
+			ParseCompileCommands(scratch, json, &tuPaths, &includeDirs);
+			break;
+		}
+		if (pIndex == 0) { break; } //the setting was given, don't go looking somewhere else
+	}
+	*VarArrayAdd(Str8, &includeDirs) = rootPath;
+	
+	//NOTE: Edges only depend on the file list, the include directories and the file's own #include lines.
+	// If the first two haven't changed since the last results then files whose #include lines also haven't changed
+	// keep their old edges and only the files that changed (usually just the one that was saved) are resolved again.
+	// graph->results isn't touched by the main thread until this job finishes so it's safe to read here
+	results->layoutHash = 0xCBF29CE484222325ULL;
+	for (uxx fIndex = 0; fIndex < numFiles; fIndex++) { results->layoutHash = MixIncludeGraphHash(results->layoutHash, HashStr8FnvAnyCase(normalizedPaths[fIndex])); }
+	VarArrayLoop(&includeDirs, dIndex) { results->layoutHash = MixIncludeGraphHash(results->layoutHash, HashStr8Fnv(*VarArrayGetHard(Str8, &includeDirs, dIndex))); }
+	const IncludeGraphResults* prevResults = &graph->results;
+	bool canReuseEdges = (graph->hasResults && prevResults->layoutHash == results->layoutHash && prevResults->paths.length == numFiles && prevResults->edgeStarts.length == numFiles+1);
+	
+	bool* isTranslationUnit = AllocArray(bool, scratch, MaxUXX(numFiles, 1));
+	MyMemSet(isTranslationUnit, 0x00, sizeof(bool) * MaxUXX(numFiles, 1));
+	results->usedCompileCommands = (tuPaths.length > 0);
+	if (results->usedCompileCommands)
+	{
+		VarArrayLoop(&tuPaths, tIndex)
+		{
+			VarArrayLoopGet(Str8, tuPath, &tuPaths, tIndex);
+			ixx fileIndex = FindIncludeGraphPath(results, *tuPath);
+			if (fileIndex >= 0) { isTranslationUnit[fileIndex] = true; }
+		}
+	}
+	else
+	{
+		for (uxx fIndex = 0; fIndex < numFiles; fIndex++) { isTranslationUnit[fIndex] = IsIncludeGraphTuExtension(normalizedPaths[fIndex]); }
+	}
+	
+	// +==============================+
+	// |        Resolve Edges         |
+	// +==============================+
+	uxx numIncludes = graph->jobIncludes.length;
+	u32* edgeStarts = AllocArray(u32, scratch, numFiles+1);
+	u32* edges = AllocArray(u32, scratch, MaxUXX(numIncludes, 1));
+	uxx numCacheSlots = 16;
+	while (numCacheSlots < numIncludes*2) { numCacheSlots *= 2; }
+	u32* cacheSlots = AllocArray(u32, scratch, numCacheSlots);
+	MyMemSet(cacheSlots, 0x00, sizeof(u32) * numCacheSlots);
+	IncludeSearchCacheEntry* cacheEntries = AllocArray(IncludeSearchCacheEntry, scratch, MaxUXX(numIncludes, 1));
+	uxx numCacheEntries = 0;
+	uxx numCacheHits = 0;
+	uxx numEdges = 0;
+	uxx numReusedFiles = 0;
+	InitVarArrayWithInitial(u64, &results->includesHashes, &graph->jobHeap, numFiles);
+	VarArrayLoop(&graph->jobFiles, fIndex)
+	{
+		VarArrayLoopGet(IncludeGraphJobFile, jobFile, &graph->jobFiles, fIndex);
+		edgeStarts[fIndex] = (u32)numEdges;
+		u64 includesHash = 0xCBF29CE484222325ULL;
+		for (uxx iIndex = jobFile->firstInclude; iIndex < jobFile->firstInclude + jobFile->numIncludes; iIndex++)
+		{
+			includesHash = MixIncludeGraphHash(includesHash, HashStr8Fnv(*VarArrayGetHard(Str8, &graph->jobIncludes, iIndex)));
+		}
+		*VarArrayAdd(u64, &results->includesHashes) = includesHash;
+		u32 prevEdgeStart = canReuseEdges ? *VarArrayGetHard(u32, &prevResults->edgeStarts, fIndex) : 0;
+		u32 prevEdgeEnd = canReuseEdges ? *VarArrayGetHard(u32, &prevResults->edgeStarts, fIndex+1) : 0;
+		if (canReuseEdges && *VarArrayGetHard(u64, &prevResults->includesHashes, fIndex) == includesHash && prevEdgeEnd - prevEdgeStart <= jobFile->numIncludes)
+		{
+			for (u32 eIndex = prevEdgeStart; eIndex < prevEdgeEnd; eIndex++) { edges[numEdges++] = *VarArrayGetHard(u32, &prevResults->edges, eIndex); }
+			numReusedFiles++;
+			continue;
+		}
+		Str8 folderPath = normalizedPaths[fIndex];
+		while (folderPath.length > 0 && folderPath.chars[folderPath.length-1] != '/') { folderPath.length--; }
+		for (uxx iIndex = jobFile->firstInclude; iIndex < jobFile->firstInclude + jobFile->numIncludes; iIndex++)
+		{
+			Str8 include = *VarArrayGetHard(Str8, &graph->jobIncludes, iIndex);
+			bool isAngle = (include.chars[0] == '<');
+			Str8 name = StrSliceFrom(include, 1);
+			ixx targetIndex = -1;
+			uxx scratchMark = ArenaGetMark(scratch);
+			if (!isAngle) { targetIndex = FindIncludeGraphPath(results, JoinIncludeGraphPath(scratch, folderPath, name)); }
+			ArenaResetToMark(scratch, scratchMark);
+			if (targetIndex < 0)
+			{
+				u32 nameHash = (u32)HashStr8Fnv(name);
+				uxx cacheSlot = nameHash & (numCacheSlots-1);
+				while (cacheSlots[cacheSlot] != 0 && !StrExactEquals(cacheEntries[cacheSlots[cacheSlot]-1].name, name)) { cacheSlot = (cacheSlot+1) & (numCacheSlots-1); }
+				if (cacheSlots[cacheSlot] != 0) { targetIndex = cacheEntries[cacheSlots[cacheSlot]-1].fileIndex; numCacheHits++; }
+				else
+				{
+					VarArrayLoop(&includeDirs, dIndex)
+					{
+						VarArrayLoopGet(Str8, includeDir, &includeDirs, dIndex);
+						uxx dirScratchMark = ArenaGetMark(scratch);
+						targetIndex = FindIncludeGraphPath(results, JoinIncludeGraphPath(scratch, *includeDir, name));
+						ArenaResetToMark(scratch, dirScratchMark);
+						if (targetIndex >= 0) { break; }
+					}
+					cacheEntries[numCacheEntries].name = name;
+					cacheEntries[numCacheEntries].fileIndex = targetIndex;
+					numCacheEntries++;
+					cacheSlots[cacheSlot] = (u32)numCacheEntries;
+				}
+			}
+			if (targetIndex >= 0 && (uxx)targetIndex != fIndex) { edges[numEdges++] = (u32)targetIndex; }
+		}
+	}
+	edgeStarts[numFiles] = (u32)numEdges;
+	InitVarArrayWithInitial(u32, &results->edgeStarts, &graph->jobHeap, numFiles+1);
+	MyMemCopy(VarArrayAddMulti(u32, &results->edgeStarts, numFiles+1), edgeStarts, sizeof(u32) * (numFiles+1));
+	InitVarArrayWithInitial(u32, &results->edges, &graph->jobHeap, MaxUXX(numEdges, 1));
+	if (numEdges > 0) { MyMemCopy(VarArrayAddMulti(u32, &results->edges, numEdges), edges, sizeof(u32) * numEdges); }
+	
+	// +==============================+
+	// |       Count Includers        |
+	// +==============================+
+	//NOTE: Each translation unit does a walk of everything it includes, visitStamps keeps us from counting a file twice for one TU
+	InitVarArrayWithInitial(u32, &results->tuCounts, &graph->jobHeap, numFiles);
+	u32* tuCounts = VarArrayAddMulti(u32, &results->tuCounts, numFiles);
+	u32* visitStamps = AllocArray(u32, scratch, MaxUXX(numFiles, 1));
+	u32* stack = AllocArray(u32, scratch, MaxUXX(numFiles, 1));
+	if (numFiles > 0)
+	{
+		MyMemSet(tuCounts, 0x00, sizeof(u32) * numFiles);
+		MyMemSet(visitStamps, 0x00, sizeof(u32) * numFiles);
+	}
+	for (uxx tIndex = 0; tIndex < numFiles; tIndex++)
+	{
+		if (!isTranslationUnit[tIndex]) { continue; }
+		results->numTranslationUnits++;
+		u32 stamp = (u32)(tIndex+1);
+		uxx stackSize = 0;
+		stack[stackSize++] = (u32)tIndex;
+		visitStamps[tIndex] = stamp;
+		while (stackSize > 0)
+		{
+			u32 fileIndex = stack[--stackSize];
+			tuCounts[fileIndex]++;
+			for (u32 eIndex = edgeStarts[fileIndex]; eIndex < edgeStarts[fileIndex+1]; eIndex++)
+			{
+				if (visitStamps[edges[eIndex]] != stamp)
+				{
+					visitStamps[edges[eIndex]] = stamp;
+					stack[stackSize++] = edges[eIndex];
+				}
+			}
+		}
+	}
+	
+	PrintLine_D("Include graph: %llu files (%llu kept their edges), %llu edges, %llu translation units, %llu include dirs, %llu/%llu header searches cached",
+		(u64)numFiles, (u64)numReusedFiles, (u64)numEdges, (u64)results->numTranslationUnits, (u64)includeDirs.length, (u64)numCacheHits, (u64)(numCacheHits + numCacheEntries)
+	);
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// +==============================+
+// |    IncludeGraphThreadMain    |
+// +==============================+
+// DWORD IncludeGraphThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(IncludeGraphThreadMain)
+{
+	NotNull(contextPntr);
+	IncludeGraph* graph = (IncludeGraph*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	DoIncludeGraphJob(graph);
+	AtomicWrite(&graph->isWorking, false);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+// +--------------------------------------------------------------+
+// |                            Graph                             |
+// +--------------------------------------------------------------+
+void InitIncludeGraph(Arena* arena, IncludeGraph* graphOut)
+{
+	NotNull(arena);
+	NotNull(graphOut);
+	ClearPointer(graphOut);
+	graphOut->arena = arena;
+	InitArenaStdHeap(&graphOut->jobHeap);
+	InitVarArray(IncludeGraphJobFile, &graphOut->jobFiles, arena);
+	InitVarArray(Str8, &graphOut->jobIncludes, arena);
+}
+
+// Returns true if new results were applied. If wait is true we block until the thread is done
+bool FinishIncludeGraphJob(IncludeGraph* graph, bool wait)
+{
+	NotNull(graph);
+	if (!graph->hasJob) { return false; }
+	if (wait)
+	{
+		ProfZoneBegin(Zone_WaitForIncludeGraph, "WaitForIncludeGraph");
+		while (AtomicRead(&graph->isWorking)) { OsSleepMs(1); }
+		ProfZoneEnd(Zone_WaitForIncludeGraph);
+	}
+	if (AtomicRead(&graph->isWorking)) { return false; }
+	if (graph->thread.isFilled)
+	{
+		OsCloseThread(&graph->thread);
+		ClearStruct(graph->thread);
+	}
+	graph->hasJob = false;
+	
+	FreeIncludeGraphResults(graph, &graph->results);
+	graph->results = graph->jobResults;
+	ClearStruct(graph->jobResults);
+	graph->hasResults = true;
+	graph->resultsGeneration = graph->jobGeneration;
+	FreeStr8(graph->arena, &graph->jobStrings);
+	VarArrayClear(&graph->jobFiles);
+	VarArrayClear(&graph->jobIncludes);
+	return true;
+}
+
+void FreeIncludeGraph(IncludeGraph* graph)
+{
+	NotNull(graph);
+	if (graph->arena != nullptr)
+	{
+		FinishIncludeGraphJob(graph, true);
+		FreeIncludeGraphResults(graph, &graph->results);
+		FreeVarArray(&graph->jobFiles);
+		FreeVarArray(&graph->jobIncludes);
+	}
+	ClearPointer(graph);
+}
+
+void StartIncludeGraphJob(IncludeGraph* graph, const UsageIndex* index)
+{
+	NotNull(graph);
+	NotNull(index);
+	if (graph->hasJob) { return; }
+	ProfZoneBegin(_funcZone, "StartIncludeGraphJob");
+	
+	//NOTE: Everything is copied into one allocation since the usage index can change while the thread is working
+	uxx totalLength = index->rootPath.length + app->settings.compileCommandsPath.length;
+	VarArrayLoop(&index->files, fIndex)
+	{
+		VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+		totalLength += file->path.length;
+		VarArrayLoop(&file->includes, iIndex) { totalLength += VarArrayGetHard(Str8, &file->includes, iIndex)->length; }
+	}
+	graph->jobStrings.length = totalLength;
+	graph->jobStrings.chars = (char*)AllocMem(graph->arena, MaxUXX(totalLength, 1));
+	NotNull(graph->jobStrings.chars);
+	uxx stringsIndex = 0;
+	#define CopyIntoJobStrings(str) (MyMemCopy(&graph->jobStrings.chars[stringsIndex], (str).chars, (str).length), stringsIndex += (str).length, NewStr8((str).length, &graph->jobStrings.chars[stringsIndex - (str).length]))
+	graph->jobRootPath = CopyIntoJobStrings(index->rootPath);
+	graph->jobCompileCommandsPath = CopyIntoJobStrings(app->settings.compileCommandsPath);
+	VarArrayExpand(&graph->jobFiles, index->files.length);
+	VarArrayLoop(&index->files, fIndex)
+	{
+		VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+		IncludeGraphJobFile* jobFile = VarArrayAdd(IncludeGraphJobFile, &graph->jobFiles);
+		NotNull(jobFile);
+		jobFile->path = CopyIntoJobStrings(file->path);
+		jobFile->firstInclude = graph->jobIncludes.length;
+		jobFile->numIncludes = file->includes.length;
+		VarArrayLoop(&file->includes, iIndex)
+		{
+			VarArrayLoopGet(Str8, include, &file->includes, iIndex);
+			*VarArrayAdd(Str8, &graph->jobIncludes) = CopyIntoJobStrings(*include);
+		}
+	}
+	#undef CopyIntoJobStrings
+	Assert(stringsIndex == totalLength);
+	
+	graph->hasJob = true;
+	graph->jobGeneration = index->includesGeneration;
+	ClearStruct(graph->jobResults);
+	AtomicWrite(&graph->isWorking, true);
+	graph->thread = OsCreateThread(IncludeGraphThreadMain, graph, true);
+	if (!graph->thread.isFilled)
+	{
+		WriteLine_W("Failed to start include graph thread! Building it on the main thread");
+		DoIncludeGraphJob(graph);
+		AtomicWrite(&graph->isWorking, false);
+	}
+	ProfZoneEnd(_funcZone);
+}
+
+// Called once a frame. Returns true if new counts are available
+bool UpdateIncludeGraph(IncludeGraph* graph, const UsageIndex* index)
+{
+	NotNull(graph);
+	NotNull(index);
+	if (graph->arena == nullptr) { return false; }
+	if (graph->hasJob) { return FinishIncludeGraphJob(graph, false); }
+	if (index->isBuilding || index->files.length == 0) { return false; }
+	if (!graph->hasResults || graph->resultsGeneration != index->includesGeneration) { StartIncludeGraphJob(graph, index); }
+	return false;
+}
+
+// Returns false if the file isn't part of the graph (or there is no graph yet)
+// The tab's path is made absolute and normalized the first time it's looked up and kept in tab->includeGraphPath
+bool GetIncludeGraphTuCount(const IncludeGraph* graph, FileTab* tab, uxx* countOut)
+{
+	NotNull(graph);
+	NotNull(tab);
+	if (!graph->hasResults || graph->results.numTranslationUnits == 0) { return false; }
+	if (IsEmptyStr(tab->includeGraphPath))
+	{
+		ScratchBegin(scratch);
+		FilePath fullPath = OsGetFullPath(scratch, tab->filePath);
+		tab->includeGraphPath = AllocStr8(stdHeap, NormalizeIncludeGraphPath(scratch, fullPath));
+		ScratchEnd(scratch);
+	}
+	ixx fileIndex = FindIncludeGraphPath(&graph->results, tab->includeGraphPath);
+	if (fileIndex < 0) { return false; }
+	SetOptionalOutPntr(countOut, (uxx)*VarArrayGetHard(u32, &graph->results.tuCounts, (uxx)fileIndex));
+	return true;
+}
+
+Str8 GetIncludeGraphTuCountStr(Arena* arena, const IncludeGraph* graph, FileTab* tab)
+{
+	uxx count = 0;
+	if (!GetIncludeGraphTuCount(graph, tab, &count)) { return Str8_Empty; }
+	return PrintInArenaStr(arena, "%llu/%llu TU%s", (u64)count, (u64)graph->results.numTranslationUnits, Plural(graph->results.numTranslationUnits, "s"));
+}
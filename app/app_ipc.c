@@ -0,0 +1,262 @@
+/*
+File:   app_ipc.c
+Description:
+	** Answers requests that other processes send over the single instance pipe/socket (see
+	** platform_single_instance.c for the transport). Every request is a few lines of text and the
+	** answer always starts with "ok" or "error [reason]". The commands are:
+	**   tabs                    lists the open tabs as "tab [index] [path]" lines
+	**   options [path]          lists the options in an open file as "option [name] on/off bool/define" lines
+	**   set [name] on/off [path]
+	**   toggle [name] [path]    any number of these can be sent in one request, if any line is bad nothing is changed
+	** All the changes in a request are written as one transaction, the same one presets use (see CommitPresetFileChanges),
+	** so each file is written once and a failed write leaves every file as it was. The open tabs are updated right away.
+	** Subscribers are sent "changed", "opened", "closed" and "reloaded" events as they happen.
+*/
+
+bool IsIpcOptionEnabled(const FileOption* option)
+{
+	return (option->type == FileOptionType_Bool) ? option->valueBool : option->isUncommented;
+}
+
+// Splits off the next space separated word. Whatever is left (trimmed) stays in restInOut, which is how paths with spaces get through
+Str8 SplitIpcWord(Str8* restInOut)
+{
+	Str8 rest = TrimWhitespace(*restInOut);
+	uxx wordEnd = 0;
+	while (wordEnd < rest.length && rest.chars[wordEnd] != ' ' && rest.chars[wordEnd] != '\t') { wordEnd++; }
+	*restInOut = TrimWhitespace(StrSliceFrom(rest, wordEnd));
+	return StrSlice(rest, 0, wordEnd);
+}
+
+Str8 MakeIpcError(Arena* arena, Str8 reason)
+{
+	return PrintInArenaStr(arena, "error %.*s\n\n", StrPrint(reason));
+}
+
+// +--------------------------------------------------------------+
+// |                            Events                            |
+// +--------------------------------------------------------------+
+void AppPublishIpcEvent(Str8 kind, Str8 details, FilePath filePath)
+{
+	ScratchBegin(scratch);
+	Str8 eventStr = IsEmptyStr(details)
+		? PrintInArenaStr(scratch, "%.*s %.*s", StrPrint(kind), StrPrint(filePath))
+		: PrintInArenaStr(scratch, "%.*s %.*s %.*s", StrPrint(kind), StrPrint(details), StrPrint(filePath));
+	platform->PublishIpcEvent(eventStr);
+	ScratchEnd(scratch);
+}
+
+void AppPublishOptionChanged(FileTab* tab, FileOption* option)
+{
+	ScratchBegin(scratch);
+	Str8 details = PrintInArenaStr(scratch, "%.*s %s", StrPrint(option->name), IsIpcOptionEnabled(option) ? "on" : "off");
+	AppPublishIpcEvent(StrLit("changed"), details, tab->filePath);
+	ScratchEnd(scratch);
+}
+
+// +--------------------------------------------------------------+
+// |                           Commands                           |
+// +--------------------------------------------------------------+
+Str8 HandleIpcTabsCommand(Arena* arena)
+{
+	TwoPassStr8Loop(result, arena, false)
+	{
+		TwoPassStrNt(&result, "ok\n");
+		VarArrayLoop(&app->tabs, tIndex)
+		{
+			VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+			TwoPassPrint(&result, "tab %llu %.*s\n", (u64)tIndex, StrPrint(tab->filePath));
+		}
+		TwoPassStrNt(&result, "\n");
+		TwoPassStr8LoopEnd(&result);
+	}
+	return result.str;
+}
+
+Str8 HandleIpcOptionsCommand(Arena* arena, FilePath filePath)
+{
+	FileTab* tab = AppFindTabForPath(filePath);
+	if (tab == nullptr) { return MakeIpcError(arena, StrLit("file is not open")); }
+	if (tab->isFromSnapshot) { return MakeIpcError(arena, StrLit("file is still loading")); }
+	TwoPassStr8Loop(result, arena, false)
+	{
+		TwoPassStrNt(&result, "ok\n");
+		VarArrayLoop(&tab->fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+			if (option->type != FileOptionType_Bool && option->type != FileOptionType_CommentDefine) { continue; }
+			TwoPassPrint(&result, "option %.*s %s %s\n",
+				StrPrint(option->name),
+				IsIpcOptionEnabled(option) ? "on" : "off",
+				(option->type == FileOptionType_Bool) ? "bool" : "define"
+			);
+		}
+		TwoPassStrNt(&result, "\n");
+		TwoPassStr8LoopEnd(&result);
+	}
+	return result.str;
+}
+
+// Every line is validated before anything is changed, so a typo on the last line doesn't leave half the options set
+Str8 HandleIpcChangeCommands(Arena* arena, Str8 message)
+{
+	ScratchBegin1(scratch, arena);
+	VarArray changes;
+	InitVarArray(IpcOptionChange, &changes, scratch);
+	
+	uxx lineIndex = 0;
+	LineParser lineParser = MakeLineParser(message);
+	Str8 line = Str8_Empty;
+	while (LineParserGetLine(&lineParser, &line))
+	{
+		line = TrimWhitespace(line);
+		if (IsEmptyStr(line)) { continue; }
+		lineIndex++;
+		
+		Str8 rest = line;
+		Str8 command = SplitIpcWord(&rest);
+		Str8 optionName = SplitIpcWord(&rest);
+		IpcOptionChange change = ZEROED;
+		change.optionName = optionName;
+		if (StrExactEquals(command, StrLit("toggle"))) { change.toggle = true; }
+		else if (StrExactEquals(command, StrLit("set")))
+		{
+			Str8 valueStr = SplitIpcWord(&rest);
+			if (StrExactEquals(valueStr, StrLit("on"))) { change.enabled = true; }
+			else if (StrExactEquals(valueStr, StrLit("off"))) { change.enabled = false; }
+			else { Str8 result = MakeIpcError(arena, ScratchPrintStr("line %llu: expected on or off, not \"%.*s\"", (u64)lineIndex, StrPrint(valueStr))); ScratchEnd(scratch); return result; }
+		}
+		else { Str8 result = MakeIpcError(arena, ScratchPrintStr("line %llu: unknown command \"%.*s\"", (u64)lineIndex, StrPrint(command))); ScratchEnd(scratch); return result; }
+		
+		if (IsEmptyStr(optionName) || IsEmptyStr(rest)) { Str8 result = MakeIpcError(arena, ScratchPrintStr("line %llu: expected an option name and a file path", (u64)lineIndex)); ScratchEnd(scratch); return result; }
+		change.tab = AppFindTabForPath(rest);
+		if (change.tab == nullptr) { Str8 result = MakeIpcError(arena, ScratchPrintStr("line %llu: file is not open", (u64)lineIndex)); ScratchEnd(scratch); return result; }
+		if (change.tab->isFromSnapshot) { Str8 result = MakeIpcError(arena, ScratchPrintStr("line %llu: file is still loading", (u64)lineIndex)); ScratchEnd(scratch); return result; }
+		
+		bool foundOption = false;
+		VarArrayLoop(&change.tab->fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &change.tab->fileOptions, oIndex);
+			if (StrExactEquals(option->name, optionName) && (option->type == FileOptionType_Bool || option->type == FileOptionType_CommentDefine)) { foundOption = true; break; }
+		}
+		if (!foundOption) { Str8 result = MakeIpcError(arena, ScratchPrintStr("line %llu: no option named \"%.*s\"", (u64)lineIndex, StrPrint(optionName))); ScratchEnd(scratch); return result; }
+		
+		IpcOptionChange* newChange = VarArrayAdd(IpcOptionChange, &changes);
+		NotNull(newChange);
+		*newChange = change;
+	}
+	if (changes.length == 0) { ScratchEnd(scratch); return MakeIpcError(arena, StrLit("empty request")); }
+	
+	// +==============================+
+	// |   Calculate New Contents     |
+	// +==============================+
+	VarArray fileChanges;
+	InitVarArray(PresetFileChange, &fileChanges, scratch);
+	VarArray changedOptions; //IpcOptionChange, one for each option that actually changes, for the "changed" events
+	InitVarArray(IpcOptionChange, &changedOptions, scratch);
+	uxx numChangedOptions = 0;
+	VarArrayLoop(&changes, cIndex)
+	{
+		//NOTE: Every file is handled once, by the first line that names it
+		FileTab* tab = VarArrayGetHard(IpcOptionChange, &changes, cIndex)->tab;
+		bool isFirstChangeForTab = true;
+		for (uxx prevIndex = 0; prevIndex < cIndex; prevIndex++)
+		{
+			if (VarArrayGetHard(IpcOptionChange, &changes, prevIndex)->tab == tab) { isFirstChangeForTab = false; break; }
+		}
+		if (!isFirstChangeForTab) { continue; }
+		
+		VarArray fileOptions;
+		InitVarArray(FileOption, &fileOptions, scratch);
+		ParseFileOptions(scratch, tab->fileContents, &fileOptions);
+		Str8* newValues = AllocArray(Str8, scratch, MaxUXX(fileOptions.length, 1));
+		NotNull(newValues);
+		uxx numChangedInFile = 0;
+		VarArrayLoop(&fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &fileOptions, oIndex);
+			newValues[oIndex] = StrSlice(tab->fileContents, option->fileContentsStartIndex, option->fileContentsEndIndex);
+			if (option->type != FileOptionType_Bool && option->type != FileOptionType_CommentDefine) { continue; }
+			//NOTE: The lines apply in order, so toggling the same option twice leaves it alone
+			bool enabled = IsIpcOptionEnabled(option);
+			for (uxx otherIndex = cIndex; otherIndex < changes.length; otherIndex++)
+			{
+				IpcOptionChange* change = VarArrayGetHard(IpcOptionChange, &changes, otherIndex);
+				if (change->tab != tab || !StrExactEquals(change->optionName, option->name)) { continue; }
+				enabled = change->toggle ? !enabled : change->enabled;
+			}
+			if (!GetOptionNewValueStr(option, enabled, &newValues[oIndex])) { continue; }
+			numChangedInFile++;
+			IpcOptionChange* changedOption = VarArrayAdd(IpcOptionChange, &changedOptions);
+			NotNull(changedOption);
+			ClearPointer(changedOption);
+			changedOption->tab = tab;
+			changedOption->optionName = AllocStr8(scratch, option->name); //tab->fileContents is replaced before we publish
+		}
+		if (numChangedInFile == 0) { continue; }
+		
+		Str8 newContents = ReplaceFileOptionValues(scratch, tab->fileContents, &fileOptions, newValues);
+		AddPresetFileChange(scratch, &fileChanges, OsGetFullPath(scratch, tab->filePath), tab->fileContents, newContents, numChangedInFile);
+		numChangedOptions += numChangedInFile;
+	}
+	
+	// +==============================+
+	// |       Write and Publish      |
+	// +==============================+
+	if (fileChanges.length > 0)
+	{
+		if (!CommitPresetFileChanges(&fileChanges, StrLit("changes from another process")))
+		{
+			Str8 result = MakeIpcError(arena, StrLit("couldn't write the files, nothing was changed"));
+			ScratchEnd(scratch);
+			return result;
+		}
+		ApplyPresetFileChangesToTabs(&fileChanges, false);
+		VarArrayLoop(&changedOptions, cIndex)
+		{
+			VarArrayLoopGet(IpcOptionChange, changedOption, &changedOptions, cIndex);
+			VarArrayLoop(&changedOption->tab->fileOptions, oIndex)
+			{
+				VarArrayLoopGet(FileOption, option, &changedOption->tab->fileOptions, oIndex);
+				if (StrExactEquals(option->name, changedOption->optionName)) { AppPublishOptionChanged(changedOption->tab, option); break; }
+			}
+		}
+	}
+	
+	ScratchEnd(scratch);
+	return PrintInArenaStr(arena, "ok\nchanged %llu\n\n", (u64)numChangedOptions);
+}
+
+// +--------------------------------------------------------------+
+// |                           Requests                           |
+// +--------------------------------------------------------------+
+Str8 HandleIpcRequest(Arena* arena, Str8 message)
+{
+	Str8 firstLine = TrimWhitespace(StrSlice(message, 0, MinUXX(StrExactFind(message, StrLit("\n")), message.length)));
+	Str8 rest = firstLine;
+	Str8 command = SplitIpcWord(&rest);
+	if (StrExactEquals(command, StrLit("tabs"))) { return HandleIpcTabsCommand(arena); }
+	else if (StrExactEquals(command, StrLit("options")))
+	{
+		if (IsEmptyStr(rest)) { return MakeIpcError(arena, StrLit("expected a file path")); }
+		return HandleIpcOptionsCommand(arena, rest);
+	}
+	else if (StrExactEquals(command, StrLit("set")) || StrExactEquals(command, StrLit("toggle"))) { return HandleIpcChangeCommands(arena, message); }
+	else { return MakeIpcError(arena, ScratchPrintStr("unknown command \"%.*s\"", StrPrint(command))); }
+}
+
+// Called every frame. Returns true if we answered anything (which may have changed what's on screen)
+bool AppHandleIpcRequests()
+{
+	bool handledAny = false;
+	IpcRequest* request = nullptr;
+	while ((request = platform->PopIpcRequest()) != nullptr)
+	{
+		ScratchBegin(scratch);
+		Str8 response = HandleIpcRequest(scratch, request->message);
+		platform->FinishIpcRequest(request, response);
+		ScratchEnd(scratch);
+		handledAny = true;
+	}
+	return handledAny;
+}
@@ -35,7 +35,11 @@ Description:
 // +--------------------------------------------------------------+
 // |                         Header Files                         |
 // +--------------------------------------------------------------+
+#include "wake_signal.h"
 #include "platform_interface.h"
+#include "app_hash.h"
+#include "app_name_table.h"
+#include "app_fuzzy.h"
 #include "app_commands.h"
 #include "app_bindings.h"
 #include "app_theme_funcs.h"
@@ -63,6 +67,8 @@ static Arena* stdHeap = nullptr;
 // |                         Source Files                         |
 // +--------------------------------------------------------------+
 #include "main2d_shader.glsl.h"
+#include "app_profiler.c"
+#include "app_memory_stats.c"
 #include "app_input.c"
 #include "app_resources.c"
 #include "app_file_watch.c"
@@ -73,13 +79,26 @@ static Arena* stdHeap = nullptr;
 #include "app_textbox.c"
 #include "app_popup_dialog.c"
 #include "app_bindings.c"
+#include "app_settings_writer.c"
+#include "app_recent_files.c"
 #include "app_helpers.c"
+#include "app_conditionals.c"
 #include "app_tab.c"
+#include "app_parse_cache.c"
+#include "app_session.c"
+#include "app_usage_index.c"
+#include "app_include_graph.c"
+#include "app_define_resolver.c"
+#include "app_presets.c"
+#include "app_ipc.c"
 #include "app_clay_widgets.c"
 #include "app_ui_renderer.c"
 #include "app_ui_widgets.c"
+#include "app_command_palette.c"
+#include "app_folder_scan.c"
 #include "app_commands.c"
 #include "app_ui.c"
+#include "app_startup.c"
 
 // +==============================+
 // |         TestWorkItem         |
@@ -144,9 +163,9 @@ OS_THREAD_FUNC_DEF(TestThreadMain)
 	
 	
 	#if SCRATCH_ARENAS_THREAD_LOCAL
-	TracyCZoneN(Zone_ScratchInit, "ScratchInit", true);
+	ProfZoneBegin(Zone_ScratchInit, "ScratchInit");
 	InitScratchArenasVirtual(Gigabytes(4));
-	TracyCZoneEnd(Zone_ScratchInit);
+	ProfZoneEnd(Zone_ScratchInit);
 	#endif
 	
 	ScratchBegin(scratch);
@@ -155,19 +174,21 @@ OS_THREAD_FUNC_DEF(TestThreadMain)
 	{
 		LockMutexBlockWithTracyZone(&app->testMutex, TIMEOUT_FOREVER, Zone_LockMutex, "LockMutex")
 		{
-			TracyCZoneN(Zone_DebugOutput, "DebugOutput", true);
+			ProfZoneBegin(Zone_DebugOutput, "DebugOutput");
 			DbgLevel level = (DbgLevel)GetRandU32Range(&random, 1, DbgLevel_Count);
 			PrintLineAt(level, "This is a %s level threaded output!", GetDbgLevelStr(level));
-			TracyCZoneEnd(Zone_DebugOutput);
+			ProfZoneEnd(Zone_DebugOutput);
 		}
 		
-		TracyCZoneN(Zone_Sleep, "Sleep", true);
+		ProfZoneBegin(Zone_Sleep, "Sleep");
 		OsSleepMs(1000);
-		TracyCZoneEnd(Zone_Sleep);
+		ProfZoneEnd(Zone_Sleep);
 	}
 	ScratchEnd(scratch);
 	
+	ReleaseProfilerThread();
 	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
 	FreeScratchArenasVirtual();
 	#endif
 	
@@ -323,7 +344,7 @@ v2i GetSheetFrameForKey(Key key, bool isPressed, i32* imageWidth, bool* isWideKe
 // void* AppInit(PlatformInfo* inPlatformInfo, PlatformApi* inPlatformApi)
 EXPORT_FUNC APP_INIT_DEF(AppInit)
 {
-	TracyCZoneN(_funcZone, "AppInit", true);
+	ProfZoneBegin(_funcZone, "AppInit");
 	#if !BUILD_INTO_SINGLE_UNIT
 	InitScratchArenasVirtual(Gigabytes(4));
 	#endif
@@ -334,6 +355,8 @@ EXPORT_FUNC APP_INIT_DEF(AppInit)
 	AppData* appData = AllocType(AppData, inPlatformInfo->platformStdHeap);
 	ClearPointer(appData);
 	UpdateDllGlobals(inPlatformInfo, inPlatformApi, (void*)appData, nullptr, nullptr);
+	InitProfiler(stdHeap, &app->profiler);
+	InitMemoryStats(&app->memoryStats);
 	
 	#if THREAD_POOL_TEST
 	InitThreadPool(stdHeap, StrLit("TestThreadPool"), true, true, Gigabytes(4), &app->threadPool);
@@ -346,32 +369,19 @@ EXPORT_FUNC APP_INIT_DEF(AppInit)
 	InitNotificationQueue(stdHeap, &app->notificationQueue);
 	
 	InitAppResources(&app->resources);
-	LoadNotificationIcons();
+	StartAppStartup(&app->startup); //the worker tasks only need app->resources, they run while we do everything below
 	
+	InitAppNameTables();
 	InitAppSettings(stdHeap, &app->settings);
-	LoadAppSettings();
+	InitSettingsWriter(stdHeap, GetAppSettingsSavePath(scratch, false), &app->settingsWriter);
 	
 	platform->SetWindowTitle(StrLit(PROJECT_READABLE_NAME_STR));
-	LoadWindowIcon();
-	
-	LoadAppIcons();
 	
 	InitRandomSeriesDefault(&app->random);
 	SeedRandomSeriesU64(&app->random, OsGetCurrentTimestamp(false));
 	
 	InitPerfGraph(&app->perfGraph, 1000.0f/60.0f); //TODO: How do we know the target framerate?
 	
-	InitCompiledShader(&app->mainShader, stdHeap, main2d);
-	
-	#if BUILD_WITH_CLAY
-	InitClayUIRenderer(stdHeap, V2_Zero, &app->clay);
-	AttachTooltipRegistryToUIRenderer(&app->clay, &app->tooltips);
-	app->clayUiFontId = AddClayUIRendererFont(&app->clay, &app->uiFont, UI_FONT_STYLE);
-	app->clayMainFontId = AddClayUIRendererFont(&app->clay, &app->mainFont, MAIN_FONT_STYLE);
-	#elif BUILD_WITH_PIG_UI
-	InitUiContext(stdHeap, &app->ui);
-	#endif //BUILD_WITH_CLAY
-	
 	app->usingKeyboardToSelect = false;
 	
 	#if BUILD_WITH_CLAY
@@ -387,53 +397,27 @@ EXPORT_FUNC APP_INIT_DEF(AppInit)
 	
 	InitFileWatches(&app->fileWatches);
 	InitVarArray(FileTab, &app->tabs, stdHeap);
+	InitEditableText(stdHeap, OPTIONS_FILTER_MAX_LENGTH, &app->optionsFilter);
+	InitVarArray(uxx, &app->visibleOptions, stdHeap);
 	
 	InitAppBindingSet(stdHeap, &app->bindings);
-	AppTryLoadBindings(true);
-	
 	InitThemeDefFuncArgInfos();
-	AppTryLoadDefaultTheme(true);
-	AppLoadUserTheme();
-	if (!TryParseThemeMode(app->settings.themeMode, &app->currentThemeMode))
-	{
-		NotifyPrint_W("Unknown theme mode in settings file: \"%.*s\"\nDefaulting to Dark Mode", StrPrint(app->settings.themeMode));
-		app->currentThemeMode = ThemeMode_Dark;
-		SetAppSettingStr8Pntr(&app->settings, &app->settings.themeMode, MakeStr8Nt(GetThemeModeStr(app->currentThemeMode)));
-		SaveAppSettings();
-	}
-	AppBakeTheme(true);
 	
 	InitVarArray(RecentFile, &app->recentFiles, stdHeap);
-	AppLoadRecentFilesList();
-	
-	bool wasCmdPathGiven = false;
-	//NOTE: Not really sure if we need to handle multiple argument paths being passed.
-	// I guess if the first one fails doesn't point to a real file we can
-	// open secondary one(s) but that really isn't super intuitive behavior
-	uxx argIndex = 0;
-	Str8 pathArgument = GetNamelessProgramArg(platformInfo->programArgs, argIndex);
-	while (!IsEmptyStr(pathArgument))
-	{
-		wasCmdPathGiven = true;
-		if (OsDoesFileExist(pathArgument))
-		{
-			FileTab* newTab = AppOpenFileTab(pathArgument);
-			if (newTab != nullptr) { break; }
-		}
-		else
-		{
-			NotifyPrint_E("Command line path does not point to a file: \"%.*s\"", StrPrint(pathArgument));
-		}
-		
-		argIndex++;
-		pathArgument = GetNamelessProgramArg(platformInfo->programArgs, argIndex);
-	}
+	InitRecentFilesWorker(stdHeap, &app->recentFilesWorker);
+	InitVarArray(Preset, &app->presets, stdHeap);
+	app->queuedPresetIndex = UINTXX_MAX;
+	InitCommandPalette(stdHeap, &app->palette);
+	InitSessionVerifier(stdHeap, &app->sessionVerifier);
+	InitParseCache(stdHeap, &app->parseCache);
+	InitFolderScan(stdHeap, &app->folderScan);
+	InitUsageIndex(stdHeap, &app->usageIndex);
+	InitIncludeGraph(stdHeap, &app->includeGraph);
+	InitDefineResolver(stdHeap, &app->defineResolver);
 	
-	if (!wasCmdPathGiven && app->recentFiles.length > 0)
-	{
-		RecentFile* mostRecentFile = VarArrayGetLast(RecentFile, &app->recentFiles);
-		AppOpenFileTab(mostRecentFile->path);
-	}
+	//NOTE: Settings (which bakes the fonts), the theme and the renderer are all the first frame needs.
+	// The rest of the startup tasks run in the first few AppUpdate calls (see UpdateAppStartup)
+	RunAppStartupTasks(&app->startup, true);
 	
 	#if 0
 	INITCOMMONCONTROLSEX commonControls = ZEROED;
@@ -450,7 +434,7 @@ EXPORT_FUNC APP_INIT_DEF(AppInit)
 	ScratchEnd(scratch);
 	ScratchEnd(scratch2);
 	ScratchEnd(scratch3);
-	TracyCZoneEnd(_funcZone);
+	ProfZoneEnd(_funcZone);
 	return (void*)app;
 }
 
@@ -468,6 +452,14 @@ EXPORT_FUNC APP_BEFORE_RELOAD_DEF(AppBeforeReload)
 	
 	WriteLine_W("App is preparing for DLL reload...");
 	//TODO: Anything that needs to be saved before the DLL reload should be done here
+	JoinAppStartupThreads(&app->startup); //the startup threads' code lives in this dll
+	FlushSettingsWriter(&app->settingsWriter, &app->settings); //the writer thread's code lives in this dll
+	FlushRecentFilesWorker(&app->recentFilesWorker);
+	FinishSessionVerifier(&app->sessionVerifier, true);
+	StopFolderScan(&app->folderScan); //the worker threads' code lives in this dll
+	StopUsageIndexThread(&app->usageIndex); //the worker thread's code lives in this dll
+	FinishIncludeGraphJob(&app->includeGraph, true);
+	FinishDefineResolverJob(&app->defineResolver, true);
 	
 	ScratchEnd(scratch);
 	ScratchEnd(scratch2);
@@ -488,7 +480,9 @@ EXPORT_FUNC APP_AFTER_RELOAD_DEF(AppAfterReload)
 	
 	WriteLine_I("New app DLL was loaded!");
 	app->shouldRenderAfterReload = true;
+	InitAppNameTables();
 	InitThemeDefFuncArgInfos();
+	app->paletteIndexGeneration++; //command palette items point at AppCommand names in the old dll
 	
 	ScratchEnd(scratch);
 	ScratchEnd(scratch2);
@@ -506,20 +500,41 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	ScratchBegin1(scratch2, scratch);
 	ScratchBegin2(scratch3, scratch, scratch2);
 	UpdateDllGlobals(inPlatformInfo, inPlatformApi, memoryPntr, input, inputHandling);
-	TracyCZoneN(_funcZone, "AppUpdate", true);
+	UpdateProfiler(&app->profiler);
+	UpdateMemoryStats(&app->memoryStats);
+	ProfZoneBegin(_funcZone, "AppUpdate");
 	#if BUILD_WITH_PIG_UI
 	SetUiContext(&app->ui);
 	#endif
 	
+	// +==============================+
+	// |       Finish Startup         |
+	// +==============================+
+	//NOTE: Until every startup task has run we only show the background, so the window isn't blank while the icons and first file load
+	if (!UpdateAppStartup(&app->startup))
+	{
+		QueueStartupPaths(&app->startup, &appIn->droppedFilePaths, &appIn->forwardedPaths);
+		BeginFrame(platform->GetSokolSwapchain(), appIn->screenSize, GetThemeColor(OptionListBack), 1.0f);
+		EndFrame();
+		#if BUILD_WITH_PIG_UI
+		SetUiContext(nullptr);
+		#endif
+		ScratchEnd(scratch);
+		ScratchEnd(scratch2);
+		ScratchEnd(scratch3);
+		ProfZoneEnd(_funcZone);
+		return true;
+	}
+	
 	if (app->testThread.isFilled)
 	{
-		TracyCZoneN(Zone_LockTestMutex, "LockMutex", true);
+		ProfZoneBegin(Zone_LockTestMutex, "LockMutex");
 		bool lockSuccess = LockMutex(&app->testMutex, TIMEOUT_FOREVER);
 		Assert(lockSuccess);
-		TracyCZoneEnd(Zone_LockTestMutex);
+		ProfZoneEnd(Zone_LockTestMutex);
 	}
 	
-	TracyCZoneN(Zone_Update, "Update", true);
+	ProfZoneBegin(Zone_Update, "Update");
 	app->notificationQueue.currentProgramTime = appIn->programTime;
 	UpdateFileWatches(&app->fileWatches);
 	UpdatePopupDialog(&app->popup);
@@ -529,7 +544,7 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 		UpdatePerfGraph(&app->perfGraph, fullUpdateMs, ((r32)appIn->unclampedElapsedMsR64 - fullUpdateMs));
 	}
 	
-	bool refreshScreen = (app->sleepingDisabled || app->showPerfGraph);
+	bool refreshScreen = (app->sleepingDisabled || app->showPerfGraph || app->showMemoryStats);
 	
 	// +==============================+
 	// |  Handle Finished WorkItems   |
@@ -546,13 +561,42 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	// +==============================+
 	// |     Handle Dropped Files     |
 	// +==============================+
-	VarArrayLoop(&appIn->droppedFilePaths, pIndex)
+	//NOTE: The queued paths arrived while startup was still running, they go first so everything is opened in the order it came in
+	const VarArray* droppedPathLists[] = { &app->startup.queuedDroppedPaths, &appIn->droppedFilePaths };
+	for (uxx lIndex = 0; lIndex < ArrayCount(droppedPathLists); lIndex++)
+	{
+		VarArrayLoop(droppedPathLists[lIndex], pIndex)
+		{
+			VarArrayLoopGet(Str8, droppedFilePath, droppedPathLists[lIndex], pIndex);
+			PrintLine_I("Dropped file: \"%.*s\"", StrPrint(*droppedFilePath));
+			if (OsDoesFolderExist(*droppedFilePath)) { StartFolderScan(&app->folderScan, *droppedFilePath); }
+			else { AppOpenFileTab(*droppedFilePath); }
+			refreshScreen = true;
+		}
+	}
+	
+	// +==============================+
+	// |    Handle Forwarded Paths    |
+	// +==============================+
+	const VarArray* forwardedPathLists[] = { &app->startup.queuedForwardedPaths, &appIn->forwardedPaths };
+	for (uxx lIndex = 0; lIndex < ArrayCount(forwardedPathLists); lIndex++)
 	{
-		VarArrayLoopGet(Str8, droppedFilePath, &appIn->droppedFilePaths, pIndex);
-		PrintLine_I("Dropped file: \"%.*s\"", StrPrint(*droppedFilePath));
-		AppOpenFileTab(*droppedFilePath);
-		refreshScreen = true;
+		VarArrayLoop(forwardedPathLists[lIndex], pIndex)
+		{
+			VarArrayLoopGet(Str8, forwardedPath, forwardedPathLists[lIndex], pIndex);
+			PrintLine_I("Forwarded path: \"%.*s\"", StrPrint(*forwardedPath));
+			if (OsDoesFolderExist(*forwardedPath)) { StartFolderScan(&app->folderScan, *forwardedPath); }
+			else if (OsDoesFileExist(*forwardedPath)) { AppOpenFileTab(*forwardedPath); }
+			else { NotifyPrint_E("Command line path does not point to a file or folder: \"%.*s\"", StrPrint(*forwardedPath)); }
+			refreshScreen = true;
+		}
 	}
+	FreeStartupQueuedPaths(&app->startup);
+	
+	// +==============================+
+	// |     Handle IPC Requests      |
+	// +==============================+
+	if (AppHandleIpcRequests()) { refreshScreen = true; }
 	
 	// +==============================+
 	// |   Handle Open File Dialog    |
@@ -575,6 +619,11 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 						AppBakeTheme(true);
 					}
 				}
+				else if (app->openFileDialogIsForFolder)
+				{
+					//NOTE: The dialog can only pick files, so we scan the folder that the chosen file lives in
+					StartFolderScan(&app->folderScan, GetFileFolderPart(app->openFileDialog.chosenFilePath));
+				}
 				else
 				{
 					AppOpenFileTab(app->openFileDialog.chosenFilePath);
@@ -587,11 +636,19 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 		}
 	}
 	
+	UpdateSettingsWriter(&app->settingsWriter, &app->settings);
+	UpdateRecentFilesWorker(&app->recentFilesWorker);
+	
 	// +====================================+
 	// | Determine if Screen Needs Refresh  |
 	// +====================================+
 	//NOTE: We will early out inside this block if we don't need to re-render the screen!
 	{
+		if (UpdateSessionVerifier(&app->sessionVerifier)) { refreshScreen = true; }
+		if (UpdateFolderScan(&app->folderScan)) { refreshScreen = true; }
+		if (UpdateUsageIndex(&app->usageIndex, &app->fileWatches)) { refreshScreen = true; }
+		if (UpdateIncludeGraph(&app->includeGraph, &app->usageIndex)) { refreshScreen = true; }
+		if (UpdateDefineResolver(&app->defineResolver)) { refreshScreen = true; }
 		if (AppCheckForFileChanges()) { refreshScreen = true; }
 		if (app->wasClayScrollingPrevFrame) { refreshScreen = true; }
 		#if BUILD_WITH_CLAY
@@ -605,6 +662,12 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 			AppLoadRecentFilesList();
 			refreshScreen = true;
 		}
+		if (app->presetsWatchId != 0 && HasFileWatchChangedWithDelay(&app->fileWatches, app->presetsWatchId, PRESETS_RELOAD_DELAY))
+		{
+			ClearFileWatchChanged(&app->fileWatches, app->presetsWatchId);
+			AppLoadPresets();
+			refreshScreen = true;
+		}
 		#if !USE_EMBEDDED_RESOURCES_ZIP
 		if (app->defaultThemeFileWatchId != 0 && HasFileWatchChangedWithDelay(&app->fileWatches, app->defaultThemeFileWatchId, DEFAULT_THEME_RELOAD_DELAY))
 		{
@@ -636,6 +699,7 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 		if (appIn->isFullscreenChanged || appIn->isMinimizedChanged || appIn->isFocusedChanged || appIn->screenSizeChanged) { refreshScreen = true; }
 		if (appIn->mouse.scrollDelta.x != 0 || appIn->mouse.scrollDelta.y != 0) { refreshScreen = true; }
 		if (app->shouldRenderAfterReload) { refreshScreen = true; app->shouldRenderAfterReload = false; }
+		if (app->queuedPresetIndex != UINTXX_MAX) { refreshScreen = true; }
 		
 		if (refreshScreen) { app->numFramesConsecutivelyRendered = 0; }
 		else { app->numFramesConsecutivelyRendered++; }
@@ -647,16 +711,16 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 			#endif
 			if (app->testThread.isFilled)
 			{
-				TracyCZoneN(Zone_UnlockTestMutex, "UnlockMutex", true);
+				ProfZoneBegin(Zone_UnlockTestMutex, "UnlockMutex");
 				UnlockMutex(&app->testMutex);
-				TracyCZoneEnd(Zone_UnlockTestMutex);
+				ProfZoneEnd(Zone_UnlockTestMutex);
 			}
 			ScratchEnd(scratch);
 			ScratchEnd(scratch2);
 			ScratchEnd(scratch3);
 			app->renderedLastFrame = false;
-			TracyCZoneEnd(Zone_Update);
-			TracyCZoneEnd(_funcZone);
+			ProfZoneEnd(Zone_Update);
+			ProfZoneEnd(_funcZone);
 			return false;
 		}
 	}
@@ -698,7 +762,7 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 			POINT mouseScreenPos = { mousePosi.x, mousePosi.y };
 		    ClientToScreen(windowHandle, &mouseScreenPos);
 		    PrintLine_D("Mouse Global Coordinates: (%d, %d)", mouseScreenPos.x, mouseScreenPos.y);
-		    
+			
 			app->tooltipWindowHandle = CreateWindowEx(
 				WS_EX_TOPMOST, TOOLTIPS_CLASS,
 				NULL,
@@ -718,7 +782,7 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 			app->tooltipInfo.lpszText = (LPSTR)AllocAndCopyCharsNt(stdHeap, "Hello Windows!", true);
 			// app->tooltipInfo.rect = (RECT){ .left = mouseScreenPos.x, .top = mouseScreenPos.y, .right = mouseScreenPos.x+1, .bottom = mouseScreenPos.y+1 };
 			// app->tooltipInfo.rect = (RECT){ 0, 0, 0, 0 };
-		    
+			
 			LRESULT addToolResult = SendMessageA(app->tooltipWindowHandle, TTM_ADDTOOL, 0, (LPARAM)&app->tooltipInfo);
 			if (addToolResult != TRUE) { DWORD errorCode = GetLastError(); PrintLine_D("SendMessage(TTM_ADDTOOL) failed: %s %d", Win32_GetErrorCodeStr(errorCode), errorCode); }
 			// SendMessage(app->tooltipWindowHandle, TTM_SETTITLE, 0, 0);
@@ -811,17 +875,18 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	// |   Debug Only Test Hotkeys    |
 	// +==============================+
 	#if DEBUG_BUILD
-	if (WasKeyComboPressed(ModifierKey_None, Key_N, true))
+	bool isTypingText = (app->palette.isOpen || app->folderScan.isOpen || app->optionsFilter.isFocused);
+	if (!isTypingText && WasKeyComboPressed(ModifierKey_None, Key_N, true))
 	{
 		DbgLevel level = (DbgLevel)GetRandU32Range(&app->random, 1, DbgLevel_Count);
 		AddNotificationToQueue(&app->notificationQueue, level, ScratchPrintStr("%s notification is here!", GetDbgLevelStr(level)));
 	}
-	if (WasKeyComboPressed(ModifierKey_None, Key_D, true))
+	if (!isTypingText && WasKeyComboPressed(ModifierKey_None, Key_D, true))
 	{
 		DbgLevel level = (DbgLevel)GetRandU32Range(&app->random, 1, DbgLevel_Count);
 		PrintLineAt(level, "This is a %s level output!", GetDbgLevelStr(level));
 	}
-	if (WasKeyComboPressed(ModifierKey_None, Key_T, true))
+	if (!isTypingText && WasKeyComboPressed(ModifierKey_None, Key_T, true))
 	{
 		ThreadId threadId = OsGetCurrentThreadId();
 		Str8 threadName = GetStandardPeopleFirstName((u64)threadId);
@@ -847,10 +912,24 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	}
 	#endif //DEBUG_BUILD
 	
+	// +==============================+
+	// |    Update Command Palette    |
+	// +==============================+
+	UpdateCommandPalette(&app->palette);
+	UpdateOptionsFilter();
+	
 	// +==============================+
 	// |   Handle Keyboard Bindings   |
 	// +==============================+
-	RunAppBindingCommands(&app->bindings);
+	//NOTE: Bindings are suspended while the command palette or folder scan is open since they use most keys themselves
+	if (!app->palette.isOpen && !app->folderScan.isOpen) { RunAppBindingCommands(&app->bindings); }
+	#if BUILD_WITH_CLAY
+	if (app->scrollToSelectedOption)
+	{
+		AutoScrollToSelectedOptionAfterMove();
+		app->scrollToSelectedOption = false;
+	}
+	#endif //BUILD_WITH_CLAY
 	
 	// +==============================+
 	// |   Handle Ctrl+ScrollWheel    |
@@ -879,14 +958,14 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	// +==============================+
 	// |          Rendering           |
 	// +==============================+
-	TracyCZoneEnd(Zone_Update);
+	ProfZoneEnd(Zone_Update);
 	OsTime afterUpdateTime = OsGetTime();
-	TracyCZoneN(Zone_BeginFrame, "BeginFrame", true);
+	ProfZoneBegin(Zone_BeginFrame, "BeginFrame");
 	BeginFrame(platform->GetSokolSwapchain(), screenSizei, GetThemeColor(OptionListBack), 1.0f);
-	TracyCZoneEnd(Zone_BeginFrame);
+	ProfZoneEnd(Zone_BeginFrame);
 	OsTime beforeRenderTime = OsGetTime();
 	{
-		TracyCZoneN(Zone_Render, "Render", true);
+		ProfZoneBegin(Zone_Render, "Render");
 		BindShader(&app->mainShader);
 		ClearDepthBuffer(1.0f);
 		SetDepth(1.0f);
@@ -936,29 +1015,40 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 		// +==============================+
 		// |       Render Overlays        |
 		// +==============================+
+		r32 overlaysBottom = 0;
 		if (app->showPerfGraph)
 		{
-			RenderPerfGraph(&app->perfGraph, &gfx, &app->uiFont, app->uiFontSize, UI_FONT_STYLE, MakeRec(10, 10, 400, 100));
+			rec perfGraphRec = MakeRec(10, 10, 400, 100);
+			RenderPerfGraph(&app->perfGraph, &gfx, &app->uiFont, app->uiFontSize, UI_FONT_STYLE, perfGraphRec);
+			r32 profilerBottom = RenderProfilerOverlay(&app->profiler, MakeRec(420, 10, 400, 100));
+			overlaysBottom = MaxR32(perfGraphRec.y + perfGraphRec.height, profilerBottom);
+		}
+		if (app->showMemoryStats)
+		{
+			//NOTE: The memory stats panel is wider than the perf graph so it has to go below the profiler table, not just the graph
+			RenderMemoryStatsPanel(MakeV2(10, overlaysBottom + 10));
 		}
 		
-		TracyCZoneEnd(Zone_Render);
+		ProfZoneEnd(Zone_Render);
 	}
 	CommitAllFontTextureUpdates(&app->uiFont);
 	CommitAllFontTextureUpdates(&app->mainFont);
 	OsTime afterRenderTime = OsGetTime();
-	TracyCZoneN(Zone_EndFrame, "BeginFrame", true);
+	ProfZoneBegin(Zone_EndFrame, "EndFrame");
 	EndFrame();
-	TracyCZoneEnd(Zone_EndFrame);
+	ProfZoneEnd(Zone_EndFrame);
 	app->renderedLastFrame = true;
 	app->prevUpdateMs =
 		OsTimeDiffMsR32(beforeUpdateTime, afterUpdateTime) +
 		OsTimeDiffMsR32(beforeRenderTime, afterRenderTime);
 	
+	AppApplyQueuedPreset();
+	
 	if (app->testThread.isFilled)
 	{
-		TracyCZoneN(Zone_UnlockTestMutex, "UnlockMutex", true);
+		ProfZoneBegin(Zone_UnlockTestMutex, "UnlockMutex");
 		UnlockMutex(&app->testMutex);
-		TracyCZoneEnd(Zone_UnlockTestMutex);
+		ProfZoneEnd(Zone_UnlockTestMutex);
 	}
 	
 	#if BUILD_WITH_PIG_UI
@@ -968,7 +1058,7 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	ScratchEnd(scratch2);
 	ScratchEnd(scratch3);
 	
-	TracyCZoneEnd(_funcZone);
+	ProfZoneEnd(_funcZone);
 	return true;
 }
 
@@ -990,7 +1080,22 @@ EXPORT_FUNC APP_CLOSING_DEF(AppClosing)
 	igSaveIniSettingsToDisk(app->imgui->io->IniFilename);
 	#endif
 	
-	AppSaveRecentFilesList();
+	//NOTE: If we close before startup got to opening the tabs, saving the session would replace the last one with nothing
+	bool startupFinished = app->startup.isFinished;
+	FinishAppStartup(&app->startup);
+	FreeStartupQueuedPaths(&app->startup);
+	FlushSettingsWriter(&app->settingsWriter, &app->settings);
+	FreeSettingsWriter(&app->settingsWriter);
+	FlushRecentFilesWorker(&app->recentFilesWorker);
+	FreeRecentFilesWorker(&app->recentFilesWorker);
+	FinishSessionVerifier(&app->sessionVerifier, true);
+	if (startupFinished) { AppSaveSession(); }
+	SaveParseCache(&app->parseCache);
+	FreeFolderScan(&app->folderScan);
+	StopUsageIndexThread(&app->usageIndex);
+	if (startupFinished) { SaveUsageIndex(&app->usageIndex); }
+	FreeIncludeGraph(&app->includeGraph);
+	FreeDefineResolver(&app->defineResolver);
 	OsFreeOpenFileDialogAsyncHandle(&app->openFileDialog);
 	
 	ScratchEnd(scratch);
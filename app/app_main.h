@@ -46,6 +46,14 @@ struct FileOption
 	uxx fileContentsStartIndex;
 	uxx fileContentsEndIndex;
 	u64 tooltipId;
+	Str8 commentedName; //"// name", only allocated for FileOptionType_CommentDefine
+	Str8 displayName; //points into name or commentedName, updated by UpdateFileOptionDisplayName
+	u64 nameCharMask; //GetFuzzyCharMask(name), calculated when the option is parsed so the command palette doesn't have to scan every name
+	#if BUILD_WITH_PIG_UI
+	UiId btnId; //UiIdStrIndex(name, optionIndex), calculated in UpdateFileTabOptions
+	#endif
+	ixx conditionalIndex; //innermost ConditionalBlock in FileTab.conditionals this option sits in, -1 if it's not inside any #if
+	bool isInactive; //inside an #if branch that we know is turned off (see app_conditionals.c)
 	union
 	{
 		bool valueBool;
@@ -78,6 +86,35 @@ struct FileWatch
 	OsFileWriteTime writeTime;
 };
 
+// See app_presets.c
+typedef plex PresetEntry PresetEntry;
+plex PresetEntry
+{
+	FilePath filePath;
+	Str8 optionName;
+	bool enabled; //valueBool for FileOptionType_Bool, isUncommented for FileOptionType_CommentDefine
+};
+
+typedef plex Preset Preset;
+plex Preset
+{
+	Str8 name;
+	u64 nameCharMask;
+	VarArray entries; //PresetEntry
+};
+
+// One file that AppApplyPreset (or a batch of IPC changes) is changing. Everything is allocated from scratch and only lives for the one transaction
+typedef plex PresetFileChange PresetFileChange;
+plex PresetFileChange
+{
+	FilePath fullPath;
+	FilePath tempPath; //fullPath + PRESET_TEMP_FILE_SUFFIX, holds newContents until it's renamed over fullPath
+	FilePath backupPath; //fullPath + PRESET_BACKUP_FILE_SUFFIX, holds oldContents so we can roll back
+	Str8 oldContents;
+	Str8 newContents;
+	uxx numChangedOptions;
+};
+
 typedef struct ScrollbarInteractionState ScrollbarInteractionState;
 struct ScrollbarInteractionState
 {
@@ -86,10 +123,60 @@ struct ScrollbarInteractionState
 	v2 grabOffset;
 };
 
+// A substring index over the name, abbreviation and value of every option in a tab, built in UpdateFileTabOptions.
+// Every 1, 2 and 3 character gram of the (lowercased) text is hashed into a bucket, and each bucket holds the
+// ascending list of options that contain a gram that landed there. A search intersects the lists for the
+// query's grams and only compares the text of the options that survive
+typedef plex OptionSearchIndex OptionSearchIndex;
+plex OptionSearchIndex
+{
+	VarArray text; //char, "name\nabbreviation\nvalue\n" of every option back to back, lowercased
+	VarArray textStarts; //uxx, numOptions+1 entries, option N's text is text[textStarts[N]..textStarts[N+1]]
+	VarArray bucketStarts; //u32, OPTION_SEARCH_NUM_BUCKETS+1 entries, offsets into postings
+	VarArray postings; //u32, option indices
+	bool isStale; //an option's value changed since the index was built, it will be rebuilt before the next search
+};
+
+// The result of evaluating a #if expression. Anything involving a name we don't have a value for is not known
+typedef plex ConditionalValue ConditionalValue;
+plex ConditionalValue
+{
+	bool isKnown;
+	i64 value;
+};
+
+// One branch of an #if chain (the #if/#ifdef/#ifndef itself, each #elif and the #else), see app_conditionals.c
+typedef plex ConditionalBlock ConditionalBlock;
+plex ConditionalBlock
+{
+	ixx parentIndex; //the branch this chain is nested in, -1 at the top level
+	uxx chainStartIndex; //the #if block of the chain this branch is part of
+	uxx endBlockIndex; //one past the last block nested in this branch, which is also the next branch of the chain (if there is one)
+	uxx firstOption; //options[firstOption..endOption) come after this directive and before the next one in the chain
+	uxx endOption;
+	Str8 expression; //empty for #else, #ifdef X is stored as "defined X"
+	uxx firstDependency; //the names the expression looked up are dependencies[firstDependency..firstDependency+numDependencies)
+	uxx numDependencies;
+	ConditionalValue condition;
+	bool isSkipped; //this branch is known not to be taken
+	bool isDead; //isSkipped or the branch we are nested in isDead
+	bool needsResolve; //used by UpdateFileTabConditionals
+};
+
+typedef plex FileConditionals FileConditionals;
+plex FileConditionals
+{
+	Arena* arena;
+	VarArray blocks; //ConditionalBlock, in file order
+	VarArray dependencies; //Str8, slices of the block expressions
+	uxx numInactiveOptions;
+};
+
 typedef struct FileTab FileTab;
 struct FileTab
 {
 	Str8 filePath;
+	Str8 includeGraphPath; //filePath made absolute and normalized, filled the first time the include graph is asked about this tab
 	Str8 fileContents;
 	Str8 originalFileContents;
 	bool isFileChangedFromOriginal;
@@ -99,6 +186,27 @@ struct FileTab
 	r32 longestAbbreviationWidthFontSize;
 	ScrollbarInteractionState scrollbarState;
 	ixx selectedOptionIndex; //-1 = no selection
+	OptionSearchIndex searchIndex;
+	FileConditionals conditionals;
+	VarArray optionSources; //Str8, one for each option, where its final value comes from if that isn't this file (see app_define_resolver.c)
+	u64 optionSourcesTime; //programTime of the last resolve, 0 resolves again as soon as this is the current tab
+	VarArray includeWatchIds; //uxx, FileWatch ids of the files the last resolve went through (other than this one)
+	r32 scrollY; //scroll of the OptionsList the last time this tab was shown
+	bool restoreScroll; //set by AppChangeTab, scrollY gets applied to the OptionsList on the next UI frame
+	bool isFromSnapshot; //the options were restored from session.bin and fileContents hasn't been read yet (see app_session.c)
+	u64 snapshotFileSize; //only valid while isFromSnapshot
+	u64 snapshotHash; //only valid while isFromSnapshot
+	u64 paletteGeneration; //unique across all tabs, assigned from app->nextTabPaletteGeneration every time fileOptions is finalized (see app_command_palette.c)
+};
+
+// One "set" or "toggle" line from an IPC request (see app_ipc.c), validated before any of them are applied
+typedef plex IpcOptionChange IpcOptionChange;
+plex IpcOptionChange
+{
+	FileTab* tab;
+	Str8 optionName;
+	bool toggle;
+	bool enabled; //ignored if toggle
 };
 
 typedef enum PopupDialogResult PopupDialogResult;
@@ -173,6 +281,735 @@ struct EditableText
 	bool textChanged;
 };
 
+// See app_startup.c. Worker tasks only read and decode into their StartupTaskState.arena, main thread tasks do everything else
+typedef enum StartupTask StartupTask;
+enum StartupTask
+{
+	StartupTask_None = 0,
+	StartupTask_DecodeWindowIcons,
+	StartupTask_DecodeNotificationIcons,
+	StartupTask_ReadAppIcons,
+	StartupTask_ReadRecentFiles,
+	StartupTask_Settings,
+	StartupTask_Theme,
+	StartupTask_Renderer,
+	StartupTask_Icons,
+	StartupTask_Bindings,
+	StartupTask_RecentFiles,
+	StartupTask_Presets,
+	StartupTask_UsageIndex,
+	StartupTask_OpenFiles,
+	StartupTask_Count,
+};
+const char* GetStartupTaskStr(StartupTask enumValue)
+{
+	switch (enumValue)
+	{
+		case StartupTask_None:                    return "None";
+		case StartupTask_DecodeWindowIcons:       return "DecodeWindowIcons";
+		case StartupTask_DecodeNotificationIcons: return "DecodeNotificationIcons";
+		case StartupTask_ReadAppIcons:            return "ReadAppIcons";
+		case StartupTask_ReadRecentFiles:         return "ReadRecentFiles";
+		case StartupTask_Settings:                return "Settings";
+		case StartupTask_Theme:                   return "Theme";
+		case StartupTask_Renderer:                return "Renderer";
+		case StartupTask_Icons:                   return "Icons";
+		case StartupTask_Bindings:                return "Bindings";
+		case StartupTask_RecentFiles:             return "RecentFiles";
+		case StartupTask_Presets:                 return "Presets";
+		case StartupTask_UsageIndex:              return "UsageIndex";
+		case StartupTask_OpenFiles:               return "OpenFiles";
+		case StartupTask_Count:                   return "Count";
+		default: return "Unknown";
+	}
+}
+
+typedef plex StartupTaskInfo StartupTaskInfo;
+plex StartupTaskInfo
+{
+	bool isWorkerTask;
+	bool isBeforeFirstFrame; //main thread tasks that AppInit runs, the window isn't shown until these are done
+	u32 dependencies; //bit flags of (1 << StartupTask)
+};
+
+typedef plex StartupTaskState StartupTaskState;
+plex StartupTaskState
+{
+	ai64 isClaimed; //worker tasks only, whichever thread swaps this to 1 runs the task
+	abool isDone;
+	OsTime startTime;
+	OsTime endTime;
+	Arena arena; //worker tasks allocate their results from here, they are freed when startup finishes
+};
+
+typedef plex AppStartup AppStartup;
+plex AppStartup
+{
+	bool isStarted;
+	bool isFinished;
+	bool hasShownFirstFrame;
+	bool printTimings; //-startup_timing on the command line
+	OsTime beginTime;
+	OsTime firstFrameTime;
+	OsThreadHandle threads[STARTUP_NUM_THREADS];
+	abool threadRunning[STARTUP_NUM_THREADS];
+	StartupTaskState tasks[StartupTask_Count];
+	
+	ImageData windowIcons[NUM_WINDOW_ICONS];
+	ImageData notificationIcons;
+	Slice appIconsImageFile;
+	Str8 appIconsMetaFile;
+	FilePath recentFilesPath;
+	bool recentFilesRead;
+	Str8 recentFilesContents;
+	
+	VarArray queuedDroppedPaths; //Str8, allocated from stdHeap, files dropped on the window before startup finished (see QueueStartupPaths)
+	VarArray queuedForwardedPaths; //Str8, allocated from stdHeap, paths forwarded by another instance before startup finished
+};
+
+typedef enum ProfilerEventKind ProfilerEventKind;
+enum ProfilerEventKind
+{
+	ProfilerEventKind_None = 0,
+	ProfilerEventKind_Begin,
+	ProfilerEventKind_End,
+	ProfilerEventKind_Detail, //attaches a string to the innermost open zone, only pushed while a capture is running
+	ProfilerEventKind_Count,
+};
+const char* GetProfilerEventKindStr(ProfilerEventKind enumValue)
+{
+	switch (enumValue)
+	{
+		case ProfilerEventKind_None:   return "None";
+		case ProfilerEventKind_Begin:  return "Begin";
+		case ProfilerEventKind_End:    return "End";
+		case ProfilerEventKind_Detail: return "Detail";
+		case ProfilerEventKind_Count:  return "Count";
+		default: return "Unknown";
+	}
+}
+
+typedef enum ProfilerCategory ProfilerCategory;
+enum ProfilerCategory
+{
+	ProfilerCategory_None = 0,
+	ProfilerCategory_FileIo,
+	ProfilerCategory_FileWatch,
+	ProfilerCategory_Job,
+	ProfilerCategory_Count,
+};
+const char* GetProfilerCategoryStr(ProfilerCategory enumValue)
+{
+	switch (enumValue)
+	{
+		case ProfilerCategory_None:      return "None";
+		case ProfilerCategory_FileIo:    return "FileIo";
+		case ProfilerCategory_FileWatch: return "FileWatch";
+		case ProfilerCategory_Job:       return "Job";
+		case ProfilerCategory_Count:     return "Count";
+		default: return "Unknown";
+	}
+}
+
+typedef enum ProfilerCaptureMode ProfilerCaptureMode;
+enum ProfilerCaptureMode
+{
+	ProfilerCaptureMode_None = 0,
+	ProfilerCaptureMode_Frames,
+	ProfilerCaptureMode_NextStall,
+	ProfilerCaptureMode_Count,
+};
+const char* GetProfilerCaptureModeStr(ProfilerCaptureMode enumValue)
+{
+	switch (enumValue)
+	{
+		case ProfilerCaptureMode_None:      return "None";
+		case ProfilerCaptureMode_Frames:    return "Frames";
+		case ProfilerCaptureMode_NextStall: return "NextStall";
+		case ProfilerCaptureMode_Count:     return "Count";
+		default: return "Unknown";
+	}
+}
+
+typedef plex ProfilerEvent ProfilerEvent;
+plex ProfilerEvent
+{
+	u64 timestamp; //see GetProfilerTimestamp
+	u32 zoneId; //for ProfilerEventKind_Detail this is the detail number instead
+	ProfilerEventKind kind;
+};
+
+typedef plex ProfilerOpenZone ProfilerOpenZone;
+plex ProfilerOpenZone
+{
+	u32 zoneId;
+	u32 detailNumber;
+	u64 beginTimestamp;
+};
+
+typedef plex ProfilerThread ProfilerThread;
+plex ProfilerThread
+{
+	abool isClaimed;
+	ThreadId threadId;
+	bool isMainThread;
+	ai64 writeIndex; //count of events ever written, only the owning thread writes events
+	ProfilerEvent* events; //PROFILER_RING_SIZE, indexed by (index % PROFILER_RING_SIZE)
+	
+	//These are only touched by UpdateProfiler on the main thread
+	i64 readIndex;
+	uxx stackDepth;
+	ProfilerOpenZone stack[PROFILER_MAX_DEPTH];
+	uxx numDroppedEvents;
+};
+
+typedef plex ProfilerZone ProfilerZone;
+plex ProfilerZone
+{
+	Str8 name; //allocated from namesArena, the literal it came from goes away when the dll is reloaded
+	ProfilerCategory category;
+	u64 frameTicks; //summed over every thread since the last UpdateProfiler
+	uxx frameCount;
+	uxx numSamples;
+	uxx nextSampleIndex;
+	r32 samples[PROFILER_HISTORY_LENGTH]; //ms, one for each frame that this zone ran in
+	r32 sortedSamples[PROFILER_HISTORY_LENGTH]; //the same samples in ascending order, kept sorted by AddProfilerZoneSample
+};
+
+typedef plex ProfilerFlameZone ProfilerFlameZone;
+plex ProfilerFlameZone
+{
+	u32 zoneId;
+	uxx depth;
+	u64 beginTimestamp;
+	u64 endTimestamp;
+};
+
+typedef plex ProfilerCaptureZone ProfilerCaptureZone;
+plex ProfilerCaptureZone
+{
+	u32 zoneId;
+	u32 threadIndex;
+	u32 detailNumber; //0 if the zone had no detail, see Profiler.captureDetailBase
+	u64 beginTimestamp;
+	u64 endTimestamp;
+};
+
+typedef plex ProfilerZoneStats ProfilerZoneStats;
+plex ProfilerZoneStats
+{
+	u32 zoneId;
+	r32 p50;
+	r32 p95;
+	r32 max;
+};
+
+typedef plex Profiler Profiler;
+plex Profiler
+{
+	bool isInitialized;
+	Mutex mutex; //held while registering zones and claiming threads
+	Arena namesArena;
+	ai64 numZones; //zone 0 is never used, so an id of 0 means the zone isn't being recorded
+	ProfilerZone* zones; //PROFILER_MAX_ZONES
+	ProfilerThread* threads; //PROFILER_MAX_THREADS
+	
+	u64 calibrateTimestamp;
+	OsTime calibrateTime;
+	r64 ticksPerMs; //0 until PROFILER_CALIBRATE_TIME has passed
+	
+	uxx numFlameZones;
+	ProfilerFlameZone* flameZones; //PROFILER_MAX_FLAME_ZONES, the main thread's zones from the last frame
+	u64 flameBeginTimestamp;
+	u64 flameEndTimestamp;
+	
+	ProfilerCaptureMode captureMode;
+	abool isCapturing; //ProfZoneDetail doesn't record anything unless this is set
+	Arena captureArena; //detail strings, held under mutex since any thread can add them
+	VarArray captureDetails; //Str8, held under mutex
+	u32 captureDetailBase; //the detail number of captureDetails[0] minus 1, older details have been dropped
+	VarArray captureZones; //ProfilerCaptureZone, zones that ended during this frame (or the whole capture when capturing frames)
+	VarArray capturePrevZones; //ProfilerCaptureZone, NextStall only, the frame before so the capture shows what led into the stall
+	VarArray captureFrames; //u64, the timestamp that each captured frame began at
+	uxx captureFramesLeft;
+	r32 captureStallThreshold; //ms
+};
+
+//NOTE: These do everything TracyCZoneN/TracyCZoneEnd do and also record into app->profiler.
+// Each call site caches its zone id in a static so the name is only looked up the first time
+#define ProfZoneBeginEx(varName, nameStr, category) TracyCZoneN(varName, nameStr, true); static u32 varName##_profId = 0; u32 varName##_prof = BeginProfilerZone(&varName##_profId, nameStr, (category))
+#define ProfZoneBegin(varName, nameStr) ProfZoneBeginEx(varName, nameStr, ProfilerCategory_None)
+#define ProfZoneEnd(varName) EndProfilerZone(varName##_prof); TracyCZoneEnd(varName)
+
+typedef plex MemoryStatsEntry MemoryStatsEntry;
+plex MemoryStatsEntry
+{
+	Str8 subsystem;
+	Str8 name;
+	bool isEstimate; //not an arena, the size was added up from the structures that the subsystem holds (only liveBytes is filled)
+	uxx liveBytes;
+	uxx peakBytes;
+	uxx framePeakBytes; //main thread scratch arenas only, the most that was used during the last frame
+	uxx allocCount;
+	uxx committedBytes;
+	uxx reservedBytes;
+};
+
+typedef plex MemoryStats MemoryStats;
+plex MemoryStats
+{
+	bool isInitialized;
+	uxx scratchFramePeaks[NUM_SCRATCH_ARENAS_PER_THREAD]; //main thread, bytes
+	uxx scratchPeaks[NUM_SCRATCH_ARENAS_PER_THREAD]; //main thread, bytes since startup
+	uxx scratchReserved[NUM_SCRATCH_ARENAS_PER_THREAD];
+	Mutex workerMutex; //worker threads report their scratch usage as they exit
+	uxx numWorkerReports;
+	uxx workerScratchPeaks[NUM_SCRATCH_ARENAS_PER_THREAD]; //bytes, the most any worker thread has used
+	uxx workerScratchReserved[NUM_SCRATCH_ARENAS_PER_THREAD];
+};
+
+typedef enum PaletteItemType PaletteItemType;
+enum PaletteItemType
+{
+	PaletteItemType_None = 0,
+	PaletteItemType_Command,
+	PaletteItemType_Option,
+	PaletteItemType_RecentFile,
+	PaletteItemType_Preset,
+	PaletteItemType_Count,
+};
+const char* GetPaletteItemTypeStr(PaletteItemType enumValue)
+{
+	switch (enumValue)
+	{
+		case PaletteItemType_None:       return "None";
+		case PaletteItemType_Command:    return "Command";
+		case PaletteItemType_Option:     return "Option";
+		case PaletteItemType_RecentFile: return "RecentFile";
+		case PaletteItemType_Preset:     return "Preset";
+		case PaletteItemType_Count:      return "Count";
+		default: return "Unknown";
+	}
+}
+
+typedef plex PaletteItem PaletteItem;
+plex PaletteItem
+{
+	PaletteItemType type;
+	Str8 searchStr; //points at the command name, option name, recent file path, or preset name. Only valid until the next index rebuild
+	uxx index; //AppCommand, option index, recent file index, or preset index
+	uxx tabIndex; //only for PaletteItemType_Option
+};
+
+typedef plex PaletteMatch PaletteMatch;
+plex PaletteMatch
+{
+	uxx itemIndex;
+	i32 score;
+};
+
+// The range of palette->items that came from one tab's options
+typedef plex PaletteTabSection PaletteTabSection;
+plex PaletteTabSection
+{
+	u64 tabGeneration; //FileTab::paletteGeneration when the items were added
+	uxx firstItem;
+};
+
+typedef plex CommandPalette CommandPalette;
+plex CommandPalette
+{
+	bool isOpen;
+	EditableText input;
+	
+	u64 indexGeneration; //compared against app->paletteIndexGeneration, a change there rebuilds all the items
+	VarArray items; //PaletteItem, laid out as: commands, the options of each tab, recent files, presets
+	VarArray itemMasks; //u64, parallel to items, kept separate so the mask prefilter walks a tightly packed array
+	VarArray tabSections; //PaletteTabSection, one for each tab in app->tabs when the items were built
+	uxx recentFilesFirstItem;
+	u64 recentFilesGeneration; //compared against app->paletteRecentFilesGeneration
+	uxx presetsFirstItem;
+	u64 presetsGeneration; //compared against app->palettePresetsGeneration
+	
+	Str8 prevQuery;
+	VarArray candidates; //uxx, indices of items that matched prevQuery, a longer query can only match a subset of these
+	uxx numResults;
+	PaletteMatch results[PALETTE_MAX_RESULTS]; //best first
+	uxx selectedIndex; //index into results
+	uxx clickedResult; //UINTXX_MAX if none, clicks are recorded by RenderCommandPalette and run in the next UpdateCommandPalette
+};
+
+// See app_recent_files.c. The job* members are only touched by the thread while isWorking is true
+typedef plex RecentFilesWorker RecentFilesWorker;
+plex RecentFilesWorker
+{
+	Arena* arena;
+	uxx numJournalLines; //lines in recent_files.txt, including the ones in pendingLines
+	VarArray pendingLines; //Str8, paths that still need to be appended to the journal
+	bool compactRequested;
+	bool probeRequested;
+	
+	bool hasJob; //true from StartRecentFilesJob until FinishRecentFilesJob has applied the results
+	OsThreadHandle thread;
+	abool isWorking;
+	FilePath jobSavePath;
+	Str8 jobAppendStr;
+	bool jobCompact;
+	Str8 jobCompactStr;
+	VarArray jobProbePaths; //Str8
+	VarArray jobProbeResults; //bool, parallel to jobProbePaths
+	bool jobWriteSucceeded;
+};
+
+// See app_usage_index.c
+typedef plex UsageIndexMention UsageIndexMention;
+plex UsageIndexMention //a define name that a preprocessor line of a file depends on
+{
+	Str8 name;
+	u32 lineNum;
+};
+
+typedef plex UsageIndexRef UsageIndexRef;
+plex UsageIndexRef
+{
+	u32 fileIndex;
+	u32 lineNum;
+};
+
+typedef plex UsageIndexName UsageIndexName;
+plex UsageIndexName
+{
+	Str8 name;
+	u32 hash;
+	VarArray refs; //UsageIndexRef
+};
+
+typedef plex UsageIndexFile UsageIndexFile;
+plex UsageIndexFile
+{
+	FilePath path;
+	OsFileWriteTime writeTime;
+	VarArray nameIndices; //u32, every name this file mentions (no duplicates) so we can find its refs again when it changes
+	VarArray includes; //Str8, see TokenizePreprocessorLines
+};
+
+typedef plex UsageIndexJobFile UsageIndexJobFile;
+plex UsageIndexJobFile //a file whose write time changed since it was last indexed, or a file under rootPath that isn't indexed yet
+{
+	uxx fileIndex; //UINTXX_MAX for a new file
+	FilePath path; //allocated from jobHeap, only set for new files
+	OsFileWriteTime writeTime;
+	VarArray mentions; //UsageIndexMention, allocated from jobHeap
+	VarArray includes; //Str8, allocated from jobHeap
+};
+
+typedef plex UsageIndex UsageIndex;
+plex UsageIndex
+{
+	Arena* arena;
+	bool isLoaded;
+	FilePath rootPath;
+	VarArray files; //UsageIndexFile, never removed so fileIndex in UsageIndexRef stays valid (deleted files just have no refs)
+	VarArray names; //UsageIndexName
+	VarArray nameSlots; //u32, open addressed table of (index+1) into names, 0 = empty slot
+	bool isBuilding; //a folder scan is feeding files in, see BeginUsageIndexBuild
+	u64 includesGeneration; //incremented whenever the includes of any file change
+	bool isDirty;
+	u64 lastWatchFeedTime; //programTime of the last UpdateUsageIndex, watches that changed after this get queued
+	VarArray queuedPaths; //FilePath, files that changed since the last job started, the next job checks them
+	u64 lastSweepTime;
+	bool sweepRequested;
+	VarArray ignoreGlobs; //Str8, copies of the folder scan filters so a sweep finds the same files the scan did
+	VarArray extensions; //Str8, same as above
+	
+	OsThreadHandle thread; //started with the first job and kept running until StopUsageIndexThread
+	abool isThreadRunning;
+	abool stopRequested;
+	WakeSignal wakeSignal; //set to hand the thread a job, or to stop it
+	WakeSignal doneSignal; //set by the thread when it finishes a job
+	bool hasJob; //the job* members (and the filter lists) are only touched by the thread while isWorking is true
+	abool isWorking; //set by the main thread to hand a job to the thread, cleared by the thread when it's done
+	Arena jobHeap;
+	bool jobIsSweep; //walk the whole folder rather than only checking jobPaths
+	VarArray jobPaths; //FilePath, allocated from jobHeap
+	VarArray jobFiles; //UsageIndexJobFile
+};
+
+// See app_include_graph.c
+typedef plex IncludeGraphJobFile IncludeGraphJobFile;
+plex IncludeGraphJobFile
+{
+	Str8 path; //points into jobStrings
+	uxx firstInclude; //index into jobIncludes
+	uxx numIncludes;
+};
+
+typedef plex IncludeGraphResults IncludeGraphResults;
+plex IncludeGraphResults
+{
+	bool usedCompileCommands;
+	uxx numTranslationUnits;
+	Str8 pathChars; //the normalized path of every file back to back
+	VarArray paths; //Str8, points into pathChars
+	VarArray pathSlots; //u32, open addressed table of (index+1) into paths
+	VarArray tuCounts; //u32, parallel to paths, how many translation units include this file (directly or not)
+	u64 layoutHash; //hash of the paths (in order) and include directories that the edges were resolved against
+	VarArray includesHashes; //u64, parallel to paths, hash of the #include lines that the file's edges were resolved from
+	VarArray edgeStarts; //u32, one more than paths, the files that paths[i] includes are edges[edgeStarts[i]] up to edges[edgeStarts[i+1]]
+	VarArray edges; //u32, indices into paths
+};
+
+typedef plex IncludeGraph IncludeGraph;
+plex IncludeGraph
+{
+	Arena* arena;
+	Arena jobHeap;
+	bool hasResults;
+	u64 resultsGeneration; //the usageIndex.includesGeneration that results were computed from
+	IncludeGraphResults results; //allocated from jobHeap
+	
+	bool hasJob; //the job* members are only touched by the thread while isWorking is true
+	OsThreadHandle thread;
+	abool isWorking;
+	u64 jobGeneration;
+	Str8 jobStrings; //allocated from arena, all the strings below point into it
+	FilePath jobRootPath;
+	FilePath jobCompileCommandsPath; //empty means look for compile_commands.json in the root
+	VarArray jobFiles; //IncludeGraphJobFile
+	VarArray jobIncludes; //Str8
+	IncludeGraphResults jobResults; //allocated from jobHeap
+};
+
+// See app_define_resolver.c
+typedef enum DefineEventKind DefineEventKind;
+enum DefineEventKind
+{
+	DefineEventKind_None = 0,
+	DefineEventKind_Define,
+	DefineEventKind_Default, //a #define inside an #ifndef of the same name, it only applies if the name isn't defined yet
+	DefineEventKind_Undef,
+	DefineEventKind_Include,
+	DefineEventKind_Count,
+};
+const char* GetDefineEventKindStr(DefineEventKind enumValue)
+{
+	switch (enumValue)
+	{
+		case DefineEventKind_None:    return "None";
+		case DefineEventKind_Define:  return "Define";
+		case DefineEventKind_Default: return "Default";
+		case DefineEventKind_Undef:   return "Undef";
+		case DefineEventKind_Include: return "Include";
+		case DefineEventKind_Count:   return "Count";
+		default: return "Unknown";
+	}
+}
+
+typedef plex DefineEvent DefineEvent;
+plex DefineEvent
+{
+	DefineEventKind kind;
+	Str8 name; //for includes this is the target with its opening '"' or '<'
+	Str8 valueStr;
+	u32 lineNum;
+};
+
+typedef plex DefineFileCacheEntry DefineFileCacheEntry;
+plex DefineFileCacheEntry
+{
+	u64 contentHash;
+	u64 lastUsedJobId;
+	VarArray events; //DefineEvent, allocated from cacheHeap
+	uxx nextInBucket; //index+1 of the next entry in the same cacheBuckets bucket (0 = end of chain)
+};
+
+typedef plex DefineResolverFile DefineResolverFile;
+plex DefineResolverFile
+{
+	FilePath path; //full path with forward slashes, see NormalizeIncludeGraphPath
+	ixx cacheIndex; //-1 until a worker loaded it (or if it couldn't be read)
+	VarArray includeTargets; //ixx, one for each of the file's events, the index in files of the file an #include event resolved to (or -1)
+	uxx nextInBucket; //index+1 of the next file in the same fileBuckets bucket (0 = end of chain)
+};
+
+typedef plex DefineResolver DefineResolver;
+typedef plex DefineResolverWorkerContext DefineResolverWorkerContext;
+plex DefineResolverWorkerContext
+{
+	DefineResolver* resolver;
+	OsThreadHandle thread;
+	abool isRunning;
+};
+
+plex DefineResolver
+{
+	Arena* arena;
+	Mutex mutex; //protects everything below while a job is running
+	Arena cacheHeap;
+	VarArray cache; //DefineFileCacheEntry, keyed by content hash, kept between jobs
+	VarArray cacheBuckets; //uxx, index+1 of the first cache entry in each contentHash bucket (0 = empty bucket). Length is always a power of 2
+	u64 nextJobId;
+	
+	bool hasJob;
+	u64 jobId;
+	FilePath jobTabPath; //allocated from arena
+	Arena jobHeap;
+	VarArray includeDirs; //Str8, from the IncludePaths setting
+	VarArray files; //DefineResolverFile, files[0] is the open file
+	VarArray fileBuckets; //uxx, index+1 of the first file in each path bucket (0 = empty bucket). Length is always a power of 2
+	VarArray queue; //uxx, files that haven't been loaded yet
+	ai64 numPendingFiles; //queued or being loaded, the workers stop once this hits 0
+	ai64 numCacheHits;
+	DefineResolverWorkerContext workers[DEFINE_RESOLVER_NUM_THREADS];
+};
+
+// See app_folder_scan.c
+typedef plex FolderScanWorkItem FolderScanWorkItem;
+plex FolderScanWorkItem
+{
+	bool isFolder;
+	FilePath path; //allocated from the heap of the worker whose queue it is in
+};
+
+typedef plex FolderScan FolderScan;
+typedef plex FolderScanWorker FolderScanWorker;
+plex FolderScanWorker
+{
+	FolderScan* scan;
+	uxx index;
+	Mutex mutex; //protects heap and queue, other workers lock this when stealing
+	Arena heap;
+	VarArray queue; //FolderScanWorkItem, the owner pops from the back and thieves take from queueHead
+	uxx queueHead; //items before this have already been stolen, they are dropped once they make up half the queue
+	OsThreadHandle thread;
+	abool isRunning;
+};
+
+typedef plex FolderScanOption FolderScanOption;
+plex FolderScanOption
+{
+	Str8 name;
+	bool isEnabled;
+};
+
+typedef plex FolderScanFile FolderScanFile;
+plex FolderScanFile
+{
+	u64 id; //stable across sorting, used to keep the selection on the same row
+	FilePath path;
+	Str8 relativePath; //points into path
+	VarArray options; //FolderScanOption
+	OsFileWriteTime writeTime;
+	VarArray mentions; //UsageIndexMention, only filled in pendingFiles, handed to the usage index when merged
+	VarArray includes; //Str8, same as above
+	uxx firstRow; //index of this file's header row in FolderScan::rows, only valid for the first numFilesWithRows files
+};
+
+typedef plex FolderScanRow FolderScanRow;
+plex FolderScanRow
+{
+	uxx fileIndex;
+	ixx optionIndex; //-1 for the file's header row
+};
+
+plex FolderScan
+{
+	Arena* arena;
+	bool isOpen;
+	FilePath rootPath;
+	VarArray ignoreGlobs; //Str8, read by the workers so it can't change while they are running
+	VarArray extensions; //Str8, same as above
+	
+	bool isRunning;
+	FolderScanWorker workers[FOLDER_SCAN_NUM_THREADS];
+	ai64 numPendingItems; //work items that have been queued but not finished, the workers stop once this hits 0
+	abool stopRequested;
+	ai64 numFilesScanned;
+	Mutex resultsMutex; //protects resultsHeap and pendingFiles
+	Arena resultsHeap;
+	VarArray pendingFiles; //FolderScanFile, allocated from resultsHeap, moved into files by UpdateFolderScan
+	
+	u64 nextFileId;
+	VarArray files; //FolderScanFile, sorted by relativePath
+	VarArray rows; //FolderScanRow, a header row for each file followed by a row for each of its options
+	uxx numFilesWithRows; //files before this index still have the right rows, RebuildFolderScanRows only redoes the rest
+	uxx numOptions;
+	uxx firstVisibleRow;
+	uxx selectedRow;
+	u64 selectedFileId;
+	ixx selectedOptionIndex;
+	uxx clickedRow; //UINTXX_MAX if none, clicks are recorded by RenderFolderScan and acted on in the next UpdateFolderScan so the files aren't freed mid-UI pass
+	bool overlayClicked;
+};
+
+// See app_parse_cache.c
+typedef plex ParseCacheEntry ParseCacheEntry;
+plex ParseCacheEntry
+{
+	u64 contentHash; //HashStr8Fnv of the file contents
+	u64 fileSize;
+	u64 numOptions;
+	Slice table; //serialized option table, see WriteFileOptionTable
+	uxx nextInBucket; //index+1 of the next entry in the same ParseCache bucket (0 = end of chain)
+	uxx lruPrev; //index+1 of the entry that was used just before this one (0 = this is the least recently used)
+	uxx lruNext; //index+1 of the entry that was used just after this one (0 = this is the most recently used)
+};
+
+typedef plex ParseCache ParseCache;
+plex ParseCache
+{
+	Arena* arena;
+	bool isLoaded; //parse_cache.bin is read the first time we need it
+	bool isDirty;
+	uxx totalSize; //sum of table.length of all entries
+	VarArray entries; //ParseCacheEntry, in no particular order, removing an entry moves the last one into its place
+	VarArray buckets; //uxx, index+1 of the first entry in each contentHash bucket (0 = empty bucket). Length is always a power of 2
+	uxx lruFirst; //index+1 of the least recently used entry, the next one to be evicted
+	uxx lruLast; //index+1 of the most recently used entry
+};
+
+// See app_session.c. The items are only touched by the thread while isWorking is true
+typedef plex SessionVerifyItem SessionVerifyItem;
+plex SessionVerifyItem
+{
+	FilePath filePath;
+	u64 expectedFileSize;
+	u64 expectedHash;
+	bool readSucceeded; //false if the file is missing or couldn't be read
+	bool matchesSnapshot;
+	Str8 fileContents; //allocated from threadHeap
+};
+
+typedef plex SessionVerifier SessionVerifier;
+plex SessionVerifier
+{
+	Arena* arena;
+	Arena threadHeap; //the thread can't allocate from stdHeap so the files are read into here
+	VarArray items; //SessionVerifyItem
+	OsThreadHandle thread;
+	abool isWorking;
+};
+
+typedef plex SettingsWriter SettingsWriter;
+plex SettingsWriter
+{
+	Arena* arena;
+	FilePath filePath;
+	bool isDirty; //set by QueueSettingsWrite, cleared when a write is started
+	OsTime firstDirtyTime;
+	OsTime lastDirtyTime;
+	
+	OsThreadHandle thread; //started with the first write and kept running until StopSettingsWriterThread
+	abool isThreadRunning;
+	abool stopRequested;
+	WakeSignal wakeSignal; //set to hand a write to the thread, or to stop it
+	WakeSignal doneSignal; //set by the thread when it finishes a write
+	bool isWaitingForResult; //a write was handed to the thread and its result hasn't been reported yet
+	AppSettings snapshot; //only read by the thread while isWriting is true
+	abool isWriting; //set by the main thread to hand a write to the thread, cleared by the thread when it's done
+	abool writeSucceeded;
+};
+
 typedef struct ClayTextbox ClayTextbox;
 struct ClayTextbox
 {
@@ -194,14 +1031,18 @@ typedef struct AppData AppData;
 struct AppData
 {
 	bool initialized;
+	AppStartup startup;
 	RandomSeries random;
 	AppResources resources;
 	VarArray fileWatches; //FileWatch
 	r32 prevUpdateMs;
 	PerfGraph perfGraph;
-	bool showPerfGraph;
+	bool showPerfGraph; //also shows the flame strip and zone table from profiler
+	Profiler profiler;
+	MemoryStats memoryStats;
+	bool showMemoryStats;
 	AppSettings settings;
-	FilePath settingsPath;
+	SettingsWriter settingsWriter;
 	
 	Shader mainShader;
 	PigFont uiFont;
@@ -211,7 +1052,10 @@ struct AppData
 	v2i appIconSheetCell[AppIcon_Count];
 	SpriteSheet appIconsSheet;
 	
-	BakedTheme theme;
+	BakedTheme* theme; //points to bakedThemes[currentThemeMode]
+	BakedTheme bakedThemes[ThemeMode_Count];
+	u32 bakedThemeModesMask;
+	ThemeDefinition bakedThemeDef; //the combined definition that bakedThemes came from, kept so the next bake only has to resolve entries that changed
 	ThemeDefinition defaultTheme;
 	#if !USE_EMBEDDED_RESOURCES_ZIP
 	uxx defaultThemeFileWatchId;
@@ -220,6 +1064,9 @@ struct AppData
 	uxx userThemeFileWatchId;
 	ThemeMode currentThemeMode;
 	bool needToBakeTheme;
+	u64 defaultThemeSourceHash;
+	u64 userThemeSourceHash;
+	bool themeDefinitionsDeferred; //true when app->theme came from the theme cache and the definitions haven't been parsed yet
 	
 	u64 numFramesConsecutivelyRendered;
 	bool renderedLastFrame;
@@ -243,23 +1090,44 @@ struct AppData
 	bool wasClayScrollingPrevFrame;
 	
 	PopupDialog popup;
+	CommandPalette palette;
+	u64 paletteIndexGeneration; //incremented when every command palette item needs rebuilding (tab changes are tracked by FileTab::paletteGeneration)
+	u64 nextTabPaletteGeneration;
+	u64 paletteRecentFilesGeneration; //incremented whenever the recent files list changes
+	u64 palettePresetsGeneration; //incremented whenever the presets change
 	NotificationQueue notificationQueue;
 	Texture notificationIconsTexture;
 	#if BUILD_WITH_CLAY
 	TooltipRegistry tooltips;
 	#endif //BUILD_WITH_CLAY
 	bool openFileDialogIsForTheme;
+	bool openFileDialogIsForFolder;
 	OsOpenFileDialogHandle openFileDialog;
 	
 	AppBindingSet bindings;
 	
 	VarArray recentFiles; //RecentFile
 	uxx recentFilesWatchId;
+	RecentFilesWorker recentFilesWorker;
+	
+	VarArray presets; //Preset
+	uxx presetsWatchId;
+	uxx queuedPresetIndex; //UINTXX_MAX if none, see AppQueuePreset
+	u64 queuedPresetGeneration; //palettePresetsGeneration when the preset was queued, the queued index is dropped if the presets changed since
 	
 	VarArray tabs; //FileTab
 	uxx currentTabIndex;
+	SessionVerifier sessionVerifier;
+	ParseCache parseCache;
+	FolderScan folderScan;
+	UsageIndex usageIndex;
+	IncludeGraph includeGraph;
+	DefineResolver defineResolver;
 	FileTab* currentTab;
 	bool usingKeyboardToSelect;
+	EditableText optionsFilter;
+	bool optionsFilterChanged; //set when the filter text, the current tab or its options change so visibleOptions gets recalculated
+	VarArray visibleOptions; //uxx, ascending indices into currentTab->fileOptions that match optionsFilter (unused while the filter is empty)
 	
 	ClayTextbox testTextbox;
 	u64 testTooltipId;
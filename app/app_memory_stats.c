@@ -0,0 +1,286 @@
+/*
+File:   app_memory_stats.c
+Description:
+	** Gathers how much memory each arena and subsystem is holding so it can be shown in the memory panel
+	** (ToggleMemoryStats) or written to a file (DumpMemoryStats). Arenas report their own counters. Things that
+	** live in stdHeap next to everything else (tabs, fonts, the theme) can't be separated out that way so their
+	** size is added up from the structures they hold, which makes those entries estimates.
+	** The scratch arenas are 4GB reservations, so we also track the most each of them is used during a frame
+	** (and the most any worker thread used before exiting) to know how much of that is actually needed.
+*/
+
+void InitMemoryStats(MemoryStats* statsOut)
+{
+	NotNull(statsOut);
+	ClearPointer(statsOut);
+	InitMutex(&statsOut->workerMutex);
+	statsOut->isInitialized = true;
+}
+
+void GetThreadScratchArenas(Arena** arenasOut)
+{
+	Assert(NUM_SCRATCH_ARENAS_PER_THREAD == 3);
+	arenasOut[0] = GetScratch(nullptr);
+	arenasOut[1] = GetScratch1(arenasOut[0], nullptr);
+	arenasOut[2] = GetScratch2(arenasOut[0], arenasOut[1], nullptr);
+}
+
+// Called at the top of AppUpdate. highUsedMark is reset every frame so it holds the peak for just that frame
+void UpdateMemoryStats(MemoryStats* stats)
+{
+	NotNull(stats);
+	if (!stats->isInitialized) { return; }
+	Arena* scratchArenas[NUM_SCRATCH_ARENAS_PER_THREAD];
+	GetThreadScratchArenas(&scratchArenas[0]);
+	for (uxx sIndex = 0; sIndex < NUM_SCRATCH_ARENAS_PER_THREAD; sIndex++)
+	{
+		Arena* scratchArena = scratchArenas[sIndex];
+		stats->scratchFramePeaks[sIndex] = scratchArena->highUsedMark;
+		stats->scratchPeaks[sIndex] = MaxUXX(stats->scratchPeaks[sIndex], scratchArena->highUsedMark);
+		stats->scratchReserved[sIndex] = scratchArena->size;
+		scratchArena->highUsedMark = scratchArena->used;
+	}
+}
+
+// Worker threads call this right before they free their scratch arenas
+void ReportWorkerScratchUsage()
+{
+	if (app == nullptr || !app->memoryStats.isInitialized) { return; }
+	MemoryStats* stats = &app->memoryStats;
+	Arena* scratchArenas[NUM_SCRATCH_ARENAS_PER_THREAD];
+	GetThreadScratchArenas(&scratchArenas[0]);
+	LockMutex(&stats->workerMutex, TIMEOUT_FOREVER);
+	for (uxx sIndex = 0; sIndex < NUM_SCRATCH_ARENAS_PER_THREAD; sIndex++)
+	{
+		stats->workerScratchPeaks[sIndex] = MaxUXX(stats->workerScratchPeaks[sIndex], scratchArenas[sIndex]->highUsedMark);
+		stats->workerScratchReserved[sIndex] = scratchArenas[sIndex]->size;
+	}
+	stats->numWorkerReports++;
+	UnlockMutex(&stats->workerMutex);
+}
+
+// +--------------------------------------------------------------+
+// |                          Gathering                           |
+// +--------------------------------------------------------------+
+MemoryStatsEntry* AddMemoryStatsEntry(VarArray* entries, const char* subsystem, Str8 name)
+{
+	MemoryStatsEntry* entry = VarArrayAdd(MemoryStatsEntry, entries);
+	NotNull(entry);
+	ClearPointer(entry);
+	entry->subsystem = MakeStr8Nt(subsystem);
+	entry->name = name;
+	return entry;
+}
+
+//NOTE: StdHeap arenas don't reserve or commit anything up front, they just pass each allocation along to malloc, so those columns are 0 for them
+void AddArenaMemoryStatsEntry(VarArray* entries, const char* subsystem, Str8 name, const Arena* arena)
+{
+	MemoryStatsEntry* entry = AddMemoryStatsEntry(entries, subsystem, name);
+	entry->liveBytes = arena->used;
+	entry->peakBytes = arena->highUsedMark;
+	entry->allocCount = arena->allocCount;
+	entry->committedBytes = arena->committed;
+	entry->reservedBytes = (arena->size != UINTXX_MAX) ? arena->size : 0;
+}
+
+uxx EstimateThemeDefinitionSize(const ThemeDefinition* themeDef)
+{
+	return themeDef->entries.allocLength * sizeof(ThemeDefEntry) + themeDef->buckets.allocLength * sizeof(uxx);
+}
+
+uxx EstimateFontSize(const PigFont* font)
+{
+	uxx result = 0;
+	VarArrayLoop(&font->atlases, aIndex)
+	{
+		VarArrayLoopGet(FontAtlas, atlas, &font->atlases, aIndex);
+		result += (uxx)atlas->texture.width * (uxx)atlas->texture.height * sizeof(Color32); //the copy on the GPU, not in any arena
+		result += atlas->glyphs.allocLength * sizeof(FontGlyph);
+	}
+	return result;
+}
+
+uxx EstimateFileTabSize(const FileTab* tab)
+{
+	uxx result = tab->filePath.length + tab->fileContents.length + tab->originalFileContents.length;
+	result += tab->fileOptions.allocLength * sizeof(FileOption);
+	VarArrayLoop(&tab->fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+		result += option->name.length + option->abbreviation.length + option->valueStr.length + option->commentedName.length;
+	}
+	result += tab->optionSources.allocLength * sizeof(Str8);
+	VarArrayLoop(&tab->optionSources, sIndex)
+	{
+		VarArrayLoopGet(Str8, optionSource, &tab->optionSources, sIndex);
+		result += optionSource->length;
+	}
+	return result;
+}
+
+// Fills entries with MemoryStatsEntry. Names are allocated from arena
+void GatherMemoryStats(Arena* arena, VarArray* entries)
+{
+	NotNull(arena);
+	NotNull(entries);
+	MemoryStats* stats = &app->memoryStats;
+	
+	AddArenaMemoryStatsEntry(entries, "Heap", StrLit("stdHeap"), stdHeap);
+	
+	Arena* scratchArenas[NUM_SCRATCH_ARENAS_PER_THREAD];
+	GetThreadScratchArenas(&scratchArenas[0]);
+	for (uxx sIndex = 0; sIndex < NUM_SCRATCH_ARENAS_PER_THREAD; sIndex++)
+	{
+		Str8 name = (scratchArenas[sIndex] == uiArena)
+			? PrintInArenaStr(arena, "Main Scratch %llu (uiArena)", (u64)sIndex)
+			: PrintInArenaStr(arena, "Main Scratch %llu", (u64)sIndex);
+		AddArenaMemoryStatsEntry(entries, "Scratch", name, scratchArenas[sIndex]);
+		MemoryStatsEntry* entry = VarArrayGetLast(MemoryStatsEntry, entries);
+		entry->peakBytes = stats->scratchPeaks[sIndex];
+		entry->framePeakBytes = stats->scratchFramePeaks[sIndex];
+	}
+	LockMutex(&stats->workerMutex, TIMEOUT_FOREVER);
+	for (uxx sIndex = 0; sIndex < NUM_SCRATCH_ARENAS_PER_THREAD; sIndex++)
+	{
+		MemoryStatsEntry* entry = AddMemoryStatsEntry(entries, "Scratch", PrintInArenaStr(arena, "Worker Scratch %llu (%llu threads)", (u64)sIndex, (u64)stats->numWorkerReports));
+		entry->peakBytes = stats->workerScratchPeaks[sIndex];
+		entry->reservedBytes = stats->workerScratchReserved[sIndex];
+	}
+	UnlockMutex(&stats->workerMutex);
+	
+	AddArenaMemoryStatsEntry(entries, "Profiler", StrLit("namesArena"), &app->profiler.namesArena);
+	AddArenaMemoryStatsEntry(entries, "Profiler", StrLit("captureArena"), &app->profiler.captureArena);
+	if (app->startup.isStarted && !app->startup.isFinished)
+	{
+		for (uxx tIndex = 1; tIndex < StartupTask_Count; tIndex++)
+		{
+			AddArenaMemoryStatsEntry(entries, "Startup", MakeStr8Nt(GetStartupTaskStr((StartupTask)tIndex)), &app->startup.tasks[tIndex].arena);
+		}
+	}
+	AddArenaMemoryStatsEntry(entries, "UsageIndex", StrLit("jobHeap"), &app->usageIndex.jobHeap);
+	AddArenaMemoryStatsEntry(entries, "IncludeGraph", StrLit("jobHeap"), &app->includeGraph.jobHeap);
+	AddArenaMemoryStatsEntry(entries, "DefineResolver", StrLit("cacheHeap"), &app->defineResolver.cacheHeap);
+	AddArenaMemoryStatsEntry(entries, "DefineResolver", StrLit("jobHeap"), &app->defineResolver.jobHeap);
+	AddArenaMemoryStatsEntry(entries, "FolderScan", StrLit("resultsHeap"), &app->folderScan.resultsHeap);
+	for (uxx wIndex = 0; wIndex < FOLDER_SCAN_NUM_THREADS; wIndex++)
+	{
+		AddArenaMemoryStatsEntry(entries, "FolderScan", PrintInArenaStr(arena, "worker %llu heap", (u64)wIndex), &app->folderScan.workers[wIndex].heap);
+	}
+	AddArenaMemoryStatsEntry(entries, "Session", StrLit("threadHeap"), &app->sessionVerifier.threadHeap);
+	
+	VarArrayLoop(&app->tabs, tIndex)
+	{
+		VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+		MemoryStatsEntry* entry = AddMemoryStatsEntry(entries, "Tabs", AllocStr8(arena, GetFileNamePart(tab->filePath, true)));
+		entry->isEstimate = true;
+		entry->liveBytes = EstimateFileTabSize(tab);
+	}
+	MemoryStatsEntry* uiFontEntry = AddMemoryStatsEntry(entries, "Fonts", StrLit("uiFont"));
+	uiFontEntry->isEstimate = true;
+	uiFontEntry->liveBytes = EstimateFontSize(&app->uiFont);
+	MemoryStatsEntry* mainFontEntry = AddMemoryStatsEntry(entries, "Fonts", StrLit("mainFont"));
+	mainFontEntry->isEstimate = true;
+	mainFontEntry->liveBytes = EstimateFontSize(&app->mainFont);
+	MemoryStatsEntry* bakedThemesEntry = AddMemoryStatsEntry(entries, "Theme", StrLit("bakedThemes"));
+	bakedThemesEntry->isEstimate = true;
+	bakedThemesEntry->liveBytes = sizeof(app->bakedThemes);
+	MemoryStatsEntry* themeDefsEntry = AddMemoryStatsEntry(entries, "Theme", StrLit("definitions"));
+	themeDefsEntry->isEstimate = true;
+	themeDefsEntry->liveBytes = EstimateThemeDefinitionSize(&app->defaultTheme) + EstimateThemeDefinitionSize(&app->userThemeOverrides) + EstimateThemeDefinitionSize(&app->bakedThemeDef);
+}
+
+// Something like "1.25MB", 0 comes out as "-" so columns that don't apply to an entry stay quiet
+Str8 FormatMemoryStatsBytes(Arena* arena, uxx numBytes)
+{
+	if (numBytes == 0) { return StrLit("-"); }
+	if (numBytes < Kilobytes(1)) { return PrintInArenaStr(arena, "%lluB", (u64)numBytes); }
+	if (numBytes < Megabytes(1)) { return PrintInArenaStr(arena, "%.1fkB", (r64)numBytes / (r64)Kilobytes(1)); }
+	if (numBytes < Gigabytes(1)) { return PrintInArenaStr(arena, "%.2fMB", (r64)numBytes / (r64)Megabytes(1)); }
+	return PrintInArenaStr(arena, "%.2fGB", (r64)numBytes / (r64)Gigabytes(1));
+}
+
+// +--------------------------------------------------------------+
+// |                           Display                            |
+// +--------------------------------------------------------------+
+void RenderMemoryStatsPanel(v2 topLeft)
+{
+	if (!app->memoryStats.isInitialized) { return; }
+	ScratchBegin(scratch);
+	VarArray entries;
+	InitVarArray(MemoryStatsEntry, &entries, scratch);
+	GatherMemoryStats(scratch, &entries);
+	
+	BindFontEx(&app->uiFont, app->uiFontSize, UI_FONT_STYLE);
+	FontAtlas* fontAtlas = GetFontAtlas(&app->uiFont, app->uiFontSize, UI_FONT_STYLE);
+	r32 lineHeight = GetLineHeight();
+	rec panelRec = MakeRec(topLeft.x, topLeft.y, MEMORY_STATS_PANEL_WIDTH, lineHeight * (entries.length+1) + 4);
+	DrawRectangle(panelRec, ColorWithAlpha(MonokaiBack, 0.85f));
+	DrawRectangleOutline(panelRec, 1, MonokaiGray1);
+	
+	const char* columnNames[] = { "Name", "Live", "Peak", "Frame Peak", "Allocs", "Committed", "Reserved" };
+	r32 columnX[ArrayCount(columnNames)] = {
+		panelRec.x + 4,
+		panelRec.x + panelRec.width - 480,
+		panelRec.x + panelRec.width - 400,
+		panelRec.x + panelRec.width - 320,
+		panelRec.x + panelRec.width - 240,
+		panelRec.x + panelRec.width - 160,
+		panelRec.x + panelRec.width - 80,
+	};
+	r32 textY = panelRec.y + 2 + lineHeight/2 + fontAtlas->centerOffset;
+	for (uxx cIndex = 0; cIndex < ArrayCount(columnNames); cIndex++) { DrawText(MakeStr8Nt(columnNames[cIndex]), MakeV2(columnX[cIndex], textY), MonokaiGray1); }
+	textY += lineHeight;
+	
+	VarArrayLoop(&entries, eIndex)
+	{
+		VarArrayLoopGet(MemoryStatsEntry, entry, &entries, eIndex);
+		Color32 textColor = entry->isEstimate ? MonokaiLightGray : MonokaiWhite;
+		DrawText(PrintInArenaStr(scratch, "%.*s %.*s%s", StrPrint(entry->subsystem), StrPrint(entry->name), entry->isEstimate ? " (est.)" : ""), MakeV2(columnX[0], textY), textColor);
+		DrawText(FormatMemoryStatsBytes(scratch, entry->liveBytes), MakeV2(columnX[1], textY), textColor);
+		DrawText(FormatMemoryStatsBytes(scratch, entry->peakBytes), MakeV2(columnX[2], textY), textColor);
+		DrawText(FormatMemoryStatsBytes(scratch, entry->framePeakBytes), MakeV2(columnX[3], textY), textColor);
+		DrawText((entry->allocCount > 0) ? PrintInArenaStr(scratch, "%llu", (u64)entry->allocCount) : StrLit("-"), MakeV2(columnX[4], textY), textColor);
+		DrawText(FormatMemoryStatsBytes(scratch, entry->committedBytes), MakeV2(columnX[5], textY), textColor);
+		DrawText(FormatMemoryStatsBytes(scratch, entry->reservedBytes), MakeV2(columnX[6], textY), textColor);
+		textY += lineHeight;
+	}
+	
+	ScratchEnd(scratch);
+}
+
+// Writes the same table as the panel to a text file in the settings folder (and the debug output)
+void DumpMemoryStats()
+{
+	ScratchBegin(scratch);
+	VarArray entries;
+	InitVarArray(MemoryStatsEntry, &entries, scratch);
+	GatherMemoryStats(scratch, &entries);
+	
+	TwoPassStr8Loop(result, scratch, false)
+	{
+		TwoPassPrint(&result, "%-48s %10s %10s %10s %8s %10s %10s\n", "Name", "Live", "Peak", "FramePeak", "Allocs", "Committed", "Reserved");
+		VarArrayLoop(&entries, eIndex)
+		{
+			VarArrayLoopGet(MemoryStatsEntry, entry, &entries, eIndex);
+			Str8 nameStr = PrintInArenaStr(scratch, "%.*s %.*s%s", StrPrint(entry->subsystem), StrPrint(entry->name), entry->isEstimate ? " (est.)" : "");
+			TwoPassPrint(&result, "%-48.*s %10llu %10llu %10llu %8llu %10llu %10llu\n",
+				StrPrint(nameStr),
+				(u64)entry->liveBytes,
+				(u64)entry->peakBytes,
+				(u64)entry->framePeakBytes,
+				(u64)entry->allocCount,
+				(u64)entry->committedBytes,
+				(u64)entry->reservedBytes
+			);
+		}
+		TwoPassStr8LoopEnd(&result);
+	}
+	PrintLine_I("%.*s", StrPrint(result.str));
+	
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), true);
+	Str8 fileName = PrintInArenaStr(scratch, MEMORY_STATS_DUMP_FILENAME_FORMAT, OsGetCurrentTimestamp(false));
+	FilePath dumpPath = JoinStringsInArenaWithChar(scratch, folderPath, '/', fileName, false);
+	if (!AppWriteTextFile(dumpPath, result.str)) { NotifyPrint_E("Failed to write memory stats to \"%.*s\"", StrPrint(dumpPath)); }
+	else { NotifyPrint_I("Wrote memory stats to \"%.*s\"", StrPrint(dumpPath)); }
+	ScratchEnd(scratch);
+}
@@ -0,0 +1,131 @@
+/*
+File:   app_name_table.h
+Description:
+	** A NameTable is a case-insensitive perfect hash table that maps a fixed list of names (usually the names from an enum or X-List) to their index
+	** The table is built once with InitNameTable and afterwards every lookup is a single hash and a single string comparison
+	** We use a "hash and displace" scheme: names are first sorted into buckets by one hash, then each bucket searches for a
+	** seed value that sends all of its names to empty slots. A lookup only needs the seed for the bucket it lands in.
+	** NOTE: The names are usually slices of string literals so tables need to be re-initialized if the app dll is reloaded (see InitAppNameTables)
+*/
+
+#ifndef _APP_NAME_TABLE_H
+#define _APP_NAME_TABLE_H
+
+#define NAME_TABLE_MAX_NAMES     256
+#define NAME_TABLE_MAX_SLOTS     (NAME_TABLE_MAX_NAMES*2)
+#define NAME_TABLE_MAX_SEED_TRIES 100000
+
+typedef plex NameTable NameTable;
+plex NameTable
+{
+	bool isInitialized;
+	uxx numBuckets;
+	uxx numSlots;
+	u32 bucketSeeds[NAME_TABLE_MAX_NAMES];
+	uxx slotValues[NAME_TABLE_MAX_SLOTS]; //index+1 of the name in this slot (0 = empty slot)
+	Str8 slotNames[NAME_TABLE_MAX_SLOTS];
+};
+
+//NOTE: Only ASCII letters are folded, which matches what StrAnyCaseEquals considers equal
+u32 HashNameAnyCase(Str8 name, u32 seed)
+{
+	u32 result = 0x811C9DC5u ^ (seed * 0x9E3779B9u);
+	for (uxx cIndex = 0; cIndex < name.length; cIndex++)
+	{
+		u8 nameChar = (u8)name.chars[cIndex];
+		if (nameChar >= 'A' && nameChar <= 'Z') { nameChar = (u8)(nameChar - 'A' + 'a'); }
+		result ^= nameChar;
+		result *= 0x01000193u;
+	}
+	result ^= (result >> 15);
+	return result;
+}
+
+// names can contain nullptr entries for indices that should not be findable (like the "None" value of most enums)
+// Returns false if there are duplicate names (case-insensitively) or no seed could be found for some bucket
+bool InitNameTable(NameTable* table, uxx numNames, const char* const* names)
+{
+	NotNull(table);
+	Assert(numNames <= NAME_TABLE_MAX_NAMES);
+	ClearPointer(table);
+	table->numBuckets = MaxUXX(numNames, 1);
+	table->numSlots = MaxUXX(numNames * 2, 1);
+	
+	uxx maxBucketSize = 0;
+	uxx bucketSizes[NAME_TABLE_MAX_NAMES] = ZEROED;
+	for (uxx nIndex = 0; nIndex < numNames; nIndex++)
+	{
+		if (names[nIndex] == nullptr) { continue; }
+		uxx bucketIndex = HashNameAnyCase(MakeStr8Nt(names[nIndex]), 0) % table->numBuckets;
+		bucketSizes[bucketIndex]++;
+		maxBucketSize = MaxUXX(maxBucketSize, bucketSizes[bucketIndex]);
+	}
+	
+	// Larger buckets are placed first while the table is mostly empty since they are the hardest to find a seed for
+	uxx bucketNameIndices[NAME_TABLE_MAX_NAMES];
+	uxx bucketSlotIndices[NAME_TABLE_MAX_NAMES];
+	for (uxx bucketSize = maxBucketSize; bucketSize > 0; bucketSize--)
+	{
+		for (uxx bIndex = 0; bIndex < table->numBuckets; bIndex++)
+		{
+			if (bucketSizes[bIndex] != bucketSize) { continue; }
+			uxx numBucketNames = 0;
+			for (uxx nIndex = 0; nIndex < numNames; nIndex++)
+			{
+				if (names[nIndex] != nullptr && HashNameAnyCase(MakeStr8Nt(names[nIndex]), 0) % table->numBuckets == bIndex)
+				{
+					//Duplicate names always hash to the same bucket and would never find a seed
+					for (uxx prevIndex = 0; prevIndex < numBucketNames; prevIndex++)
+					{
+						if (StrAnyCaseEquals(MakeStr8Nt(names[bucketNameIndices[prevIndex]]), MakeStr8Nt(names[nIndex]))) { return false; }
+					}
+					bucketNameIndices[numBucketNames] = nIndex;
+					numBucketNames++;
+				}
+			}
+			
+			bool foundSeed = false;
+			for (u32 seed = 1; seed <= NAME_TABLE_MAX_SEED_TRIES && !foundSeed; seed++)
+			{
+				foundSeed = true;
+				for (uxx bnIndex = 0; bnIndex < numBucketNames; bnIndex++)
+				{
+					uxx slotIndex = HashNameAnyCase(MakeStr8Nt(names[bucketNameIndices[bnIndex]]), seed) % table->numSlots;
+					if (table->slotValues[slotIndex] != 0) { foundSeed = false; break; }
+					for (uxx prevIndex = 0; prevIndex < bnIndex; prevIndex++)
+					{
+						if (bucketSlotIndices[prevIndex] == slotIndex) { foundSeed = false; break; }
+					}
+					if (!foundSeed) { break; }
+					bucketSlotIndices[bnIndex] = slotIndex;
+				}
+				if (foundSeed) { table->bucketSeeds[bIndex] = seed; }
+			}
+			if (!foundSeed) { return false; }
+			
+			for (uxx bnIndex = 0; bnIndex < numBucketNames; bnIndex++)
+			{
+				table->slotValues[bucketSlotIndices[bnIndex]] = bucketNameIndices[bnIndex] + 1;
+				table->slotNames[bucketSlotIndices[bnIndex]] = MakeStr8Nt(names[bucketNameIndices[bnIndex]]);
+			}
+		}
+	}
+	
+	table->isInitialized = true;
+	return true;
+}
+
+// Returns the index of the name in the list passed to InitNameTable, or UINTXX_MAX if it's not in the table
+uxx FindNameTableIndex(const NameTable* table, Str8 name)
+{
+	NotNull(table);
+	DebugAssertMsg(table->isInitialized, "NameTable was used before InitAppNameTables was called!");
+	if (!table->isInitialized) { return UINTXX_MAX; }
+	u32 bucketSeed = table->bucketSeeds[HashNameAnyCase(name, 0) % table->numBuckets];
+	if (bucketSeed == 0) { return UINTXX_MAX; }
+	uxx slotIndex = HashNameAnyCase(name, bucketSeed) % table->numSlots;
+	if (table->slotValues[slotIndex] == 0 || !StrAnyCaseEquals(table->slotNames[slotIndex], name)) { return UINTXX_MAX; }
+	return table->slotValues[slotIndex] - 1;
+}
+
+#endif //  _APP_NAME_TABLE_H
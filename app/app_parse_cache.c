@@ -0,0 +1,477 @@
+/*
+File:   app_parse_cache.c
+Description:
+	** The parse cache remembers the option table of files we have parsed before, keyed by a hash of the file's
+	** contents, so opening (or reloading) a file we have already seen only costs a read and a hash instead of a
+	** full pass through UpdateFileTabOptions. Entries are kept in memory and written to parse_cache.bin in the
+	** settings folder when the app closes. When the entries add up to more than PARSE_CACHE_MAX_SIZE bytes
+	** the least recently used ones are evicted. Entries are found through hash buckets on contentHash and kept
+	** in a linked list from least to most recently used, so a lookup or an eviction never walks every entry.
+	** This file also holds the option table serialization that session.bin uses (see app_session.c)
+*/
+
+// +--------------------------------------------------------------+
+// |                   Option Table Serialization                 |
+// +--------------------------------------------------------------+
+// Writes are done in two passes, the first pass only counts bytes (bytes == nullptr)
+typedef plex SerialWriter SerialWriter;
+plex SerialWriter
+{
+	u8* bytes;
+	uxx size;
+};
+void SerialWrite(SerialWriter* writer, uxx numBytes, const void* bytesPntr)
+{
+	if (writer->bytes != nullptr && numBytes > 0) { MyMemCopy(&writer->bytes[writer->size], bytesPntr, numBytes); }
+	writer->size += numBytes;
+}
+
+typedef plex SerialReader SerialReader;
+plex SerialReader
+{
+	Slice data;
+	uxx cursor;
+};
+bool SerialRead(SerialReader* reader, uxx numBytes, void* bytesOut)
+{
+	if (numBytes > reader->data.length - reader->cursor) { return false; }
+	if (numBytes > 0) { MyMemCopy(bytesOut, &reader->data.bytes[reader->cursor], numBytes); }
+	reader->cursor += numBytes;
+	return true;
+}
+bool SerialReadStr(SerialReader* reader, uxx length, Str8* strOut)
+{
+	if (length > reader->data.length - reader->cursor) { return false; }
+	*strOut = NewStr8(length, &reader->data.chars[reader->cursor]);
+	reader->cursor += length;
+	return true;
+}
+
+// An option table is FileOptionRecord[numOptions] followed by the name and value chars of each option
+typedef plex FileOptionRecord FileOptionRecord;
+plex FileOptionRecord
+{
+	u64 startIndex;
+	u64 endIndex;
+	u64 numEmptyLinesAfter;
+	u32 nameLength;
+	u32 valueLength;
+	u8 type; //FileOptionType
+	u8 value; //valueBool or isUncommented
+	u8 padding[6];
+};
+
+void WriteFileOptionTable(SerialWriter* writer, const VarArray* fileOptions)
+{
+	VarArrayLoop(fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, fileOptions, oIndex);
+		FileOptionRecord optionRecord = ZEROED;
+		optionRecord.startIndex = option->fileContentsStartIndex;
+		optionRecord.endIndex = option->fileContentsEndIndex;
+		optionRecord.numEmptyLinesAfter = option->numEmptyLinesAfter;
+		optionRecord.nameLength = (u32)option->name.length;
+		optionRecord.valueLength = (u32)option->valueStr.length;
+		optionRecord.type = (u8)option->type;
+		optionRecord.value = option->valueBool ? 1 : 0;
+		SerialWrite(writer, sizeof(optionRecord), &optionRecord);
+	}
+	VarArrayLoop(fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, fileOptions, oIndex);
+		SerialWrite(writer, option->name.length, option->name.chars);
+		SerialWrite(writer, option->valueStr.length, option->valueStr.chars);
+	}
+}
+
+// Adds numOptions FileOptions to the array. Returns false if the data is malformed (any options that were added are left for the caller to free)
+bool ReadFileOptionTable(SerialReader* reader, u64 numOptions, u64 fileSize, VarArray* fileOptionsOut)
+{
+	if (numOptions > (reader->data.length - reader->cursor) / sizeof(FileOptionRecord)) { return false; }
+	ScratchBegin(scratch);
+	FileOptionRecord* optionRecords = AllocArray(FileOptionRecord, scratch, (uxx)numOptions);
+	if (numOptions > 0 && optionRecords == nullptr) { ScratchEnd(scratch); return false; }
+	if (!SerialRead(reader, sizeof(FileOptionRecord) * (uxx)numOptions, optionRecords)) { ScratchEnd(scratch); return false; }
+	
+	for (uxx oIndex = 0; oIndex < numOptions; oIndex++)
+	{
+		const FileOptionRecord* optionRecord = &optionRecords[oIndex];
+		Str8 nameStr = Str8_Empty;
+		Str8 valueStr = Str8_Empty;
+		if (!SerialReadStr(reader, optionRecord->nameLength, &nameStr) ||
+			!SerialReadStr(reader, optionRecord->valueLength, &valueStr) ||
+			optionRecord->type == FileOptionType_None || optionRecord->type >= FileOptionType_Count ||
+			optionRecord->startIndex > optionRecord->endIndex || optionRecord->endIndex > fileSize ||
+			IsEmptyStr(nameStr))
+		{
+			ScratchEnd(scratch);
+			return false;
+		}
+		
+		FileOption* newOption = VarArrayAdd(FileOption, fileOptionsOut);
+		NotNull(newOption);
+		ClearPointer(newOption);
+		newOption->name = AllocStr8(stdHeap, nameStr);
+		newOption->abbreviation = GetOptionNameAbbreviation(stdHeap, newOption->name);
+		newOption->type = (FileOptionType)optionRecord->type;
+		newOption->valueBool = (optionRecord->value != 0);
+		newOption->numEmptyLinesAfter = optionRecord->numEmptyLinesAfter;
+		newOption->fileContentsStartIndex = (uxx)optionRecord->startIndex;
+		newOption->fileContentsEndIndex = (uxx)optionRecord->endIndex;
+		newOption->valueStr = AllocStr8(stdHeap, valueStr);
+	}
+	ScratchEnd(scratch);
+	return true;
+}
+
+// +--------------------------------------------------------------+
+// |                         Parse Cache                          |
+// +--------------------------------------------------------------+
+// parse_cache.bin is a ParseCacheHeader followed by numEntries of ParseCacheEntryRecord + option table (tableSize bytes)
+#define PARSE_CACHE_MAGIC   0x43504343 //"CCPC"
+#define PARSE_CACHE_VERSION 2
+//NOTE: The tables are only valid for the parser that made them, so the file is thrown away if FILE_OPTION_PARSER_REVISION or the size of FileOption
+// (a cheap way to notice that fields were added without anyone bumping the revision) don't match what we were built with
+typedef plex ParseCacheHeader ParseCacheHeader;
+plex ParseCacheHeader
+{
+	u32 magic;
+	u32 version;
+	u32 entryRecordSize;
+	u32 optionRecordSize;
+	u32 parserRevision;
+	u32 fileOptionSize;
+	u64 numEntries;
+};
+typedef plex ParseCacheEntryRecord ParseCacheEntryRecord;
+plex ParseCacheEntryRecord
+{
+	u64 contentHash;
+	u64 fileSize;
+	u64 numOptions;
+	u64 tableSize;
+};
+
+FilePath GetParseCacheSavePath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = JoinStringsInArenaWithChar(arena, folderPath, '/', StrLit(PARSE_CACHE_FILENAME), false);
+	ScratchEnd(scratch);
+	return result;
+}
+
+void FreeParseCacheEntry(ParseCache* cache, ParseCacheEntry* entry)
+{
+	NotNull(cache);
+	NotNull(entry);
+	FreeStr8(cache->arena, &entry->table);
+	ClearPointer(entry);
+}
+
+void FreeParseCache(ParseCache* cache)
+{
+	NotNull(cache);
+	if (cache->arena != nullptr)
+	{
+		VarArrayLoop(&cache->entries, eIndex)
+		{
+			VarArrayLoopGet(ParseCacheEntry, entry, &cache->entries, eIndex);
+			FreeParseCacheEntry(cache, entry);
+		}
+		FreeVarArray(&cache->entries);
+		FreeVarArray(&cache->buckets);
+	}
+	ClearPointer(cache);
+}
+
+void InitParseCache(Arena* arena, ParseCache* cacheOut)
+{
+	NotNull(arena);
+	NotNull(cacheOut);
+	ClearPointer(cacheOut);
+	cacheOut->arena = arena;
+	InitVarArray(ParseCacheEntry, &cacheOut->entries, arena);
+	InitVarArrayWithInitial(uxx, &cacheOut->buckets, arena, PARSE_CACHE_MIN_NUM_BUCKETS);
+	ResetHashBuckets(&cacheOut->buckets, 0, PARSE_CACHE_MIN_NUM_BUCKETS);
+}
+
+// +--------------------------------------------------------------+
+// |                      Index and LRU Order                     |
+// +--------------------------------------------------------------+
+ParseCacheEntry* GetParseCacheEntry(ParseCache* cache, uxx entryIndexPlusOne)
+{
+	return (entryIndexPlusOne != 0) ? VarArrayGetHard(ParseCacheEntry, &cache->entries, entryIndexPlusOne-1) : nullptr;
+}
+uxx* GetParseCacheBucket(ParseCache* cache, u64 contentHash)
+{
+	return GetHashBucket(&cache->buckets, contentHash);
+}
+
+// Relinks every entry into the bucket chains, growing the bucket array so we stay at or below 1 entry per bucket on average
+void RebuildParseCacheBuckets(ParseCache* cache)
+{
+	NotNull(cache);
+	ResetHashBuckets(&cache->buckets, cache->entries.length, PARSE_CACHE_MIN_NUM_BUCKETS);
+	VarArrayLoop(&cache->entries, eIndex)
+	{
+		VarArrayLoopGet(ParseCacheEntry, entry, &cache->entries, eIndex);
+		uxx* bucket = GetParseCacheBucket(cache, entry->contentHash);
+		entry->nextInBucket = *bucket;
+		*bucket = eIndex+1;
+	}
+}
+
+// Returns index+1 of the entry, or 0 if we don't have one for these contents
+uxx FindParseCacheEntry(ParseCache* cache, u64 contentHash, u64 fileSize)
+{
+	uxx entryIndexPlusOne = *GetParseCacheBucket(cache, contentHash);
+	while (entryIndexPlusOne != 0)
+	{
+		ParseCacheEntry* entry = GetParseCacheEntry(cache, entryIndexPlusOne);
+		if (entry->contentHash == contentHash && entry->fileSize == fileSize) { return entryIndexPlusOne; }
+		entryIndexPlusOne = entry->nextInBucket;
+	}
+	return 0;
+}
+
+void UnlinkParseCacheEntryLru(ParseCache* cache, uxx entryIndexPlusOne)
+{
+	ParseCacheEntry* entry = GetParseCacheEntry(cache, entryIndexPlusOne);
+	if (entry->lruPrev != 0) { GetParseCacheEntry(cache, entry->lruPrev)->lruNext = entry->lruNext; }
+	else { cache->lruFirst = entry->lruNext; }
+	if (entry->lruNext != 0) { GetParseCacheEntry(cache, entry->lruNext)->lruPrev = entry->lruPrev; }
+	else { cache->lruLast = entry->lruPrev; }
+	entry->lruPrev = 0;
+	entry->lruNext = 0;
+}
+// Makes the entry the most recently used one
+void PushParseCacheEntryLru(ParseCache* cache, uxx entryIndexPlusOne)
+{
+	ParseCacheEntry* entry = GetParseCacheEntry(cache, entryIndexPlusOne);
+	entry->lruPrev = cache->lruLast;
+	entry->lruNext = 0;
+	if (cache->lruLast != 0) { GetParseCacheEntry(cache, cache->lruLast)->lruNext = entryIndexPlusOne; }
+	else { cache->lruFirst = entryIndexPlusOne; }
+	cache->lruLast = entryIndexPlusOne;
+}
+
+// The caller fills in the entry. It starts out as the most recently used one
+ParseCacheEntry* AddParseCacheEntry(ParseCache* cache, u64 contentHash, u64 fileSize)
+{
+	ParseCacheEntry* newEntry = VarArrayAdd(ParseCacheEntry, &cache->entries);
+	NotNull(newEntry);
+	ClearPointer(newEntry);
+	newEntry->contentHash = contentHash;
+	newEntry->fileSize = fileSize;
+	uxx newEntryIndexPlusOne = cache->entries.length;
+	if (cache->entries.length > cache->buckets.length) { RebuildParseCacheBuckets(cache); }
+	else
+	{
+		uxx* bucket = GetParseCacheBucket(cache, contentHash);
+		newEntry->nextInBucket = *bucket;
+		*bucket = newEntryIndexPlusOne;
+	}
+	PushParseCacheEntryLru(cache, newEntryIndexPlusOne);
+	return newEntry;
+}
+
+// Points whatever links to oldIndexPlusOne (its bucket chain and LRU neighbours) at newIndexPlusOne instead
+void RelinkParseCacheEntry(ParseCache* cache, uxx oldIndexPlusOne, uxx newIndexPlusOne)
+{
+	ParseCacheEntry* entry = GetParseCacheEntry(cache, oldIndexPlusOne);
+	uxx* link = GetParseCacheBucket(cache, entry->contentHash);
+	while (*link != oldIndexPlusOne) { link = &GetParseCacheEntry(cache, *link)->nextInBucket; }
+	*link = newIndexPlusOne;
+	if (entry->lruPrev != 0) { GetParseCacheEntry(cache, entry->lruPrev)->lruNext = newIndexPlusOne; }
+	else { cache->lruFirst = newIndexPlusOne; }
+	if (entry->lruNext != 0) { GetParseCacheEntry(cache, entry->lruNext)->lruPrev = newIndexPlusOne; }
+	else { cache->lruLast = newIndexPlusOne; }
+}
+
+// Frees the entry and moves the last entry into its slot so nothing else has to shift
+void RemoveParseCacheEntry(ParseCache* cache, uxx entryIndexPlusOne)
+{
+	NotNull(cache);
+	ParseCacheEntry* entry = GetParseCacheEntry(cache, entryIndexPlusOne);
+	uxx* link = GetParseCacheBucket(cache, entry->contentHash);
+	while (*link != entryIndexPlusOne) { link = &GetParseCacheEntry(cache, *link)->nextInBucket; }
+	*link = entry->nextInBucket;
+	UnlinkParseCacheEntryLru(cache, entryIndexPlusOne);
+	cache->totalSize -= entry->table.length;
+	FreeParseCacheEntry(cache, entry);
+	
+	uxx lastIndexPlusOne = cache->entries.length;
+	if (entryIndexPlusOne != lastIndexPlusOne)
+	{
+		RelinkParseCacheEntry(cache, lastIndexPlusOne, entryIndexPlusOne);
+		*entry = *GetParseCacheEntry(cache, lastIndexPlusOne);
+	}
+	VarArrayRemoveAt(ParseCacheEntry, &cache->entries, lastIndexPlusOne-1);
+	cache->isDirty = true;
+}
+
+// Drops the least recently used entries until there is room for numBytes more
+void EvictParseCacheEntries(ParseCache* cache, uxx numBytes)
+{
+	NotNull(cache);
+	while (cache->lruFirst != 0 && cache->totalSize + numBytes > PARSE_CACHE_MAX_SIZE)
+	{
+		RemoveParseCacheEntry(cache, cache->lruFirst);
+	}
+}
+
+// The cache file is read the first time we need it rather than in AppInit since a session restore might not open any files at all
+void LoadParseCache(ParseCache* cache)
+{
+	NotNull(cache);
+	NotNull(cache->arena);
+	if (cache->isLoaded) { return; }
+	cache->isLoaded = true;
+	ProfZoneBegin(_funcZone, "LoadParseCache");
+	ScratchBegin1(scratch, cache->arena);
+	FilePath savePath = GetParseCacheSavePath(scratch, false);
+	SerialReader reader = ZEROED;
+	ParseCacheHeader header = ZEROED;
+	if (!OsDoesFileExist(savePath) || !AppReadBinFile(savePath, scratch, &reader.data) ||
+		!SerialRead(&reader, sizeof(header), &header) ||
+		header.magic != PARSE_CACHE_MAGIC || header.version != PARSE_CACHE_VERSION ||
+		header.entryRecordSize != sizeof(ParseCacheEntryRecord) || header.optionRecordSize != sizeof(FileOptionRecord) ||
+		header.parserRevision != FILE_OPTION_PARSER_REVISION || header.fileOptionSize != (u32)sizeof(FileOption))
+	{
+		ScratchEnd(scratch);
+		ProfZoneEnd(_funcZone);
+		return;
+	}
+	
+	for (u64 eIndex = 0; eIndex < header.numEntries; eIndex++)
+	{
+		ParseCacheEntryRecord entryRecord = ZEROED;
+		Str8 tableStr = Str8_Empty;
+		if (!SerialRead(&reader, sizeof(entryRecord), &entryRecord) || !SerialReadStr(&reader, (uxx)entryRecord.tableSize, &tableStr))
+		{
+			WriteLine_W("Parse cache file is malformed, the remaining entries were dropped");
+			cache->isDirty = true;
+			break;
+		}
+		if (cache->totalSize + tableStr.length > PARSE_CACHE_MAX_SIZE) { cache->isDirty = true; continue; }
+		if (FindParseCacheEntry(cache, entryRecord.contentHash, entryRecord.fileSize) != 0) { cache->isDirty = true; continue; }
+		//NOTE: SaveParseCache writes the entries from least to most recently used, so adding them in file order restores the LRU order
+		ParseCacheEntry* newEntry = AddParseCacheEntry(cache, entryRecord.contentHash, entryRecord.fileSize);
+		newEntry->numOptions = entryRecord.numOptions;
+		newEntry->table = AllocStr8(cache->arena, tableStr);
+		cache->totalSize += newEntry->table.length;
+	}
+	PrintLine_D("Loaded parse cache: %llu entries, %llu bytes", (u64)cache->entries.length, (u64)cache->totalSize);
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+void SaveParseCache(ParseCache* cache)
+{
+	NotNull(cache);
+	if (cache->arena == nullptr || !cache->isDirty) { return; }
+	ProfZoneBegin(_funcZone, "SaveParseCache");
+	ScratchBegin1(scratch, cache->arena);
+	SerialWriter writer = ZEROED;
+	for (uxx pass = 0; pass < 2; pass++)
+	{
+		writer.size = 0;
+		ParseCacheHeader header = ZEROED;
+		header.magic = PARSE_CACHE_MAGIC;
+		header.version = PARSE_CACHE_VERSION;
+		header.entryRecordSize = sizeof(ParseCacheEntryRecord);
+		header.optionRecordSize = sizeof(FileOptionRecord);
+		header.parserRevision = FILE_OPTION_PARSER_REVISION;
+		header.fileOptionSize = (u32)sizeof(FileOption);
+		header.numEntries = cache->entries.length;
+		SerialWrite(&writer, sizeof(header), &header);
+		for (ParseCacheEntry* entry = GetParseCacheEntry(cache, cache->lruFirst); entry != nullptr; entry = GetParseCacheEntry(cache, entry->lruNext))
+		{
+			ParseCacheEntryRecord entryRecord = ZEROED;
+			entryRecord.contentHash = entry->contentHash;
+			entryRecord.fileSize = entry->fileSize;
+			entryRecord.numOptions = entry->numOptions;
+			entryRecord.tableSize = entry->table.length;
+			SerialWrite(&writer, sizeof(entryRecord), &entryRecord);
+			SerialWrite(&writer, entry->table.length, entry->table.chars);
+		}
+		if (pass == 0)
+		{
+			writer.bytes = (u8*)AllocMem(scratch, writer.size);
+			NotNull(writer.bytes);
+		}
+	}
+	
+	FilePath savePath = GetParseCacheSavePath(scratch, true);
+	//NOTE: The cache is only an optimization so we don't bother the user if this fails
+	if (!AppWriteBinFile(savePath, NewStr8(writer.size, writer.bytes))) { WriteLine_W("Failed to write parse cache file"); }
+	else { cache->isDirty = false; }
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// Fills tab->fileOptions from the cache if we have an entry for these exact file contents. The caller still needs to call FinalizeFileTabOptions
+bool TryLoadFileOptionsFromParseCache(ParseCache* cache, u64 contentHash, FileTab* tab)
+{
+	NotNull(cache);
+	NotNull(tab);
+	if (cache->arena == nullptr) { return false; }
+	LoadParseCache(cache);
+	uxx entryIndexPlusOne = FindParseCacheEntry(cache, contentHash, tab->fileContents.length);
+	if (entryIndexPlusOne == 0) { return false; }
+	ParseCacheEntry* entry = GetParseCacheEntry(cache, entryIndexPlusOne);
+	
+	ProfZoneBegin(_funcZone, "ParseCacheHit");
+	SerialReader reader = ZEROED;
+	reader.data = entry->table;
+	if (!ReadFileOptionTable(&reader, entry->numOptions, entry->fileSize, &tab->fileOptions) || reader.cursor != reader.data.length)
+	{
+		WriteLine_W("Parse cache entry is malformed, dropping it");
+		VarArrayLoop(&tab->fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+			FreeFileOption(option);
+		}
+		VarArrayClear(&tab->fileOptions);
+		RemoveParseCacheEntry(cache, entryIndexPlusOne);
+		ProfZoneEnd(_funcZone);
+		return false;
+	}
+	UnlinkParseCacheEntryLru(cache, entryIndexPlusOne);
+	PushParseCacheEntryLru(cache, entryIndexPlusOne);
+	cache->isDirty = true;
+	ProfZoneEnd(_funcZone);
+	return true;
+}
+
+// Called after a tab was parsed the slow way
+void AddFileOptionsToParseCache(ParseCache* cache, u64 contentHash, const FileTab* tab)
+{
+	NotNull(cache);
+	NotNull(tab);
+	if (cache->arena == nullptr) { return; }
+	LoadParseCache(cache);
+	
+	SerialWriter writer = ZEROED;
+	WriteFileOptionTable(&writer, &tab->fileOptions);
+	if (writer.size > PARSE_CACHE_MAX_SIZE) { return; }
+	uxx existingIndexPlusOne = FindParseCacheEntry(cache, contentHash, tab->fileContents.length);
+	if (existingIndexPlusOne != 0) { RemoveParseCacheEntry(cache, existingIndexPlusOne); }
+	EvictParseCacheEntries(cache, writer.size);
+	
+	ParseCacheEntry* newEntry = AddParseCacheEntry(cache, contentHash, tab->fileContents.length);
+	newEntry->numOptions = tab->fileOptions.length;
+	newEntry->table.length = writer.size;
+	if (writer.size > 0)
+	{
+		newEntry->table.chars = (char*)AllocMem(cache->arena, writer.size);
+		NotNull(newEntry->table.chars);
+		writer.bytes = (u8*)newEntry->table.chars;
+		writer.size = 0;
+		WriteFileOptionTable(&writer, &tab->fileOptions);
+		Assert(writer.size == newEntry->table.length);
+	}
+	cache->totalSize += newEntry->table.length;
+	cache->isDirty = true;
+}
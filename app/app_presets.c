@@ -0,0 +1,579 @@
+/*
+File:   app_presets.c
+Description:
+	** A preset is a named list of "file | option | on/off" entries, stored in presets.txt in the
+	** settings folder (which is meant to be hand edited, SavePreset just gives you a starting point).
+	** Applying a preset is one transaction across every file it touches: all the new file contents are
+	** calculated in memory first, then each file gets a temp file (new contents) and a backup (old contents),
+	** a journal listing the files is written, and only then are the temp files renamed over the real ones.
+	** If any rename fails the backups are renamed back. If we crash in the middle, the journal is still there
+	** on the next startup and AppRecoverPresetJournal rolls everything back the same way.
+	** The transaction (CommitPresetFileChanges) is also how a batch of "set"/"toggle" IPC commands is written, see app_ipc.c
+*/
+
+FilePath GetPresetsSavePath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = JoinStringsInArenaWithChar(arena, folderPath, '/', StrLit(PRESETS_FILENAME), false);
+	ScratchEnd(scratch);
+	return result;
+}
+FilePath GetPresetJournalPath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = JoinStringsInArenaWithChar(arena, folderPath, '/', StrLit(PRESET_JOURNAL_FILENAME), false);
+	ScratchEnd(scratch);
+	return result;
+}
+
+void FreePreset(Preset* preset)
+{
+	NotNull(preset);
+	VarArrayLoop(&preset->entries, eIndex)
+	{
+		VarArrayLoopGet(PresetEntry, entry, &preset->entries, eIndex);
+		FreeStr8(stdHeap, &entry->filePath);
+		FreeStr8(stdHeap, &entry->optionName);
+	}
+	FreeVarArray(&preset->entries);
+	FreeStr8(stdHeap, &preset->name);
+	ClearPointer(preset);
+}
+
+void AppClearPresets()
+{
+	VarArrayLoop(&app->presets, pIndex)
+	{
+		VarArrayLoopGet(Preset, preset, &app->presets, pIndex);
+		FreePreset(preset);
+	}
+	VarArrayClear(&app->presets);
+	app->palettePresetsGeneration++;
+}
+
+Preset* AppAddPreset(Str8 name)
+{
+	Preset* newPreset = VarArrayAdd(Preset, &app->presets);
+	NotNull(newPreset);
+	ClearPointer(newPreset);
+	newPreset->name = AllocStr8(stdHeap, name);
+	newPreset->nameCharMask = GetFuzzyCharMask(newPreset->name);
+	InitVarArray(PresetEntry, &newPreset->entries, stdHeap);
+	app->palettePresetsGeneration++;
+	return newPreset;
+}
+
+Preset* AppFindPreset(Str8 name)
+{
+	VarArrayLoop(&app->presets, pIndex)
+	{
+		VarArrayLoopGet(Preset, preset, &app->presets, pIndex);
+		if (StrAnyCaseEquals(preset->name, name)) { return preset; }
+	}
+	return nullptr;
+}
+
+bool TryParsePresetEnabledStr(Str8 valueStr, bool* enabledOut)
+{
+	if (StrAnyCaseEquals(valueStr, StrLit("on")) || StrExactEquals(valueStr, StrLit("1")) || StrAnyCaseEquals(valueStr, StrLit("true"))) { SetOptionalOutPntr(enabledOut, true); return true; }
+	if (StrAnyCaseEquals(valueStr, StrLit("off")) || StrExactEquals(valueStr, StrLit("0")) || StrAnyCaseEquals(valueStr, StrLit("false"))) { SetOptionalOutPntr(enabledOut, false); return true; }
+	return false;
+}
+
+// +--------------------------------------------------------------+
+// |                        Load and Save                         |
+// +--------------------------------------------------------------+
+void AppLoadPresets()
+{
+	ProfZoneBegin(_funcZone, "AppLoadPresets");
+	ScratchBegin(scratch);
+	FilePath savePath = GetPresetsSavePath(scratch, false);
+	
+	Str8 fileContent = Str8_Empty;
+	if (AppReadTextFile(savePath, scratch, &fileContent))
+	{
+		AppClearPresets();
+		uxx numInvalidLines = 0;
+		Preset* currentPreset = nullptr;
+		LineParser parser = MakeLineParser(fileContent);
+		Str8 fullLine = ZEROED;
+		while (LineParserGetLine(&parser, &fullLine))
+		{
+			Str8 line = TrimWhitespace(fullLine);
+			if (IsEmptyStr(line) || StrExactStartsWith(line, StrLit("//"))) { continue; }
+			
+			if (StrExactStartsWith(line, StrLit("[")) && StrExactEndsWith(line, StrLit("]")))
+			{
+				Str8 presetName = TrimWhitespace(StrSlice(line, 1, line.length-1));
+				if (IsEmptyStr(presetName)) { numInvalidLines++; currentPreset = nullptr; continue; }
+				currentPreset = AppFindPreset(presetName);
+				if (currentPreset == nullptr) { currentPreset = AppAddPreset(presetName); }
+				continue;
+			}
+			
+			//NOTE: We split on the last two '|' characters so the path is the only part that could contain one
+			uxx valueSepIndex = line.length;
+			uxx nameSepIndex = line.length;
+			for (uxx cIndex = line.length; cIndex > 0; cIndex--)
+			{
+				if (line.chars[cIndex-1] != '|') { continue; }
+				if (valueSepIndex == line.length) { valueSepIndex = cIndex-1; }
+				else { nameSepIndex = cIndex-1; break; }
+			}
+			bool enabled = false;
+			if (currentPreset == nullptr || nameSepIndex >= line.length) { numInvalidLines++; continue; }
+			Str8 filePath = TrimWhitespace(StrSlice(line, 0, nameSepIndex));
+			Str8 optionName = TrimWhitespace(StrSlice(line, nameSepIndex+1, valueSepIndex));
+			Str8 valueStr = TrimWhitespace(StrSliceFrom(line, valueSepIndex+1));
+			if (IsEmptyStr(filePath) || IsEmptyStr(optionName) || !TryParsePresetEnabledStr(valueStr, &enabled)) { numInvalidLines++; continue; }
+			
+			PresetEntry* newEntry = VarArrayAdd(PresetEntry, &currentPreset->entries);
+			NotNull(newEntry);
+			ClearPointer(newEntry);
+			newEntry->filePath = AllocStr8(stdHeap, filePath);
+			newEntry->optionName = AllocStr8(stdHeap, optionName);
+			newEntry->enabled = enabled;
+		}
+		
+		if (numInvalidLines > 0) { NotifyPrint_W("Ignored %llu invalid line%s in %s", (u64)numInvalidLines, Plural(numInvalidLines, "s"), PRESETS_FILENAME); }
+		PrintLine_D("Loaded %llu preset%s from \"%.*s\"", (u64)app->presets.length, Plural(app->presets.length, "s"), StrPrint(savePath));
+		if (app->presetsWatchId == 0) { app->presetsWatchId = AddFileWatch(&app->fileWatches, savePath, CHECK_PRESETS_WRITE_TIME_PERIOD); }
+		else { ClearFileWatchChanged(&app->fileWatches, app->presetsWatchId); }
+	}
+	else { PrintLine_D("No presets file found at \"%.*s\"", StrPrint(savePath)); }
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+Str8 SerializePresets(Arena* arena)
+{
+	TwoPassStr8Loop(result, arena, false)
+	{
+		TwoPassStrNt(&result, "// Each [Name] starts a preset, followed by lines of: file path | OPTION_NAME | on/off\n");
+		TwoPassStrNt(&result, "// Applying a preset changes every file it lists at once (or none of them if something goes wrong).\n");
+		TwoPassStrNt(&result, "// Feel free to rename presets or remove lines for options the preset shouldn't touch.\n");
+		VarArrayLoop(&app->presets, pIndex)
+		{
+			VarArrayLoopGet(Preset, preset, &app->presets, pIndex);
+			TwoPassPrint(&result, "\n[%.*s]\n", StrPrint(preset->name));
+			VarArrayLoop(&preset->entries, eIndex)
+			{
+				VarArrayLoopGet(PresetEntry, entry, &preset->entries, eIndex);
+				TwoPassPrint(&result, "%.*s | %.*s | %s\n", StrPrint(entry->filePath), StrPrint(entry->optionName), entry->enabled ? "on" : "off");
+			}
+		}
+		TwoPassStr8LoopEnd(&result);
+	}
+	return result.str;
+}
+
+bool AppSavePresets()
+{
+	ScratchBegin(scratch);
+	FilePath savePath = GetPresetsSavePath(scratch, true);
+	Str8 fileContent = SerializePresets(scratch);
+	bool writeSuccess = AppWriteTextFileAtomically(savePath, fileContent);
+	if (writeSuccess)
+	{
+		if (app->presetsWatchId == 0) { app->presetsWatchId = AddFileWatch(&app->fileWatches, savePath, CHECK_PRESETS_WRITE_TIME_PERIOD); }
+		else { ClearFileWatchChanged(&app->fileWatches, app->presetsWatchId); }
+	}
+	else { NotifyPrint_E("Failed to save presets to \"%.*s\"", StrPrint(savePath)); }
+	ScratchEnd(scratch);
+	return writeSuccess;
+}
+
+// Records the current value of every option in every open tab as a new preset named "Preset N"
+void AppSavePresetFromOpenTabs()
+{
+	ScratchBegin(scratch);
+	if (app->tabs.length == 0) { Notify_W("Open some files before saving a preset"); ScratchEnd(scratch); return; }
+	
+	uxx presetNumber = app->presets.length+1;
+	Str8 presetName = PrintInArenaStr(scratch, "Preset %llu", (u64)presetNumber);
+	while (AppFindPreset(presetName) != nullptr) { presetNumber++; presetName = PrintInArenaStr(scratch, "Preset %llu", (u64)presetNumber); }
+	
+	Preset* newPreset = AppAddPreset(presetName);
+	VarArrayLoop(&app->tabs, tIndex)
+	{
+		VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+		FilePath fullPath = OsGetFullPath(scratch, tab->filePath);
+		uxx firstEntryIndex = newPreset->entries.length;
+		VarArrayLoop(&tab->fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+			if (option->type != FileOptionType_Bool && option->type != FileOptionType_CommentDefine) { continue; }
+			//NOTE: Applying an entry changes every option with that name in the file, so only the first one is recorded
+			bool isDuplicate = false;
+			for (uxx eIndex = firstEntryIndex; eIndex < newPreset->entries.length; eIndex++)
+			{
+				if (StrExactEquals(VarArrayGetHard(PresetEntry, &newPreset->entries, eIndex)->optionName, option->name)) { isDuplicate = true; break; }
+			}
+			if (isDuplicate) { continue; }
+			
+			PresetEntry* newEntry = VarArrayAdd(PresetEntry, &newPreset->entries);
+			NotNull(newEntry);
+			ClearPointer(newEntry);
+			newEntry->filePath = AllocStr8(stdHeap, fullPath);
+			newEntry->optionName = AllocStr8(stdHeap, option->name);
+			newEntry->enabled = (option->type == FileOptionType_Bool) ? option->valueBool : option->isUncommented;
+		}
+	}
+	
+	if (AppSavePresets())
+	{
+		NotifyPrint_I("Saved %llu option%s as \"%.*s\", you can rename it in %s", (u64)newPreset->entries.length, Plural(newPreset->entries.length, "s"), StrPrint(presetName), PRESETS_FILENAME);
+	}
+	ScratchEnd(scratch);
+}
+
+// +--------------------------------------------------------------+
+// |                         Transaction                          |
+// +--------------------------------------------------------------+
+// Returns true (and the text that should replace the option's value) if the option doesn't already match the entry
+// Returns false if the option is already in that state (or isn't a type that can be turned on and off)
+bool GetOptionNewValueStr(const FileOption* option, bool enabled, Str8* newValueOut)
+{
+	if (option->type == FileOptionType_Bool)
+	{
+		if (option->valueBool == enabled) { return false; }
+		//NOTE: Stick to the style the file already uses, like ToggleOption does
+		bool isWordStyle = (StrExactEquals(option->valueStr, StrLit("true")) || StrExactEquals(option->valueStr, StrLit("false")));
+		if (isWordStyle) { SetOptionalOutPntr(newValueOut, enabled ? StrLit("true") : StrLit("false")); }
+		else { SetOptionalOutPntr(newValueOut, enabled ? StrLit("1") : StrLit("0")); }
+		return true;
+	}
+	else if (option->type == FileOptionType_CommentDefine)
+	{
+		if (option->isUncommented == enabled) { return false; }
+		SetOptionalOutPntr(newValueOut, enabled ? StrLit("") : StrLit("// "));
+		return true;
+	}
+	else { return false; }
+}
+
+// Builds the new contents of a file in a single pass. fileOptions must be in file order (which ParseFileOptions gives us) with a new value for each one
+Str8 ReplaceFileOptionValues(Arena* arena, Str8 oldContents, const VarArray* fileOptions, const Str8* newValues)
+{
+	uxx newLength = oldContents.length;
+	VarArrayLoop(fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, fileOptions, oIndex);
+		newLength = newLength - (option->fileContentsEndIndex - option->fileContentsStartIndex) + newValues[oIndex].length;
+	}
+	char* newChars = AllocArray(char, arena, MaxUXX(newLength, 1));
+	NotNull(newChars);
+	uxx readIndex = 0;
+	uxx writeIndex = 0;
+	VarArrayLoop(fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, fileOptions, oIndex);
+		DebugAssert(option->fileContentsStartIndex >= readIndex);
+		uxx numUnchangedBytes = option->fileContentsStartIndex - readIndex;
+		if (numUnchangedBytes > 0) { MyMemCopy(&newChars[writeIndex], &oldContents.chars[readIndex], numUnchangedBytes); }
+		writeIndex += numUnchangedBytes;
+		if (newValues[oIndex].length > 0) { MyMemCopy(&newChars[writeIndex], newValues[oIndex].chars, newValues[oIndex].length); }
+		writeIndex += newValues[oIndex].length;
+		readIndex = option->fileContentsEndIndex;
+	}
+	if (readIndex < oldContents.length) { MyMemCopy(&newChars[writeIndex], &oldContents.chars[readIndex], oldContents.length - readIndex); }
+	writeIndex += oldContents.length - readIndex;
+	Assert(writeIndex == newLength);
+	return NewStr8(newLength, newChars);
+}
+
+void AddPresetFileChange(Arena* arena, VarArray* changes, FilePath fullPath, Str8 oldContents, Str8 newContents, uxx numChangedOptions)
+{
+	PresetFileChange* newChange = VarArrayAdd(PresetFileChange, changes);
+	NotNull(newChange);
+	ClearPointer(newChange);
+	newChange->fullPath = fullPath;
+	newChange->tempPath = PrintInArenaStr(arena, "%.*s%s", StrPrint(fullPath), PRESET_TEMP_FILE_SUFFIX);
+	newChange->backupPath = PrintInArenaStr(arena, "%.*s%s", StrPrint(fullPath), PRESET_BACKUP_FILE_SUFFIX);
+	newChange->oldContents = oldContents;
+	newChange->newContents = newContents;
+	newChange->numChangedOptions = numChangedOptions;
+}
+
+// Rolls back a transaction that was interrupted by a crash (or a failed rollback) using the backups listed in the journal
+void AppRecoverPresetJournal()
+{
+	ScratchBegin(scratch);
+	FilePath journalPath = GetPresetJournalPath(scratch, false);
+	Str8 journalContent = Str8_Empty;
+	if (!AppReadTextFile(journalPath, scratch, &journalContent)) { ScratchEnd(scratch); return; }
+	
+	uxx numRestored = 0;
+	uxx numFailed = 0;
+	LineParser parser = MakeLineParser(journalContent);
+	Str8 fullLine = ZEROED;
+	while (LineParserGetLine(&parser, &fullLine))
+	{
+		FilePath fullPath = TrimWhitespace(fullLine);
+		if (IsEmptyStr(fullPath) || StrExactStartsWith(fullPath, StrLit("//"))) { continue; }
+		FilePath tempPath = PrintInArenaStr(scratch, "%.*s%s", StrPrint(fullPath), PRESET_TEMP_FILE_SUFFIX);
+		FilePath backupPath = PrintInArenaStr(scratch, "%.*s%s", StrPrint(fullPath), PRESET_BACKUP_FILE_SUFFIX);
+		if (OsDoesFileExist(backupPath))
+		{
+			if (AppReplaceFile(backupPath, fullPath)) { numRestored++; }
+			else { numFailed++; PrintLine_E("Failed to restore \"%.*s\" from \"%.*s\"", StrPrint(fullPath), StrPrint(backupPath)); }
+		}
+		if (OsDoesFileExist(tempPath)) { AppDeleteFile(tempPath); }
+	}
+	
+	if (numFailed == 0)
+	{
+		AppDeleteFile(journalPath);
+		NotifyPrint_W("Applying a preset was interrupted last time, restored %llu file%s to how they were before", (u64)numRestored, Plural(numRestored, "s"));
+	}
+	else
+	{
+		NotifyPrint_E("Applying a preset was interrupted last time and %llu file%s couldn't be restored! The backups are next to them with the \"%s\" extension", (u64)numFailed, Plural(numFailed, "s"), PRESET_BACKUP_FILE_SUFFIX);
+	}
+	ScratchEnd(scratch);
+}
+
+// Writes every change as one transaction (see the top of this file). description is used in the error notifications, like "preset \"Debug\""
+bool CommitPresetFileChanges(const VarArray* changes, Str8 description)
+{
+	ScratchBegin(scratch);
+	// +==============================+
+	// |  Write Temps and Backups     |
+	// +==============================+
+	uxx numPrepared = 0;
+	VarArrayLoop(changes, cIndex)
+	{
+		VarArrayLoopGet(PresetFileChange, change, changes, cIndex);
+		bool wroteTemp = AppWriteTextFile(change->tempPath, change->newContents);
+		bool wroteBackup = wroteTemp && AppWriteTextFile(change->backupPath, change->oldContents);
+		if (!wroteTemp || !wroteBackup)
+		{
+			NotifyPrint_E("Didn't apply %.*s, couldn't write \"%.*s\"", StrPrint(description), StrPrint(wroteTemp ? change->backupPath : change->tempPath));
+			if (wroteTemp) { AppDeleteFile(change->tempPath); }
+			break;
+		}
+		numPrepared++;
+	}
+	
+	FilePath journalPath = GetPresetJournalPath(scratch, true);
+	bool wroteJournal = false;
+	if (numPrepared == changes->length)
+	{
+		TwoPassStr8Loop(journalStr, scratch, false)
+		{
+			TwoPassStrNt(&journalStr, "// CSwitch was in the middle of changing these files. It will roll them back on startup\n");
+			VarArrayLoop(changes, cIndex)
+			{
+				VarArrayLoopGet(PresetFileChange, change, changes, cIndex);
+				TwoPassPrint(&journalStr, "%.*s\n", StrPrint(change->fullPath));
+			}
+			TwoPassStr8LoopEnd(&journalStr);
+		}
+		wroteJournal = AppWriteTextFileAtomically(journalPath, journalStr.str);
+		if (!wroteJournal) { NotifyPrint_E("Didn't apply %.*s, couldn't write the journal to \"%.*s\"", StrPrint(description), StrPrint(journalPath)); }
+	}
+	if (!wroteJournal)
+	{
+		for (uxx cIndex = 0; cIndex < numPrepared; cIndex++)
+		{
+			PresetFileChange* change = VarArrayGetHard(PresetFileChange, changes, cIndex);
+			AppDeleteFile(change->tempPath);
+			AppDeleteFile(change->backupPath);
+		}
+		ScratchEnd(scratch);
+		return false;
+	}
+	
+	// +==============================+
+	// |     Rename or Roll Back      |
+	// +==============================+
+	uxx numReplaced = 0;
+	VarArrayLoop(changes, cIndex)
+	{
+		VarArrayLoopGet(PresetFileChange, change, changes, cIndex);
+		if (!AppReplaceFile(change->tempPath, change->fullPath))
+		{
+			NotifyPrint_E("Didn't apply %.*s, couldn't replace \"%.*s\"", StrPrint(description), StrPrint(change->fullPath));
+			break;
+		}
+		numReplaced++;
+	}
+	if (numReplaced < changes->length)
+	{
+		uxx numRestoreFailures = 0;
+		VarArrayLoop(changes, cIndex)
+		{
+			VarArrayLoopGet(PresetFileChange, change, changes, cIndex);
+			if (cIndex < numReplaced)
+			{
+				if (!AppReplaceFile(change->backupPath, change->fullPath)) { numRestoreFailures++; }
+			}
+			else
+			{
+				AppDeleteFile(change->tempPath);
+				AppDeleteFile(change->backupPath);
+			}
+		}
+		//NOTE: If a restore failed we leave the journal behind so AppRecoverPresetJournal gets another chance at it on the next startup
+		if (numRestoreFailures == 0) { AppDeleteFile(journalPath); }
+		else { NotifyPrint_E("Failed to roll back %llu file%s! They will be restored the next time CSwitch starts", (u64)numRestoreFailures, Plural(numRestoreFailures, "s")); }
+		ScratchEnd(scratch);
+		return false;
+	}
+	
+	//NOTE: The journal goes first, once it's gone the transaction is committed and the backups are just leftovers
+	AppDeleteFile(journalPath);
+	VarArrayLoop(changes, cIndex)
+	{
+		VarArrayLoopGet(PresetFileChange, change, changes, cIndex);
+		AppDeleteFile(change->backupPath);
+	}
+	ScratchEnd(scratch);
+	return true;
+}
+
+// Called after CommitPresetFileChanges succeeds, so the open tabs (and anything watching them) see the new contents
+void ApplyPresetFileChangesToTabs(const VarArray* changes, bool publishReloaded)
+{
+	ScratchBegin(scratch);
+	uxx* watchIds = AllocArray(uxx, scratch, changes->length);
+	NotNull(watchIds);
+	uxx numWatchIds = 0;
+	VarArrayLoop(changes, cIndex)
+	{
+		VarArrayLoopGet(PresetFileChange, change, changes, cIndex);
+		if (publishReloaded) { AppPublishIpcEvent(StrLit("reloaded"), Str8_Empty, change->fullPath); }
+		QueueUsageIndexFileCheck(&app->usageIndex, change->fullPath);
+		FileTab* tab = AppFindTabForPath(change->fullPath);
+		//NOTE: Tabs that are still from the session snapshot get reloaded by the SessionVerifier when it sees the file doesn't match anymore
+		if (tab == nullptr || tab->isFromSnapshot) { continue; }
+		FreeStr8(stdHeap, &tab->fileContents);
+		tab->fileContents = AllocStr8(stdHeap, change->newContents);
+		tab->isFileChangedFromOriginal = !StrExactEquals(tab->fileContents, tab->originalFileContents);
+		UpdateFileTabOptions(tab);
+		watchIds[numWatchIds++] = tab->fileWatchId;
+	}
+	ClearFileWatchesChanged(&app->fileWatches, watchIds, numWatchIds);
+	ScratchEnd(scratch);
+}
+
+bool AppApplyPreset(uxx presetIndex)
+{
+	Assert(presetIndex < app->presets.length);
+	ProfZoneBegin(_funcZone, "AppApplyPreset");
+	ScratchBegin(scratch);
+	Preset* preset = VarArrayGetHard(Preset, &app->presets, presetIndex);
+	uxx numEntries = preset->entries.length;
+	
+	// +==============================+
+	// |   Calculate New Contents     |
+	// +==============================+
+	FilePath* entryFullPaths = AllocArray(FilePath, scratch, MaxUXX(numEntries, 1));
+	bool* entryFound = AllocArray(bool, scratch, MaxUXX(numEntries, 1));
+	NotNull(entryFullPaths);
+	NotNull(entryFound);
+	VarArrayLoop(&preset->entries, eIndex)
+	{
+		VarArrayLoopGet(PresetEntry, entry, &preset->entries, eIndex);
+		entryFullPaths[eIndex] = OsGetFullPath(scratch, entry->filePath);
+		entryFound[eIndex] = false;
+	}
+	
+	VarArray changes;
+	InitVarArray(PresetFileChange, &changes, scratch);
+	VarArrayLoop(&preset->entries, eIndex)
+	{
+		//NOTE: Every file is handled once, by the first entry that names it
+		bool isFirstEntryForFile = true;
+		for (uxx prevIndex = 0; prevIndex < eIndex; prevIndex++)
+		{
+			if (StrAnyCaseEquals(entryFullPaths[prevIndex], entryFullPaths[eIndex])) { isFirstEntryForFile = false; break; }
+		}
+		if (!isFirstEntryForFile) { continue; }
+		
+		Str8 oldContents = Str8_Empty;
+		if (!AppReadTextFile(entryFullPaths[eIndex], scratch, &oldContents))
+		{
+			NotifyPrint_E("Didn't apply preset \"%.*s\", couldn't read \"%.*s\"", StrPrint(preset->name), StrPrint(entryFullPaths[eIndex]));
+			ScratchEnd(scratch);
+			ProfZoneEnd(_funcZone);
+			return false;
+		}
+		VarArray fileOptions;
+		InitVarArray(FileOption, &fileOptions, scratch);
+		ParseFileOptions(scratch, oldContents, &fileOptions);
+		
+		Str8* newValues = AllocArray(Str8, scratch, MaxUXX(fileOptions.length, 1));
+		NotNull(newValues);
+		uxx numChangedOptions = 0;
+		VarArrayLoop(&fileOptions, oIndex)
+		{
+			VarArrayLoopGet(FileOption, option, &fileOptions, oIndex);
+			newValues[oIndex] = StrSlice(oldContents, option->fileContentsStartIndex, option->fileContentsEndIndex);
+			for (uxx otherIndex = eIndex; otherIndex < numEntries; otherIndex++)
+			{
+				PresetEntry* entry = VarArrayGetHard(PresetEntry, &preset->entries, otherIndex);
+				if (!StrExactEquals(entry->optionName, option->name) || !StrAnyCaseEquals(entryFullPaths[otherIndex], entryFullPaths[eIndex])) { continue; }
+				entryFound[otherIndex] = true;
+				if (GetOptionNewValueStr(option, entry->enabled, &newValues[oIndex])) { numChangedOptions++; }
+				break;
+			}
+		}
+		if (numChangedOptions == 0) { continue; }
+		
+		Str8 newContents = ReplaceFileOptionValues(scratch, oldContents, &fileOptions, newValues);
+		AddPresetFileChange(scratch, &changes, entryFullPaths[eIndex], oldContents, newContents, numChangedOptions);
+	}
+	
+	uxx numMissingOptions = 0;
+	for (uxx eIndex = 0; eIndex < numEntries; eIndex++) { if (!entryFound[eIndex]) { numMissingOptions++; } }
+	if (changes.length == 0)
+	{
+		if (numMissingOptions > 0) { NotifyPrint_W("Nothing to change for preset \"%.*s\" (%llu option%s not found)", StrPrint(preset->name), (u64)numMissingOptions, Plural(numMissingOptions, "s")); }
+		else { NotifyPrint_I("Preset \"%.*s\" is already applied", StrPrint(preset->name)); }
+		ScratchEnd(scratch);
+		ProfZoneEnd(_funcZone);
+		return true;
+	}
+	
+	if (!CommitPresetFileChanges(&changes, ScratchPrintStr("preset \"%.*s\"", StrPrint(preset->name))))
+	{
+		ScratchEnd(scratch);
+		ProfZoneEnd(_funcZone);
+		return false;
+	}
+	ApplyPresetFileChangesToTabs(&changes, true);
+	uxx numChangedOptions = 0;
+	VarArrayLoop(&changes, cIndex) { numChangedOptions += VarArrayGetHard(PresetFileChange, &changes, cIndex)->numChangedOptions; }
+	
+	if (numMissingOptions > 0)
+	{
+		NotifyPrint_W("Applied preset \"%.*s\" to %llu file%s, %llu option%s not found", StrPrint(preset->name), (u64)changes.length, Plural(changes.length, "s"), (u64)numMissingOptions, Plural(numMissingOptions, "s"));
+	}
+	else
+	{
+		NotifyPrint_I("Applied preset \"%.*s\", changed %llu option%s in %llu file%s", StrPrint(preset->name), (u64)numChangedOptions, Plural(numChangedOptions, "s"), (u64)changes.length, Plural(changes.length, "s"));
+	}
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+	return true;
+}
+
+// Presets picked from the UI (like the command palette) are applied by AppApplyQueuedPreset at the end of the frame, once the UI pass
+// is done with the options of every tab, since applying one re-parses the tabs it changes
+void AppQueuePreset(uxx presetIndex)
+{
+	Assert(presetIndex < app->presets.length);
+	app->queuedPresetIndex = presetIndex;
+	app->queuedPresetGeneration = app->palettePresetsGeneration;
+}
+
+void AppApplyQueuedPreset()
+{
+	if (app->queuedPresetIndex == UINTXX_MAX) { return; }
+	uxx presetIndex = app->queuedPresetIndex;
+	app->queuedPresetIndex = UINTXX_MAX;
+	if (app->queuedPresetGeneration == app->palettePresetsGeneration && presetIndex < app->presets.length) { AppApplyPreset(presetIndex); }
+}
@@ -0,0 +1,789 @@
+/*
+File:   app_profiler.c
+Description:
+	** A lightweight profiler that is always compiled in, unlike the Tracy zones which need PROFILING_ENABLED
+	** and an external viewer. ProfZoneBegin/ProfZoneEnd (see app_main.h) push a begin or end event with a cycle
+	** counter timestamp into a ring buffer that belongs to the calling thread. Once a frame UpdateProfiler drains
+	** every ring on the main thread, matches up the begin/end pairs and adds each zone's time for the frame to its
+	** history, which is where the p50/p95/max in the overlay come from. The main thread's zones from the last
+	** frame are also kept so they can be drawn as a flame strip next to the PerfGraph.
+	** While a capture is running (see the CaptureFrames and CaptureNextStall commands) every zone that ends is also
+	** kept, along with any detail attached by SetProfilerZoneDetail, and written out as a Chrome trace JSON file.
+*/
+
+#if COMPILER_IS_MSVC
+#include <intrin.h>
+#elif (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+#if !TARGET_IS_WINDOWS
+#include <sys/stat.h>
+#endif
+
+//NOTE: Threads claim a ProfilerThread the first time they hit a zone. After a dll reload these start out empty again and the claim is found again by thread id
+static THREAD_LOCAL ProfilerThread* profilerThread = nullptr;
+static THREAD_LOCAL bool profilerThreadUnavailable = false;
+
+u64 GetProfilerTimestamp()
+{
+	#if (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+	return (u64)__rdtsc();
+	#elif defined(_M_ARM64)
+	return (u64)_ReadStatusReg(ARM64_CNTVCT);
+	#elif defined(__aarch64__)
+	u64 result;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(result));
+	return result;
+	#else
+	#error GetProfilerTimestamp does not know how to read a cycle counter on this architecture
+	#endif
+}
+
+r32 ProfilerTicksToMs(const Profiler* profiler, u64 ticks)
+{
+	if (profiler->ticksPerMs == 0) { return 0.0f; }
+	return (r32)((r64)ticks / profiler->ticksPerMs);
+}
+
+void InitProfiler(Arena* arena, Profiler* profilerOut)
+{
+	NotNull(arena);
+	NotNull(profilerOut);
+	ClearPointer(profilerOut);
+	InitMutex(&profilerOut->mutex);
+	InitArenaStdHeap(&profilerOut->namesArena);
+	profilerOut->zones = AllocArray(ProfilerZone, arena, PROFILER_MAX_ZONES);
+	NotNull(profilerOut->zones);
+	MyMemSet(profilerOut->zones, 0x00, sizeof(ProfilerZone) * PROFILER_MAX_ZONES);
+	AtomicWrite(&profilerOut->numZones, 1);
+	profilerOut->threads = AllocArray(ProfilerThread, arena, PROFILER_MAX_THREADS);
+	NotNull(profilerOut->threads);
+	MyMemSet(profilerOut->threads, 0x00, sizeof(ProfilerThread) * PROFILER_MAX_THREADS);
+	for (uxx tIndex = 0; tIndex < PROFILER_MAX_THREADS; tIndex++)
+	{
+		profilerOut->threads[tIndex].events = AllocArray(ProfilerEvent, arena, PROFILER_RING_SIZE);
+		NotNull(profilerOut->threads[tIndex].events);
+	}
+	profilerOut->flameZones = AllocArray(ProfilerFlameZone, arena, PROFILER_MAX_FLAME_ZONES);
+	NotNull(profilerOut->flameZones);
+	InitArenaStdHeap(&profilerOut->captureArena);
+	InitVarArray(Str8, &profilerOut->captureDetails, &profilerOut->captureArena);
+	InitVarArray(ProfilerCaptureZone, &profilerOut->captureZones, arena);
+	InitVarArray(ProfilerCaptureZone, &profilerOut->capturePrevZones, arena);
+	InitVarArray(u64, &profilerOut->captureFrames, arena);
+	profilerOut->calibrateTimestamp = GetProfilerTimestamp();
+	profilerOut->calibrateTime = OsGetTime();
+	profilerOut->isInitialized = true;
+}
+
+// +--------------------------------------------------------------+
+// |                          Recording                           |
+// +--------------------------------------------------------------+
+ProfilerThread* GetProfilerThread()
+{
+	if (profilerThread != nullptr) { return profilerThread; }
+	if (profilerThreadUnavailable || app == nullptr || !app->profiler.isInitialized) { return nullptr; }
+	
+	Profiler* profiler = &app->profiler;
+	ThreadId threadId = OsGetCurrentThreadId();
+	LockMutex(&profiler->mutex, TIMEOUT_FOREVER);
+	ProfilerThread* freeThread = nullptr;
+	for (uxx tIndex = 0; tIndex < PROFILER_MAX_THREADS; tIndex++)
+	{
+		ProfilerThread* thread = &profiler->threads[tIndex];
+		if (!AtomicRead(&thread->isClaimed)) { if (freeThread == nullptr) { freeThread = thread; } }
+		else if (thread->threadId == threadId) { profilerThread = thread; break; }
+	}
+	if (profilerThread == nullptr && freeThread != nullptr)
+	{
+		//NOTE: writeIndex carries on from the last thread that had this slot, so UpdateProfiler never has to notice the change in owner
+		freeThread->threadId = threadId;
+		freeThread->isMainThread = OsIsMainThread();
+		AtomicWrite(&freeThread->isClaimed, true);
+		profilerThread = freeThread;
+	}
+	UnlockMutex(&profiler->mutex);
+	
+	if (profilerThread == nullptr) { profilerThreadUnavailable = true; }
+	return profilerThread;
+}
+
+// Worker threads call this right before they exit so their slot can be reused
+void ReleaseProfilerThread()
+{
+	if (profilerThread == nullptr) { return; }
+	AtomicWrite(&profilerThread->isClaimed, false);
+	profilerThread = nullptr;
+}
+
+u32 RegisterProfilerZone(Profiler* profiler, const char* zoneName, ProfilerCategory category)
+{
+	Str8 nameStr = MakeStr8Nt(zoneName);
+	u32 result = 0;
+	LockMutex(&profiler->mutex, TIMEOUT_FOREVER);
+	i64 numZones = AtomicRead(&profiler->numZones);
+	for (i64 zIndex = 1; zIndex < numZones; zIndex++)
+	{
+		if (StrExactEquals(profiler->zones[zIndex].name, nameStr)) { result = (u32)zIndex; break; }
+	}
+	if (result == 0 && numZones < PROFILER_MAX_ZONES)
+	{
+		profiler->zones[numZones].name = AllocStr8(&profiler->namesArena, nameStr);
+		profiler->zones[numZones].category = category;
+		result = (u32)numZones;
+		AtomicWrite(&profiler->numZones, numZones+1);
+	}
+	UnlockMutex(&profiler->mutex);
+	return result;
+}
+
+void PushProfilerEvent(ProfilerThread* thread, u32 zoneId, ProfilerEventKind kind)
+{
+	i64 writeIndex = AtomicRead(&thread->writeIndex);
+	ProfilerEvent* event = &thread->events[writeIndex % PROFILER_RING_SIZE];
+	event->timestamp = GetProfilerTimestamp();
+	event->zoneId = zoneId;
+	event->kind = kind;
+	AtomicWrite(&thread->writeIndex, writeIndex+1);
+}
+
+// Returns the id that ProfZoneEnd should pass to EndProfilerZone, 0 if this zone isn't being recorded
+u32 BeginProfilerZone(u32* zoneIdCache, const char* zoneName, ProfilerCategory category)
+{
+	ProfilerThread* thread = GetProfilerThread();
+	if (thread == nullptr) { return 0; }
+	if (*zoneIdCache == 0) { *zoneIdCache = RegisterProfilerZone(&app->profiler, zoneName, category); }
+	if (*zoneIdCache == 0) { return 0; }
+	PushProfilerEvent(thread, *zoneIdCache, ProfilerEventKind_Begin);
+	return *zoneIdCache;
+}
+
+void EndProfilerZone(u32 zoneId)
+{
+	if (zoneId == 0 || profilerThread == nullptr) { return; }
+	PushProfilerEvent(profilerThread, zoneId, ProfilerEventKind_End);
+}
+
+// Attaches a string (like the path of a file being read) to the zone this thread is in. This only does anything while a capture is running
+void SetProfilerZoneDetail(Str8 detail)
+{
+	if (profilerThread == nullptr || !AtomicRead(&app->profiler.isCapturing)) { return; }
+	Profiler* profiler = &app->profiler;
+	u32 detailNumber = 0;
+	LockMutex(&profiler->mutex, TIMEOUT_FOREVER);
+	if (profiler->captureDetails.length < PROFILER_CAPTURE_MAX_DETAILS)
+	{
+		detailNumber = profiler->captureDetailBase + (u32)profiler->captureDetails.length + 1;
+		Str8* newDetail = VarArrayAdd(Str8, &profiler->captureDetails);
+		NotNull(newDetail);
+		*newDetail = AllocStr8(&profiler->captureArena, detail);
+	}
+	UnlockMutex(&profiler->mutex);
+	if (detailNumber != 0) { PushProfilerEvent(profilerThread, detailNumber, ProfilerEventKind_Detail); }
+}
+
+// +--------------------------------------------------------------+
+// |                     Profiled File Access                     |
+// +--------------------------------------------------------------+
+//NOTE: These are the Os file functions wrapped in a zone, with the path attached as the detail, so file I/O is easy to pick out in a capture
+bool AppReadFile(FilePath path, Arena* arena, bool convertNewLines, Str8* contentsOut)
+{
+	ProfZoneBeginEx(_funcZone, "ReadFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	bool result = OsReadFile(path, arena, convertNewLines, contentsOut);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+bool AppReadTextFile(FilePath path, Arena* arena, Str8* contentsOut)
+{
+	ProfZoneBeginEx(_funcZone, "ReadTextFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	bool result = OsReadTextFile(path, arena, contentsOut);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+bool AppReadBinFile(FilePath path, Arena* arena, Slice* contentsOut)
+{
+	ProfZoneBeginEx(_funcZone, "ReadBinFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	bool result = OsReadBinFile(path, arena, contentsOut);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+bool AppWriteTextFile(FilePath path, Str8 contents)
+{
+	ProfZoneBeginEx(_funcZone, "WriteTextFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	bool result = OsWriteTextFile(path, contents);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+bool AppWriteBinFile(FilePath path, Slice contents)
+{
+	ProfZoneBeginEx(_funcZone, "WriteBinFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	bool result = OsWriteBinFile(path, contents);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+// Renames sourcePath over targetPath, replacing targetPath if it exists. The replace is atomic on both Windows and POSIX so targetPath is always either the old or the new file
+bool AppReplaceFile(FilePath sourcePath, FilePath targetPath)
+{
+	ProfZoneBeginEx(_funcZone, "ReplaceFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(targetPath);
+	ScratchBegin(scratch);
+	Str8 sourcePathNt = PrintInArenaStr(scratch, "%.*s", StrPrint(sourcePath));
+	Str8 targetPathNt = PrintInArenaStr(scratch, "%.*s", StrPrint(targetPath));
+	#if TARGET_IS_WINDOWS
+	bool result = (MoveFileExA(sourcePathNt.chars, targetPathNt.chars, MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH) != 0);
+	#else
+	bool result = (rename(sourcePathNt.chars, targetPathNt.chars) == 0);
+	#endif
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+bool AppDeleteFile(FilePath path)
+{
+	ProfZoneBeginEx(_funcZone, "DeleteFile", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	ScratchBegin(scratch);
+	Str8 pathNt = PrintInArenaStr(scratch, "%.*s", StrPrint(path));
+	#if TARGET_IS_WINDOWS
+	bool result = (DeleteFileA(pathNt.chars) != 0);
+	#else
+	bool result = (remove(pathNt.chars) == 0);
+	#endif
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+// True for symbolic links (and junctions or other reparse points on Windows). Recursive walks skip these folders since a link back up the tree would never end
+bool AppIsSymbolicLink(FilePath path)
+{
+	ProfZoneBeginEx(_funcZone, "IsSymbolicLink", ProfilerCategory_FileIo);
+	SetProfilerZoneDetail(path);
+	ScratchBegin(scratch);
+	Str8 pathNt = PrintInArenaStr(scratch, "%.*s", StrPrint(path));
+	#if TARGET_IS_WINDOWS
+	DWORD attributes = GetFileAttributesA(pathNt.chars);
+	bool result = (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0);
+	#else
+	struct stat pathInfo;
+	bool result = (lstat(pathNt.chars, &pathInfo) == 0 && S_ISLNK(pathInfo.st_mode));
+	#endif
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+// Writes to "[path].tmp" and then renames it over path, so a crash mid-write (or another instance reading the file) never sees a half-written file
+bool AppWriteTextFileAtomically(FilePath path, Str8 contents)
+{
+	ScratchBegin(scratch);
+	Str8 tempPath = PrintInArenaStr(scratch, "%.*s.tmp", StrPrint(path));
+	if (!AppWriteTextFile(tempPath, contents)) { ScratchEnd(scratch); return false; }
+	bool result = AppReplaceFile(tempPath, path);
+	if (!result) { AppDeleteFile(tempPath); }
+	ScratchEnd(scratch);
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                           Capture                            |
+// +--------------------------------------------------------------+
+// Escapes quotes, backslashes (every Windows path has them) and control characters so str can go inside a JSON string
+Str8 EscapeProfilerJsonStr(Arena* arena, Str8 str)
+{
+	uxx resultLength = 0;
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		u8 c = (u8)str.chars[cIndex];
+		if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t') { resultLength += 2; }
+		else if (c < 0x20) { resultLength += 6; }
+		else { resultLength += 1; }
+	}
+	if (resultLength == str.length) { return str; }
+	
+	const char* hexChars = "0123456789ABCDEF";
+	Str8 result = NewStr8(resultLength, (char*)AllocMem(arena, resultLength));
+	NotNull(result.chars);
+	uxx writeIndex = 0;
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		u8 c = (u8)str.chars[cIndex];
+		if (c == '"' || c == '\\') { result.chars[writeIndex++] = '\\'; result.chars[writeIndex++] = (char)c; }
+		else if (c == '\n') { result.chars[writeIndex++] = '\\'; result.chars[writeIndex++] = 'n'; }
+		else if (c == '\r') { result.chars[writeIndex++] = '\\'; result.chars[writeIndex++] = 'r'; }
+		else if (c == '\t') { result.chars[writeIndex++] = '\\'; result.chars[writeIndex++] = 't'; }
+		else if (c < 0x20)
+		{
+			result.chars[writeIndex++] = '\\';
+			result.chars[writeIndex++] = 'u';
+			result.chars[writeIndex++] = '0';
+			result.chars[writeIndex++] = '0';
+			result.chars[writeIndex++] = hexChars[c >> 4];
+			result.chars[writeIndex++] = hexChars[c & 0x0F];
+		}
+		else { result.chars[writeIndex++] = (char)c; }
+	}
+	Assert(writeIndex == resultLength);
+	return result;
+}
+
+void ClearProfilerCaptureDetails(Profiler* profiler)
+{
+	LockMutex(&profiler->mutex, TIMEOUT_FOREVER);
+	VarArrayLoop(&profiler->captureDetails, dIndex)
+	{
+		VarArrayLoopGet(Str8, detail, &profiler->captureDetails, dIndex);
+		FreeStr8(&profiler->captureArena, detail);
+	}
+	profiler->captureDetailBase += (u32)profiler->captureDetails.length;
+	VarArrayClear(&profiler->captureDetails);
+	UnlockMutex(&profiler->mutex);
+}
+
+void StartProfilerCapture(Profiler* profiler, ProfilerCaptureMode mode, uxx numFrames, r32 stallThreshold)
+{
+	NotNull(profiler);
+	Assert(profiler->captureMode == ProfilerCaptureMode_None);
+	Assert(mode != ProfilerCaptureMode_None);
+	profiler->captureMode = mode;
+	profiler->captureFramesLeft = MaxUXX(numFrames, 1);
+	profiler->captureStallThreshold = stallThreshold;
+	u64* firstFrame = VarArrayAdd(u64, &profiler->captureFrames);
+	NotNull(firstFrame);
+	*firstFrame = GetProfilerTimestamp();
+	AtomicWrite(&profiler->isCapturing, true);
+}
+
+void StopProfilerCapture(Profiler* profiler)
+{
+	NotNull(profiler);
+	AtomicWrite(&profiler->isCapturing, false);
+	profiler->captureMode = ProfilerCaptureMode_None;
+	VarArrayClear(&profiler->captureZones);
+	VarArrayClear(&profiler->capturePrevZones);
+	VarArrayClear(&profiler->captureFrames);
+	ClearProfilerCaptureDetails(profiler);
+}
+
+// Writes the capture in Chrome's trace event format, which chrome://tracing, ui.perfetto.dev and speedscope can all open.
+// Returns the path it was written to, or an empty path if the write failed
+FilePath WriteProfilerCapture(Arena* arena, Profiler* profiler)
+{
+	NotNull(profiler);
+	Assert(profiler->ticksPerMs != 0);
+	ScratchBegin1(scratch, arena);
+	u64 baseTimestamp = (profiler->captureFrames.length > 0) ? *VarArrayGetFirst(u64, &profiler->captureFrames) : 0;
+	r64 ticksPerUs = profiler->ticksPerMs / 1000.0;
+	
+	i64 numZones = AtomicRead(&profiler->numZones);
+	Str8* zoneNames = AllocArray(Str8, scratch, (uxx)numZones);
+	NotNull(zoneNames);
+	for (i64 zIndex = 0; zIndex < numZones; zIndex++) { zoneNames[zIndex] = EscapeProfilerJsonStr(scratch, profiler->zones[zIndex].name); }
+	
+	LockMutex(&profiler->mutex, TIMEOUT_FOREVER);
+	u32 detailBase = profiler->captureDetailBase;
+	uxx numDetails = profiler->captureDetails.length;
+	Str8* details = AllocArray(Str8, scratch, MaxUXX(numDetails, 1));
+	NotNull(details);
+	VarArrayLoop(&profiler->captureDetails, dIndex)
+	{
+		VarArrayLoopGet(Str8, detail, &profiler->captureDetails, dIndex);
+		details[dIndex] = EscapeProfilerJsonStr(scratch, *detail);
+	}
+	UnlockMutex(&profiler->mutex);
+	
+	uxx mainThreadIndex = 0;
+	bool isThreadUsed[PROFILER_MAX_THREADS] = ZEROED;
+	VarArray* zoneArrays[2] = { &profiler->capturePrevZones, &profiler->captureZones };
+	for (uxx aIndex = 0; aIndex < ArrayCount(zoneArrays); aIndex++)
+	{
+		VarArrayLoop(zoneArrays[aIndex], zIndex)
+		{
+			VarArrayLoopGet(ProfilerCaptureZone, captureZone, zoneArrays[aIndex], zIndex);
+			isThreadUsed[captureZone->threadIndex] = true;
+			if (profiler->threads[captureZone->threadIndex].isMainThread) { mainThreadIndex = captureZone->threadIndex; }
+		}
+	}
+	
+	TwoPassStr8Loop(result, scratch, false)
+	{
+		TwoPassPrint(&result, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"%s\"}}", PROJECT_READABLE_NAME_STR);
+		for (uxx tIndex = 0; tIndex < PROFILER_MAX_THREADS; tIndex++)
+		{
+			if (!isThreadUsed[tIndex]) { continue; }
+			if (profiler->threads[tIndex].isMainThread) { TwoPassPrint(&result, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,\"args\":{\"name\":\"Main\"}}", (u64)tIndex); }
+			else { TwoPassPrint(&result, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,\"args\":{\"name\":\"Thread %llu\"}}", (u64)tIndex, (u64)tIndex); }
+		}
+		VarArrayLoop(&profiler->captureFrames, fIndex)
+		{
+			VarArrayLoopGet(u64, frameTimestamp, &profiler->captureFrames, fIndex);
+			r64 frameUs = (*frameTimestamp > baseTimestamp) ? (r64)(*frameTimestamp - baseTimestamp) / ticksPerUs : 0.0;
+			TwoPassPrint(&result, ",\n{\"name\":\"Frame\",\"cat\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%llu,\"ts\":%.3f}", (u64)mainThreadIndex, frameUs);
+		}
+		for (uxx aIndex = 0; aIndex < ArrayCount(zoneArrays); aIndex++)
+		{
+			VarArrayLoop(zoneArrays[aIndex], zIndex)
+			{
+				VarArrayLoopGet(ProfilerCaptureZone, captureZone, zoneArrays[aIndex], zIndex);
+				//NOTE: Zones that began before the capture did (like a long job on a worker thread) are clipped to the start of the capture
+				r64 beginUs = (captureZone->beginTimestamp > baseTimestamp) ? (r64)(captureZone->beginTimestamp - baseTimestamp) / ticksPerUs : 0.0;
+				r64 endUs = (captureZone->endTimestamp > baseTimestamp) ? (r64)(captureZone->endTimestamp - baseTimestamp) / ticksPerUs : 0.0;
+				TwoPassPrint(&result, ",\n{\"name\":\"%.*s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+					StrPrint(zoneNames[captureZone->zoneId]),
+					GetProfilerCategoryStr(profiler->zones[captureZone->zoneId].category),
+					captureZone->threadIndex,
+					beginUs,
+					endUs - beginUs
+				);
+				if (captureZone->detailNumber > detailBase && captureZone->detailNumber - detailBase - 1 < numDetails)
+				{
+					TwoPassPrint(&result, ",\"args\":{\"detail\":\"%.*s\"}", StrPrint(details[captureZone->detailNumber - detailBase - 1]));
+				}
+				TwoPassStrNt(&result, "}");
+			}
+		}
+		TwoPassStrNt(&result, "\n]}\n");
+		TwoPassStr8LoopEnd(&result);
+	}
+	
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), true);
+	Str8 fileName = PrintInArenaStr(scratch, PROFILER_CAPTURE_FILENAME_FORMAT, OsGetCurrentTimestamp(false));
+	FilePath capturePath = JoinStringsInArenaWithChar(arena, folderPath, '/', fileName, false);
+	if (!OsWriteTextFile(capturePath, result.str))
+	{
+		FreeStr8(arena, &capturePath);
+		capturePath = Str8_Empty;
+	}
+	ScratchEnd(scratch);
+	return capturePath;
+}
+
+void FinishProfilerCapture(Profiler* profiler, Str8 reasonStr)
+{
+	ScratchBegin(scratch);
+	AtomicWrite(&profiler->isCapturing, false);
+	FilePath capturePath = WriteProfilerCapture(scratch, profiler);
+	if (IsEmptyStr(capturePath)) { NotifyPrint_E("Failed to write the capture of %.*s to the settings folder", StrPrint(reasonStr)); }
+	else { NotifyPrint_I("Saved a capture of %.*s to \"%.*s\"", StrPrint(reasonStr), StrPrint(capturePath)); }
+	StopProfilerCapture(profiler);
+	ScratchEnd(scratch);
+}
+
+// Called by UpdateProfiler once the frame that just finished has been collected. frameTimestamp is when the next frame is starting
+void UpdateProfilerCapture(Profiler* profiler, u64 frameTimestamp)
+{
+	if (profiler->captureMode == ProfilerCaptureMode_Frames)
+	{
+		profiler->captureFramesLeft--;
+		if (profiler->captureFramesLeft == 0)
+		{
+			FinishProfilerCapture(profiler, ScratchPrintStr("%llu frames", (u64)profiler->captureFrames.length));
+			return;
+		}
+		u64* newFrame = VarArrayAdd(u64, &profiler->captureFrames);
+		NotNull(newFrame);
+		*newFrame = frameTimestamp;
+	}
+	else if (profiler->captureMode == ProfilerCaptureMode_NextStall)
+	{
+		u64 frameTicks = (profiler->flameEndTimestamp > profiler->flameBeginTimestamp) ? (profiler->flameEndTimestamp - profiler->flameBeginTimestamp) : 0;
+		r32 frameMs = ProfilerTicksToMs(profiler, frameTicks);
+		if (frameMs >= profiler->captureStallThreshold)
+		{
+			FinishProfilerCapture(profiler, ScratchPrintStr("a %.1fms frame and the one before it", frameMs));
+			return;
+		}
+		
+		//NOTE: Only the last frame is kept so that when a stall does happen we can see what led into it
+		VarArray oldPrevZones = profiler->capturePrevZones;
+		profiler->capturePrevZones = profiler->captureZones;
+		profiler->captureZones = oldPrevZones;
+		VarArrayClear(&profiler->captureZones);
+		while (profiler->captureFrames.length > 1) { VarArrayRemoveAt(u64, &profiler->captureFrames, 0); }
+		u64* newFrame = VarArrayAdd(u64, &profiler->captureFrames);
+		NotNull(newFrame);
+		*newFrame = frameTimestamp;
+		//NOTE: Details are only freed in bulk, so while we wait for a stall the older ones get dropped every so often
+		if (profiler->captureDetails.length >= PROFILER_CAPTURE_MAX_DETAILS/2) { ClearProfilerCaptureDetails(profiler); }
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                          Collecting                          |
+// +--------------------------------------------------------------+
+void HandleProfilerEvent(Profiler* profiler, uxx threadIndex, ProfilerEvent event)
+{
+	ProfilerThread* thread = &profiler->threads[threadIndex];
+	if (event.kind == ProfilerEventKind_Begin)
+	{
+		if (thread->stackDepth < PROFILER_MAX_DEPTH)
+		{
+			thread->stack[thread->stackDepth].zoneId = event.zoneId;
+			thread->stack[thread->stackDepth].detailNumber = 0;
+			thread->stack[thread->stackDepth].beginTimestamp = event.timestamp;
+		}
+		thread->stackDepth++;
+		return;
+	}
+	if (event.kind == ProfilerEventKind_Detail)
+	{
+		if (thread->stackDepth > 0 && thread->stackDepth <= PROFILER_MAX_DEPTH) { thread->stack[thread->stackDepth-1].detailNumber = event.zoneId; }
+		return;
+	}
+	
+	if (thread->stackDepth == 0) { return; } //the begin was dropped
+	thread->stackDepth--;
+	if (thread->stackDepth >= PROFILER_MAX_DEPTH) { return; }
+	ProfilerOpenZone openZone = thread->stack[thread->stackDepth];
+	//NOTE: If these don't match then an end was skipped (like an early return that missed a ProfZoneEnd), the best we can do is start over
+	if (openZone.zoneId != event.zoneId) { thread->stackDepth = 0; return; }
+	
+	u64 ticks = (event.timestamp > openZone.beginTimestamp) ? (event.timestamp - openZone.beginTimestamp) : 0;
+	ProfilerZone* zone = &profiler->zones[event.zoneId];
+	zone->frameTicks += ticks;
+	zone->frameCount++;
+	
+	if (profiler->captureMode != ProfilerCaptureMode_None)
+	{
+		ProfilerCaptureZone* captureZone = VarArrayAdd(ProfilerCaptureZone, &profiler->captureZones);
+		NotNull(captureZone);
+		captureZone->zoneId = event.zoneId;
+		captureZone->threadIndex = (u32)threadIndex;
+		captureZone->detailNumber = openZone.detailNumber;
+		captureZone->beginTimestamp = openZone.beginTimestamp;
+		captureZone->endTimestamp = event.timestamp;
+	}
+	
+	if (thread->isMainThread && profiler->numFlameZones < PROFILER_MAX_FLAME_ZONES)
+	{
+		ProfilerFlameZone* flameZone = &profiler->flameZones[profiler->numFlameZones];
+		flameZone->zoneId = event.zoneId;
+		flameZone->depth = thread->stackDepth;
+		flameZone->beginTimestamp = openZone.beginTimestamp;
+		flameZone->endTimestamp = event.timestamp;
+		profiler->numFlameZones++;
+		if (thread->stackDepth == 0)
+		{
+			if (profiler->flameBeginTimestamp == 0 || openZone.beginTimestamp < profiler->flameBeginTimestamp) { profiler->flameBeginTimestamp = openZone.beginTimestamp; }
+			if (event.timestamp > profiler->flameEndTimestamp) { profiler->flameEndTimestamp = event.timestamp; }
+		}
+	}
+}
+
+// Returns the index of the first sample in sortedSamples that isn't less than sample
+uxx FindProfilerSortedSampleIndex(const r32* sortedSamples, uxx numSamples, r32 sample)
+{
+	uxx minIndex = 0;
+	uxx maxIndex = numSamples;
+	while (minIndex < maxIndex)
+	{
+		uxx middleIndex = minIndex + (maxIndex - minIndex)/2;
+		if (sortedSamples[middleIndex] < sample) { minIndex = middleIndex+1; }
+		else { maxIndex = middleIndex; }
+	}
+	return minIndex;
+}
+
+// Adds the sample to the history, replacing the oldest one once it's full, and keeps sortedSamples in order
+// by removing the replaced sample and inserting the new one instead of sorting the whole history again
+void AddProfilerZoneSample(ProfilerZone* zone, r32 sample)
+{
+	uxx numSorted = zone->numSamples;
+	if (numSorted == PROFILER_HISTORY_LENGTH)
+	{
+		uxx removeIndex = FindProfilerSortedSampleIndex(zone->sortedSamples, numSorted, zone->samples[zone->nextSampleIndex]);
+		Assert(removeIndex < numSorted);
+		numSorted--;
+		if (removeIndex < numSorted) { MyMemMove(&zone->sortedSamples[removeIndex], &zone->sortedSamples[removeIndex+1], sizeof(r32) * (numSorted - removeIndex)); }
+	}
+	uxx insertIndex = FindProfilerSortedSampleIndex(zone->sortedSamples, numSorted, sample);
+	if (insertIndex < numSorted) { MyMemMove(&zone->sortedSamples[insertIndex+1], &zone->sortedSamples[insertIndex], sizeof(r32) * (numSorted - insertIndex)); }
+	zone->sortedSamples[insertIndex] = sample;
+	
+	zone->samples[zone->nextSampleIndex] = sample;
+	zone->nextSampleIndex = (zone->nextSampleIndex + 1) % PROFILER_HISTORY_LENGTH;
+	if (zone->numSamples < PROFILER_HISTORY_LENGTH) { zone->numSamples++; }
+}
+
+// Called at the top of AppUpdate, before the AppUpdate zone begins, so the main thread's events are exactly the last frame
+void UpdateProfiler(Profiler* profiler)
+{
+	NotNull(profiler);
+	if (!profiler->isInitialized) { return; }
+	
+	u64 frameTimestamp = GetProfilerTimestamp();
+	if (profiler->ticksPerMs == 0)
+	{
+		r32 elapsedMs = OsTimeDiffMsR32(profiler->calibrateTime, OsGetTime());
+		if (elapsedMs >= (r32)PROFILER_CALIBRATE_TIME && frameTimestamp > profiler->calibrateTimestamp)
+		{
+			profiler->ticksPerMs = (r64)(frameTimestamp - profiler->calibrateTimestamp) / (r64)elapsedMs;
+		}
+	}
+	
+	profiler->numFlameZones = 0;
+	profiler->flameBeginTimestamp = 0;
+	profiler->flameEndTimestamp = 0;
+	for (uxx tIndex = 0; tIndex < PROFILER_MAX_THREADS; tIndex++)
+	{
+		ProfilerThread* thread = &profiler->threads[tIndex];
+		i64 writeIndex = AtomicRead(&thread->writeIndex);
+		if (writeIndex - thread->readIndex > PROFILER_RING_SIZE)
+		{
+			thread->numDroppedEvents += (uxx)(writeIndex - PROFILER_RING_SIZE - thread->readIndex);
+			thread->readIndex = writeIndex - PROFILER_RING_SIZE;
+			thread->stackDepth = 0;
+		}
+		i64 firstReadIndex = thread->readIndex;
+		while (thread->readIndex < writeIndex)
+		{
+			ProfilerEvent event = thread->events[thread->readIndex % PROFILER_RING_SIZE];
+			thread->readIndex++;
+			HandleProfilerEvent(profiler, tIndex, event);
+		}
+		//NOTE: If the thread went all the way around the ring while we were reading then some of what we read was overwritten
+		if (AtomicRead(&thread->writeIndex) - firstReadIndex > PROFILER_RING_SIZE)
+		{
+			thread->numDroppedEvents++;
+			thread->stackDepth = 0;
+		}
+	}
+	
+	i64 numZones = AtomicRead(&profiler->numZones);
+	for (i64 zIndex = 1; zIndex < numZones; zIndex++)
+	{
+		ProfilerZone* zone = &profiler->zones[zIndex];
+		if (zone->frameCount == 0) { continue; }
+		if (profiler->ticksPerMs != 0)
+		{
+			AddProfilerZoneSample(zone, ProfilerTicksToMs(profiler, zone->frameTicks));
+		}
+		zone->frameTicks = 0;
+		zone->frameCount = 0;
+	}
+	
+	if (profiler->captureMode != ProfilerCaptureMode_None) { UpdateProfilerCapture(profiler, frameTimestamp); }
+}
+
+// The stats only read zone->sortedSamples so they are cheap enough to ask for every frame
+ProfilerZoneStats GetProfilerZoneStats(const Profiler* profiler, u32 zoneId)
+{
+	const ProfilerZone* zone = &profiler->zones[zoneId];
+	ProfilerZoneStats result = ZEROED;
+	result.zoneId = zoneId;
+	if (zone->numSamples == 0) { return result; }
+	result.p50 = zone->sortedSamples[((zone->numSamples-1) * 50) / 100];
+	result.p95 = zone->sortedSamples[((zone->numSamples-1) * 95) / 100];
+	result.max = zone->sortedSamples[zone->numSamples-1];
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                          Rendering                           |
+// +--------------------------------------------------------------+
+Color32 GetProfilerZoneColor(u32 zoneId)
+{
+	switch (zoneId % 6)
+	{
+		case 0: return MonokaiYellow;
+		case 1: return MonokaiGreen;
+		case 2: return MonokaiBlue;
+		case 3: return MonokaiOrange;
+		case 4: return MonokaiPurple;
+		default: return MonokaiMagenta;
+	}
+}
+
+// Draws the flame strip in stripRec and the zones with the highest p95 in a table below it. Returns the y coordinate of the bottom of everything drawn
+r32 RenderProfilerOverlay(Profiler* profiler, rec stripRec)
+{
+	NotNull(profiler);
+	if (!profiler->isInitialized || profiler->ticksPerMs == 0) { return stripRec.y; }
+	ScratchBegin(scratch);
+	BindFontEx(&app->uiFont, app->uiFontSize, UI_FONT_STYLE);
+	FontAtlas* fontAtlas = GetFontAtlas(&app->uiFont, app->uiFontSize, UI_FONT_STYLE);
+	r32 lineHeight = GetLineHeight();
+	v2 mousePos = appIn->mouse.position;
+	
+	// +==============================+
+	// |         Flame Strip          |
+	// +==============================+
+	DrawRectangle(stripRec, ColorWithAlpha(MonokaiBack, 0.85f));
+	const ProfilerFlameZone* hoverZone = nullptr;
+	u64 frameTicks = (profiler->flameEndTimestamp > profiler->flameBeginTimestamp) ? (profiler->flameEndTimestamp - profiler->flameBeginTimestamp) : 0;
+	if (frameTicks > 0)
+	{
+		r32 rowHeight = stripRec.height / PROFILER_FLAME_ROWS;
+		for (uxx fIndex = 0; fIndex < profiler->numFlameZones; fIndex++)
+		{
+			const ProfilerFlameZone* flameZone = &profiler->flameZones[fIndex];
+			if (flameZone->depth >= PROFILER_FLAME_ROWS || flameZone->beginTimestamp < profiler->flameBeginTimestamp) { continue; }
+			r32 beginPercent = (r32)((r64)(flameZone->beginTimestamp - profiler->flameBeginTimestamp) / (r64)frameTicks);
+			r32 endPercent = (r32)((r64)(flameZone->endTimestamp - profiler->flameBeginTimestamp) / (r64)frameTicks);
+			rec zoneRec = MakeRec(
+				stripRec.x + stripRec.width * beginPercent,
+				stripRec.y + rowHeight * flameZone->depth,
+				MaxR32(stripRec.width * (endPercent - beginPercent), 1.0f),
+				rowHeight - 1
+			);
+			DrawRectangle(zoneRec, GetProfilerZoneColor(flameZone->zoneId));
+			if (mousePos.x >= zoneRec.x && mousePos.x < zoneRec.x + zoneRec.width && mousePos.y >= zoneRec.y && mousePos.y < zoneRec.y + zoneRec.height) { hoverZone = flameZone; }
+			
+			Str8 zoneName = profiler->zones[flameZone->zoneId].name;
+			if (zoneRec.width >= 40 && MeasureTextEx(&app->uiFont, app->uiFontSize, UI_FONT_STYLE, false, 0.0f, zoneName).visualRec.width + 4 <= zoneRec.width)
+			{
+				DrawText(zoneName, MakeV2(zoneRec.x + 2, zoneRec.y + zoneRec.height/2 + fontAtlas->centerOffset), MonokaiBack);
+			}
+		}
+	}
+	DrawRectangleOutline(stripRec, 1, MonokaiGray1);
+	DrawText(ScratchPrintStr("%.2fms", ProfilerTicksToMs(profiler, frameTicks)), MakeV2(stripRec.x + stripRec.width - 60, stripRec.y + stripRec.height - lineHeight/2), MonokaiWhite);
+	
+	// +==============================+
+	// |          Zone Table          |
+	// +==============================+
+	i64 numZones = AtomicRead(&profiler->numZones);
+	ProfilerZoneStats* stats = AllocArray(ProfilerZoneStats, scratch, (uxx)numZones);
+	uxx numStats = 0;
+	for (i64 zIndex = 1; zIndex < numZones; zIndex++)
+	{
+		if (profiler->zones[zIndex].numSamples == 0) { continue; }
+		ProfilerZoneStats zoneStats = GetProfilerZoneStats(profiler, (u32)zIndex);
+		uxx insertIndex = numStats;
+		while (insertIndex > 0 && stats[insertIndex-1].p95 < zoneStats.p95) { stats[insertIndex] = stats[insertIndex-1]; insertIndex--; }
+		stats[insertIndex] = zoneStats;
+		numStats++;
+	}
+	
+	uxx numRows = MinUXX(numStats, PROFILER_TABLE_ROWS);
+	rec tableRec = MakeRec(stripRec.x, stripRec.y + stripRec.height + 4, stripRec.width, lineHeight * (numRows+1) + 4);
+	DrawRectangle(tableRec, ColorWithAlpha(MonokaiBack, 0.85f));
+	r32 columnX[4] = { tableRec.x + 4, tableRec.x + tableRec.width - 180, tableRec.x + tableRec.width - 120, tableRec.x + tableRec.width - 60 };
+	v2 textPos = MakeV2(0, tableRec.y + 2 + lineHeight/2 + fontAtlas->centerOffset);
+	DrawText(StrLit("Zone"), MakeV2(columnX[0], textPos.y), MonokaiGray1);
+	DrawText(StrLit("p50"), MakeV2(columnX[1], textPos.y), MonokaiGray1);
+	DrawText(StrLit("p95"), MakeV2(columnX[2], textPos.y), MonokaiGray1);
+	DrawText(StrLit("max"), MakeV2(columnX[3], textPos.y), MonokaiGray1);
+	textPos.y += lineHeight;
+	for (uxx rIndex = 0; rIndex < numRows; rIndex++)
+	{
+		const ProfilerZoneStats* zoneStats = &stats[rIndex];
+		DrawText(profiler->zones[zoneStats->zoneId].name, MakeV2(columnX[0], textPos.y), GetProfilerZoneColor(zoneStats->zoneId));
+		DrawText(ScratchPrintStr("%.2f", zoneStats->p50), MakeV2(columnX[1], textPos.y), MonokaiWhite);
+		DrawText(ScratchPrintStr("%.2f", zoneStats->p95), MakeV2(columnX[2], textPos.y), MonokaiWhite);
+		DrawText(ScratchPrintStr("%.2f", zoneStats->max), MakeV2(columnX[3], textPos.y), MonokaiWhite);
+		textPos.y += lineHeight;
+	}
+	
+	if (hoverZone != nullptr)
+	{
+		Str8 hoverStr = ScratchPrintStr("%.*s %.3fms", StrPrint(profiler->zones[hoverZone->zoneId].name), ProfilerTicksToMs(profiler, hoverZone->endTimestamp - hoverZone->beginTimestamp));
+		DrawText(hoverStr, Add(mousePos, MakeV2(12, 0)), MonokaiWhite);
+	}
+	
+	ScratchEnd(scratch);
+	return tableRec.y + tableRec.height;
+}
@@ -0,0 +1,439 @@
+/*
+File:   app_recent_files.c
+Description:
+	** Holds the functions that manage app->recentFiles and the recent_files.txt file that backs it.
+	** recent_files.txt is treated as a journal: every time a file is opened we append its path as a new line,
+	** and replaying the lines in order (moving repeated paths to the end) rebuilds the list. Once the journal
+	** gets longer than RECENT_FILES_COMPACT_LENGTH lines we rewrite it with only the current list, which is
+	** the same format the file had before it was a journal.
+	** All file IO (appending, compacting, and checking whether each recent file still exists) is done by a
+	** short-lived thread so a slow or unmounted network path never stalls the main thread.
+	** NOTE: FlushRecentFilesWorker must be called before the app closes or the dll is reloaded
+*/
+
+FilePath GetRecentFilesSavePath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath settingsFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = PrintInArenaStr(arena, "%.*s%s%s",
+		StrPrint(settingsFolderPath),
+		DoesPathHaveTrailingSlash(settingsFolderPath) ? "" : "/",
+		RECENT_FILES_SAVE_FILEPATH
+	);
+	ScratchEnd(scratch);
+	return result;
+}
+
+void FreeRecentFile(RecentFile* recentFile)
+{
+	NotNull(recentFile);
+	FreeStr8(stdHeap, &recentFile->path);
+	ClearPointer(recentFile);
+}
+
+void AppClearRecentFiles()
+{
+	VarArrayLoop(&app->recentFiles, rIndex)
+	{
+		VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
+		FreeRecentFile(recentFile);
+	}
+	VarArrayClear(&app->recentFiles);
+	app->paletteRecentFilesGeneration++;
+}
+
+// Moves fullPath to the end of the list (adding it if it's not already there) and drops the oldest entries if the list is too long
+RecentFile* AppPushRecentFile(Str8 fullPath, bool fileExists)
+{
+	VarArrayLoop(&app->recentFiles, rIndex)
+	{
+		VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
+		if (StrAnyCaseEquals(recentFile->path, fullPath))
+		{
+			if (rIndex+1 < app->recentFiles.length)
+			{
+				//Move this path to the end of the array
+				RecentFile temp;
+				MyMemCopy(&temp, recentFile, sizeof(RecentFile));
+				VarArrayRemove(RecentFile, &app->recentFiles, recentFile);
+				RecentFile* newRecentFile = VarArrayAdd(RecentFile, &app->recentFiles);
+				MyMemCopy(newRecentFile, &temp, sizeof(RecentFile));
+			}
+			return VarArrayGetLast(RecentFile, &app->recentFiles);
+		}
+	}
+	
+	RecentFile* newRecentFile = VarArrayAdd(RecentFile, &app->recentFiles);
+	NotNull(newRecentFile);
+	ClearPointer(newRecentFile);
+	newRecentFile->path = AllocStr8(stdHeap, fullPath);
+	newRecentFile->fileExists = fileExists;
+	NotNull(newRecentFile->path.chars);
+	
+	while (app->recentFiles.length > RECENT_FILES_MAX_LENGTH)
+	{
+		RecentFile* firstFile = VarArrayGetFirst(RecentFile, &app->recentFiles);
+		FreeRecentFile(firstFile);
+		VarArrayRemoveFirst(RecentFile, &app->recentFiles);
+	}
+	return VarArrayGetLast(RecentFile, &app->recentFiles);
+}
+
+// +--------------------------------------------------------------+
+// |                     Recent Files Worker                      |
+// +--------------------------------------------------------------+
+// Does the file IO described by the job fields of the worker. This is run on the worker thread, or directly when flushing
+void DoRecentFilesJob(RecentFilesWorker* worker)
+{
+	NotNull(worker);
+	ProfZoneBeginEx(_funcZone, "DoRecentFilesJob", ProfilerCategory_Job);
+	bool writeSucceeded = true;
+	if (worker->jobCompact)
+	{
+		writeSucceeded = AppWriteTextFileAtomically(worker->jobSavePath, worker->jobCompactStr);
+	}
+	else if (!IsEmptyStr(worker->jobAppendStr))
+	{
+		ScratchBegin(scratch);
+		OsFile fileHandle = ZEROED;
+		if (OsOpenFile(scratch, worker->jobSavePath, OsOpenFileMode_Append, false, &fileHandle))
+		{
+			writeSucceeded = OsWriteToOpenTextFile(&fileHandle, worker->jobAppendStr);
+			OsCloseFile(&fileHandle);
+		}
+		else { writeSucceeded = false; }
+		ScratchEnd(scratch);
+	}
+	worker->jobWriteSucceeded = writeSucceeded;
+	
+	VarArrayLoop(&worker->jobProbePaths, pIndex)
+	{
+		VarArrayLoopGet(Str8, probePath, &worker->jobProbePaths, pIndex);
+		*VarArrayGetHard(bool, &worker->jobProbeResults, pIndex) = OsDoesFileExist(*probePath);
+	}
+	ProfZoneEnd(_funcZone);
+}
+
+// +==============================+
+// |   RecentFilesThreadMain      |
+// +==============================+
+// DWORD RecentFilesThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(RecentFilesThreadMain)
+{
+	NotNull(contextPntr);
+	RecentFilesWorker* worker = (RecentFilesWorker*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	DoRecentFilesJob(worker);
+	AtomicWrite(&worker->isWorking, false);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+void FreeRecentFilesJob(RecentFilesWorker* worker)
+{
+	NotNull(worker);
+	FreeStr8(worker->arena, &worker->jobSavePath);
+	FreeStr8(worker->arena, &worker->jobAppendStr);
+	FreeStr8(worker->arena, &worker->jobCompactStr);
+	VarArrayLoop(&worker->jobProbePaths, pIndex)
+	{
+		VarArrayLoopGet(Str8, probePath, &worker->jobProbePaths, pIndex);
+		FreeStr8(worker->arena, probePath);
+	}
+	VarArrayClear(&worker->jobProbePaths);
+	VarArrayClear(&worker->jobProbeResults);
+	worker->jobCompact = false;
+	worker->jobWriteSucceeded = false;
+}
+
+void FreeRecentFilesWorker(RecentFilesWorker* worker)
+{
+	NotNull(worker);
+	if (worker->arena != nullptr)
+	{
+		if (worker->thread.isFilled)
+		{
+			while (AtomicRead(&worker->isWorking)) { OsSleepMs(1); }
+			OsCloseThread(&worker->thread);
+		}
+		FreeRecentFilesJob(worker);
+		VarArrayLoop(&worker->pendingLines, lIndex)
+		{
+			VarArrayLoopGet(Str8, pendingLine, &worker->pendingLines, lIndex);
+			FreeStr8(worker->arena, pendingLine);
+		}
+		FreeVarArray(&worker->pendingLines);
+		FreeVarArray(&worker->jobProbePaths);
+		FreeVarArray(&worker->jobProbeResults);
+	}
+	ClearPointer(worker);
+}
+
+void InitRecentFilesWorker(Arena* arena, RecentFilesWorker* workerOut)
+{
+	NotNull(arena);
+	NotNull(workerOut);
+	ClearPointer(workerOut);
+	workerOut->arena = arena;
+	InitVarArray(Str8, &workerOut->pendingLines, arena);
+	InitVarArray(Str8, &workerOut->jobProbePaths, arena);
+	InitVarArray(bool, &workerOut->jobProbeResults, arena);
+}
+
+// Applies the results of a finished job. If wait is true we block until the thread is done
+void FinishRecentFilesJob(RecentFilesWorker* worker, bool wait)
+{
+	NotNull(worker);
+	if (!worker->thread.isFilled && !worker->hasJob) { return; }
+	if (worker->thread.isFilled)
+	{
+		if (wait)
+		{
+			ProfZoneBegin(Zone_WaitForWorker, "WaitForRecentFilesWorker");
+			while (AtomicRead(&worker->isWorking)) { OsSleepMs(1); }
+			ProfZoneEnd(Zone_WaitForWorker);
+		}
+		if (AtomicRead(&worker->isWorking)) { return; }
+		OsCloseThread(&worker->thread);
+		ClearStruct(worker->thread);
+	}
+	
+	if (!worker->jobWriteSucceeded) { NotifyPrint_E("Failed to save recent files list to \"%.*s\"", StrPrint(worker->jobSavePath)); }
+	if (worker->jobCompact || !IsEmptyStr(worker->jobAppendStr))
+	{
+		//NOTE: This re-reads the write time so our own write doesn't look like an outside change to the file
+		if (app->recentFilesWatchId == 0) { app->recentFilesWatchId = AddFileWatch(&app->fileWatches, worker->jobSavePath, CHECK_RECENT_FILES_WRITE_TIME_PERIOD); }
+		else { ClearFileWatchChanged(&app->fileWatches, app->recentFilesWatchId); }
+	}
+	
+	// The list may have changed while the thread was working so the results are matched up by path
+	bool anyExistenceChanged = false;
+	VarArrayLoop(&worker->jobProbePaths, pIndex)
+	{
+		VarArrayLoopGet(Str8, probePath, &worker->jobProbePaths, pIndex);
+		bool doesExist = *VarArrayGetHard(bool, &worker->jobProbeResults, pIndex);
+		VarArrayLoop(&app->recentFiles, rIndex)
+		{
+			VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
+			if (StrExactEquals(recentFile->path, *probePath))
+			{
+				if (recentFile->fileExists != doesExist) { anyExistenceChanged = true; }
+				recentFile->fileExists = doesExist;
+				break;
+			}
+		}
+	}
+	if (anyExistenceChanged) { app->paletteRecentFilesGeneration++; }
+	
+	FreeRecentFilesJob(worker);
+	worker->hasJob = false;
+}
+
+// Hands all the pending work to a new thread (or does it right here if runOnThisThread is true)
+void StartRecentFilesJob(RecentFilesWorker* worker, bool runOnThisThread)
+{
+	NotNull(worker);
+	Assert(!worker->hasJob);
+	ProfZoneBegin(_funcZone, "StartRecentFilesJob");
+	
+	ScratchBegin1(scratch, worker->arena);
+	worker->jobSavePath = AllocStr8(worker->arena, GetRecentFilesSavePath(scratch, true));
+	ScratchEnd(scratch);
+	if (worker->compactRequested && app->recentFiles.length == 0)
+	{
+		worker->jobCompact = true;
+		worker->jobCompactStr = Str8_Empty;
+		worker->numJournalLines = 0;
+	}
+	else if (worker->compactRequested)
+	{
+		worker->jobCompact = true;
+		TwoPassStr8Loop(compactStr, worker->arena, false)
+		{
+			VarArrayLoop(&app->recentFiles, rIndex)
+			{
+				VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
+				TwoPassPrint(&compactStr, "%.*s\n", StrPrint(recentFile->path));
+			}
+			TwoPassStr8LoopEnd(&compactStr);
+		}
+		worker->jobCompactStr = compactStr.str;
+		worker->numJournalLines = app->recentFiles.length;
+	}
+	else if (worker->pendingLines.length > 0)
+	{
+		TwoPassStr8Loop(appendStr, worker->arena, false)
+		{
+			VarArrayLoop(&worker->pendingLines, lIndex)
+			{
+				VarArrayLoopGet(Str8, pendingLine, &worker->pendingLines, lIndex);
+				TwoPassPrint(&appendStr, "%.*s\n", StrPrint(*pendingLine));
+			}
+			TwoPassStr8LoopEnd(&appendStr);
+		}
+		worker->jobAppendStr = appendStr.str;
+	}
+	VarArrayLoop(&worker->pendingLines, lIndex)
+	{
+		VarArrayLoopGet(Str8, pendingLine, &worker->pendingLines, lIndex);
+		FreeStr8(worker->arena, pendingLine);
+	}
+	VarArrayClear(&worker->pendingLines);
+	worker->compactRequested = false;
+	
+	if (worker->probeRequested && app->recentFiles.length > 0)
+	{
+		VarArrayLoop(&app->recentFiles, rIndex)
+		{
+			VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
+			Str8* probePath = VarArrayAdd(Str8, &worker->jobProbePaths);
+			bool* probeResult = VarArrayAdd(bool, &worker->jobProbeResults);
+			NotNull(probePath);
+			NotNull(probeResult);
+			*probePath = AllocStr8(worker->arena, recentFile->path);
+			*probeResult = recentFile->fileExists;
+		}
+	}
+	worker->probeRequested = false;
+	worker->hasJob = true;
+	
+	if (!runOnThisThread)
+	{
+		AtomicWrite(&worker->isWorking, true);
+		worker->thread = OsCreateThread(RecentFilesThreadMain, worker, true);
+		if (!worker->thread.isFilled)
+		{
+			AtomicWrite(&worker->isWorking, false);
+			WriteLine_W("Failed to start recent files thread! Doing the work on the main thread");
+			runOnThisThread = true;
+		}
+	}
+	if (runOnThisThread)
+	{
+		DoRecentFilesJob(worker);
+		FinishRecentFilesJob(worker, true);
+	}
+	ProfZoneEnd(_funcZone);
+}
+
+// Called once a frame
+void UpdateRecentFilesWorker(RecentFilesWorker* worker)
+{
+	NotNull(worker);
+	if (worker->arena == nullptr) { return; }
+	FinishRecentFilesJob(worker, false);
+	if (worker->hasJob) { return; }
+	if (worker->pendingLines.length > 0 || worker->compactRequested || worker->probeRequested)
+	{
+		StartRecentFilesJob(worker, false);
+	}
+}
+
+// Waits for the thread and then writes anything that's still pending. The journal is always compacted here since we are closing (or reloading) anyways
+void FlushRecentFilesWorker(RecentFilesWorker* worker)
+{
+	NotNull(worker);
+	if (worker->arena == nullptr) { return; }
+	ProfZoneBegin(_funcZone, "FlushRecentFilesWorker");
+	FinishRecentFilesJob(worker, true);
+	if (worker->numJournalLines > app->recentFiles.length) { worker->compactRequested = true; }
+	worker->probeRequested = false;
+	if (worker->pendingLines.length > 0 || worker->compactRequested) { StartRecentFilesJob(worker, true); }
+	ProfZoneEnd(_funcZone);
+}
+
+// +--------------------------------------------------------------+
+// |                       Load and Remember                      |
+// +--------------------------------------------------------------+
+// fileContent is nullptr if the save file couldn't be read. At startup the read happens on a worker (see app_startup.c)
+void AppLoadRecentFilesListFrom(FilePath savePath, const Str8* fileContent)
+{
+	ProfZoneBegin(_funcZone, "AppLoadRecentFilesList");
+	ScratchBegin(scratch);
+	if (fileContent != nullptr)
+	{
+		// Remember which files we already knew were missing so the list doesn't flicker while the new probe is running
+		uxx numPrevFiles = app->recentFiles.length;
+		Str8* prevMissingPaths = AllocArray(Str8, scratch, MaxUXX(numPrevFiles, 1));
+		uxx numPrevMissing = 0;
+		VarArrayLoop(&app->recentFiles, rIndex)
+		{
+			VarArrayLoopGet(RecentFile, recentFile, &app->recentFiles, rIndex);
+			if (!recentFile->fileExists) { prevMissingPaths[numPrevMissing++] = AllocStr8(scratch, recentFile->path); }
+		}
+		
+		AppClearRecentFiles();
+		uxx numJournalLines = 0;
+		LineParser parser = MakeLineParser(*fileContent);
+		Str8 fileLine = ZEROED;
+		while (LineParserGetLine(&parser, &fileLine))
+		{
+			if (!IsEmptyStr(fileLine))
+			{
+				bool wasMissing = false;
+				for (uxx mIndex = 0; mIndex < numPrevMissing; mIndex++)
+				{
+					if (StrExactEquals(prevMissingPaths[mIndex], fileLine)) { wasMissing = true; break; }
+				}
+				AppPushRecentFile(fileLine, !wasMissing);
+				numJournalLines++;
+			}
+		}
+		
+		app->recentFilesWorker.numJournalLines = numJournalLines;
+		app->recentFilesWorker.probeRequested = true;
+		if (numJournalLines > RECENT_FILES_COMPACT_LENGTH) { app->recentFilesWorker.compactRequested = true; }
+		app->paletteRecentFilesGeneration++;
+		PrintLine_D("Loaded %llu recent file%s from %llu line%s in \"%.*s\"", app->recentFiles.length, Plural(app->recentFiles.length, "s"), numJournalLines, Plural(numJournalLines, "s"), StrPrint(savePath));
+		if (app->recentFilesWatchId == 0) { app->recentFilesWatchId = AddFileWatch(&app->fileWatches, savePath, CHECK_RECENT_FILES_WRITE_TIME_PERIOD); }
+		else { ClearFileWatchChanged(&app->fileWatches, app->recentFilesWatchId); }
+	}
+	else { PrintLine_W("No recent files save found at \"%.*s\"", StrPrint(savePath)); }
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+void AppLoadRecentFilesList()
+{
+	ScratchBegin(scratch);
+	FilePath savePath = GetRecentFilesSavePath(scratch, false);
+	//NOTE: OsReadTextFile simply fails if the file doesn't exist, which avoids an extra OsDoesFileExist call
+	Str8 fileContent = Str8_Empty;
+	bool readSuccess = AppReadTextFile(savePath, scratch, &fileContent);
+	AppLoadRecentFilesListFrom(savePath, readSuccess ? &fileContent : nullptr);
+	ScratchEnd(scratch);
+}
+
+// Rewrites recent_files.txt with only the current list (on the worker thread)
+void AppSaveRecentFilesList()
+{
+	app->recentFilesWorker.compactRequested = true;
+}
+
+void AppRememberRecentFile(FilePath filePath)
+{
+	ScratchBegin(scratch);
+	Str8 fullPath = OsGetFullPath(scratch, filePath);
+	RecentFile* recentFile = AppPushRecentFile(fullPath, true);
+	recentFile->fileExists = true; //we just opened it so it must exist
+	app->paletteRecentFilesGeneration++;
+	
+	RecentFilesWorker* worker = &app->recentFilesWorker;
+	Str8* newLine = VarArrayAdd(Str8, &worker->pendingLines);
+	NotNull(newLine);
+	*newLine = AllocStr8(worker->arena, fullPath);
+	worker->numJournalLines++;
+	if (worker->numJournalLines > RECENT_FILES_COMPACT_LENGTH) { worker->compactRequested = true; }
+	
+	ScratchEnd(scratch);
+}
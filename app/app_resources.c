@@ -70,7 +70,7 @@ Result TryReadAppResource(AppResources* resources, Arena* arena, FilePath path,
 		
 		if (fileContentsOut != nullptr)
 		{
-			bool readSuccess = OsReadFile(resourcePath, arena, convertNewLines, fileContentsOut);
+			bool readSuccess = AppReadFile(resourcePath, arena, convertNewLines, fileContentsOut);
 			if (!readSuccess) { PrintLine_E("Failed to read resource %s app bundle \"%.*s\"", USE_OSX_APP_BUNDLE_RESOURCES ? "from inside" : "next to", StrPrint(resourcePath)); }
 			return readSuccess ? Result_Success : Result_FailedToReadFile;
 		}
@@ -85,7 +85,7 @@ Result TryReadAppResource(AppResources* resources, Arena* arena, FilePath path,
 	{
 		if (fileContentsOut != nullptr)
 		{
-			bool readSuccess = OsReadFile(path, arena, convertNewLines, fileContentsOut);
+			bool readSuccess = AppReadFile(path, arena, convertNewLines, fileContentsOut);
 			return readSuccess ? Result_Success : Result_FailedToReadFile;
 		}
 		else
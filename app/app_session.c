@@ -0,0 +1,351 @@
+/*
+File:   app_session.c
+Description:
+	** Saves the open tabs to session.bin when the app closes and restores them on the next startup.
+	** Alongside the path, selection and scroll offset of each tab we store a snapshot of its parsed
+	** options so the restored tabs can be shown on the first frame without reading or parsing any files.
+	** The snapshot is then verified by a short-lived thread that reads each file and compares its size and
+	** content hash against the snapshot. Tabs that match simply get their fileContents filled in, tabs whose
+	** file changed are reparsed, and tabs whose file is gone are closed.
+	** NOTE: Until a tab has been verified (isFromSnapshot) it has no fileContents and can't be toggled
+*/
+
+// session.bin is a SessionHeader followed by numTabs of:
+//   SessionTabRecord, path chars, then the tab's option table (see WriteFileOptionTable in app_parse_cache.c)
+#define SESSION_MAGIC   0x53534343 //"CCSS"
+#define SESSION_VERSION 1
+typedef plex SessionHeader SessionHeader;
+plex SessionHeader
+{
+	u32 magic;
+	u32 version;
+	u32 tabRecordSize;
+	u32 optionRecordSize; //sizeof(FileOptionRecord)
+	u64 numTabs;
+	u64 currentTabIndex;
+};
+typedef plex SessionTabRecord SessionTabRecord;
+plex SessionTabRecord
+{
+	u64 fileSize;
+	u64 contentHash;
+	i64 selectedOptionIndex;
+	r32 scrollY;
+	u32 pathLength;
+	u64 numOptions;
+};
+
+FilePath GetSessionSavePath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = JoinStringsInArenaWithChar(arena, folderPath, '/', StrLit(SESSION_FILENAME), false);
+	ScratchEnd(scratch);
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                       Session Verifier                       |
+// +--------------------------------------------------------------+
+// +==============================+
+// |   SessionVerifierThreadMain  |
+// +==============================+
+// DWORD SessionVerifierThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(SessionVerifierThreadMain)
+{
+	NotNull(contextPntr);
+	SessionVerifier* verifier = (SessionVerifier*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	ProfZoneBeginEx(_funcZone, "SessionVerifierThread", ProfilerCategory_Job);
+	VarArrayLoop(&verifier->items, iIndex)
+	{
+		VarArrayLoopGet(SessionVerifyItem, item, &verifier->items, iIndex);
+		item->readSucceeded = (OsDoesFileExist(item->filePath) && AppReadTextFile(item->filePath, &verifier->threadHeap, &item->fileContents));
+		//NOTE: We have to read the whole file anyways so we don't bother comparing write times, the hash is the real test
+		item->matchesSnapshot = (item->readSucceeded &&
+			item->fileContents.length == item->expectedFileSize &&
+			HashStr8Fnv(item->fileContents) == item->expectedHash);
+	}
+	AtomicWrite(&verifier->isWorking, false);
+	ProfZoneEnd(_funcZone);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+void FreeSessionVerifierItems(SessionVerifier* verifier)
+{
+	NotNull(verifier);
+	VarArrayLoop(&verifier->items, iIndex)
+	{
+		VarArrayLoopGet(SessionVerifyItem, item, &verifier->items, iIndex);
+		FreeStr8(verifier->arena, &item->filePath);
+		FreeStr8(&verifier->threadHeap, &item->fileContents);
+	}
+	VarArrayClear(&verifier->items);
+}
+
+void InitSessionVerifier(Arena* arena, SessionVerifier* verifierOut)
+{
+	NotNull(arena);
+	NotNull(verifierOut);
+	ClearPointer(verifierOut);
+	verifierOut->arena = arena;
+	InitArenaStdHeap(&verifierOut->threadHeap);
+	InitVarArray(SessionVerifyItem, &verifierOut->items, arena);
+}
+
+// Applies the results to any tabs that are still waiting on them. If wait is true we block until the thread is done
+void FinishSessionVerifier(SessionVerifier* verifier, bool wait)
+{
+	NotNull(verifier);
+	if (!verifier->thread.isFilled) { return; }
+	if (wait)
+	{
+		ProfZoneBegin(Zone_WaitForVerifier, "WaitForSessionVerifier");
+		while (AtomicRead(&verifier->isWorking)) { OsSleepMs(1); }
+		ProfZoneEnd(Zone_WaitForVerifier);
+	}
+	if (AtomicRead(&verifier->isWorking)) { return; }
+	OsCloseThread(&verifier->thread);
+	ClearStruct(verifier->thread);
+	
+	ProfZoneBegin(_funcZone, "FinishSessionVerifier");
+	// Tabs may have been closed (or reloaded) while the thread was working so the results are matched up by path
+	VarArrayLoop(&verifier->items, iIndex)
+	{
+		VarArrayLoopGet(SessionVerifyItem, item, &verifier->items, iIndex);
+		uxx tabIndex = app->tabs.length;
+		VarArrayLoop(&app->tabs, tIndex)
+		{
+			VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+			if (tab->isFromSnapshot && StrExactEquals(tab->filePath, item->filePath)) { tabIndex = tIndex; break; }
+		}
+		if (tabIndex >= app->tabs.length) { continue; }
+		
+		FileTab* tab = VarArrayGetHard(FileTab, &app->tabs, tabIndex);
+		if (!item->readSucceeded)
+		{
+			NotifyPrint_W("Failed to open file at \"%.*s\"", StrPrint(tab->filePath));
+			AppCloseFileTab(tabIndex);
+			continue;
+		}
+		
+		FreeStr8(stdHeap, &tab->fileContents);
+		FreeStr8(stdHeap, &tab->originalFileContents);
+		tab->fileContents = AllocStr8(stdHeap, item->fileContents);
+		tab->originalFileContents = AllocStr8(stdHeap, item->fileContents);
+		tab->isFileChangedFromOriginal = false;
+		tab->isFromSnapshot = false;
+		tab->fileWatchId = AddFileWatch(&app->fileWatches, tab->filePath, CHECK_FILE_WRITE_TIME_PERIOD);
+		if (!item->matchesSnapshot)
+		{
+			PrintLine_D("\"%.*s\" changed since the last session, reparsing", StrPrint(tab->filePath));
+			UpdateFileTabOptions(tab);
+		}
+		else
+		{
+			//The options came from the snapshot, but we needed the file contents to find the #if blocks around them
+			BuildFileTabConditionals(tab);
+		}
+	}
+	FreeSessionVerifierItems(verifier);
+	ProfZoneEnd(_funcZone);
+}
+
+void FreeSessionVerifier(SessionVerifier* verifier)
+{
+	NotNull(verifier);
+	if (verifier->arena != nullptr)
+	{
+		FinishSessionVerifier(verifier, true);
+		FreeSessionVerifierItems(verifier);
+		FreeVarArray(&verifier->items);
+	}
+	ClearPointer(verifier);
+}
+
+// Hands every tab that is still showing its snapshot to a new thread (or verifies them right here if we can't start one)
+void StartSessionVerifier(SessionVerifier* verifier)
+{
+	NotNull(verifier);
+	NotNull(verifier->arena);
+	Assert(!verifier->thread.isFilled);
+	ProfZoneBegin(_funcZone, "StartSessionVerifier");
+	VarArrayLoop(&app->tabs, tIndex)
+	{
+		VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+		if (!tab->isFromSnapshot) { continue; }
+		SessionVerifyItem* item = VarArrayAdd(SessionVerifyItem, &verifier->items);
+		NotNull(item);
+		ClearPointer(item);
+		item->filePath = AllocStr8(verifier->arena, tab->filePath);
+		item->expectedFileSize = tab->snapshotFileSize;
+		item->expectedHash = tab->snapshotHash;
+	}
+	if (verifier->items.length == 0) { ProfZoneEnd(_funcZone); return; }
+	
+	AtomicWrite(&verifier->isWorking, true);
+	verifier->thread = OsCreateThread(SessionVerifierThreadMain, verifier, true);
+	if (!verifier->thread.isFilled)
+	{
+		//NOTE: Without a thread we lose the quick startup but the tabs still get verified
+		AtomicWrite(&verifier->isWorking, false);
+		WriteLine_W("Failed to start session verifier thread! Verifying on the main thread");
+		VarArrayLoop(&verifier->items, iIndex)
+		{
+			VarArrayLoopGet(SessionVerifyItem, item, &verifier->items, iIndex);
+			FileTab* tab = AppFindTabForPath(item->filePath);
+			uxx tabIndex = 0;
+			if (tab == nullptr || !VarArrayGetIndexOf(FileTab, &app->tabs, tab, &tabIndex)) { continue; }
+			AppReloadFileTab(tabIndex);
+		}
+		FreeSessionVerifierItems(verifier);
+	}
+	ProfZoneEnd(_funcZone);
+}
+
+// Called once a frame, returns true if any tab was updated
+bool UpdateSessionVerifier(SessionVerifier* verifier)
+{
+	NotNull(verifier);
+	if (verifier->arena == nullptr || !verifier->thread.isFilled) { return false; }
+	FinishSessionVerifier(verifier, false);
+	return !verifier->thread.isFilled;
+}
+
+// +--------------------------------------------------------------+
+// |                         Save Session                         |
+// +--------------------------------------------------------------+
+void AppSaveSession()
+{
+	ProfZoneBegin(_funcZone, "AppSaveSession");
+	ScratchBegin(scratch);
+	SerialWriter writer = ZEROED;
+	for (uxx pass = 0; pass < 2; pass++)
+	{
+		writer.size = 0;
+		
+		SessionHeader header = ZEROED;
+		header.magic = SESSION_MAGIC;
+		header.version = SESSION_VERSION;
+		header.tabRecordSize = sizeof(SessionTabRecord);
+		header.optionRecordSize = sizeof(FileOptionRecord);
+		header.numTabs = app->tabs.length;
+		header.currentTabIndex = app->currentTabIndex;
+		SerialWrite(&writer, sizeof(header), &header);
+		
+		VarArrayLoop(&app->tabs, tIndex)
+		{
+			VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+			SessionTabRecord tabRecord = ZEROED;
+			//NOTE: Tabs that were never verified keep the values from their snapshot since their options still came from that version of the file
+			tabRecord.fileSize = tab->isFromSnapshot ? tab->snapshotFileSize : tab->fileContents.length;
+			if (pass == 1) { tabRecord.contentHash = tab->isFromSnapshot ? tab->snapshotHash : HashStr8Fnv(tab->fileContents); }
+			tabRecord.selectedOptionIndex = tab->selectedOptionIndex;
+			tabRecord.scrollY = tab->scrollY;
+			tabRecord.pathLength = (u32)tab->filePath.length;
+			tabRecord.numOptions = tab->fileOptions.length;
+			SerialWrite(&writer, sizeof(tabRecord), &tabRecord);
+			SerialWrite(&writer, tab->filePath.length, tab->filePath.chars);
+			
+			WriteFileOptionTable(&writer, &tab->fileOptions);
+		}
+		
+		if (pass == 0)
+		{
+			writer.bytes = (u8*)AllocMem(scratch, writer.size);
+			NotNull(writer.bytes);
+		}
+	}
+	
+	FilePath savePath = GetSessionSavePath(scratch, true);
+	//NOTE: The session is only a convenience so we don't bother the user if this fails
+	if (!AppWriteBinFile(savePath, NewStr8(writer.size, writer.bytes))) { WriteLine_W("Failed to write session file"); }
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// +--------------------------------------------------------------+
+// |                       Restore Session                        |
+// +--------------------------------------------------------------+
+// Opens the tabs from the last session using their snapshots and starts verifying them in the background. Returns false if there was nothing to restore
+bool AppRestoreSession()
+{
+	ProfZoneBegin(_funcZone, "AppRestoreSession");
+	ScratchBegin(scratch);
+	FilePath savePath = GetSessionSavePath(scratch, false);
+	SerialReader reader = ZEROED;
+	SessionHeader header = ZEROED;
+	if (!OsDoesFileExist(savePath) || !AppReadBinFile(savePath, scratch, &reader.data) ||
+		!SerialRead(&reader, sizeof(header), &header) ||
+		header.magic != SESSION_MAGIC || header.version != SESSION_VERSION ||
+		header.tabRecordSize != sizeof(SessionTabRecord) || header.optionRecordSize != sizeof(FileOptionRecord))
+	{
+		ScratchEnd(scratch);
+		ProfZoneEnd(_funcZone);
+		return false;
+	}
+	
+	uxx numTabsBefore = app->tabs.length;
+	for (u64 tIndex = 0; tIndex < header.numTabs; tIndex++)
+	{
+		SessionTabRecord tabRecord = ZEROED;
+		Str8 pathStr = Str8_Empty;
+		if (!SerialRead(&reader, sizeof(tabRecord), &tabRecord) || !SerialReadStr(&reader, tabRecord.pathLength, &pathStr))
+		{
+			WriteLine_W("Session file is malformed, the remaining tabs won't be restored");
+			break;
+		}
+		if (IsEmptyStr(pathStr) || AppFindTabForPath(pathStr) != nullptr)
+		{
+			//NOTE: We still have to step over the options of a tab we skip
+			FileTab skippedTab = ZEROED;
+			InitVarArray(FileOption, &skippedTab.fileOptions, stdHeap);
+			bool readSuccess = ReadFileOptionTable(&reader, tabRecord.numOptions, tabRecord.fileSize, &skippedTab.fileOptions);
+			FreeFileTab(&skippedTab);
+			if (!readSuccess) { break; }
+			continue;
+		}
+		
+		FileTab* newTab = VarArrayAdd(FileTab, &app->tabs);
+		NotNull(newTab);
+		ClearPointer(newTab);
+		newTab->filePath = AllocStr8(stdHeap, pathStr);
+		InitVarArray(FileOption, &newTab->fileOptions, stdHeap);
+		if (!ReadFileOptionTable(&reader, tabRecord.numOptions, tabRecord.fileSize, &newTab->fileOptions))
+		{
+			WriteLine_W("Session file is malformed, the remaining tabs won't be restored");
+			FreeFileTab(newTab);
+			VarArrayRemoveAt(FileTab, &app->tabs, app->tabs.length-1);
+			break;
+		}
+		newTab->selectedOptionIndex = (tabRecord.selectedOptionIndex >= 0 && (u64)tabRecord.selectedOptionIndex < tabRecord.numOptions) ? (ixx)tabRecord.selectedOptionIndex : -1;
+		newTab->scrollY = (tabRecord.scrollY > 0.0f) ? tabRecord.scrollY : 0.0f;
+		newTab->isFromSnapshot = true;
+		newTab->snapshotFileSize = tabRecord.fileSize;
+		newTab->snapshotHash = tabRecord.contentHash;
+		FinalizeFileTabOptions(newTab);
+	}
+	ScratchEnd(scratch);
+	
+	uxx numRestoredTabs = app->tabs.length - numTabsBefore;
+	if (numRestoredTabs > 0)
+	{
+		PrintLine_D("Restored %llu tab%s from the last session", (u64)numRestoredTabs, Plural(numRestoredTabs, "s"));
+		uxx restoredTabIndex = numTabsBefore + ((header.currentTabIndex < numRestoredTabs) ? (uxx)header.currentTabIndex : numRestoredTabs-1);
+		AppChangeTab(restoredTabIndex);
+		StartSessionVerifier(&app->sessionVerifier);
+	}
+	ProfZoneEnd(_funcZone);
+	return (numRestoredTabs > 0);
+}
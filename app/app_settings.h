@@ -26,7 +26,12 @@ Description:
 	X(Bool, bool, "OptionTooltipsDisabled", optionTooltipsDisabled, false)   \
 	X(String, Str8, "ThemeMode", themeMode, StrLit("Dark"))                  \
 	X(String, Str8, "UserThemePath", userThemePath, StrLit(""))              \
-	X(Bool, bool, "DontAutoReloadFile", dontAutoReloadFile, false)
+	X(Bool, bool, "DontAutoReloadFile", dontAutoReloadFile, false)           \
+	X(String, Str8, "FolderScanIgnore", folderScanIgnore, StrLit(FOLDER_SCAN_DEFAULT_IGNORE)) \
+	X(String, Str8, "CompileCommandsPath", compileCommandsPath, StrLit("")) \
+	X(String, Str8, "IncludePaths", includePaths, StrLit(""))               \
+	X(U32, u32, "CaptureFrameCount", captureFrameCount, PROFILER_CAPTURE_DEFAULT_FRAMES) \
+	X(R32, r32, "CaptureStallThreshold", captureStallThreshold, PROFILER_CAPTURE_DEFAULT_STALL)
 
 typedef enum AppSettingType AppSettingType;
 enum AppSettingType
@@ -88,6 +93,21 @@ const char* GetAppSettingNameAtIndex(uxx settingIndex)
 	if (settingIndex >= ArrayCount(nameArray)) { return nullptr; }
 	return nameArray[settingIndex];
 }
+static NameTable AppSettingNameTable = ZEROED;
+void InitAppSettingNameTable()
+{
+	const char* names[] = {
+		#define X(type, cType, nameNt, cName, defaultValue) nameNt,
+		Settings_XList(X)
+		#undef X
+	};
+	if (!InitNameTable(&AppSettingNameTable, ArrayCount(names), &names[0])) { AssertMsg(false, "Failed to build AppSetting NameTable!"); }
+}
+// Returns UINTXX_MAX if the name doesn't match any setting
+uxx FindAppSettingIndexByName(Str8 settingName)
+{
+	return FindNameTableIndex(&AppSettingNameTable, settingName);
+}
 void* GetAppSettingPntrAtIndex(AppSettings* settings, uxx settingIndex, uxx* sizeOut)
 {
 	const u32 memberOffsets[] = {
@@ -276,6 +296,28 @@ void InitAppSettings(Arena* arena, AppSettings* settingsOut)
 	}
 }
 
+// dest must already be initialized, any strings are allocated from dest->arena
+void CopyAppSettings(AppSettings* dest, const AppSettings* source)
+{
+	NotNull(dest);
+	NotNull(source);
+	Assert(dest->count == source->count);
+	for (uxx sIndex = 0; sIndex < source->count; sIndex++)
+	{
+		if (GetAppSettingTypeAtIndex(sIndex) == AppSettingType_String)
+		{
+			SetAppSettingStr8(dest, sIndex, GetAppSettingStr8(source, sIndex));
+		}
+		else
+		{
+			uxx settingSize = 0;
+			void* destPntr = GetAppSettingPntrAtIndex(dest, sIndex, &settingSize);
+			const void* sourcePntr = GetAppSettingPntrAtIndex((AppSettings*)source, sIndex, nullptr);
+			MyMemCopy(destPntr, sourcePntr, settingSize);
+		}
+	}
+}
+
 Result TryParseAppSettingsFile(Str8 fileContents, AppSettings* settingsOut)
 {
 	NotNull(settingsOut);
@@ -299,17 +341,12 @@ Result TryParseAppSettingsFile(Str8 fileContents, AppSettings* settingsOut)
 				Str8 settingName = Str8_Empty;
 				AppSettingType settingType = AppSettingType_None;
 				
-				for (uxx sIndex = 0; sIndex < settingsOut->count; sIndex++)
+				settingIndex = FindAppSettingIndexByName(token.key);
+				if (settingIndex < settingsOut->count)
 				{
-					Str8 loopSettingName = MakeStr8Nt(GetAppSettingNameAtIndex(sIndex));
-					if (StrAnyCaseEquals(loopSettingName, token.key))
-					{
-						parsedSettingName = true;
-						settingIndex = sIndex;
-						settingName = loopSettingName;
-						settingType = GetAppSettingTypeAtIndex(sIndex);
-						break;
-					}
+					parsedSettingName = true;
+					settingName = MakeStr8Nt(GetAppSettingNameAtIndex(settingIndex));
+					settingType = GetAppSettingTypeAtIndex(settingIndex);
 				}
 				
 				if (parsedSettingName)
@@ -465,13 +502,5 @@ Str8 SerializeAppSettings(Arena* arena, const AppSettings* settings)
 	}
 	return result.str;
 }
-bool TrySaveAppSettingsTo(const AppSettings* settings, FilePath filePath)
-{
-	ScratchBegin(scratch);
-	Str8 serializedSettings = SerializeAppSettings(scratch, settings);
-	bool writeFileSuccess = OsWriteTextFile(filePath, serializedSettings);
-	ScratchEnd(scratch);
-	return writeFileSuccess;
-}
 
 #endif //  _APP_SETTINGS_H
@@ -0,0 +1,189 @@
+/*
+File:   app_settings_writer.c
+Description:
+	** The SettingsWriter batches calls to SaveAppSettings so a burst of changes (like Ctrl+Scroll changing
+	** the UI scale every tick) only writes settings.txt once. After the settings stop changing for
+	** SETTINGS_SAVE_DELAY (or SETTINGS_SAVE_MAX_DELAY has passed since the first change) we copy the settings
+	** into writer->snapshot and hand them to the writer thread, which serializes and writes them. The thread is
+	** started with the first write and then blocks on wakeSignal between writes instead of being created again for each one.
+	** It never touches app->settings so the main thread is free to keep changing them while a write is in progress.
+	** NOTE: FlushSettingsWriter must be called before the app closes or the dll is reloaded (it stops the thread)
+*/
+
+bool TrySaveAppSettingsTo(const AppSettings* settings, FilePath filePath)
+{
+	ScratchBegin(scratch);
+	Str8 serializedSettings = SerializeAppSettings(scratch, settings);
+	bool writeFileSuccess = AppWriteTextFileAtomically(filePath, serializedSettings);
+	ScratchEnd(scratch);
+	return writeFileSuccess;
+}
+
+// +==============================+
+// |   SettingsWriterThreadMain   |
+// +==============================+
+// DWORD SettingsWriterThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(SettingsWriterThreadMain)
+{
+	NotNull(contextPntr);
+	SettingsWriter* writer = (SettingsWriter*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	while (!AtomicRead(&writer->stopRequested))
+	{
+		if (AtomicRead(&writer->isWriting))
+		{
+			ProfZoneBeginEx(Zone_Write, "SettingsWriterThread", ProfilerCategory_Job);
+			bool saveSuccess = TrySaveAppSettingsTo(&writer->snapshot, writer->filePath);
+			AtomicWrite(&writer->writeSucceeded, saveSuccess);
+			AtomicWrite(&writer->isWriting, false);
+			ProfZoneEnd(Zone_Write);
+			SetWakeSignal(&writer->doneSignal);
+		}
+		else { WaitForWakeSignal(&writer->wakeSignal, TIMEOUT_FOREVER); }
+	}
+	AtomicWrite(&writer->isThreadRunning, false);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+void ReportSettingsWriteResult(SettingsWriter* writer, bool saveSuccess)
+{
+	NotNull(writer);
+	if (!saveSuccess)
+	{
+		NotifyPrint_E("Failed to save settings file! Make sure the folder has write permissions for the current user!\nPath: \"%.*s\"", StrPrint(writer->filePath));
+		DebugAssert(saveSuccess);
+	}
+}
+
+// Reports the result of the write we handed to the thread once it's done. If wait is true we block until it's done
+void FinishSettingsWrite(SettingsWriter* writer, bool wait)
+{
+	NotNull(writer);
+	if (!writer->isWaitingForResult) { return; }
+	if (wait)
+	{
+		ProfZoneBegin(Zone_WaitForWriter, "WaitForSettingsWriter");
+		while (AtomicRead(&writer->isWriting)) { WaitForWakeSignal(&writer->doneSignal, TIMEOUT_FOREVER); }
+		ProfZoneEnd(Zone_WaitForWriter);
+	}
+	if (AtomicRead(&writer->isWriting)) { return; }
+	writer->isWaitingForResult = false;
+	ReportSettingsWriteResult(writer, AtomicRead(&writer->writeSucceeded));
+}
+
+// Waits for any write in progress and then stops the thread. The next write starts a new one
+void StopSettingsWriterThread(SettingsWriter* writer)
+{
+	NotNull(writer);
+	FinishSettingsWrite(writer, true);
+	if (!writer->thread.isFilled) { return; }
+	AtomicWrite(&writer->stopRequested, true);
+	SetWakeSignal(&writer->wakeSignal);
+	while (AtomicRead(&writer->isThreadRunning)) { OsSleepMs(1); } //only waits for the thread to return, it has no write left to do
+	OsCloseThread(&writer->thread);
+	ClearStruct(writer->thread);
+	FreeWakeSignal(&writer->wakeSignal);
+	FreeWakeSignal(&writer->doneSignal);
+	AtomicWrite(&writer->stopRequested, false);
+}
+
+void FreeSettingsWriter(SettingsWriter* writer)
+{
+	NotNull(writer);
+	if (writer->arena != nullptr)
+	{
+		StopSettingsWriterThread(writer);
+		FreeAppSettings(&writer->snapshot);
+		FreeStr8(writer->arena, &writer->filePath);
+	}
+	ClearPointer(writer);
+}
+
+void InitSettingsWriter(Arena* arena, FilePath filePath, SettingsWriter* writerOut)
+{
+	NotNull(arena);
+	NotNull(writerOut);
+	ClearPointer(writerOut);
+	writerOut->arena = arena;
+	writerOut->filePath = AllocStr8(arena, filePath);
+	InitAppSettings(arena, &writerOut->snapshot);
+}
+
+void QueueSettingsWrite(SettingsWriter* writer)
+{
+	NotNull(writer);
+	NotNull(writer->arena);
+	OsTime currentTime = OsGetTime();
+	if (!writer->isDirty) { writer->firstDirtyTime = currentTime; }
+	writer->lastDirtyTime = currentTime;
+	writer->isDirty = true;
+}
+
+// Called once a frame. Hands a write to the worker thread once the settings have settled, settings changes that happen while a write is in progress get picked up by the next write
+void UpdateSettingsWriter(SettingsWriter* writer, const AppSettings* settings)
+{
+	NotNull(writer);
+	NotNull(settings);
+	if (writer->arena == nullptr) { return; }
+	FinishSettingsWrite(writer, false);
+	if (!writer->isDirty || writer->isWaitingForResult) { return; }
+	
+	OsTime currentTime = OsGetTime();
+	bool hasSettled = (OsTimeDiffMsR32(writer->lastDirtyTime, currentTime) >= (r32)SETTINGS_SAVE_DELAY);
+	bool waitedTooLong = (OsTimeDiffMsR32(writer->firstDirtyTime, currentTime) >= (r32)SETTINGS_SAVE_MAX_DELAY);
+	if (!hasSettled && !waitedTooLong) { return; }
+	
+	ProfZoneBegin(_funcZone, "StartSettingsWrite");
+	CopyAppSettings(&writer->snapshot, settings);
+	writer->isDirty = false;
+	if (!writer->thread.isFilled && InitWakeSignal(&writer->wakeSignal) && InitWakeSignal(&writer->doneSignal))
+	{
+		AtomicWrite(&writer->isThreadRunning, true);
+		writer->thread = OsCreateThread(SettingsWriterThreadMain, writer, true);
+		if (!writer->thread.isFilled) { AtomicWrite(&writer->isThreadRunning, false); }
+	}
+	if (writer->thread.isFilled)
+	{
+		AtomicWrite(&writer->writeSucceeded, false);
+		writer->isWaitingForResult = true;
+		AtomicWrite(&writer->isWriting, true);
+		SetWakeSignal(&writer->wakeSignal);
+	}
+	else
+	{
+		//NOTE: If we can't start a thread we just do the write here, the user still gets their settings saved
+		FreeWakeSignal(&writer->wakeSignal);
+		FreeWakeSignal(&writer->doneSignal);
+		WriteLine_W("Failed to start settings writer thread! Saving on the main thread");
+		ReportSettingsWriteResult(writer, TrySaveAppSettingsTo(&writer->snapshot, writer->filePath));
+	}
+	ProfZoneEnd(_funcZone);
+}
+
+// Waits for any in-progress write, stops the thread and then synchronously writes any changes that haven't been saved yet
+void FlushSettingsWriter(SettingsWriter* writer, const AppSettings* settings)
+{
+	NotNull(writer);
+	NotNull(settings);
+	if (writer->arena == nullptr) { return; }
+	ProfZoneBegin(_funcZone, "FlushSettingsWriter");
+	StopSettingsWriterThread(writer);
+	if (writer->isDirty)
+	{
+		WriteLine_D("Flushing settings...");
+		writer->isDirty = false;
+		ReportSettingsWriteResult(writer, TrySaveAppSettingsTo(settings, writer->filePath));
+	}
+	ProfZoneEnd(_funcZone);
+}
@@ -0,0 +1,381 @@
+/*
+File:   app_startup.c
+Description:
+	** Everything AppInit used to do one step after the other is split into StartupTasks with dependencies
+	** between them. Worker tasks (png decoding and file reads) start on STARTUP_NUM_THREADS threads at the very
+	** top of AppInit and run while the main thread loads the settings (which bakes the fonts) and the theme.
+	** Those are all the first frame needs, so AppInit returns and the window shows a plain frame while the
+	** rest of the main thread tasks (texture uploads, bindings, recent files, opening the first file) run
+	** in the next AppUpdate calls as soon as the worker tasks they depend on are done.
+	** Run with -startup_timing to get a report of how long each task took and when it ran.
+*/
+
+StartupTaskInfo GetStartupTaskInfo(StartupTask task)
+{
+	StartupTaskInfo result = ZEROED;
+	switch (task)
+	{
+		case StartupTask_DecodeWindowIcons:       result.isWorkerTask = true; break;
+		case StartupTask_DecodeNotificationIcons: result.isWorkerTask = true; break;
+		case StartupTask_ReadAppIcons:            result.isWorkerTask = true; break;
+		case StartupTask_ReadRecentFiles:         result.isWorkerTask = true; break;
+		case StartupTask_Settings:                result.isBeforeFirstFrame = true; break;
+		case StartupTask_Theme:                   result.isBeforeFirstFrame = true; result.dependencies = (1 << StartupTask_Settings); break;
+		case StartupTask_Renderer:                result.isBeforeFirstFrame = true; result.dependencies = (1 << StartupTask_Settings); break;
+		case StartupTask_Icons:                   result.dependencies = (1 << StartupTask_DecodeWindowIcons) | (1 << StartupTask_DecodeNotificationIcons) | (1 << StartupTask_ReadAppIcons); break;
+		case StartupTask_RecentFiles:             result.dependencies = (1 << StartupTask_ReadRecentFiles); break;
+		//NOTE: Tabs have to see the files after the preset journal is rolled back, and opening a file pushes it onto the recent files
+		case StartupTask_OpenFiles:               result.dependencies = (1 << StartupTask_RecentFiles) | (1 << StartupTask_Presets) | (1 << StartupTask_UsageIndex); break;
+		default: break;
+	}
+	return result;
+}
+
+bool AreStartupDependenciesDone(AppStartup* startup, StartupTask task)
+{
+	u32 dependencies = GetStartupTaskInfo(task).dependencies;
+	for (uxx tIndex = 1; tIndex < StartupTask_Count; tIndex++)
+	{
+		if (IsFlagSet(dependencies, (1u << tIndex)) && !AtomicRead(&startup->tasks[tIndex].isDone)) { return false; }
+	}
+	return true;
+}
+
+// +--------------------------------------------------------------+
+// |                         Worker Tasks                         |
+// +--------------------------------------------------------------+
+// Runs on a startup thread (or the main thread if the threads couldn't be created). Must not touch anything but the task's arena and its own results in startup
+void RunStartupWorkerTask(AppStartup* startup, StartupTask task)
+{
+	StartupTaskState* state = &startup->tasks[task];
+	state->startTime = OsGetTime();
+	switch (task)
+	{
+		case StartupTask_DecodeWindowIcons:
+		{
+			DecodeWindowIcons(&state->arena, &startup->windowIcons[0]);
+		} break;
+		
+		case StartupTask_DecodeNotificationIcons:
+		{
+			startup->notificationIcons = LoadImageData(&state->arena, NOTIFICATION_ICONS_TEXTURE_PATH);
+		} break;
+		
+		case StartupTask_ReadAppIcons:
+		{
+			startup->appIconsImageFile = ReadAppResource(&app->resources, &state->arena, StrLit(APP_ICONS_TEXTURE_PATH), false);
+			startup->appIconsMetaFile = ReadAppResource(&app->resources, &state->arena, StrLit(APP_ICONS_METADATA_PATH), true);
+		} break;
+		
+		case StartupTask_ReadRecentFiles:
+		{
+			startup->recentFilesPath = GetRecentFilesSavePath(&state->arena, false);
+			startup->recentFilesRead = AppReadTextFile(startup->recentFilesPath, &state->arena, &startup->recentFilesContents);
+		} break;
+		
+		default: Assert(false); break;
+	}
+	state->endTime = OsGetTime();
+	AtomicWrite(&state->isDone, true);
+}
+
+// Claims and runs worker tasks until there are none left. Worker tasks don't depend on each other so any order is fine
+void RunStartupWorkerTasks(AppStartup* startup)
+{
+	for (uxx tIndex = 1; tIndex < StartupTask_Count; tIndex++)
+	{
+		StartupTask task = (StartupTask)tIndex;
+		if (!GetStartupTaskInfo(task).isWorkerTask) { continue; }
+		if (AtomicExchange(&startup->tasks[tIndex].isClaimed, 1) != 0) { continue; }
+		RunStartupWorkerTask(startup, task);
+	}
+}
+
+// +==============================+
+// |      StartupThreadMain       |
+// +==============================+
+// DWORD StartupThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(StartupThreadMain)
+{
+	NotNull(contextPntr);
+	abool* isRunning = (abool*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	RunStartupWorkerTasks(&app->startup);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	AtomicWrite(isRunning, false);
+	OsThreadReturn(0, nullptr);
+}
+
+// +--------------------------------------------------------------+
+// |                      Main Thread Tasks                       |
+// +--------------------------------------------------------------+
+void OpenStartupFiles()
+{
+	bool wasCmdPathGiven = false;
+	//NOTE: Not really sure if we need to handle multiple argument paths being passed.
+	// I guess if the first one fails doesn't point to a real file we can
+	// open secondary one(s) but that really isn't super intuitive behavior
+	uxx argIndex = 0;
+	Str8 pathArgument = GetNamelessProgramArg(platformInfo->programArgs, argIndex);
+	while (!IsEmptyStr(pathArgument))
+	{
+		wasCmdPathGiven = true;
+		if (OsDoesFileExist(pathArgument))
+		{
+			FileTab* newTab = AppOpenFileTab(pathArgument);
+			if (newTab != nullptr) { break; }
+		}
+		else if (OsDoesFolderExist(pathArgument))
+		{
+			StartFolderScan(&app->folderScan, pathArgument);
+			break;
+		}
+		else
+		{
+			NotifyPrint_E("Command line path does not point to a file or folder: \"%.*s\"", StrPrint(pathArgument));
+		}
+		
+		argIndex++;
+		pathArgument = GetNamelessProgramArg(platformInfo->programArgs, argIndex);
+	}
+	
+	if (!wasCmdPathGiven && !AppRestoreSession() && app->recentFiles.length > 0)
+	{
+		RecentFile* mostRecentFile = VarArrayGetLast(RecentFile, &app->recentFiles);
+		AppOpenFileTab(mostRecentFile->path);
+	}
+}
+
+void RunStartupMainTask(AppStartup* startup, StartupTask task)
+{
+	StartupTaskState* state = &startup->tasks[task];
+	state->startTime = OsGetTime();
+	switch (task)
+	{
+		case StartupTask_Settings:
+		{
+			LoadAppSettings();
+		} break;
+		
+		case StartupTask_Theme:
+		{
+			if (!TryParseThemeMode(app->settings.themeMode, &app->currentThemeMode))
+			{
+				NotifyPrint_W("Unknown theme mode in settings file: \"%.*s\"\nDefaulting to Dark Mode", StrPrint(app->settings.themeMode));
+				app->currentThemeMode = ThemeMode_Dark;
+				SetAppSettingStr8Pntr(&app->settings, &app->settings.themeMode, MakeStr8Nt(GetThemeModeStr(app->currentThemeMode)));
+				SaveAppSettings();
+			}
+			app->theme = &app->bakedThemes[app->currentThemeMode];
+			if (!AppTryLoadThemeCache())
+			{
+				AppTryLoadDefaultTheme(true);
+				AppLoadUserTheme();
+				AppBakeTheme(true);
+			}
+		} break;
+		
+		case StartupTask_Renderer:
+		{
+			InitCompiledShader(&app->mainShader, stdHeap, main2d);
+			#if BUILD_WITH_CLAY
+			InitClayUIRenderer(stdHeap, V2_Zero, &app->clay);
+			AttachTooltipRegistryToUIRenderer(&app->clay, &app->tooltips);
+			app->clayUiFontId = AddClayUIRendererFont(&app->clay, &app->uiFont, UI_FONT_STYLE);
+			app->clayMainFontId = AddClayUIRendererFont(&app->clay, &app->mainFont, MAIN_FONT_STYLE);
+			#elif BUILD_WITH_PIG_UI
+			InitUiContext(stdHeap, &app->ui);
+			#endif //BUILD_WITH_CLAY
+		} break;
+		
+		case StartupTask_Icons:
+		{
+			LoadNotificationIconsFrom(startup->notificationIcons);
+			platform->SetWindowIcon(NUM_WINDOW_ICONS, &startup->windowIcons[0]);
+			LoadAppIconsFrom(startup->appIconsImageFile, startup->appIconsMetaFile);
+		} break;
+		
+		case StartupTask_Bindings:
+		{
+			AppTryLoadBindings(true);
+		} break;
+		
+		case StartupTask_RecentFiles:
+		{
+			AppLoadRecentFilesListFrom(startup->recentFilesPath, startup->recentFilesRead ? &startup->recentFilesContents : nullptr);
+		} break;
+		
+		case StartupTask_Presets:
+		{
+			AppRecoverPresetJournal(); //before any tabs are opened so they see the restored files
+			AppLoadPresets();
+		} break;
+		
+		case StartupTask_UsageIndex:
+		{
+			LoadUsageIndex(&app->usageIndex);
+		} break;
+		
+		case StartupTask_OpenFiles:
+		{
+			OpenStartupFiles();
+		} break;
+		
+		default: Assert(false); break;
+	}
+	state->endTime = OsGetTime();
+	AtomicWrite(&state->isDone, true);
+}
+
+// +--------------------------------------------------------------+
+// |                          Scheduling                          |
+// +--------------------------------------------------------------+
+void StartAppStartup(AppStartup* startup)
+{
+	NotNull(startup);
+	ClearPointer(startup);
+	startup->isStarted = true;
+	startup->beginTime = OsGetTime();
+	startup->printTimings = FindNamedProgramArgBoolEx(platformInfo->programArgs, StrLit("startup_timing"), StrLit("timing"), false, 0);
+	for (uxx tIndex = 1; tIndex < StartupTask_Count; tIndex++) { InitArenaStdHeap(&startup->tasks[tIndex].arena); }
+	InitVarArray(Str8, &startup->queuedDroppedPaths, stdHeap);
+	InitVarArray(Str8, &startup->queuedForwardedPaths, stdHeap);
+	
+	uxx numThreadsStarted = 0;
+	for (uxx tIndex = 0; tIndex < STARTUP_NUM_THREADS; tIndex++)
+	{
+		AtomicWrite(&startup->threadRunning[tIndex], true);
+		startup->threads[tIndex] = OsCreateThread(StartupThreadMain, &startup->threadRunning[tIndex], true);
+		if (startup->threads[tIndex].isFilled) { numThreadsStarted++; }
+		else { AtomicWrite(&startup->threadRunning[tIndex], false); }
+	}
+	//NOTE: Without any threads the worker tasks just run here, which is the same as AppInit used to do
+	if (numThreadsStarted == 0) { WriteLine_W("Failed to start any startup threads"); RunStartupWorkerTasks(startup); }
+}
+
+// Runs every main thread task (of the given phase) whose dependencies are done. Tasks only depend on ones before them in the enum
+// so a single pass in order is enough. Returns true once all of them have run
+bool RunAppStartupTasks(AppStartup* startup, bool beforeFirstFrame)
+{
+	NotNull(startup);
+	bool allDone = true;
+	for (uxx tIndex = 1; tIndex < StartupTask_Count; tIndex++)
+	{
+		StartupTask task = (StartupTask)tIndex;
+		StartupTaskInfo info = GetStartupTaskInfo(task);
+		if (info.isWorkerTask || AtomicRead(&startup->tasks[tIndex].isDone)) { continue; }
+		if (info.isBeforeFirstFrame != beforeFirstFrame) { allDone = false; continue; }
+		if (!AreStartupDependenciesDone(startup, task)) { allDone = false; continue; }
+		ProfZoneBegin(_taskZone, "StartupTask");
+		RunStartupMainTask(startup, task);
+		ProfZoneEnd(_taskZone);
+	}
+	return allDone;
+}
+
+void PrintAppStartupReport(AppStartup* startup)
+{
+	OsTime endTime = OsGetTime();
+	PrintLine_I("Startup took %.1fms (first frame at %.1fms, %d startup thread%s):",
+		OsTimeDiffMsR32(startup->beginTime, endTime),
+		OsTimeDiffMsR32(startup->beginTime, startup->firstFrameTime),
+		STARTUP_NUM_THREADS, Plural(STARTUP_NUM_THREADS, "s")
+	);
+	for (uxx tIndex = 1; tIndex < StartupTask_Count; tIndex++)
+	{
+		StartupTask task = (StartupTask)tIndex;
+		StartupTaskState* state = &startup->tasks[tIndex];
+		StartupTaskInfo info = GetStartupTaskInfo(task);
+		PrintLine_I("  %-24s %-6s %7.1fms -> %7.1fms (%.1fms)",
+			GetStartupTaskStr(task),
+			info.isWorkerTask ? "worker" : (info.isBeforeFirstFrame ? "init" : "frame"),
+			OsTimeDiffMsR32(startup->beginTime, state->startTime),
+			OsTimeDiffMsR32(startup->beginTime, state->endTime),
+			OsTimeDiffMsR32(state->startTime, state->endTime)
+		);
+	}
+}
+
+// The worker tasks are short so this doesn't wait long. Called before a dll reload since the threads run code in this dll, the main thread tasks carry on afterwards
+void JoinAppStartupThreads(AppStartup* startup)
+{
+	NotNull(startup);
+	for (uxx tIndex = 0; tIndex < STARTUP_NUM_THREADS; tIndex++)
+	{
+		if (!startup->threads[tIndex].isFilled) { continue; }
+		while (AtomicRead(&startup->threadRunning[tIndex])) { OsSleepMs(1); }
+		OsCloseThread(&startup->threads[tIndex]);
+	}
+}
+
+// Frees what the worker tasks loaded. Called once every task is done, or from AppClosing if we close before that
+void FinishAppStartup(AppStartup* startup)
+{
+	NotNull(startup);
+	if (!startup->isStarted || startup->isFinished) { return; }
+	JoinAppStartupThreads(startup);
+	
+	StartupTaskState* windowIconsTask = &startup->tasks[StartupTask_DecodeWindowIcons];
+	for (uxx iIndex = 0; iIndex < NUM_WINDOW_ICONS; iIndex++)
+	{
+		ImageData* imageData = &startup->windowIcons[iIndex];
+		if (imageData->pixels != nullptr) { FreeMem(&windowIconsTask->arena, imageData->pixels, sizeof(u32) * (uxx)(imageData->size.width * imageData->size.height)); }
+	}
+	ImageData* notificationIcons = &startup->notificationIcons;
+	if (notificationIcons->pixels != nullptr) { FreeMem(&startup->tasks[StartupTask_DecodeNotificationIcons].arena, notificationIcons->pixels, sizeof(u32) * (uxx)(notificationIcons->size.width * notificationIcons->size.height)); }
+	FreeStr8(&startup->tasks[StartupTask_ReadAppIcons].arena, &startup->appIconsImageFile);
+	FreeStr8(&startup->tasks[StartupTask_ReadAppIcons].arena, &startup->appIconsMetaFile);
+	FreeStr8(&startup->tasks[StartupTask_ReadRecentFiles].arena, &startup->recentFilesPath);
+	if (startup->recentFilesRead) { FreeStr8(&startup->tasks[StartupTask_ReadRecentFiles].arena, &startup->recentFilesContents); }
+	
+	if (startup->printTimings && AtomicRead(&startup->tasks[StartupTask_OpenFiles].isDone)) { PrintAppStartupReport(startup); }
+	startup->isFinished = true;
+}
+
+// Dropped and forwarded paths are only in AppInput for one frame (the platform frees them on the next swap), so the ones
+// that arrive while AppUpdate is still waiting on startup are copied here and handled once the startup tabs are open
+void QueueStartupPaths(AppStartup* startup, const VarArray* droppedPaths, const VarArray* forwardedPaths)
+{
+	NotNull(startup);
+	VarArrayLoop(droppedPaths, pIndex) { *VarArrayAdd(Str8, &startup->queuedDroppedPaths) = AllocStr8(stdHeap, *VarArrayGetHard(Str8, droppedPaths, pIndex)); }
+	VarArrayLoop(forwardedPaths, pIndex) { *VarArrayAdd(Str8, &startup->queuedForwardedPaths) = AllocStr8(stdHeap, *VarArrayGetHard(Str8, forwardedPaths, pIndex)); }
+}
+
+// Called once the queued paths have been handled, or when we close before startup finishes
+void FreeStartupQueuedPaths(AppStartup* startup)
+{
+	NotNull(startup);
+	if (startup->queuedDroppedPaths.arena == nullptr) { return; }
+	VarArrayLoop(&startup->queuedDroppedPaths, pIndex) { FreeStr8(stdHeap, VarArrayGetHard(Str8, &startup->queuedDroppedPaths, pIndex)); }
+	VarArrayLoop(&startup->queuedForwardedPaths, pIndex) { FreeStr8(stdHeap, VarArrayGetHard(Str8, &startup->queuedForwardedPaths, pIndex)); }
+	FreeVarArray(&startup->queuedDroppedPaths);
+	FreeVarArray(&startup->queuedForwardedPaths);
+	ClearStruct(startup->queuedDroppedPaths);
+	ClearStruct(startup->queuedForwardedPaths);
+}
+
+// Called at the top of AppUpdate until it returns true. The first call never runs any tasks so the window gets its first frame right away
+bool UpdateAppStartup(AppStartup* startup)
+{
+	NotNull(startup);
+	if (startup->isFinished) { return true; }
+	if (!startup->hasShownFirstFrame)
+	{
+		startup->hasShownFirstFrame = true;
+		startup->firstFrameTime = OsGetTime();
+		return false;
+	}
+	if (!RunAppStartupTasks(startup, false)) { return false; }
+	FinishAppStartup(startup);
+	return true;
+}
@@ -12,13 +12,216 @@ void FreeFileOption(FileOption* option)
 	FreeStr8(stdHeap, &option->name);
 	FreeStr8(stdHeap, &option->abbreviation);
 	FreeStr8(stdHeap, &option->valueStr);
+	FreeStr8(stdHeap, &option->commentedName);
 	ClearPointer(option);
 }
 
+// The displayName is what we show on the large option buttons. We calculate it whenever the
+// option is parsed or toggled so the UI doesn't need to format a new string every frame
+void UpdateFileOptionDisplayName(FileOption* option)
+{
+	NotNull(option);
+	if (option->type == FileOptionType_CommentDefine)
+	{
+		if (option->commentedName.length == 0) { option->commentedName = PrintInArenaStr(stdHeap, "// %.*s", StrPrint(option->name)); }
+		option->displayName = option->isUncommented ? option->name : option->commentedName;
+	}
+	else { option->displayName = option->name; }
+}
+
+// +--------------------------------------------------------------+
+// |                     Option Search Index                      |
+// +--------------------------------------------------------------+
+void FreeOptionSearchIndex(OptionSearchIndex* index)
+{
+	NotNull(index);
+	if (index->text.arena != nullptr)
+	{
+		FreeVarArray(&index->text);
+		FreeVarArray(&index->textStarts);
+		FreeVarArray(&index->bucketStarts);
+		FreeVarArray(&index->postings);
+	}
+	ClearPointer(index);
+}
+
+// gramChars must already be lowercased. The gram length is part of the hash so "ab" and "ab?" don't share a bucket by default
+u32 GetOptionSearchBucket(const char* gramChars, uxx gramLength)
+{
+	u32 gram = (u32)gramLength << 24;
+	for (uxx cIndex = 0; cIndex < gramLength; cIndex++) { gram |= (u32)(u8)gramChars[cIndex] << (cIndex*8); }
+	return (gram * 2654435761u) >> (32 - OPTION_SEARCH_BUCKET_BITS);
+}
+
+void AppendOptionSearchText(VarArray* text, Str8 str)
+{
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		char* newChar = VarArrayAdd(char, text);
+		NotNull(newChar);
+		*newChar = (char)FuzzyFoldChar(str.chars[cIndex]);
+	}
+	char* separator = VarArrayAdd(char, text);
+	NotNull(separator);
+	*separator = '\n';
+}
+
+void BuildOptionSearchIndex(FileTab* tab)
+{
+	NotNull(tab);
+	ProfZoneBegin(_funcZone, "BuildOptionSearchIndex");
+	ScratchBegin(scratch);
+	OptionSearchIndex* index = &tab->searchIndex;
+	if (index->text.arena == nullptr)
+	{
+		InitVarArray(char, &index->text, stdHeap);
+		InitVarArray(uxx, &index->textStarts, stdHeap);
+		InitVarArray(u32, &index->bucketStarts, stdHeap);
+		InitVarArray(u32, &index->postings, stdHeap);
+	}
+	VarArrayClear(&index->text);
+	VarArrayClear(&index->textStarts);
+	VarArrayClear(&index->postings);
+	
+	VarArrayLoop(&tab->fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+		uxx* textStart = VarArrayAdd(uxx, &index->textStarts);
+		NotNull(textStart);
+		*textStart = index->text.length;
+		AppendOptionSearchText(&index->text, option->name);
+		AppendOptionSearchText(&index->text, option->abbreviation);
+		AppendOptionSearchText(&index->text, option->valueStr);
+	}
+	uxx* textEnd = VarArrayAdd(uxx, &index->textStarts);
+	NotNull(textEnd);
+	*textEnd = index->text.length;
+	
+	const char* text = (const char*)index->text.items;
+	const uxx* textStarts = (const uxx*)index->textStarts.items;
+	VarArrayExpand(&index->bucketStarts, OPTION_SEARCH_NUM_BUCKETS+1);
+	index->bucketStarts.length = OPTION_SEARCH_NUM_BUCKETS+1;
+	u32* bucketStarts = (u32*)index->bucketStarts.items;
+	MyMemSet(bucketStarts, 0x00, sizeof(u32) * (OPTION_SEARCH_NUM_BUCKETS+1));
+	//lastOption[bucket] is the option index+1 that was last added to the bucket, so an option that has the same gram many times is only listed once
+	u32* lastOption = AllocArray(u32, scratch, OPTION_SEARCH_NUM_BUCKETS);
+	u32* bucketFill = AllocArray(u32, scratch, OPTION_SEARCH_NUM_BUCKETS);
+	NotNull(lastOption);
+	NotNull(bucketFill);
+	
+	// Pass 0 counts how many options land in each bucket, pass 1 writes them into their slice of postings
+	for (uxx pass = 0; pass < 2; pass++)
+	{
+		MyMemSet(lastOption, 0x00, sizeof(u32) * OPTION_SEARCH_NUM_BUCKETS);
+		for (uxx oIndex = 0; oIndex < tab->fileOptions.length; oIndex++)
+		{
+			for (uxx cIndex = textStarts[oIndex]; cIndex < textStarts[oIndex+1]; cIndex++)
+			{
+				for (uxx gramLength = 1; gramLength <= 3 && cIndex + gramLength <= textStarts[oIndex+1]; gramLength++)
+				{
+					if (text[cIndex + gramLength-1] == '\n') { break; }
+					u32 bucket = GetOptionSearchBucket(&text[cIndex], gramLength);
+					if (lastOption[bucket] == (u32)(oIndex+1)) { continue; }
+					lastOption[bucket] = (u32)(oIndex+1);
+					if (pass == 0) { bucketStarts[bucket+1]++; }
+					else { ((u32*)index->postings.items)[bucketFill[bucket]++] = (u32)oIndex; }
+				}
+			}
+		}
+		
+		if (pass == 0)
+		{
+			for (uxx bIndex = 0; bIndex < OPTION_SEARCH_NUM_BUCKETS; bIndex++) { bucketStarts[bIndex+1] += bucketStarts[bIndex]; }
+			MyMemCopy(bucketFill, bucketStarts, sizeof(u32) * OPTION_SEARCH_NUM_BUCKETS);
+			VarArrayExpand(&index->postings, bucketStarts[OPTION_SEARCH_NUM_BUCKETS]);
+			index->postings.length = bucketStarts[OPTION_SEARCH_NUM_BUCKETS];
+		}
+	}
+	index->isStale = false;
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// Finds every option whose name, abbreviation or value contains query (case-insensitive). Results are added to resultsOut (uxx) in ascending order
+void SearchOptionSearchIndex(FileTab* tab, Str8 query, VarArray* resultsOut)
+{
+	NotNull(tab);
+	NotNull(resultsOut);
+	NotEmptyStr(query);
+	ProfZoneBegin(_funcZone, "SearchOptionSearchIndex");
+	ScratchBegin1(scratch, resultsOut->arena);
+	if (tab->searchIndex.isStale || tab->searchIndex.text.arena == nullptr) { BuildOptionSearchIndex(tab); }
+	OptionSearchIndex* index = &tab->searchIndex;
+	const u32* bucketStarts = (const u32*)index->bucketStarts.items;
+	const u32* postings = (const u32*)index->postings.items;
+	const uxx* textStarts = (const uxx*)index->textStarts.items;
+	
+	Str8 foldedQuery = AllocStr8(scratch, query);
+	for (uxx cIndex = 0; cIndex < foldedQuery.length; cIndex++) { foldedQuery.chars[cIndex] = (char)FuzzyFoldChar(foldedQuery.chars[cIndex]); }
+	
+	// Start with the smallest posting list of the query's grams (whole query if it's short enough, otherwise every 3 character gram)
+	uxx gramLength = MinUXX(foldedQuery.length, 3);
+	uxx numGrams = foldedQuery.length - gramLength + 1;
+	u32* gramBuckets = AllocArray(u32, scratch, numGrams);
+	NotNull(gramBuckets);
+	uxx smallestGramIndex = 0;
+	for (uxx gIndex = 0; gIndex < numGrams; gIndex++)
+	{
+		gramBuckets[gIndex] = GetOptionSearchBucket(&foldedQuery.chars[gIndex], gramLength);
+		u32 bucketSize = bucketStarts[gramBuckets[gIndex]+1] - bucketStarts[gramBuckets[gIndex]];
+		u32 smallestSize = bucketStarts[gramBuckets[smallestGramIndex]+1] - bucketStarts[gramBuckets[smallestGramIndex]];
+		if (bucketSize < smallestSize) { smallestGramIndex = gIndex; }
+	}
+	
+	u32 numCandidates = bucketStarts[gramBuckets[smallestGramIndex]+1] - bucketStarts[gramBuckets[smallestGramIndex]];
+	u32* candidates = AllocArray(u32, scratch, MaxUXX(numCandidates, 1));
+	NotNull(candidates);
+	MyMemCopy(candidates, &postings[bucketStarts[gramBuckets[smallestGramIndex]]], sizeof(u32) * numCandidates);
+	
+	// Intersect with the other grams' lists, they are all ascending so this is a simple merge
+	for (uxx gIndex = 0; gIndex < numGrams && numCandidates > 0; gIndex++)
+	{
+		if (gIndex == smallestGramIndex || gramBuckets[gIndex] == gramBuckets[smallestGramIndex]) { continue; }
+		const u32* otherList = &postings[bucketStarts[gramBuckets[gIndex]]];
+		u32 otherLength = bucketStarts[gramBuckets[gIndex]+1] - bucketStarts[gramBuckets[gIndex]];
+		u32 numKept = 0;
+		u32 otherIndex = 0;
+		for (u32 cIndex = 0; cIndex < numCandidates; cIndex++)
+		{
+			while (otherIndex < otherLength && otherList[otherIndex] < candidates[cIndex]) { otherIndex++; }
+			if (otherIndex < otherLength && otherList[otherIndex] == candidates[cIndex]) { candidates[numKept++] = candidates[cIndex]; }
+		}
+		numCandidates = numKept;
+	}
+	
+	// Buckets are shared by any grams that hash the same, so the survivors still need their text checked
+	for (u32 cIndex = 0; cIndex < numCandidates; cIndex++)
+	{
+		uxx optionIndex = candidates[cIndex];
+		Str8 optionText = MakeStr8(textStarts[optionIndex+1] - textStarts[optionIndex], &((char*)index->text.items)[textStarts[optionIndex]]);
+		if (StrExactContains(optionText, foldedQuery))
+		{
+			uxx* newResult = VarArrayAdd(uxx, resultsOut);
+			NotNull(newResult);
+			*newResult = optionIndex;
+		}
+	}
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+void FreeFileTabOptionSources(FileTab* tab);
+void RemoveFileTabIncludeWatches(FileTab* tab);
+void AppPublishIpcEvent(Str8 kind, Str8 details, FilePath filePath);
+void AppPublishOptionChanged(FileTab* tab, FileOption* option);
+
 void FreeFileTab(FileTab* tab)
 {
 	NotNull(tab);
 	FreeStr8(stdHeap, &tab->filePath);
+	FreeStr8(stdHeap, &tab->includeGraphPath);
 	FreeStr8(stdHeap, &tab->fileContents);
 	FreeStr8(stdHeap, &tab->originalFileContents);
 	VarArrayLoop(&tab->fileOptions, oIndex)
@@ -27,6 +230,9 @@ void FreeFileTab(FileTab* tab)
 		FreeFileOption(option);
 	}
 	FreeVarArray(&tab->fileOptions);
+	FreeOptionSearchIndex(&tab->searchIndex);
+	FreeFileConditionals(&tab->conditionals);
+	FreeFileTabOptionSources(tab);
 	ClearPointer(tab);
 }
 
@@ -35,9 +241,12 @@ void AppCloseFileTab(uxx tabIndex)
 	Assert(tabIndex < app->tabs.length);
 	FileTab* closedTab = VarArrayGetHard(FileTab, &app->tabs, tabIndex);
 	
-	RemoveFileWatch(&app->fileWatches, closedTab->fileWatchId);
+	if (closedTab->fileWatchId != 0) { RemoveFileWatch(&app->fileWatches, closedTab->fileWatchId); }
+	RemoveFileTabIncludeWatches(closedTab);
+	AppPublishIpcEvent(StrLit("closed"), Str8_Empty, closedTab->filePath);
 	FreeFileTab(closedTab);
 	VarArrayRemoveAt(FileTab, &app->tabs, tabIndex);
+	app->optionsFilterChanged = true;
 	
 	if (app->tabs.length == 0)
 	{
@@ -59,6 +268,7 @@ void AppCloseFileTab(uxx tabIndex)
 	app->currentTab = VarArrayGetSoft(FileTab, &app->tabs, app->currentTabIndex);
 	if (app->currentTab != nullptr)
 	{
+		app->currentTab->restoreScroll = true;
 		platform->SetWindowTitle(ScratchPrintStr("%.*s - %s", StrPrint(app->currentTab->filePath), PROJECT_READABLE_NAME_STR));
 	}
 	else
@@ -91,6 +301,8 @@ void AppChangeTab(uxx newTabIndex)
 	Assert(newTabIndex < app->tabs.length);
 	app->currentTabIndex = newTabIndex;
 	app->currentTab = VarArrayGetHard(FileTab, &app->tabs, app->currentTabIndex);
+	app->currentTab->restoreScroll = true; //the outgoing tab's scrollY is kept up to date by the UI every frame
+	app->optionsFilterChanged = true;
 	platform->SetWindowTitle(ScratchPrintStr("%.*s - %s", StrPrint(app->currentTab->filePath), PROJECT_READABLE_NAME_STR));
 }
 
@@ -156,19 +368,19 @@ void CalculateLongestAbbreviationWidth(FileTab* tab)
 	tab->longestAbbreviationWidthFontSize = app->mainFontSize;
 }
 
-void UpdateFileTabOptions(FileTab* tab)
+//NOTE: Bump this whenever ParseFileOptions changes what it produces for the same file contents. parse_cache.bin remembers it so entries from an older parser are thrown away
+#define FILE_OPTION_PARSER_REVISION 1
+
+// The scanner behind UpdateFileTabOptions. Everything is allocated from arena and nothing touches app state so the folder scan can run this on its worker threads.
+// The displayName of each option is not filled in here (see FinalizeFileTabOptions)
+void ParseFileOptions(Arena* arena, Str8 fileContents, VarArray* fileOptionsOut)
 {
-	ScratchBegin(scratch);
-	
-	VarArrayLoop(&tab->fileOptions, oIndex)
-	{
-		VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
-		FreeFileOption(option);
-	}
-	VarArrayClear(&tab->fileOptions);
+	NotNull(arena);
+	NotNull(fileOptionsOut);
+	ScratchBegin1(scratch, arena);
 	
 	Str8 commentStartStr = StrLit("//");
-	LineParser lineParser = MakeLineParser(tab->fileContents);
+	LineParser lineParser = MakeLineParser(fileContents);
 	Str8 fullLine = Str8_Empty;
 	FileOption* prevOption = nullptr;
 	while (LineParserGetLine(&lineParser, &fullLine))
@@ -196,16 +408,16 @@ void UpdateFileTabOptions(FileTab* tab)
 				Str8 namePart = TrimWhitespace(StrSliceFrom(commentContents, defineStr.length));
 				if (!IsEmptyStr(namePart))
 				{
-					FileOption* newOption = VarArrayAdd(FileOption, &tab->fileOptions);
+					FileOption* newOption = VarArrayAdd(FileOption, fileOptionsOut);
 					NotNull(newOption);
 					ClearPointer(newOption);
-					newOption->name = AllocStr8(stdHeap, namePart);
-					newOption->abbreviation = GetOptionNameAbbreviation(stdHeap, newOption->name);
+					newOption->name = AllocStr8(arena, namePart);
+					newOption->abbreviation = GetOptionNameAbbreviation(arena, newOption->name);
 					newOption->type = FileOptionType_CommentDefine;
 					newOption->isUncommented = false;
 					newOption->fileContentsStartIndex = commentStartIndex;
 					newOption->fileContentsEndIndex = defineStartIndex;
-					newOption->valueStr = AllocStr8(stdHeap, commentStartStr);
+					newOption->valueStr = AllocStr8(arena, commentStartStr);
 					prevOption = newOption;
 					isOption = true;
 				}
@@ -223,17 +435,17 @@ void UpdateFileTabOptions(FileTab* tab)
 					StrExactEndsWith(line, boolValueStr) &&
 					IsCharWhitespace(line.chars[line.length-boolValueStr.length-1], false))
 				{
-					FileOption* newOption = VarArrayAdd(FileOption, &tab->fileOptions);
+					FileOption* newOption = VarArrayAdd(FileOption, fileOptionsOut);
 					NotNull(newOption);
 					ClearPointer(newOption);
 					newOption->name = TrimWhitespace(StrSlice(line, defineStr.length, line.length - boolValueStr.length));
-					newOption->name = AllocStr8(stdHeap, newOption->name);
-					newOption->abbreviation = GetOptionNameAbbreviation(stdHeap, newOption->name);
+					newOption->name = AllocStr8(arena, newOption->name);
+					newOption->abbreviation = GetOptionNameAbbreviation(arena, newOption->name);
 					newOption->type = FileOptionType_Bool;
 					newOption->valueBool = ((vIndex%2) == 0);
 					newOption->fileContentsStartIndex = lineEndIndex - boolValueStr.length;
 					newOption->fileContentsEndIndex = lineEndIndex;
-					newOption->valueStr = AllocStr8(stdHeap, StrSlice(tab->fileContents, newOption->fileContentsStartIndex, newOption->fileContentsEndIndex));
+					newOption->valueStr = AllocStr8(arena, StrSlice(fileContents, newOption->fileContentsStartIndex, newOption->fileContentsEndIndex));
 					prevOption = newOption;
 					isOption = true;
 					break;
@@ -249,11 +461,11 @@ void UpdateFileTabOptions(FileTab* tab)
 				Str8 namePart = TrimWhitespace(StrSliceFrom(line, defineStr.length));
 				if (IsValidIdentifier(namePart.length, namePart.chars, false, false, false))
 				{
-					FileOption* newOption = VarArrayAdd(FileOption, &tab->fileOptions);
+					FileOption* newOption = VarArrayAdd(FileOption, fileOptionsOut);
 					NotNull(newOption);
 					ClearPointer(newOption);
-					newOption->name = AllocStr8(stdHeap, namePart);
-					newOption->abbreviation = GetOptionNameAbbreviation(stdHeap, newOption->name);
+					newOption->name = AllocStr8(arena, namePart);
+					newOption->abbreviation = GetOptionNameAbbreviation(arena, newOption->name);
 					newOption->type = FileOptionType_CommentDefine;
 					newOption->isUncommented = true;
 					newOption->fileContentsStartIndex = lineStartIndex;
@@ -286,16 +498,16 @@ void UpdateFileTabOptions(FileTab* tab)
 				
 				if (isBooleanValue)
 				{
-					FileOption* newOption = VarArrayAdd(FileOption, &tab->fileOptions);
+					FileOption* newOption = VarArrayAdd(FileOption, fileOptionsOut);
 					NotNull(newOption);
 					ClearPointer(newOption);
-					newOption->name = AllocStr8(stdHeap, namePart);
-					newOption->abbreviation = GetOptionNameAbbreviation(stdHeap, newOption->name);
+					newOption->name = AllocStr8(arena, namePart);
+					newOption->abbreviation = GetOptionNameAbbreviation(arena, newOption->name);
 					newOption->type = FileOptionType_Bool;
 					newOption->valueBool = isBooleanTrue;
 					newOption->fileContentsStartIndex = lineStartIndex + (uxx)(valuePart.chars - line.chars);
 					newOption->fileContentsEndIndex = newOption->fileContentsStartIndex + valuePart.length;
-					newOption->valueStr = AllocStr8(stdHeap, StrSlice(tab->fileContents, newOption->fileContentsStartIndex, newOption->fileContentsEndIndex));
+					newOption->valueStr = AllocStr8(arena, StrSlice(fileContents, newOption->fileContentsStartIndex, newOption->fileContentsEndIndex));
 					prevOption = newOption;
 					isOption = true;
 				}
@@ -309,6 +521,56 @@ void UpdateFileTabOptions(FileTab* tab)
 		ArenaResetToMark(scratch, scratchMark);
 	}
 	
+	ScratchEnd(scratch);
+}
+
+void FinalizeFileTabOptions(FileTab* tab);
+bool TryLoadFileOptionsFromParseCache(ParseCache* cache, u64 contentHash, FileTab* tab);
+void AddFileOptionsToParseCache(ParseCache* cache, u64 contentHash, const FileTab* tab);
+void QueueUsageIndexFileCheck(UsageIndex* index, FilePath path);
+
+void UpdateFileTabOptions(FileTab* tab)
+{
+	ProfZoneBegin(_funcZone, "UpdateFileTabOptions");
+	VarArrayLoop(&tab->fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+		FreeFileOption(option);
+	}
+	VarArrayClear(&tab->fileOptions);
+	
+	u64 contentHash = HashStr8Fnv(tab->fileContents);
+	if (!TryLoadFileOptionsFromParseCache(&app->parseCache, contentHash, tab))
+	{
+		ParseFileOptions(stdHeap, tab->fileContents, &tab->fileOptions);
+		AddFileOptionsToParseCache(&app->parseCache, contentHash, tab);
+	}
+	BuildFileTabConditionals(tab);
+	FreeFileTabOptionSources(tab);
+	tab->optionSourcesTime = 0; //resolve the includes again, they might have changed too
+	FinalizeFileTabOptions(tab);
+	ProfZoneEnd(_funcZone);
+}
+
+// Calculates everything that is derived from the list of options, after they have been parsed (or restored from the session snapshot, see app_session.c)
+void FinalizeFileTabOptions(FileTab* tab)
+{
+	NotNull(tab);
+	VarArrayLoop(&tab->fileOptions, oIndex)
+	{
+		VarArrayLoopGet(FileOption, option, &tab->fileOptions, oIndex);
+		UpdateFileOptionDisplayName(option);
+		option->nameCharMask = GetFuzzyCharMask(option->name);
+		#if BUILD_WITH_PIG_UI
+		option->btnId = UiIdStrIndex(option->name, oIndex);
+		#endif
+	}
+	app->nextTabPaletteGeneration++;
+	tab->paletteGeneration = app->nextTabPaletteGeneration;
+	
+	BuildOptionSearchIndex(tab);
+	app->optionsFilterChanged = true;
+	
 	CalculateLongestAbbreviationWidth(tab);
 	
 	//TODO: We need to maintain the selectedOptionIndex through the option reload. We could save the name of the option it had selected and find it in the new file if it stil exists. Otherwise we could fall back to selecting a similar index or a nearby option?
@@ -317,8 +579,6 @@ void UpdateFileTabOptions(FileTab* tab)
 		//For now we will just make sure the index is still within the range of options
 		tab->selectedOptionIndex = tab->fileOptions.length > 0 ? (ixx)tab->fileOptions.length-1 : -1;
 	}
-	
-	ScratchEnd(scratch);
 }
 
 //NOTE: This function automatically sets the tab as the currentTab (it will also focus an existing tab if the file is already open)
@@ -340,7 +600,7 @@ FileTab* AppOpenFileTab(FilePath filePath)
 	else
 	{
 		Str8 fileContents = Str8_Empty;
-		bool openResult = OsReadTextFile(fullPath, stdHeap, &fileContents);
+		bool openResult = AppReadTextFile(fullPath, stdHeap, &fileContents);
 		if (!openResult) { NotifyPrint_W("Failed to open file at \"%.*s\"", StrPrint(fullPath)); return nullptr; }
 		
 		FileTab* newTab = VarArrayAdd(FileTab, &app->tabs);
@@ -356,6 +616,7 @@ FileTab* AppOpenFileTab(FilePath filePath)
 		UpdateFileTabOptions(newTab);
 		
 		newTab->fileWatchId = AddFileWatch(&app->fileWatches, newTab->filePath, CHECK_FILE_WRITE_TIME_PERIOD);
+		AppPublishIpcEvent(StrLit("opened"), Str8_Empty, newTab->filePath);
 		
 		AppChangeTab(app->tabs.length-1);
 		result = newTab;
@@ -371,7 +632,7 @@ void AppReloadFileTab(uxx tabIndex)
 	Assert(tabIndex < app->tabs.length);
 	FileTab* tab = VarArrayGetHard(FileTab, &app->tabs, tabIndex);
 	Str8 fileContents = Str8_Empty;
-	bool openResult = OsReadTextFile(tab->filePath, stdHeap, &fileContents);
+	bool openResult = AppReadTextFile(tab->filePath, stdHeap, &fileContents);
 	if (!openResult)
 	{
 		NotifyPrint_W("Failed to reload file at \"%.*s\"", StrPrint(tab->filePath));
@@ -384,8 +645,14 @@ void AppReloadFileTab(uxx tabIndex)
 	tab->fileContents = fileContents;
 	tab->originalFileContents = AllocStr8(stdHeap, tab->fileContents);
 	tab->isFileChangedFromOriginal = false;
+	if (tab->isFromSnapshot)
+	{
+		tab->isFromSnapshot = false;
+		tab->fileWatchId = AddFileWatch(&app->fileWatches, tab->filePath, CHECK_FILE_WRITE_TIME_PERIOD);
+	}
 	
 	UpdateFileTabOptions(tab);
+	AppPublishIpcEvent(StrLit("reloaded"), Str8_Empty, tab->filePath);
 }
 
 bool AppCheckForFileChanges()
@@ -396,6 +663,7 @@ bool AppCheckForFileChanges()
 		VarArrayLoop(&app->tabs, tIndex)
 		{
 			VarArrayLoopGet(FileTab, tab, &app->tabs, tIndex);
+			if (tab->fileWatchId == 0) { continue; } //still verifying the session snapshot
 			if (HasFileWatchChangedWithDelay(&app->fileWatches, tab->fileWatchId, FILE_RELOAD_DELAY))
 			{
 				ClearFileWatchChanged(&app->fileWatches, tab->fileWatchId);
@@ -423,7 +691,7 @@ void UpdateOptionValueInFile(FileTab* tab, FileOption* option)
 		Str8 fileEnd = StrSliceFrom(tab->fileContents, option->fileContentsEndIndex);
 		Str8 newFileContents = JoinStringsInArena(scratch, fileBeginning, option->valueStr, false);
 		newFileContents = JoinStringsInArena(scratch, newFileContents, fileEnd, false);
-		bool writeResult = OsWriteTextFile(tab->filePath, newFileContents);
+		bool writeResult = AppWriteTextFile(tab->filePath, newFileContents);
 		if (writeResult)
 		{
 			if (newFileContents.length != tab->fileContents.length)
@@ -447,6 +715,7 @@ void UpdateOptionValueInFile(FileTab* tab, FileOption* option)
 			
 			//Since we just wrote to the file, make sure we immediately updated out file write time so we don't think it was an external change
 			ClearFileWatchChanged(&app->fileWatches, tab->fileWatchId);
+			QueueUsageIndexFileCheck(&app->usageIndex, tab->filePath);
 		}
 		else
 		{
@@ -467,6 +736,8 @@ void SetOptionValue(FileTab* tab, FileOption* option, Str8 newValueStr)
 		FreeStr8(stdHeap, &option->valueStr);
 		option->valueStr = AllocStr8(stdHeap, newValueStr);
 		UpdateOptionValueInFile(tab, option);
+		tab->searchIndex.isStale = true;
+		UpdateFileTabConditionals(tab, option->name);
 	}
 }
 
@@ -474,6 +745,12 @@ void ToggleOption(FileTab* tab, FileOption* option)
 {
 	NotNull(tab);
 	NotNull(option);
+	if (tab->isFromSnapshot)
+	{
+		//NOTE: This only happens if the user is very quick after startup (or the file is on a slow drive)
+		Notify_W("This file is still being loaded, try again in a moment");
+		return;
+	}
 	if (option->type == FileOptionType_Bool)
 	{
 		option->valueBool = !option->valueBool;
@@ -481,11 +758,14 @@ void ToggleOption(FileTab* tab, FileOption* option)
 		else if (StrExactEquals(option->valueStr, StrLit("true"))) { SetOptionValue(tab, option, StrLit("false")); }
 		else if (StrExactEquals(option->valueStr, StrLit("0"))) { SetOptionValue(tab, option, StrLit("1")); }
 		else { SetOptionValue(tab, option, StrLit("0")); }
+		AppPublishOptionChanged(tab, option);
 	}
 	else if (option->type == FileOptionType_CommentDefine)
 	{
 		option->isUncommented = !option->isUncommented;
+		UpdateFileOptionDisplayName(option);
 		SetOptionValue(tab, option, option->isUncommented ? StrLit("") : StrLit("// "));
+		AppPublishOptionChanged(tab, option);
 	}
 	else
 	{
@@ -493,3 +773,85 @@ void ToggleOption(FileTab* tab, FileOption* option)
 		//TODO: Implement me!
 	}
 }
+
+// +--------------------------------------------------------------+
+// |                        Options Filter                        |
+// +--------------------------------------------------------------+
+// While the filter is empty every option is visible and visibleOptions is not used
+bool IsOptionsFilterActive()
+{
+	return (app->currentTab != nullptr && !IsEmptyStr(app->optionsFilter.str));
+}
+
+ixx FindVisibleIndexOfOption(ixx optionIndex);
+
+// visibleOptions is recalculated lazily so anything that changes the current tab mid-frame doesn't leave it pointing at the wrong options
+void RefreshVisibleOptions()
+{
+	if (!app->optionsFilterChanged) { return; }
+	app->optionsFilterChanged = false;
+	VarArrayClear(&app->visibleOptions);
+	if (IsOptionsFilterActive())
+	{
+		SearchOptionSearchIndex(app->currentTab, app->optionsFilter.str, &app->visibleOptions);
+		if (FindVisibleIndexOfOption(app->currentTab->selectedOptionIndex) < 0) { app->currentTab->selectedOptionIndex = -1; }
+	}
+}
+
+uxx GetNumVisibleOptions()
+{
+	if (app->currentTab == nullptr) { return 0; }
+	RefreshVisibleOptions();
+	return IsOptionsFilterActive() ? app->visibleOptions.length : app->currentTab->fileOptions.length;
+}
+
+uxx GetVisibleOptionIndex(uxx visibleIndex)
+{
+	RefreshVisibleOptions();
+	if (!IsOptionsFilterActive()) { return visibleIndex; }
+	return *VarArrayGetHard(uxx, &app->visibleOptions, visibleIndex);
+}
+
+// Returns -1 if the option is hidden by the filter (or optionIndex is -1)
+ixx FindVisibleIndexOfOption(ixx optionIndex)
+{
+	RefreshVisibleOptions();
+	if (optionIndex < 0 || !IsOptionsFilterActive()) { return optionIndex; }
+	const uxx* visibleOptions = (const uxx*)app->visibleOptions.items;
+	uxx low = 0;
+	uxx high = app->visibleOptions.length;
+	while (low < high)
+	{
+		uxx middle = low + (high - low)/2;
+		if (visibleOptions[middle] < (uxx)optionIndex) { low = middle+1; }
+		else { high = middle; }
+	}
+	return (low < app->visibleOptions.length && visibleOptions[low] == (uxx)optionIndex) ? (ixx)low : -1;
+}
+
+void UpdateOptionsFilter()
+{
+	if (!app->palette.isOpen) { EditTextHandleKeyboardInput(&app->optionsFilter); }
+	if (app->optionsFilter.textChanged)
+	{
+		app->optionsFilter.textChanged = false;
+		app->optionsFilterChanged = true;
+	}
+	RefreshVisibleOptions();
+}
+
+void FocusOptionsFilter()
+{
+	app->optionsFilter.isFocused = true;
+	app->optionsFilter.cursorStart = 0;
+	app->optionsFilter.cursorEnd = app->optionsFilter.str.length;
+	EditTextResetCursorBlink(&app->optionsFilter);
+}
+
+void ClearOptionsFilter()
+{
+	EditTextDeleteRange(&app->optionsFilter, 0, app->optionsFilter.str.length);
+	app->optionsFilter.cursorStart = 0;
+	app->optionsFilter.cursorEnd = 0;
+	app->optionsFilterChanged = true;
+}
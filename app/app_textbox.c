@@ -47,6 +47,32 @@ void InitClayTextbox(Arena* arena, Str8 idStr, Str8 initialText, u16 clayFontId,
 	textboxOut->fontSize = fontSize;
 	InitVarArrayWithInitial(FontFlowGlyph, &textboxOut->flowGlyphs, arena, initialText.length);
 }
+#endif
+
+// +--------------------------------------------------------------+
+// |                    EditableText Functions                    |
+// +--------------------------------------------------------------+
+void FreeEditableText(EditableText* editText)
+{
+	NotNull(editText);
+	if (editText->arena != nullptr)
+	{
+		FreeVarArray(&editText->strBuffer);
+	}
+	ClearPointer(editText);
+}
+
+void InitEditableText(Arena* arena, uxx maxLength, EditableText* editTextOut)
+{
+	NotNull(arena);
+	NotNull(editTextOut);
+	ClearPointer(editTextOut);
+	editTextOut->arena = arena;
+	editTextOut->maxLength = maxLength;
+	InitVarArrayWithInitial(char, &editTextOut->strBuffer, arena, (maxLength > 0) ? maxLength : 64);
+	editTextOut->str = MakeStr8(0, (char*)editTextOut->strBuffer.items);
+	editTextOut->cursorActive = true;
+}
 
 void EditTextResetCursorBlink(EditableText* editText)
 {
@@ -87,6 +113,7 @@ void EditTextInsertAt(EditableText* editText, Str8 newText, uxx insertionIndex)
 	Assert(insertionIndex <= editText->str.length);
 	if (!editText->cursorActive) { return; }
 	if (newText.length == 0) { return; }
+	if (editText->maxLength > 0 && editText->str.length + newText.length > editText->maxLength) { return; }
 	VarArrayExpand(&editText->strBuffer, editText->str.length + newText.length);
 	editText->str.chars = (char*)editText->strBuffer.items;
 	if (editText->str.length > insertionIndex)
@@ -121,6 +148,137 @@ bool EditTextHandleCharInput(EditableText* editText, KeyboardCharInput* charInpu
 	return true;
 }
 
+// Handles arrow keys, Backspace, Delete and typed characters for a focused EditableText.
+// Typed characters that get inserted are marked as handled so nothing else responds to them
+void EditTextHandleKeyboardInput(EditableText* editText)
+{
+	NotNull(editText);
+	NotNull(editText->arena);
+	if (!editText->isFocused) { return; }
+	
+	// +==============================+
+	// |      Handle Arrow Keys       |
+	// +==============================+
+	//TODO: Handle Ctrl and Alt modifiers!
+	if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Left, true))
+	{
+		if (editText->cursorActive)
+		{
+			if (editText->cursorStart == editText->cursorEnd || IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift))
+			{
+				if (editText->cursorEnd > 0)
+				{
+					editText->cursorEnd--;
+					if (!IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift)) { editText->cursorStart = editText->cursorEnd; }
+				}
+			}
+			else
+			{
+				editText->cursorEnd = MinUXX(editText->cursorStart, editText->cursorEnd);
+				editText->cursorStart = editText->cursorEnd;
+			}
+		}
+		else
+		{
+			editText->cursorEnd = editText->str.length;
+			editText->cursorStart = editText->cursorEnd;
+		}
+		EditTextResetCursorBlink(editText);
+	}
+	if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Right, true))
+	{
+		if (editText->cursorActive)
+		{
+			if (editText->cursorStart == editText->cursorEnd || IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift))
+			{
+				if (editText->cursorEnd < editText->str.length)
+				{
+					editText->cursorEnd++;
+					if (!IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift)) { editText->cursorStart = editText->cursorEnd; }
+				}
+			}
+			else
+			{
+				editText->cursorEnd = MaxUXX(editText->cursorStart, editText->cursorEnd);
+				editText->cursorStart = editText->cursorEnd;
+			}
+		}
+		else
+		{
+			editText->cursorEnd = editText->str.length;
+			editText->cursorStart = editText->cursorEnd;
+		}
+		EditTextResetCursorBlink(editText);
+	}
+	
+	// +==============================+
+	// |       Handle Backspace       |
+	// +==============================+
+	if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Backspace, true))
+	{
+		if (!editText->cursorActive)
+		{
+			editText->cursorEnd = editText->str.length;
+			editText->cursorStart = editText->cursorEnd;
+			editText->cursorActive = true;
+		}
+		
+		if (editText->cursorEnd != editText->cursorStart)
+		{
+			EditTextDeleteRange(editText, editText->cursorStart, editText->cursorEnd);
+		}
+		else if (editText->cursorEnd > 0)
+		{
+			//TODO: This needs to actually figure out how big the previous encoded UTF-8 character is! It's not always 1 byte!
+			EditTextDeleteRange(editText, editText->cursorEnd-1, editText->cursorEnd);
+		}
+	}
+	
+	// +==============================+
+	// |        Handle Delete         |
+	// +==============================+
+	if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Delete, true))
+	{
+		if (!editText->cursorActive)
+		{
+			editText->cursorEnd = editText->str.length;
+			editText->cursorStart = editText->cursorEnd;
+			editText->cursorActive = true;
+		}
+		
+		if (editText->cursorEnd != editText->cursorStart)
+		{
+			EditTextDeleteRange(editText, editText->cursorStart, editText->cursorEnd);
+		}
+		else if (editText->cursorEnd < editText->str.length)
+		{
+			//TODO: This needs to actually figure out how big the next encoded UTF-8 character is! It's not always 1 byte!
+			EditTextDeleteRange(editText, editText->cursorEnd, editText->cursorEnd+1);
+		}
+	}
+	
+	// +==============================+
+	// |   Handle Typed Characters    |
+	// +==============================+
+	if (editText->isFocused && editText->cursorActive)
+	{
+		for (uxx cIndex = 0; cIndex < appIn->keyboard.numCharInputs; cIndex++)
+		{
+			KeyboardCharInput* charInput = &appIn->keyboard.charInputs[cIndex];
+			if (!appInputHandling->keyboard.charInputHandled[cIndex])
+			{
+				bool inputHandled = EditTextHandleCharInput(editText, charInput);
+				if (inputHandled)
+				{
+					appInputHandling->keyboard.charInputHandled[cIndex] = true;
+					//TODO: Handle the corresponding Key BtnState!
+				}
+			}
+		}
+	}
+}
+
+#if 0
 void UpdateClayTextbox(ClayTextbox* textbox)
 {
 	NotNull(textbox);
@@ -226,129 +384,7 @@ void UpdateClayTextbox(ClayTextbox* textbox)
 		textbox->edit.isFocused = false;
 	}
 	
-	if (textbox->edit.isFocused)
-	{
-		// +==============================+
-		// |      Handle Arrow Keys       |
-		// +==============================+
-		//TODO: Handle Ctrl and Alt modifiers!
-		if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Left, true))
-		{
-			if (textbox->edit.cursorActive)
-			{
-				if (textbox->edit.cursorStart == textbox->edit.cursorEnd || IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift))
-				{
-					if (textbox->edit.cursorEnd > 0)
-					{
-						textbox->edit.cursorEnd--;
-						if (!IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift)) { textbox->edit.cursorStart = textbox->edit.cursorEnd; }
-					}
-				}
-				else
-				{
-					textbox->edit.cursorEnd = MinUXX(textbox->edit.cursorStart, textbox->edit.cursorEnd);
-					textbox->edit.cursorStart = textbox->edit.cursorEnd;
-				}
-			}
-			else
-			{
-				textbox->edit.cursorEnd = textbox->edit.str.length;
-				textbox->edit.cursorStart = textbox->edit.cursorEnd;
-			}
-			EditTextResetCursorBlink(&textbox->edit);
-		}
-		if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Right, true))
-		{
-			if (textbox->edit.cursorActive)
-			{
-				if (textbox->edit.cursorStart == textbox->edit.cursorEnd || IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift))
-				{
-					if (textbox->edit.cursorEnd < textbox->edit.str.length)
-					{
-						textbox->edit.cursorEnd++;
-						if (!IsKeyboardKeyDown(&appIn->keyboard, nullptr, Key_Shift)) { textbox->edit.cursorStart = textbox->edit.cursorEnd; }
-					}
-				}
-				else
-				{
-					textbox->edit.cursorEnd = MaxUXX(textbox->edit.cursorStart, textbox->edit.cursorEnd);
-					textbox->edit.cursorStart = textbox->edit.cursorEnd;
-				}
-			}
-			else
-			{
-				textbox->edit.cursorEnd = textbox->edit.str.length;
-				textbox->edit.cursorStart = textbox->edit.cursorEnd;
-			}
-			EditTextResetCursorBlink(&textbox->edit);
-		}
-		
-		// +==============================+
-		// |       Handle Backspace       |
-		// +==============================+
-		if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Backspace, true))
-		{
-			if (!textbox->edit.cursorActive)
-			{
-				textbox->edit.cursorEnd = textbox->edit.str.length;
-				textbox->edit.cursorStart = textbox->edit.cursorEnd;
-				textbox->edit.cursorActive = true;
-			}
-			
-			if (textbox->edit.cursorEnd != textbox->edit.cursorStart)
-			{
-				EditTextDeleteRange(&textbox->edit, textbox->edit.cursorStart, textbox->edit.cursorEnd);
-			}
-			else if (textbox->edit.cursorEnd > 0)
-			{
-				//TODO: This needs to actually figure out how big the previous encoded UTF-8 character is! It's not always 1 byte!
-				EditTextDeleteRange(&textbox->edit, textbox->edit.cursorEnd-1, textbox->edit.cursorEnd);
-			}
-		}
-		
-		// +==============================+
-		// |        Handle Delete         |
-		// +==============================+
-		if (IsKeyboardKeyPressed(&appIn->keyboard, &appInputHandling->keyboard, Key_Delete, true))
-		{
-			if (!textbox->edit.cursorActive)
-			{
-				textbox->edit.cursorEnd = textbox->edit.str.length;
-				textbox->edit.cursorStart = textbox->edit.cursorEnd;
-				textbox->edit.cursorActive = true;
-			}
-			
-			if (textbox->edit.cursorEnd != textbox->edit.cursorStart)
-			{
-				EditTextDeleteRange(&textbox->edit, textbox->edit.cursorStart, textbox->edit.cursorEnd);
-			}
-			else if (textbox->edit.cursorEnd < textbox->edit.str.length)
-			{
-				//TODO: This needs to actually figure out how big the next encoded UTF-8 character is! It's not always 1 byte!
-				EditTextDeleteRange(&textbox->edit, textbox->edit.cursorEnd, textbox->edit.cursorEnd+1);
-			}
-		}
-		
-		// +==============================+
-		// |   Handle Typed Characters    |
-		// +==============================+
-		if (textbox->edit.isFocused && textbox->edit.cursorActive)
-		{
-			for (uxx cIndex = 0; cIndex < appIn->keyboard.numCharInputs; cIndex++)
-			{
-				KeyboardCharInput* charInput = &appIn->keyboard.charInputs[cIndex];
-				if (!appInputHandling->keyboard.charInputHandled[cIndex])
-				{
-					bool inputHandled = EditTextHandleCharInput(&textbox->edit, charInput);
-					if (inputHandled)
-					{
-						appInputHandling->keyboard.charInputHandled[cIndex] = true;
-						//TODO: Handle the corresponding Key BtnState!
-					}
-				}
-			}
-		}
-	}
+	EditTextHandleKeyboardInput(&textbox->edit);
 	
 	ScratchEnd(scratch);
 }
@@ -9,7 +9,7 @@ Description:
 */
 
 //NOTE: This is the primary usage macro in the UI code. See the Theme_XList macro for possible names
-#define GetThemeColorEx(themeColorSuffix, themeState) (app->theme.entries[ThemeColor_##themeColorSuffix].colors[themeState])
+#define GetThemeColorEx(themeColorSuffix, themeState) (app->theme->entries[ThemeColor_##themeColorSuffix].colors[themeState])
 #define GetThemeColor(themeColorSuffix) GetThemeColorEx(themeColorSuffix, ThemeState_Default)
 
 void FreeThemeDefinition(ThemeDefinition* theme)
@@ -23,6 +23,7 @@ void FreeThemeDefinition(ThemeDefinition* theme)
 			FreeThemeDefEntry(theme, entry);
 		}
 		FreeVarArray(&theme->entries);
+		FreeVarArray(&theme->buckets);
 	}
 	ClearPointer(theme);
 }
@@ -33,12 +34,16 @@ void InitThemeDefinition(Arena* arena, ThemeDefinition* themeOut, uxx numEntries
 	ClearPointer(themeOut);
 	themeOut->arena = arena;
 	InitVarArrayWithInitial(ThemeDefEntry, &themeOut->entries, arena, numEntriesExpected);
+	uxx numBuckets = THEME_DEF_MIN_NUM_BUCKETS;
+	while (numBuckets < numEntriesExpected) { numBuckets *= 2; }
+	InitVarArrayWithInitial(uxx, &themeOut->buckets, arena, numBuckets);
+	RebuildThemeDefIndex(themeOut, numBuckets);
 }
 
+// overrideTheme can be nullptr, in which case themeOut becomes a deep copy of baseTheme
 void CombineThemeDefinitions(const ThemeDefinition* baseTheme, const ThemeDefinition* overrideTheme, ThemeDefinition* themeOut)
 {
 	NotNull(baseTheme);
-	NotNull(overrideTheme);
 	NotNull(themeOut);
 	NotNull(themeOut->arena);
 	
@@ -47,10 +52,13 @@ void CombineThemeDefinitions(const ThemeDefinition* baseTheme, const ThemeDefini
 		const VarArrayLoopGet(ThemeDefEntry, baseEntry, &baseTheme->entries, eIndex);
 		AddThemeDefEntryPntr(themeOut, baseEntry);
 	}
-	VarArrayLoop(&overrideTheme->entries, eIndex)
+	if (overrideTheme != nullptr)
 	{
-		const VarArrayLoopGet(ThemeDefEntry, overrideEntry, &overrideTheme->entries, eIndex);
-		AddThemeDefEntryPntr(themeOut, overrideEntry);
+		VarArrayLoop(&overrideTheme->entries, eIndex)
+		{
+			const VarArrayLoopGet(ThemeDefEntry, overrideEntry, &overrideTheme->entries, eIndex);
+			AddThemeDefEntryPntr(themeOut, overrideEntry);
+		}
 	}
 }
 
@@ -93,8 +101,111 @@ Result TryResolveThemeIdentifier(const ThemeDefinition* themeDef, ThemeMode mode
 	return Result_NotFound;
 }
 
-Result BakeTheme(ThemeDefinition* themeDef, ThemeMode mode, BakedTheme* themeOut)
+bool DoesThemeDefEntryApplyToMode(const ThemeDefEntry* entry, ThemeMode mode)
+{
+	return (entry->mode == mode || entry->mode == ThemeMode_None);
+}
+
+// Fills depIndicesOut[0..THEME_DEF_FUNC_MAX_ARGS] with the index of each entry this entry directly depends on (UINTXX_MAX for slots that are not identifiers)
+// Returns the number of slots used, or sets unknownIdentifierOut if one of the identifiers doesn't exist in the definition
+uxx GetThemeDefEntryDependencies(ThemeDefinition* themeDef, ThemeMode mode, const ThemeDefEntry* entry, uxx* depIndicesOut, Str8* unknownIdentifierOut)
+{
+	uxx numSlots = 0;
+	if (entry->type == ThemeDefEntryType_Reference)
+	{
+		Str8 strippedReferenceName = entry->referenceKey;
+		ThemeState referencedState = StripThemeIdentifierStateSuffix(&strippedReferenceName);
+		ThemeDefEntry* referencedEntry = FindThemeDefEntry(themeDef, entry->mode, true, referencedState, false, strippedReferenceName);
+		depIndicesOut[0] = UINTXX_MAX;
+		if (referencedEntry != nullptr) { VarArrayGetIndexOf(ThemeDefEntry, &themeDef->entries, referencedEntry, &depIndicesOut[0]); }
+		else { SetOptionalOutPntr(unknownIdentifierOut, entry->referenceKey); }
+		numSlots = 1;
+	}
+	else if (entry->type == ThemeDefEntryType_Function)
+	{
+		for (uxx aIndex = 0; aIndex < entry->functionArgCount; aIndex++)
+		{
+			depIndicesOut[aIndex] = UINTXX_MAX;
+			if (entry->functionArgValues[aIndex].type == ThemeDefFuncArgType_Identifier)
+			{
+				Str8 identifier = entry->functionArgValues[aIndex].valueIdentifier;
+				ThemeState stateSuffix = StripThemeIdentifierStateSuffix(&identifier);
+				ThemeDefEntry* referencedEntry = FindThemeDefEntry(themeDef, mode, true, stateSuffix, true, identifier);
+				if (referencedEntry != nullptr) { VarArrayGetIndexOf(ThemeDefEntry, &themeDef->entries, referencedEntry, &depIndicesOut[aIndex]); }
+				else { SetOptionalOutPntr(unknownIdentifierOut, entry->functionArgValues[aIndex].valueIdentifier); }
+			}
+		}
+		numSlots = entry->functionArgCount;
+	}
+	return numSlots;
+}
+
+// +==============================+
+// |      Bake Reuse Helpers      |
+// +==============================+
+bool AreThemeDefEntriesEquivalent(const ThemeDefEntry* left, const ThemeDefEntry* right)
+{
+	if (left->type != right->type || left->mode != right->mode || left->state != right->state) { return false; }
+	if (!StrExactEquals(left->key, right->key)) { return false; }
+	if (left->type == ThemeDefEntryType_Color) { return (left->color.valueU32 == right->color.valueU32); }
+	if (left->type == ThemeDefEntryType_Reference) { return StrExactEquals(left->referenceKey, right->referenceKey); }
+	if (left->type == ThemeDefEntryType_Function)
+	{
+		if (left->function != right->function || left->functionArgCount != right->functionArgCount) { return false; }
+		for (uxx aIndex = 0; aIndex < left->functionArgCount; aIndex++)
+		{
+			const ThemeDefFuncArgValue* leftArg = &left->functionArgValues[aIndex];
+			const ThemeDefFuncArgValue* rightArg = &right->functionArgValues[aIndex];
+			if (leftArg->type != rightArg->type) { return false; }
+			switch (leftArg->type)
+			{
+				case ThemeDefFuncArgType_U8:         if (leftArg->valueU8 != rightArg->valueU8) { return false; } break;
+				case ThemeDefFuncArgType_I32:        if (leftArg->valueI32 != rightArg->valueI32) { return false; } break;
+				case ThemeDefFuncArgType_R32:        if (leftArg->valueR32 != rightArg->valueR32) { return false; } break;
+				case ThemeDefFuncArgType_Color:      if (leftArg->valueColor.valueU32 != rightArg->valueColor.valueU32) { return false; } break;
+				case ThemeDefFuncArgType_Identifier: if (!StrExactEquals(leftArg->valueIdentifier, rightArg->valueIdentifier)) { return false; } break;
+				default: break;
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+// Adds the hash of every key where the entry that wins the lookup for some mode/state differs between the two definitions (including keys that were added or removed)
+void FindChangedThemeDefKeys(const ThemeDefinition* oldDef, const ThemeDefinition* newDef, HashSet64* dirtyKeysOut)
+{
+	for (uxx dIndex = 0; dIndex < 2; dIndex++)
+	{
+		const ThemeDefinition* loopDef = (dIndex == 0) ? newDef : oldDef;
+		VarArrayLoop(&loopDef->entries, eIndex)
+		{
+			VarArrayLoopGet(ThemeDefEntry, entry, &loopDef->entries, eIndex);
+			if (HashSet64Contains(dirtyKeysOut, entry->keyHash)) { continue; }
+			const ThemeDefEntry* oldEntry = FindThemeDefEntry((ThemeDefinition*)oldDef, entry->mode, false, entry->state, false, entry->key);
+			const ThemeDefEntry* newEntry = FindThemeDefEntry((ThemeDefinition*)newDef, entry->mode, false, entry->state, false, entry->key);
+			if (oldEntry == nullptr || newEntry == nullptr || !AreThemeDefEntriesEquivalent(oldEntry, newEntry))
+			{
+				HashSet64Add(dirtyKeysOut, entry->keyHash);
+			}
+		}
+	}
+}
+
+// Adds the hash of every key that has at least one entry for a specific mode. Everything else resolves the same in all modes
+void FindModeSpecificThemeDefKeys(const ThemeDefinition* themeDef, HashSet64* dirtyKeysOut)
+{
+	VarArrayLoop(&themeDef->entries, eIndex)
+	{
+		VarArrayLoopGet(ThemeDefEntry, entry, &themeDef->entries, eIndex);
+		if (entry->mode != ThemeMode_None) { HashSet64Add(dirtyKeysOut, entry->keyHash); }
+	}
+}
+
+// reuseInfo is optional. See ThemeBakeReuseInfo
+Result BakeTheme(ThemeDefinition* themeDef, ThemeMode mode, const ThemeBakeReuseInfo* reuseInfo, BakedTheme* themeOut)
 {
+	ProfZoneBegin(_funcZone, "BakeTheme");
 	Result result = Result_None;
 	
 	if (mode == ThemeMode_Debug)
@@ -106,9 +217,14 @@ Result BakeTheme(ThemeDefinition* themeDef, ThemeMode mode, BakedTheme* themeOut
 				themeOut->entries[cIndex].colors[sIndex] = GetPredefPalColorByIndex(cIndex + sIndex);
 			}
 		}
+		ProfZoneEnd(_funcZone);
 		return Result_Success;
 	}
 	
+	ScratchBegin1(scratch, themeDef->arena);
+	uxx numEntries = themeDef->entries.length;
+	uxx numEntriesAlloc = MaxUXX(numEntries, 1); //avoid 0 sized allocations
+	
 	VarArrayLoop(&themeDef->entries, eIndex)
 	{
 		VarArrayLoopGet(ThemeDefEntry, entry, &themeDef->entries, eIndex);
@@ -116,102 +232,182 @@ Result BakeTheme(ThemeDefinition* themeDef, ThemeMode mode, BakedTheme* themeOut
 		entry->isReferenced = false;
 	}
 	
-	uxx numUnresolvedEntries = 1;
-	uxx resolveIter = 0; UNUSED(resolveIter);
-	while (numUnresolvedEntries > 0)
+	// +==============================+
+	// |    Build Dependency Graph    |
+	// +==============================+
+	// Each entry has up to THEME_DEF_FUNC_MAX_ARGS outgoing edges. We look up every identifier exactly once here
+	uxx* depIndices = AllocArray(uxx, scratch, numEntriesAlloc * THEME_DEF_FUNC_MAX_ARGS);
+	uxx* numDeps = AllocArray(uxx, scratch, numEntriesAlloc);
+	NotNull(depIndices);
+	NotNull(numDeps);
+	VarArrayLoop(&themeDef->entries, eIndex)
 	{
-		numUnresolvedEntries = 0;
-		ThemeDefEntry* firstUnresolvedEntry = nullptr;
-		uxx numNewlyResolvedEntries = 0;
-		VarArrayLoop(&themeDef->entries, eIndex)
+		VarArrayLoopGet(ThemeDefEntry, entry, &themeDef->entries, eIndex);
+		numDeps[eIndex] = 0;
+		if (!DoesThemeDefEntryApplyToMode(entry, mode)) { continue; }
+		Str8 unknownIdentifier = Str8_Empty;
+		numDeps[eIndex] = GetThemeDefEntryDependencies(themeDef, mode, entry, &depIndices[eIndex * THEME_DEF_FUNC_MAX_ARGS], &unknownIdentifier);
+		if (!IsEmptyStr(unknownIdentifier))
 		{
-			VarArrayLoopGet(ThemeDefEntry, entry, &themeDef->entries, eIndex);
-			if (!entry->isResolved && (entry->mode == mode || entry->mode == ThemeMode_None))
+			NotifyPrint_E("Unknown identifier: \"%.*s\" given for theme value file for \"%.*s\"!", StrPrint(unknownIdentifier), StrPrint(entry->key));
+			result = Result_UnknownString;
+		}
+		for (uxx dIndex = 0; dIndex < numDeps[eIndex]; dIndex++)
+		{
+			uxx depIndex = depIndices[eIndex * THEME_DEF_FUNC_MAX_ARGS + dIndex];
+			if (depIndex != UINTXX_MAX) { VarArrayGetHard(ThemeDefEntry, &themeDef->entries, depIndex)->isReferenced = true; }
+		}
+	}
+	
+	// +==============================+
+	// |       Topological Sort       |
+	// +==============================+
+	// Iterative depth-first search, an entry is added to sortedIndices only after all of its dependencies have been added.
+	// Finding an edge to an entry that is still on the stack means we found a cycle, and the stack holds the exact path
+	u8* visitStates = AllocArray(u8, scratch, numEntriesAlloc); //0=unvisited, 1=on stack, 2=sorted
+	uxx* stackIndices = AllocArray(uxx, scratch, numEntriesAlloc);
+	uxx* stackNextDep = AllocArray(uxx, scratch, numEntriesAlloc);
+	uxx* sortedIndices = AllocArray(uxx, scratch, numEntriesAlloc);
+	NotNull(visitStates);
+	NotNull(stackIndices);
+	NotNull(stackNextDep);
+	NotNull(sortedIndices);
+	for (uxx eIndex = 0; eIndex < numEntries; eIndex++) { visitStates[eIndex] = 0; }
+	uxx numSorted = 0;
+	bool foundCycle = false;
+	for (uxx rootIndex = 0; rootIndex < numEntries && !foundCycle; rootIndex++)
+	{
+		ThemeDefEntry* rootEntry = VarArrayGetHard(ThemeDefEntry, &themeDef->entries, rootIndex);
+		if (visitStates[rootIndex] != 0 || !DoesThemeDefEntryApplyToMode(rootEntry, mode)) { continue; }
+		uxx stackSize = 0;
+		stackIndices[stackSize] = rootIndex; stackNextDep[stackSize] = 0; stackSize++;
+		visitStates[rootIndex] = 1;
+		while (stackSize > 0)
+		{
+			uxx topIndex = stackIndices[stackSize-1];
+			if (stackNextDep[stackSize-1] < numDeps[topIndex])
 			{
-				if (entry->type == ThemeDefEntryType_Color)
+				uxx depIndex = depIndices[topIndex * THEME_DEF_FUNC_MAX_ARGS + stackNextDep[stackSize-1]];
+				stackNextDep[stackSize-1]++;
+				if (depIndex == UINTXX_MAX || visitStates[depIndex] == 2) { continue; }
+				if (visitStates[depIndex] == 1)
 				{
-					entry->isResolved = true;
-					numNewlyResolvedEntries++;
-				}
-				else if (entry->type == ThemeDefEntryType_Reference)
-				{
-					Str8 strippedReferenceName = entry->referenceKey;
-					ThemeState referencedState = StripThemeIdentifierStateSuffix(&strippedReferenceName);
-					ThemeDefEntry* referencedEntry = FindThemeDefEntry(themeDef, entry->mode, true, referencedState, false, strippedReferenceName);
-					if (referencedEntry != nullptr)
+					uxx cycleStart = 0;
+					while (stackIndices[cycleStart] != depIndex) { cycleStart++; }
+					Str8 cyclePath = Str8_Empty;
+					for (uxx sIndex = cycleStart; sIndex < stackSize; sIndex++)
 					{
-						referencedEntry->isReferenced = true;
-						if (referencedEntry->isResolved)
-						{
-							entry->isResolved = true;
-							entry->color = referencedEntry->color;
-							numNewlyResolvedEntries++;
-						}
-						else
-						{
-							if (firstUnresolvedEntry == nullptr) { firstUnresolvedEntry = entry; }
-							numUnresolvedEntries++;
-						}
-					}
-					else
-					{
-						NotifyPrint_E("Unknown identifier: \"%.*s\" given for theme value file for \"%.*s\"!", StrPrint(entry->referenceKey), StrPrint(entry->key));
-						result = Result_UnknownString;
+						ThemeDefEntry* pathEntry = VarArrayGetHard(ThemeDefEntry, &themeDef->entries, stackIndices[sIndex]);
+						cyclePath = PrintInArenaStr(scratch, "%.*s%.*s -> ", StrPrint(cyclePath), StrPrint(pathEntry->key));
 					}
+					cyclePath = PrintInArenaStr(scratch, "%.*s%.*s", StrPrint(cyclePath), StrPrint(VarArrayGetHard(ThemeDefEntry, &themeDef->entries, depIndex)->key));
+					NotifyPrint_E("Circular dependency between identifiers in theme: %.*s", StrPrint(cyclePath));
+					result = Result_InvalidInput;
+					foundCycle = true;
+					break;
 				}
-				else if (entry->type == ThemeDefEntryType_Function)
+				stackIndices[stackSize] = depIndex; stackNextDep[stackSize] = 0; stackSize++;
+				visitStates[depIndex] = 1;
+			}
+			else
+			{
+				visitStates[topIndex] = 2;
+				sortedIndices[numSorted] = topIndex;
+				numSorted++;
+				stackSize--;
+			}
+		}
+	}
+	
+	// +==============================+
+	// |   Resolve In Sorted Order    |
+	// +==============================+
+	// Since dependencies are always visited first, an entry is only clean if its own key is clean and all of its dependencies turned out clean
+	bool* entryIsDirty = AllocArray(bool, scratch, numEntriesAlloc);
+	NotNull(entryIsDirty);
+	uxx numUnresolvedEntries = 0;
+	uxx numReusedEntries = 0;
+	for (uxx sIndex = 0; sIndex < numSorted && !foundCycle; sIndex++)
+	{
+		uxx eIndex = sortedIndices[sIndex];
+		ThemeDefEntry* entry = VarArrayGetHard(ThemeDefEntry, &themeDef->entries, eIndex);
+		const uxx* entryDeps = &depIndices[eIndex * THEME_DEF_FUNC_MAX_ARGS];
+		
+		bool isDirty = (reuseInfo == nullptr || HashSet64Contains(reuseInfo->dirtyKeys, entry->keyHash));
+		for (uxx dIndex = 0; dIndex < numDeps[eIndex] && !isDirty; dIndex++)
+		{
+			if (entryDeps[dIndex] != UINTXX_MAX && entryIsDirty[entryDeps[dIndex]]) { isDirty = true; }
+		}
+		const ThemeDefEntry* sourceEntry = nullptr;
+		if (!isDirty)
+		{
+			sourceEntry = (reuseInfo->sourceDef == themeDef)
+				? entry
+				: FindThemeDefEntry((ThemeDefinition*)reuseInfo->sourceDef, entry->mode, false, entry->state, false, entry->key);
+			if (sourceEntry == nullptr) { isDirty = true; }
+		}
+		entryIsDirty[eIndex] = isDirty;
+		if (!isDirty)
+		{
+			entry->isResolved = true;
+			entry->color = sourceEntry->bakedColors[reuseInfo->sourceMode];
+			entry->bakedColors[mode] = entry->color;
+			numReusedEntries++;
+			continue;
+		}
+		
+		if (entry->type == ThemeDefEntryType_Color)
+		{
+			entry->isResolved = true;
+		}
+		else if (entry->type == ThemeDefEntryType_Reference)
+		{
+			ThemeDefEntry* referencedEntry = (entryDeps[0] != UINTXX_MAX) ? VarArrayGetHard(ThemeDefEntry, &themeDef->entries, entryDeps[0]) : nullptr;
+			if (referencedEntry != nullptr && referencedEntry->isResolved)
+			{
+				entry->isResolved = true;
+				entry->color = referencedEntry->color;
+			}
+			else { numUnresolvedEntries++; }
+		}
+		else if (entry->type == ThemeDefEntryType_Function)
+		{
+			bool allArgsResolved = true;
+			ThemeDefFuncArgValue resolvedArgs[THEME_DEF_FUNC_MAX_ARGS];
+			for (uxx aIndex = 0; aIndex < entry->functionArgCount; aIndex++)
+			{
+				if (entry->functionArgValues[aIndex].type == ThemeDefFuncArgType_Identifier)
 				{
-					bool allArgsResolved = true;
-					ThemeDefFuncArgValue resolvedArgs[THEME_DEF_FUNC_MAX_ARGS];
-					for (uxx aIndex = 0; aIndex < entry->functionArgCount; aIndex++)
+					ThemeDefEntry* argEntry = (entryDeps[aIndex] != UINTXX_MAX) ? VarArrayGetHard(ThemeDefEntry, &themeDef->entries, entryDeps[aIndex]) : nullptr;
+					if (argEntry != nullptr && argEntry->isResolved)
 					{
-						if (entry->functionArgValues[aIndex].type == ThemeDefFuncArgType_Identifier)
-						{
-							Color32 resolvedColor = Transparent_Const;
-							Result resolveResult = TryResolveThemeIdentifier(themeDef, mode, entry->functionArgValues[aIndex].valueIdentifier, &resolvedColor);
-							if (resolveResult == Result_Success)
-							{
-								resolvedArgs[aIndex].type = ThemeDefFuncArgType_Color;
-								resolvedArgs[aIndex].valueColor = resolvedColor;
-							}
-							else { allArgsResolved = false; break; }
-						}
-						else
-						{
-							MyMemCopy(&resolvedArgs[aIndex], &entry->functionArgValues[aIndex], sizeof(ThemeDefFuncArgValue));
-						}
-					}
-					
-					if (allArgsResolved)
-					{
-						Color32 functionResult = CallThemeDefFunc(
-							entry->function,
-							themeDef, mode,
-							entry->functionArgCount, &resolvedArgs[0]
-						);
-						entry->isResolved = true;
-						entry->color = functionResult;
-						numNewlyResolvedEntries++;
-					}
-					else
-					{
-						numUnresolvedEntries++;
+						resolvedArgs[aIndex].type = ThemeDefFuncArgType_Color;
+						resolvedArgs[aIndex].valueColor = argEntry->color;
 					}
+					else { allArgsResolved = false; break; }
+				}
+				else
+				{
+					MyMemCopy(&resolvedArgs[aIndex], &entry->functionArgValues[aIndex], sizeof(ThemeDefFuncArgValue));
 				}
-				else { Assert(false); }
 			}
+			
+			if (allArgsResolved)
+			{
+				entry->isResolved = true;
+				entry->color = CallThemeDefFunc(
+					entry->function,
+					themeDef, mode,
+					entry->functionArgCount, &resolvedArgs[0]
+				);
+			}
+			else { numUnresolvedEntries++; }
 		}
-		if (numNewlyResolvedEntries == 0 && numUnresolvedEntries > 0)
-		{
-			NotifyPrint_E("Unresolved entries in theme (circular dependencies between identifiers). Unresolved entries \"%.*s\" and %llu other%s",
-				StrPrint(firstUnresolvedEntry->key),
-				(numUnresolvedEntries-1), Plural(numUnresolvedEntries-1, "s")
-			);
-			result = Result_InvalidInput;
-			break;
-		}
-		resolveIter++;
+		else { Assert(false); }
+		
+		if (entry->isResolved) { entry->bakedColors[mode] = entry->color; }
 	}
+	if (reuseInfo != nullptr) { PrintLine_D("Reused %llu/%llu entries while baking %s theme", (u64)numReusedEntries, (u64)numSorted, GetThemeModeStr(mode)); }
 	
 	if (numUnresolvedEntries == 0 && result == Result_None)
 	{
@@ -222,10 +418,11 @@ Result BakeTheme(ThemeDefinition* themeDef, ThemeMode mode, BakedTheme* themeOut
 			VarArrayLoopGet(ThemeDefEntry, entry, &themeDef->entries, eIndex);
 			if (!entry->isReferenced && (entry->mode == mode || entry->mode == ThemeMode_None))
 			{
-				for (uxx cIndex = 1; cIndex < ThemeColor_Count; cIndex++)
+				ThemeColor themeColor = ThemeColor_None;
+				if (TryParseThemeColor(entry->key, &themeColor) && themeColor != ThemeColor_None &&
+					StrExactEquals(entry->key, MakeStr8Nt(GetThemeColorStr(themeColor))))
 				{
-					Str8 enumValueName = MakeStr8Nt(GetThemeColorStr((ThemeColor)cIndex));
-					if (StrExactEquals(entry->key, enumValueName)) { entry->isReferenced = true; break; }
+					entry->isReferenced = true;
 				}
 				if (!entry->isReferenced)
 				{
@@ -265,6 +462,49 @@ Result BakeTheme(ThemeDefinition* themeDef, ThemeMode mode, BakedTheme* themeOut
 		if (result == Result_None) { result = Result_Success; }
 	}
 	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+	return result;
+}
+
+// Bakes every ThemeMode (except ThemeMode_None) into themesOut[ThemeMode_Count] so switching modes doesn't require a bake.
+// If prevDef is given it must be a definition that was successfully baked in all modes. Only entries whose dependency closure touches a key that changed since prevDef are resolved again.
+// Otherwise the first mode is resolved fully and the other modes copy any entry that doesn't depend on mode-specific keys from it
+Result BakeThemeAllModes(ThemeDefinition* themeDef, const ThemeDefinition* prevDef, BakedTheme* themesOut)
+{
+	NotNull(themeDef);
+	NotNull(themesOut);
+	ProfZoneBegin(_funcZone, "BakeThemeAllModes");
+	ScratchBegin1(scratch, themeDef->arena);
+	
+	HashSet64 dirtyKeys;
+	InitHashSet64(scratch, &dirtyKeys, THEME_DEF_MIN_NUM_BUCKETS);
+	ThemeBakeReuseInfo reuseInfo = ZEROED;
+	reuseInfo.dirtyKeys = &dirtyKeys;
+	if (prevDef != nullptr)
+	{
+		FindChangedThemeDefKeys(prevDef, themeDef, &dirtyKeys);
+		reuseInfo.sourceDef = prevDef;
+	}
+	else
+	{
+		FindModeSpecificThemeDefKeys(themeDef, &dirtyKeys);
+		reuseInfo.sourceDef = themeDef;
+		reuseInfo.sourceMode = ThemeMode_Dark;
+	}
+	
+	Result result = Result_Success;
+	for (uxx mIndex = 1; mIndex < ThemeMode_Count; mIndex++)
+	{
+		ThemeMode mode = (ThemeMode)mIndex;
+		if (prevDef != nullptr) { reuseInfo.sourceMode = mode; }
+		bool canReuse = (prevDef != nullptr || mode != reuseInfo.sourceMode);
+		result = BakeTheme(themeDef, mode, canReuse ? &reuseInfo : nullptr, &themesOut[mIndex]);
+		if (result != Result_Success) { break; }
+	}
+	
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
 	return result;
 }
 
@@ -354,120 +594,116 @@ Result TryParseThemeFile(Str8 fileContents, ThemeDefinition* themeOut)
 				{
 					bool parsedFunction = false;
 					
-					for (uxx fIndex = 1; fIndex < ThemeDefFunc_Count; fIndex++)
+					Str8 functionName = StrSlice(token.value, 0, FindNextUnknownCharInStr(token.value, 0, StrLit(IDENTIFIER_CHARS)));
+					ThemeDefFunc function = ThemeDefFunc_None;
+					if (TryParseThemeDefFunc(functionName, &function))
 					{
-						ThemeDefFunc function = (ThemeDefFunc)fIndex;
-						Str8 functionName = MakeStr8Nt(GetThemeDefFuncStr(function));
-						if (StrAnyCaseStartsWith(token.value, functionName))
+						ThemeDefFuncArgInfo funcArgInfo = GetThemeDefFuncArgInfo(function);
+						
+						Str8 argsStr = TrimWhitespace(StrSliceFrom(token.value, functionName.length));
+						if (argsStr.length >= 2 && argsStr.chars[0] == '(' && argsStr.chars[argsStr.length-1] == ')')
 						{
-							ThemeDefFuncArgInfo funcArgInfo = GetThemeDefFuncArgInfo(function);
-							
-							Str8 argsStr = TrimWhitespace(StrSliceFrom(token.value, functionName.length));
-							if (argsStr.length >= 2 && argsStr.chars[0] == '(' && argsStr.chars[argsStr.length-1] == ')')
-							{
-								argsStr = TrimWhitespace(StrSlice(argsStr, 1, argsStr.length-1));
-							}
-							
-							uxx argIndex = 0;
-							ThemeDefFuncArgValue argValues[THEME_DEF_FUNC_MAX_ARGS];
-							bool parsedAllArguments = true;
-							uxx prevCommaIndex = 0;
-							for (uxx cIndex = 0; cIndex <= argsStr.length; cIndex++)
+							argsStr = TrimWhitespace(StrSlice(argsStr, 1, argsStr.length-1));
+						}
+						
+						uxx argIndex = 0;
+						ThemeDefFuncArgValue argValues[THEME_DEF_FUNC_MAX_ARGS];
+						bool parsedAllArguments = true;
+						uxx prevCommaIndex = 0;
+						for (uxx cIndex = 0; cIndex <= argsStr.length; cIndex++)
+						{
+							if (cIndex == argsStr.length || argsStr.chars[cIndex] == ',')
 							{
-								if (cIndex == argsStr.length || argsStr.chars[cIndex] == ',')
+								Str8 argStr = TrimWhitespace(StrSlice(argsStr, prevCommaIndex, cIndex));
+								if (argStr.length == 0) { return Result_EmptyArgument; }
+								if (argIndex >= funcArgInfo.argCount)
 								{
-									Str8 argStr = TrimWhitespace(StrSlice(argsStr, prevCommaIndex, cIndex));
-									if (argStr.length == 0) { return Result_EmptyArgument; }
-									if (argIndex >= funcArgInfo.argCount)
+									PrintLine_W("Too many arguments for function %.*s (expected %llu) on line %llu",
+										StrPrint(functionName),
+										funcArgInfo.argCount,
+										parser.lineParser.lineIndex
+									);
+									parsedAllArguments = false;
+									break;
+								}
+								
+								bool argParseSuccess = false;
+								Result argParseError = Result_None;
+								ThemeDefFuncArgType actualArgType = funcArgInfo.argType[argIndex];
+								switch (funcArgInfo.argType[argIndex])
+								{
+									case ThemeDefFuncArgType_U8: argParseSuccess = TryParseU8(argStr, &argValues[argIndex].valueU8, &argParseError); break;
+									case ThemeDefFuncArgType_I32: argParseSuccess = TryParseI32(argStr, &argValues[argIndex].valueI32, &argParseError); break;
+									case ThemeDefFuncArgType_R32: argParseSuccess = TryParseR32(argStr, &argValues[argIndex].valueR32, &argParseError); break;
+									case ThemeDefFuncArgType_Color:
 									{
-										PrintLine_W("Too many arguments for function %.*s (expected %llu) on line %llu",
-											StrPrint(functionName),
-											funcArgInfo.argCount,
-											parser.lineParser.lineIndex
-										);
-										parsedAllArguments = false;
-										break;
-									}
-									
-									bool argParseSuccess = false;
-									Result argParseError = Result_None;
-									ThemeDefFuncArgType actualArgType = funcArgInfo.argType[argIndex];
-									switch (funcArgInfo.argType[argIndex])
+										argParseSuccess = TryParseColor(argStr, &argValues[argIndex].valueColor, &argParseError);
+										
+										//NOTE: Color type parameters could be identifiers that get resolved during the baking process
+										if (!argParseSuccess && IsValidIdentifier(argStr.length, argStr.chars, false, false, false))
+										{
+											actualArgType = ThemeDefFuncArgType_Identifier;
+											argValues[argIndex].valueIdentifier = argStr;
+											argParseSuccess = true;
+										}
+									} break;
+									case ThemeDefFuncArgType_Identifier:
 									{
-										case ThemeDefFuncArgType_U8: argParseSuccess = TryParseU8(argStr, &argValues[argIndex].valueU8, &argParseError); break;
-										case ThemeDefFuncArgType_I32: argParseSuccess = TryParseI32(argStr, &argValues[argIndex].valueI32, &argParseError); break;
-										case ThemeDefFuncArgType_R32: argParseSuccess = TryParseR32(argStr, &argValues[argIndex].valueR32, &argParseError); break;
-										case ThemeDefFuncArgType_Color:
+										if (IsValidIdentifier(argStr.length, argStr.chars, false, false, false))
 										{
-											argParseSuccess = TryParseColor(argStr, &argValues[argIndex].valueColor, &argParseError);
-											
-											//NOTE: Color type parameters could be identifiers that get resolved during the baking process
-											if (!argParseSuccess && IsValidIdentifier(argStr.length, argStr.chars, false, false, false))
-											{
-												actualArgType = ThemeDefFuncArgType_Identifier;
-												argValues[argIndex].valueIdentifier = argStr;
-												argParseSuccess = true;
-											}
-										} break;
-										case ThemeDefFuncArgType_Identifier:
+											argValues[argIndex].valueIdentifier = argStr;
+											argParseSuccess = true;
+										}
+										else
 										{
-											if (IsValidIdentifier(argStr.length, argStr.chars, false, false, false))
-											{
-												argValues[argIndex].valueIdentifier = argStr;
-												argParseSuccess = true;
-											}
-											else
-											{
-												argParseError = Result_InvalidIdentifier;
-												argParseSuccess = false;
-											}
-											
-										} break;
-										default: Assert(false); break;
-									}
-									
-									if (argParseSuccess)
-									{
-										argValues[argIndex].type = actualArgType;
-									}
-									else
-									{
-										PrintLine_W("Couldn't parse function %.*s arg %llu as %s on line %llu: \"%.*s\" (Error: %s)",
-											StrPrint(functionName),
-											argIndex,
-											GetThemeDefFuncArgTypeStr(actualArgType),
-											parser.lineParser.lineIndex,
-											StrPrint(argStr),
-											GetResultStr(argParseError)
-										);
-										parsedAllArguments = false;
-										break;
-									}
-									
-									prevCommaIndex = cIndex+1;
-									argIndex++;
+											argParseError = Result_InvalidIdentifier;
+											argParseSuccess = false;
+										}
+										
+									} break;
+									default: Assert(false); break;
+								}
+								
+								if (argParseSuccess)
+								{
+									argValues[argIndex].type = actualArgType;
+								}
+								else
+								{
+									PrintLine_W("Couldn't parse function %.*s arg %llu as %s on line %llu: \"%.*s\" (Error: %s)",
+										StrPrint(functionName),
+										argIndex,
+										GetThemeDefFuncArgTypeStr(actualArgType),
+										parser.lineParser.lineIndex,
+										StrPrint(argStr),
+										GetResultStr(argParseError)
+									);
+									parsedAllArguments = false;
+									break;
 								}
+								
+								prevCommaIndex = cIndex+1;
+								argIndex++;
 							}
-							
-							if (parsedAllArguments && argIndex == GetThemeDefFuncArgCount(function))
+						}
+						
+						if (parsedAllArguments && argIndex == GetThemeDefFuncArgCount(function))
+						{
+							for (uxx sIndex = 0; sIndex < numThemeStates; sIndex++)
 							{
-								for (uxx sIndex = 0; sIndex < numThemeStates; sIndex++)
+								isNewEntry = AddThemeDefEntryFunction(themeOut, currentMode, themeStates[sIndex], strippedName, function, argIndex, &argValues[0]);
+								if (!isNewEntry)
 								{
-									isNewEntry = AddThemeDefEntryFunction(themeOut, currentMode, themeStates[sIndex], strippedName, function, argIndex, &argValues[0]);
-									if (!isNewEntry)
-									{
-										NotifyPrint_W("Duplicate entry in theme file for \"%.*s\"%s%s%s on line %llu",
-											StrPrint(strippedName),
-											(themeStates[sIndex] == ThemeState_Any ? "" : " ("),
-											(themeStates[sIndex] == ThemeState_Any ? "" : GetThemeStateStr(themeStates[sIndex])),
-											(themeStates[sIndex] == ThemeState_Any ? "" : ")"),
-											parser.lineParser.lineIndex
-										);
-									}
+									NotifyPrint_W("Duplicate entry in theme file for \"%.*s\"%s%s%s on line %llu",
+										StrPrint(strippedName),
+										(themeStates[sIndex] == ThemeState_Any ? "" : " ("),
+										(themeStates[sIndex] == ThemeState_Any ? "" : GetThemeStateStr(themeStates[sIndex])),
+										(themeStates[sIndex] == ThemeState_Any ? "" : ")"),
+										parser.lineParser.lineIndex
+									);
 								}
-								parsedFunction = true;
-								break;
 							}
+							parsedFunction = true;
 						}
 					}
 					
@@ -514,17 +750,18 @@ Result TryParseThemeFile(Str8 fileContents, ThemeDefinition* themeOut)
 	return Result_Success;
 }
 
-Result TryLoadThemeFile(FilePath filePath, ThemeDefinition* themeOut)
+Result TryLoadThemeFile(FilePath filePath, ThemeDefinition* themeOut, u64* fileHashOut)
 {
 	NotNull(themeOut);
 	NotNull(themeOut->arena);
 	ScratchBegin1(scratch, themeOut->arena);
 	Str8 fileContents = Str8_Empty;
-	if (!OsReadTextFile(filePath, scratch, &fileContents))
+	if (!AppReadTextFile(filePath, scratch, &fileContents))
 	{
 		ScratchEnd(scratch);
 		return Result_FailedToReadFile;
 	}
+	SetOptionalOutPntr(fileHashOut, HashStr8Fnv(fileContents));
 	Result result = TryParseThemeFile(fileContents, themeOut);
 	ScratchEnd(scratch);
 	return result;
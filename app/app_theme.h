@@ -9,6 +9,7 @@ Date:   12\10\2025
 
 #define DEFAULT_THEME_FILE_PATH "resources/text/default_theme.txt"
 #define NUM_ENTRIES_EXPECTED_IN_DEFAULT_THEME (40 + ThemeColor_Count*3) //this should be an overestimate
+#define THEME_DEF_MIN_NUM_BUCKETS 64 //must be a power of 2
 
 // The Theme_XList macro needs to be able to define all possible states for a color entry, thus we have this flag-style enum that maps to entries in the ThemeState enum
 typedef enum ThemeStateFlag ThemeStateFlag;
@@ -130,15 +131,23 @@ const char* GetThemeColorStr(ThemeColor enumValue)
 		default: return UNKNOWN_STR;
 	}
 }
+static NameTable ThemeColorNameTable = ZEROED;
+void InitThemeColorNameTable()
+{
+	const char* names[ThemeColor_Count] = {
+		"None",
+		#define X(EnumName, StateFlags) #EnumName,
+		Theme_XList(X)
+		#undef X
+	};
+	if (!InitNameTable(&ThemeColorNameTable, ThemeColor_Count, &names[0])) { AssertMsg(false, "Failed to build ThemeColor NameTable!"); }
+}
 bool TryParseThemeColor(Str8 themeColorStr, ThemeColor* colorOut)
 {
-	if (StrAnyCaseEquals(themeColorStr, StrLit("None"))) { SetOptionalOutPntr(colorOut, ThemeColor_None); return true; }
-	
-	#define X(EnumName, StateFlags) else if (StrAnyCaseEquals(themeColorStr, StrLit(#EnumName))) { SetOptionalOutPntr(colorOut, ThemeColor_##EnumName); return true; }
-	Theme_XList(X)
-	#undef X
-	
-	else { return false; }
+	uxx colorIndex = FindNameTableIndex(&ThemeColorNameTable, themeColorStr);
+	if (colorIndex == UINTXX_MAX) { return false; }
+	SetOptionalOutPntr(colorOut, (ThemeColor)colorIndex);
+	return true;
 }
 u8 GetThemeColorStateFlags(ThemeColor themeColor)
 {
@@ -151,6 +160,17 @@ u8 GetThemeColorStateFlags(ThemeColor themeColor)
 		default: return ThemeStateFlag_None;
 	}
 }
+// Every name and state flag in Theme_XList, in order. The theme cache stores its hash (see GetThemeColorListHash) since renaming
+// or reordering entries doesn't always change sizeof(BakedTheme)
+static const char ThemeColorListStr[] =
+	#define X(EnumName, StateFlags) #EnumName ":" #StateFlags ";"
+	Theme_XList(X)
+	#undef X
+	"";
+u64 GetThemeColorListHash()
+{
+	return HashStr8Fnv(MakeStr8Nt(ThemeColorListStr));
+}
 
 #undef S_None
 #undef S_Clickable
@@ -265,6 +285,23 @@ plex BakedTheme
 	BakedThemeEntry entries[ThemeColor_Count];
 };
 
+// The theme cache file is a ThemeCacheHeader followed by BakedTheme[ThemeMode_Count]
+// It lets us skip parsing and baking the theme files on startup if neither file has changed
+#define THEME_CACHE_MAGIC   0x43544343 //"CCTC"
+#define THEME_CACHE_VERSION 3
+#define THEME_MODES_ALL_MASK ((u32)(((u32)1 << ThemeMode_Count) - 2)) //bit per ThemeMode except ThemeMode_None
+typedef plex ThemeCacheHeader ThemeCacheHeader;
+plex ThemeCacheHeader
+{
+	u32 magic;
+	u32 version;
+	u32 bakedThemeSize; //sizeof(BakedTheme) changes whenever the ThemeColor or ThemeState enums change
+	u32 validModesMask; //bit per ThemeMode
+	u64 themeColorListHash; //GetThemeColorListHash, catches Theme_XList changes that keep the same size
+	u64 defaultThemeHash;
+	u64 userThemeHash; //0 if there are no user theme overrides
+};
+
 typedef enum ThemeDefEntryType ThemeDefEntryType;
 enum ThemeDefEntryType
 {
@@ -282,6 +319,9 @@ plex ThemeDefEntry
 	ThemeState state;
 	Str8 key;
 	
+	u64 keyHash;
+	uxx nextInBucket; //index+1 of the next entry in the same ThemeDefinition bucket (0 = end of chain)
+	
 	bool isResolved;
 	bool isReferenced;
 	
@@ -289,6 +329,8 @@ plex ThemeDefEntry
 	
 	//only filled if (type == ThemeDefEntryType_Color || isResolved)
 	Color32 color;
+	//filled by BakeTheme for each mode this entry was resolved in, so later bakes can reuse the result
+	Color32 bakedColors[ThemeMode_Count];
 	
 	//only filled if (type == ThemeDefEntryType_Reference)
 	Str8 referenceKey;
@@ -306,8 +348,34 @@ plex ThemeDefinition
 {
 	Arena* arena;
 	VarArray entries; //ThemeDefEntry
+	VarArray buckets; //uxx, index+1 of the first entry in each hash bucket (0 = empty bucket). Length is always a power of 2
+};
+
+// Passed to BakeTheme to skip resolving entries that we already have a result for in a previously baked definition (or a previously baked mode of the same definition)
+// Any entry whose key, or the key of anything in its dependency closure, is in dirtyKeys gets resolved from scratch
+typedef plex ThemeBakeReuseInfo ThemeBakeReuseInfo;
+plex ThemeBakeReuseInfo
+{
+	const ThemeDefinition* sourceDef;
+	ThemeMode sourceMode;
+	const HashSet64* dirtyKeys; //key hashes
 };
 
+// Relinks every entry into the bucket chains, growing the bucket array if needed so we stay at or below 1 entry per bucket on average
+void RebuildThemeDefIndex(ThemeDefinition* theme, uxx minNumBuckets)
+{
+	NotNull(theme);
+	NotNull(theme->arena);
+	ResetHashBuckets(&theme->buckets, minNumBuckets, THEME_DEF_MIN_NUM_BUCKETS);
+	VarArrayLoop(&theme->entries, eIndex)
+	{
+		VarArrayLoopGet(ThemeDefEntry, entry, &theme->entries, eIndex);
+		uxx* bucket = GetHashBucket(&theme->buckets, entry->keyHash);
+		entry->nextInBucket = *bucket;
+		*bucket = eIndex+1;
+	}
+}
+
 void FreeThemeDefEntryValue(ThemeDefinition* theme, ThemeDefEntry* entry)
 {
 	NotNull(theme);
@@ -345,22 +413,24 @@ void FreeThemeDefEntry(ThemeDefinition* theme, ThemeDefEntry* entry)
 
 ThemeDefEntry* FindThemeDefEntry(ThemeDefinition* theme, ThemeMode mode, bool allowModeNone, ThemeState state, bool allowStateAny, Str8 key)
 {
-	//TODO: We should probably sort the entry list and lookup entries using binary search!
-	//      In my testing so far this doesn't cause performance problems yet
-	//      It takes about 8ms to load default theme (which has 335 entries) on startup which is a minority of our load time
 	//TODO: We need to prioritize mode matches over state matches!
+	if (theme->buckets.length == 0) { return nullptr; }
+	u64 keyHash = HashStr8Fnv(key);
 	ThemeDefEntry* result = nullptr;
-	VarArrayLoop(&theme->entries, eIndex)
+	//NOTE: Bucket chains are walked in reverse order of the entries array, so the first None/Any match
+	// we find is the last one in the array, which is the entry that should win (later entries override earlier ones)
+	uxx entryIndexPlusOne = *GetHashBucket(&theme->buckets, keyHash);
+	while (entryIndexPlusOne != 0)
 	{
-		VarArrayLoopGet(ThemeDefEntry, entry, &theme->entries, eIndex);
-		if (StrExactEquals(entry->key, key))
+		ThemeDefEntry* entry = VarArrayGetHard(ThemeDefEntry, &theme->entries, entryIndexPlusOne-1);
+		if (entry->keyHash == keyHash && StrExactEquals(entry->key, key))
 		{
 			if (entry->mode == mode && entry->state == state)
 			{
 				result = entry;
 				break; //breaking early prioritizes exact matches over None/Any matches
 			}
-			else if (allowModeNone || allowStateAny)
+			else if (result == nullptr && (allowModeNone || allowStateAny))
 			{
 				if ((entry->mode == mode || (allowModeNone && entry->mode == ThemeMode_None)) &&
 					(entry->state == state || (allowStateAny && entry->state == ThemeState_Any)))
@@ -370,10 +440,36 @@ ThemeDefEntry* FindThemeDefEntry(ThemeDefinition* theme, ThemeMode mode, bool al
 				}
 			}
 		}
+		entryIndexPlusOne = entry->nextInBucket;
 	}
 	return result;
 }
 
+// Adds a new entry to the array and links it into the bucket index. Caller fills in the type and value
+ThemeDefEntry* AddThemeDefEntry(ThemeDefinition* theme, ThemeMode mode, ThemeState state, Str8 key)
+{
+	NotNull(theme);
+	NotNull(theme->arena);
+	ThemeDefEntry* newEntry = VarArrayAdd(ThemeDefEntry, &theme->entries);
+	NotNull(newEntry);
+	ClearPointer(newEntry);
+	newEntry->mode = mode;
+	newEntry->state = state;
+	newEntry->key = AllocStr8(theme->arena, key);
+	newEntry->keyHash = HashStr8Fnv(newEntry->key);
+	if (theme->entries.length > theme->buckets.length)
+	{
+		RebuildThemeDefIndex(theme, theme->entries.length*2);
+	}
+	else
+	{
+		uxx* bucket = GetHashBucket(&theme->buckets, newEntry->keyHash);
+		newEntry->nextInBucket = *bucket;
+		*bucket = theme->entries.length;
+	}
+	return newEntry;
+}
+
 // Returns false if an entry already existed and is getting overridden
 bool AddThemeDefEntryColor(ThemeDefinition* theme, ThemeMode mode, ThemeState state, Str8 key, Color32 color)
 {
@@ -387,12 +483,7 @@ bool AddThemeDefEntryColor(ThemeDefinition* theme, ThemeMode mode, ThemeState st
 		existingEntry->color = color;
 		return false;
 	}
-	ThemeDefEntry* newEntry = VarArrayAdd(ThemeDefEntry, &theme->entries);
-	NotNull(newEntry);
-	ClearPointer(newEntry);
-	newEntry->mode = mode;
-	newEntry->state = state;
-	newEntry->key = AllocStr8(theme->arena, key);
+	ThemeDefEntry* newEntry = AddThemeDefEntry(theme, mode, state, key);
 	newEntry->type = ThemeDefEntryType_Color;
 	newEntry->color = color;
 	return true;
@@ -410,12 +501,7 @@ bool AddThemeDefEntryReference(ThemeDefinition* theme, ThemeMode mode, ThemeStat
 		existingEntry->referenceKey = AllocStr8(theme->arena, referenceStr);
 		return false;
 	}
-	ThemeDefEntry* newEntry = VarArrayAdd(ThemeDefEntry, &theme->entries);
-	NotNull(newEntry);
-	ClearPointer(newEntry);
-	newEntry->mode = mode;
-	newEntry->state = state;
-	newEntry->key = AllocStr8(theme->arena, key);
+	ThemeDefEntry* newEntry = AddThemeDefEntry(theme, mode, state, key);
 	newEntry->type = ThemeDefEntryType_Reference;
 	newEntry->referenceKey = AllocStr8(theme->arena, referenceStr);
 	return true;
@@ -442,12 +528,7 @@ bool AddThemeDefEntryFunction(ThemeDefinition* theme, ThemeMode mode, ThemeState
 		}
 		return false;
 	}
-	ThemeDefEntry* newEntry = VarArrayAdd(ThemeDefEntry, &theme->entries);
-	NotNull(newEntry);
-	ClearPointer(newEntry);
-	newEntry->mode = mode;
-	newEntry->state = state;
-	newEntry->key = AllocStr8(theme->arena, key);
+	ThemeDefEntry* newEntry = AddThemeDefEntry(theme, mode, state, key);
 	newEntry->type = ThemeDefEntryType_Function;
 	newEntry->function = function;
 	newEntry->functionArgCount = numArgs;
@@ -85,6 +85,24 @@ const char* GetThemeDefFuncStr(ThemeDefFunc enumValue)
 		default: return UNKNOWN_STR;
 	}
 }
+static NameTable ThemeDefFuncNameTable = ZEROED;
+void InitThemeDefFuncNameTable()
+{
+	const char* names[ThemeDefFunc_Count] = {
+		nullptr,
+		#define X(FuncName, CFuncName, NumArgs, ArgStr) #FuncName,
+		ThemeDefFunc_XList(X)
+		#undef X
+	};
+	if (!InitNameTable(&ThemeDefFuncNameTable, ThemeDefFunc_Count, &names[0])) { AssertMsg(false, "Failed to build ThemeDefFunc NameTable!"); }
+}
+bool TryParseThemeDefFunc(Str8 functionName, ThemeDefFunc* functionOut)
+{
+	uxx functionIndex = FindNameTableIndex(&ThemeDefFuncNameTable, functionName);
+	if (functionIndex == UINTXX_MAX) { return false; }
+	SetOptionalOutPntr(functionOut, (ThemeDefFunc)functionIndex);
+	return true;
+}
 uxx GetThemeDefFuncArgCount(ThemeDefFunc enumValue)
 {
 	switch (enumValue)
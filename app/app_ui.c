@@ -52,6 +52,17 @@ void DoCSwitchAppUI(v2 screenSize)
 	);
 	
 	AppCalculateSmallButtonsGrid();
+	if (app->currentTab != nullptr)
+	{
+		//NOTE: AppChangeTab sets restoreScroll on the incoming tab, until then we keep track of the scroll so we can go back to it later
+		UiElement* optionsListElem = GetUiElementByIdInPrevFrame(UiIdLit("OptionsList"), true);
+		if (optionsListElem != nullptr && app->currentTab->restoreScroll)
+		{
+			SetUiElementScroll(UiIdLit("OptionsList"), MakeV2(-1, app->currentTab->scrollY), MakeV2(-1, app->currentTab->scrollY));
+			app->currentTab->restoreScroll = false;
+		}
+		else if (optionsListElem != nullptr) { app->currentTab->scrollY = optionsListElem->scroll.y; }
+	}
 	if (app->scrollToSelectedOption)
 	{
 		AutoScrollToSelectedOptionAfterMove();
@@ -85,6 +96,12 @@ void DoCSwitchAppUI(v2 screenSize)
 						app->isFileMenuOpen = false;
 					}
 					
+					if (UiDropdownBtn(UiIdLit("OpenFolderBtn"), true, AppIcon_OpenFile, StrLit("Open Folder" UNICODE_ELLIPSIS_STR), AppCommand_OpenFolder, StrLit("List the options of every source file in a folder")))
+					{
+						RunAppCommand(AppCommand_OpenFolder);
+						app->isFileMenuOpen = false;
+					}
+					
 					UiDropdownSubmenuBtn(UiIdLit("OpenRecentSubmenu"), (app->recentFiles.length > 0), AppIcon_OpenRecent, StrLit("Open Recent " UNICODE_RIGHT_ARROW_STR), &app->isOpenRecentSubmenuOpen, &app->keepOpenRecentSubmenuOpenUntilMouseOver)
 					{
 						VarArrayLoop(&app->recentFiles, fIndex)
@@ -316,6 +333,19 @@ void DoCSwitchAppUI(v2 screenSize)
 							.sizing = UI_TEXT_CLIP(0),
 							.renderer = { .textContraction = TextContraction_EllipseFilePath },
 						});
+						Str8 tuCountStr = GetIncludeGraphTuCountStr(uiArena, &app->includeGraph, app->currentTab);
+						if (!IsEmptyStr(tuCountStr))
+						{
+							UIELEM_LEAF({ .id = UiIdLit("FilePathTuCount"),
+								.text = tuCountStr,
+								.padding = { .outer={ .right=4 } },
+								.font = &app->uiFont,
+								.fontSize = app->uiFontSize,
+								.fontStyle = UI_FONT_STYLE,
+								.textColor = GetThemeColor(TopbarPathText),
+								.sizing = UI_TEXT_FULL(),
+							});
+						}
 					}
 				}
 			}
@@ -377,6 +407,20 @@ void DoCSwitchAppUI(v2 screenSize)
 							.sizing = UI_TEXT_FULL(),
 							.renderer = { .textContraction = TextContraction_EllipseRight },
 						});
+						// How many translation units include this file, see app_include_graph.c
+						Str8 tuCountStr = GetIncludeGraphTuCountStr(uiArena, &app->includeGraph, tab);
+						if (!IsEmptyStr(tuCountStr))
+						{
+							UIELEM_LEAF({ .id = UiIdLitIndex("TabTuCount", tIndex),
+								.text = tuCountStr,
+								.padding = { .outer={ .left=6 } },
+								.font = &app->uiFont,
+								.fontSize = app->uiFontSize,
+								.fontStyle = UI_FONT_STYLE,
+								.textColor = textColor,
+								.sizing = UI_TEXT_FULL(),
+							});
+						}
 						
 						if (isHovered && MouseLeftClicked())
 						{
@@ -394,6 +438,29 @@ void DoCSwitchAppUI(v2 screenSize)
 			}
 		}
 		
+		// +==============================+
+		// |        Options Filter        |
+		// +==============================+
+		if (app->currentTab != nullptr && (!app->minimalModeEnabled || IsOptionsFilterActive()))
+		{
+			UIELEM({ .id = UiIdLit("OptionsFilterContainer"),
+				.direction = UiLayoutDir_LeftToRight,
+				.sizing = { .width=UI_EXPAND(), .height=UI_FIT() },
+				.padding = { .inner = MakeV4(4, 4, 4, 0) },
+			})
+			{
+				if (UiEditableText(UiIdLit("OptionsFilter"), &app->optionsFilter, StrLit("Filter options")))
+				{
+					app->optionsFilter.isFocused = true;
+					EditTextResetCursorBlink(&app->optionsFilter);
+				}
+				else if (app->optionsFilter.isFocused && MouseLeftClicked())
+				{
+					app->optionsFilter.isFocused = false;
+				}
+			}
+		}
+		
 		// +==============================+
 		// |         Options List         |
 		// +==============================+
@@ -412,38 +479,56 @@ void DoCSwitchAppUI(v2 screenSize)
 			{
 				if (app->currentTab != nullptr)
 				{
+					//NOTE: When the filter is active we walk visibleOptions instead of every option, and the empty line gaps are dropped since neighboring options are usually hidden
+					uxx numVisibleOptions = GetNumVisibleOptions();
+					bool isFilterActive = IsOptionsFilterActive();
+					if (isFilterActive && numVisibleOptions == 0)
+					{
+						UIELEM_LEAF({
+							.text = StrLit("No matching options"),
+							.font = &app->uiFont,
+							.fontSize = app->uiFontSize,
+							.fontStyle = UI_FONT_STYLE,
+							.textColor = ColorWithAlpha(GetThemeColor(ConfirmDialogText), 0.5f),
+							.sizing = UI_TEXT_FULL(),
+						});
+					}
+					
 					// +==============================+
 					// |        Large Options         |
 					// +==============================+
 					if (app->settings.smallButtons == false)
 					{
-						VarArrayLoop(&app->currentTab->fileOptions, oIndex)
+						for (uxx vIndex = 0; vIndex < numVisibleOptions; vIndex++)
 						{
-							VarArrayLoopGet(FileOption, option, &app->currentTab->fileOptions, oIndex);
+							uxx oIndex = GetVisibleOptionIndex(vIndex);
+							FileOption* option = VarArrayGetHard(FileOption, &app->currentTab->fileOptions, oIndex);
 							bool isOptionSelected = (app->usingKeyboardToSelect && app->currentTab->selectedOptionIndex >= 0 && (uxx)app->currentTab->selectedOptionIndex == oIndex);
+							Str8 usageStr = GetUsageIndexCountStr(uiArena, &app->usageIndex, option->name);
+							Str8 sourceStr = GetOptionSourceStr(app->currentTab, oIndex);
 							
 							if (option->type == FileOptionType_Bool)
 							{
-								if (UiOptionBtn(UiIdStrIndex(option->name, oIndex), option->name, option->valueStr, option->valueBool, isOptionSelected))
+								if (UiOptionBtn(option->btnId, option->displayName, usageStr, sourceStr, option->valueStr, option->valueBool, isOptionSelected, option->isInactive))
 								{
 									ToggleOption(app->currentTab, option);
 								}
 							}
 							else if (option->type == FileOptionType_CommentDefine)
 							{
-								if (UiOptionBtn(UiIdStrIndex(option->name, oIndex), ScratchPrintStr("%s%.*s", option->isUncommented ? "" : "// ", StrPrint(option->name)), Str8_Empty, option->isUncommented, isOptionSelected))
+								if (UiOptionBtn(option->btnId, option->displayName, usageStr, sourceStr, Str8_Empty, option->isUncommented, isOptionSelected, option->isInactive))
 								{
 									ToggleOption(app->currentTab, option);
 								}
 							}
 							else
 							{
-								if (UiOptionBtn(UiIdStrIndex(option->name, oIndex), option->name, StrLit("-"), false, isOptionSelected))
+								if (UiOptionBtn(option->btnId, option->displayName, usageStr, sourceStr, StrLit("-"), false, isOptionSelected, option->isInactive))
 								{
 									ToggleOption(app->currentTab, option);
 								}
 							}
-							if (option->numEmptyLinesAfter > 0)
+							if (option->numEmptyLinesAfter > 0 && !isFilterActive)
 							{
 								UIELEM_LEAF({
 									.sizing = { .height=UI_FIXED((r32)option->numEmptyLinesAfter * LINE_BREAK_EXTRA_UI_GAP) },
@@ -457,12 +542,13 @@ void DoCSwitchAppUI(v2 screenSize)
 					else
 					{
 						bool containerStarted = false;
-						VarArrayLoop(&app->currentTab->fileOptions, oIndex)
+						for (uxx vIndex = 0; vIndex < numVisibleOptions; vIndex++)
 						{
-							VarArrayLoopGet(FileOption, option, &app->currentTab->fileOptions, oIndex);
+							uxx oIndex = GetVisibleOptionIndex(vIndex);
+							FileOption* option = VarArrayGetHard(FileOption, &app->currentTab->fileOptions, oIndex);
 							bool isOptionSelected = (app->usingKeyboardToSelect && app->currentTab->selectedOptionIndex >= 0 && (uxx)app->currentTab->selectedOptionIndex == oIndex);
 							
-							if ((oIndex % app->smallBtnNumColumns) == 0)
+							if ((vIndex % app->smallBtnNumColumns) == 0)
 							{
 								if (containerStarted) { CloseUiElement(); }
 								OpenUiElement((UiElemConfig){
@@ -476,21 +562,21 @@ void DoCSwitchAppUI(v2 screenSize)
 							
 							if (option->type == FileOptionType_Bool)
 							{
-								if (UiSmallOptionBtn(UiIdStrIndex(option->name, oIndex), option->abbreviation, option->valueBool, isOptionSelected, app->smallBtnWidth))
+								if (UiSmallOptionBtn(option->btnId, option->abbreviation, option->valueBool, isOptionSelected, option->isInactive, app->smallBtnWidth))
 								{
 									ToggleOption(app->currentTab, option);
 								}
 							}
 							else if (option->type == FileOptionType_CommentDefine)
 							{
-								if (UiSmallOptionBtn(UiIdStrIndex(option->name, oIndex), option->abbreviation, option->isUncommented, isOptionSelected, app->smallBtnWidth))
+								if (UiSmallOptionBtn(option->btnId, option->abbreviation, option->isUncommented, isOptionSelected, option->isInactive, app->smallBtnWidth))
 								{
 									ToggleOption(app->currentTab, option);
 								}
 							}
 							else
 							{
-								if (UiSmallOptionBtn(UiIdStrIndex(option->name, oIndex), option->abbreviation, false, isOptionSelected, app->smallBtnWidth))
+								if (UiSmallOptionBtn(option->btnId, option->abbreviation, false, isOptionSelected, option->isInactive, app->smallBtnWidth))
 								{
 									ToggleOption(app->currentTab, option);
 								}
@@ -504,6 +590,8 @@ void DoCSwitchAppUI(v2 screenSize)
 	}
 	
 	DoUiNotificationQueue(&app->notificationQueue, &app->uiFont, app->uiFontSize, UI_FONT_STYLE, RoundV2i(screenSize), NOTIFICATION_DEPTH);
+	RenderFolderScan(&app->folderScan);
+	RenderCommandPalette(&app->palette);
 	RenderPopupDialog(&app->popup);
 	
 	RenderPigUi(GetUiRenderList());
@@ -1084,7 +1172,7 @@ void DoCSwitchAppUI(v2 screenSize)
 							}
 							else if (option->type == FileOptionType_CommentDefine)
 							{
-								if (ClayOptionBtn(optionsContainerId, option->name, oIndex, ScratchPrintStr("%s%.*s", option->isUncommented ? "" : "// ", StrPrint(option->name)), Str8_Empty, option->isUncommented, isOptionSelected))
+								if (ClayOptionBtn(optionsContainerId, option->name, oIndex, option->displayName, Str8_Empty, option->isUncommented, isOptionSelected))
 								{
 									ToggleOption(app->currentTab, option);
 								}
@@ -49,7 +49,10 @@ void RenderPigUi(UiRenderList* renderList)
 				}
 				else
 				{
-					if (cmd->rectangle.texture != nullptr)
+					//TODO: These tessellate every corner on the CPU, which dominates render time with thousands of small buttons.
+					// An instanced path (one quad per rectangle, corners and borders evaluated as an SDF in the fragment shader) needs
+					// its own program in main2d_shader.glsl and main2d_shader.glsl.h regenerated with sokol-shdc (BUILD_SHADERS) alongside it
+					if (cmd->rectangle.texture == nullptr)
 					{
 						DrawRoundedRectangleEx(cmd->rectangle.rectangle,
 							cmd->rectangle.cornerRadius.topLeft, cmd->rectangle.cornerRadius.topRight, cmd->rectangle.cornerRadius.bottomRight, cmd->rectangle.cornerRadius.bottomLeft,
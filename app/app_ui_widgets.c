@@ -267,7 +267,10 @@ bool UiDropdownSubmenuBtn_(UiId btnId, bool isEnabled, AppIcon appIcon, Str8 dis
 }
 #define UiDropdownSubmenuBtn(...) DeferIfBlockCondEnd(UiDropdownSubmenuBtn_(__VA_ARGS__), CloseUiElement())
 
-bool UiOptionBtn(UiId btnId, Str8 nameStr, Str8 valueStr, bool enabled, bool isSelected)
+// usageStr is shown in front of the value, it's empty when there is no usage index (see app_usage_index.c)
+// isInactive dims the text of options that sit in an #if branch that is turned off (see app_conditionals.c)
+// sourceStr is where the option's final value comes from when another file overrides it (see app_define_resolver.c)
+bool UiOptionBtn(UiId btnId, Str8 nameStr, Str8 usageStr, Str8 sourceStr, Str8 valueStr, bool enabled, bool isSelected, bool isInactive)
 {
 	bool isHovered = IsUiElementHovered(btnId);
 	bool isPressed = (isHovered && IsMouseDownRaw(MouseBtn_Left));
@@ -277,11 +280,16 @@ bool UiOptionBtn(UiId btnId, Str8 nameStr, Str8 valueStr, bool enabled, bool isS
 	Color32 borderColor     = enabled ? GetThemeColorEx(OptionOnBorder,    btnThemeState) : GetThemeColorEx(OptionOffBorder,    btnThemeState);
 	Color32 nameTextColor   = enabled ? GetThemeColorEx(OptionOnNameText,  btnThemeState) : GetThemeColorEx(OptionOffNameText,  btnThemeState);
 	Color32 valueTextColor  = enabled ? GetThemeColorEx(OptionOnValueText, btnThemeState) : GetThemeColorEx(OptionOffValueText, btnThemeState);
+	if (isInactive)
+	{
+		nameTextColor = ColorWithAlpha(nameTextColor, INACTIVE_OPTION_ALPHA);
+		valueTextColor = ColorWithAlpha(valueTextColor, INACTIVE_OPTION_ALPHA);
+	}
 	
 	UIELEM({ .id = btnId,
 		.direction = UiLayoutDir_LeftToRight,
 		.sizing = { .width=UI_EXPAND(), .height=UI_FIT() },
-		.padding = { .inner=FillV4(4) },
+		.padding = { .inner=FillV4(4), .child=8 },
 		.color = backgroundColor,
 		.borderColor = borderColor,
 		.borderThickness = FillV4(2),
@@ -299,6 +307,28 @@ bool UiOptionBtn(UiId btnId, Str8 nameStr, Str8 valueStr, bool enabled, bool isS
 			.renderer = { .textContraction = (app->settings.clipNamesLeft ? TextContraction_EllipseLeft : TextContraction_EllipseRight) },
 		});
 		UIEXPANDER_HORI();
+		if (!IsEmptyStr(sourceStr))
+		{
+			UIELEM_LEAF({ .id = UiIdSuffixLit(btnId, "_Source"),
+				.sizing = UI_TEXT_FULL(),
+				.text = sourceStr,
+				.textColor = valueTextColor,
+				.font = &app->uiFont,
+				.fontSize = app->uiFontSize,
+				.fontStyle = UI_FONT_STYLE,
+			});
+		}
+		if (!IsEmptyStr(usageStr))
+		{
+			UIELEM_LEAF({ .id = UiIdSuffixLit(btnId, "_Usage"),
+				.sizing = UI_TEXT_FULL(),
+				.text = usageStr,
+				.textColor = valueTextColor,
+				.font = &app->uiFont,
+				.fontSize = app->uiFontSize,
+				.fontStyle = UI_FONT_STYLE,
+			});
+		}
 		UIELEM_LEAF({ .id = UiIdSuffixLit(btnId, "_Value"),
 			.sizing = UI_TEXT_FULL(),
 			.text = valueStr,
@@ -312,15 +342,16 @@ bool UiOptionBtn(UiId btnId, Str8 nameStr, Str8 valueStr, bool enabled, bool isS
 	return (isHovered && MouseLeftClicked());
 }
 
-bool UiSmallOptionBtn(UiId btnId, Str8 abbrevStr, bool enabled, bool isSelected, r32 buttonWidth)
+bool UiSmallOptionBtn(UiId btnId, Str8 abbrevStr, bool enabled, bool isSelected, bool isInactive, r32 buttonWidth)
 {
 	bool isHovered = IsUiElementHovered(btnId);
 	bool isPressed = (isHovered && IsMouseDownRaw(MouseBtn_Left));
-
+	
 	ThemeState btnThemeState = isPressed ? ThemeState_Pressed : (isSelected ? ThemeState_Selected : (isHovered ? ThemeState_Hovered : ThemeState_Default));
 	Color32 backgroundColor = enabled ? GetThemeColorEx(OptionOnBack,      btnThemeState) : GetThemeColorEx(OptionOffBack,      btnThemeState);
 	Color32 borderColor     = enabled ? GetThemeColorEx(OptionOnBorder,    btnThemeState) : GetThemeColorEx(OptionOffBorder,    btnThemeState);
 	Color32 nameTextColor   = enabled ? GetThemeColorEx(OptionOnNameText,  btnThemeState) : GetThemeColorEx(OptionOffNameText,  btnThemeState);
+	if (isInactive) { nameTextColor = ColorWithAlpha(nameTextColor, INACTIVE_OPTION_ALPHA); }
 	
 	UIELEM({ .id = btnId,
 		.direction = UiLayoutDir_LeftToRight,
@@ -346,4 +377,71 @@ bool UiSmallOptionBtn(UiId btnId, Str8 abbrevStr, bool enabled, bool isSelected,
 	return (isHovered && MouseLeftClicked());
 }
 
+// Draws the text of an EditableText with a cursor, or hintStr while it's empty. Input is handled separately by EditTextHandleKeyboardInput
+// Returns true if the box was clicked
+bool UiEditableText(UiId boxId, EditableText* editText, Str8 hintStr)
+{
+	NotNull(editText);
+	bool isHovered = IsUiElementHovered(boxId);
+	Color32 textColor = GetThemeColor(ConfirmDialogText);
+	
+	UIELEM({ .id = boxId,
+		.direction = UiLayoutDir_LeftToRight,
+		.sizing = { .width=UI_EXPAND(), .height=UI_FIT() },
+		.alignment = UI_ALIGN_LEFT_CENTER(),
+		.padding = { .inner=FillV4(4) },
+		.color = GetThemeColor(OptionListBack),
+		.borderColor = GetThemeColorEx(ConfirmDialogBorder, (editText->isFocused || isHovered) ? ThemeState_Hovered : ThemeState_Default),
+		.borderThickness = FillV4(1),
+		.cornerRadius = FillV4(4),
+	})
+	{
+		Str8 beforeCursor = StrSlice(editText->str, 0, editText->cursorEnd);
+		Str8 afterCursor = StrSliceFrom(editText->str, editText->cursorEnd);
+		if (!IsEmptyStr(beforeCursor))
+		{
+			UIELEM_LEAF({
+				.text = beforeCursor,
+				.font = &app->uiFont,
+				.fontSize = app->uiFontSize,
+				.fontStyle = UI_FONT_STYLE,
+				.textColor = textColor,
+				.sizing = UI_TEXT_FULL(),
+			});
+		}
+		if (editText->isFocused)
+		{
+			UIELEM_LEAF({ .id = UiIdSuffixLit(boxId, "_Cursor"),
+				.sizing = { .width=UI_FIXED(1), .height=UI_FIXED(app->uiFontSize) },
+				.color = textColor,
+			});
+		}
+		if (!IsEmptyStr(afterCursor))
+		{
+			UIELEM_LEAF({
+				.text = afterCursor,
+				.font = &app->uiFont,
+				.fontSize = app->uiFontSize,
+				.fontStyle = UI_FONT_STYLE,
+				.textColor = textColor,
+				.sizing = UI_TEXT_FULL(),
+			});
+		}
+		if (IsEmptyStr(editText->str))
+		{
+			UIELEM_LEAF({
+				.text = hintStr,
+				.font = &app->uiFont,
+				.fontSize = app->uiFontSize,
+				.fontStyle = UI_FONT_STYLE,
+				.textColor = ColorWithAlpha(textColor, 0.5f),
+				.sizing = UI_TEXT_CLIP(0),
+				.renderer = { .textContraction = TextContraction_EllipseRight },
+			});
+		}
+	}
+	
+	return (isHovered && MouseLeftClicked());
+}
+
 #endif //BUILD_WITH_PIG_UI
\ No newline at end of file
@@ -0,0 +1,977 @@
+/*
+File:   app_usage_index.c
+Description:
+	** The usage index answers "how much code does this define gate?" for the option buttons. It maps every
+	** name that appears in a #if, #ifdef, #ifndef or #elif (including inside defined()) to the files and lines
+	** that mention it, across the folder that was last opened with Open Folder.
+	** The full build rides along with the folder scan: the scan workers already read every source file in parallel
+	** so they also run TokenizePreprocessorLines and hand the mentions over with the rest of their results.
+	** After that the index is kept up to date incrementally. Every FileWatch that fires (open tabs, the headers they
+	** include, ...) and every file we write ourselves is queued, and the worker thread re-tokenizes only those files.
+	** Files nothing watches are caught by a sweep, which compares the write time of every indexed file and walks the
+	** folder for files that aren't indexed yet. A sweep runs after the index is loaded and when the window regains
+	** focus (the user is probably back from their editor), at most every USAGE_INDEX_SWEEP_PERIOD.
+	** The thread is started with the first job and blocks on wakeSignal between jobs.
+	** NOTE: StopUsageIndexThread must be called before the app closes or the dll is reloaded
+	** The index is saved to usage_index.bin in the settings folder so the counts are there on the next startup.
+	** The #include lines of every file are kept here as well since they come from the same pass, the include
+	** graph (see app_include_graph.c) is computed from them.
+*/
+
+#define USAGE_INDEX_MAGIC   0x49554343 //"CCUI"
+#define USAGE_INDEX_VERSION 2
+
+// usage_index.bin is a UsageIndexHeader and the root path, then numFiles of UsageIndexFileRecord + path + (u32 length + chars)[numIncludes],
+// then numNames of UsageIndexNameRecord + name + UsageIndexRef[numRefs]
+typedef plex UsageIndexHeader UsageIndexHeader;
+plex UsageIndexHeader
+{
+	u32 magic;
+	u32 version;
+	u32 writeTimeSize;
+	u32 refSize;
+	u64 rootPathLength;
+	u64 numFiles;
+	u64 numNames;
+};
+typedef plex UsageIndexFileRecord UsageIndexFileRecord;
+plex UsageIndexFileRecord
+{
+	u64 pathLength;
+	u64 numIncludes;
+	OsFileWriteTime writeTime; //only meaningful on the machine that wrote the file, which is the only one that reads it
+};
+typedef plex UsageIndexNameRecord UsageIndexNameRecord;
+plex UsageIndexNameRecord
+{
+	u64 nameLength;
+	u64 numRefs;
+};
+
+// +--------------------------------------------------------------+
+// |                          Tokenizer                           |
+// +--------------------------------------------------------------+
+bool IsUsageIdentifierChar(char c, bool isFirstChar)
+{
+	if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_') { return true; }
+	return (!isFirstChar && c >= '0' && c <= '9');
+}
+
+// Adds a mention for every identifier in one physical line of a directive's expression. Returns true if the line ends in a '\' continuation
+bool AddDefineMentionsInLine(Str8 line, u32 lineNum, bool onlyFirst, uxx firstMentionIndex, VarArray* mentionsOut)
+{
+	uxx cIndex = 0;
+	while (cIndex < line.length)
+	{
+		char c = line.chars[cIndex];
+		if (c == '/' && cIndex+1 < line.length && line.chars[cIndex+1] == '/') { break; }
+		else if (c == '/' && cIndex+1 < line.length && line.chars[cIndex+1] == '*')
+		{
+			cIndex += 2;
+			while (cIndex+1 < line.length && !(line.chars[cIndex] == '*' && line.chars[cIndex+1] == '/')) { cIndex++; }
+			cIndex += 2;
+		}
+		else if (c == '\'' || c == '"')
+		{
+			cIndex++;
+			while (cIndex < line.length && line.chars[cIndex] != c) { cIndex += (line.chars[cIndex] == '\\') ? 2 : 1; }
+			cIndex++;
+		}
+		else if (c >= '0' && c <= '9')
+		{
+			//Numbers can have suffixes (10ULL, 0x1F) that shouldn't be read as identifiers
+			while (cIndex < line.length && (IsUsageIdentifierChar(line.chars[cIndex], false) || line.chars[cIndex] == '.')) { cIndex++; }
+		}
+		else if (IsUsageIdentifierChar(c, true))
+		{
+			uxx nameStart = cIndex;
+			while (cIndex < line.length && IsUsageIdentifierChar(line.chars[cIndex], false)) { cIndex++; }
+			Str8 name = StrSlice(line, nameStart, cIndex);
+			if (StrExactStartsWith(name, StrLit("__has_")))
+			{
+				//__has_include(<some/file.h>) and friends take arguments that aren't defines
+				while (cIndex < line.length && line.chars[cIndex] != ')') { cIndex++; }
+				continue;
+			}
+			if (StrExactEquals(name, StrLit("defined")) || StrExactEquals(name, StrLit("true")) || StrExactEquals(name, StrLit("false"))) { continue; }
+			
+			bool isDuplicate = false;
+			for (uxx mIndex = firstMentionIndex; mIndex < mentionsOut->length; mIndex++)
+			{
+				if (StrExactEquals(VarArrayGetHard(UsageIndexMention, mentionsOut, mIndex)->name, name)) { isDuplicate = true; break; }
+			}
+			if (!isDuplicate)
+			{
+				UsageIndexMention* newMention = VarArrayAdd(UsageIndexMention, mentionsOut);
+				NotNull(newMention);
+				newMention->name = name;
+				newMention->lineNum = lineNum;
+			}
+			if (onlyFirst) { return false; }
+		}
+		else { cIndex++; }
+	}
+	Str8 trimmedLine = TrimWhitespace(line);
+	return (trimmedLine.length > 0 && trimmedLine.chars[trimmedLine.length-1] == '\\');
+}
+
+// Finds every define name that a conditional directive depends on, and the target of every #include. The strings put in
+// mentionsOut and includesOut are slices of fileContents. The includes keep their opening '"' or '<' so we know how to search for them.
+// Nothing here touches app state so the folder scan workers call this from their threads
+void TokenizePreprocessorLines(Str8 fileContents, VarArray* mentionsOut, VarArray* includesOut)
+{
+	NotNull(mentionsOut);
+	NotNull(includesOut);
+	u32 lineNum = 0;
+	uxx cIndex = 0;
+	while (cIndex < fileContents.length)
+	{
+		uxx lineStart = cIndex;
+		while (cIndex < fileContents.length && fileContents.chars[cIndex] != '\n') { cIndex++; }
+		Str8 line = TrimWhitespace(StrSlice(fileContents, lineStart, cIndex));
+		if (cIndex < fileContents.length) { cIndex++; }
+		lineNum++;
+		if (line.length == 0 || line.chars[0] != '#') { continue; }
+		
+		uxx dIndex = 1;
+		while (dIndex < line.length && IsCharWhitespace(line.chars[dIndex], false)) { dIndex++; }
+		uxx directiveStart = dIndex;
+		while (dIndex < line.length && IsUsageIdentifierChar(line.chars[dIndex], false)) { dIndex++; }
+		Str8 directive = StrSlice(line, directiveStart, dIndex);
+		if (StrExactEquals(directive, StrLit("include")))
+		{
+			Str8 target = TrimWhitespace(StrSliceFrom(line, dIndex));
+			char closeChar = (target.length > 0 && target.chars[0] == '<') ? '>' : '"';
+			if (target.length > 0 && (target.chars[0] == '<' || target.chars[0] == '"'))
+			{
+				uxx closeIndex = 1;
+				while (closeIndex < target.length && target.chars[closeIndex] != closeChar) { closeIndex++; }
+				//NOTE: Includes of a macro (#include SOME_HEADER) are skipped, we don't know what they expand to
+				if (closeIndex < target.length && closeIndex > 1)
+				{
+					Str8* newInclude = VarArrayAdd(Str8, includesOut);
+					NotNull(newInclude);
+					*newInclude = StrSlice(target, 0, closeIndex);
+				}
+			}
+			continue;
+		}
+		bool takesName = (StrExactEquals(directive, StrLit("ifdef")) || StrExactEquals(directive, StrLit("ifndef")) ||
+			StrExactEquals(directive, StrLit("elifdef")) || StrExactEquals(directive, StrLit("elifndef")));
+		bool takesExpression = (StrExactEquals(directive, StrLit("if")) || StrExactEquals(directive, StrLit("elif")));
+		if (!takesName && !takesExpression) { continue; }
+		
+		u32 directiveLineNum = lineNum;
+		uxx firstMentionIndex = mentionsOut->length;
+		bool continues = AddDefineMentionsInLine(StrSliceFrom(line, dIndex), directiveLineNum, takesName, firstMentionIndex, mentionsOut);
+		while (continues && cIndex < fileContents.length)
+		{
+			lineStart = cIndex;
+			while (cIndex < fileContents.length && fileContents.chars[cIndex] != '\n') { cIndex++; }
+			Str8 nextLine = StrSlice(fileContents, lineStart, cIndex);
+			if (cIndex < fileContents.length) { cIndex++; }
+			lineNum++;
+			continues = AddDefineMentionsInLine(nextLine, directiveLineNum, takesName, firstMentionIndex, mentionsOut);
+		}
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                          Name Table                          |
+// +--------------------------------------------------------------+
+UsageIndexName* FindUsageIndexName(const UsageIndex* index, Str8 name)
+{
+	NotNull(index);
+	if (index->nameSlots.length == 0) { return nullptr; }
+	u32 hash = (u32)HashStr8Fnv(name);
+	uxx slotMask = index->nameSlots.length-1;
+	for (uxx probe = 0; probe < index->nameSlots.length; probe++)
+	{
+		u32 slotValue = *VarArrayGetHard(u32, &index->nameSlots, (hash + probe) & slotMask);
+		if (slotValue == 0) { return nullptr; }
+		UsageIndexName* entry = VarArrayGetHard(UsageIndexName, &index->names, slotValue-1);
+		if (entry->hash == hash && StrExactEquals(entry->name, name)) { return entry; }
+	}
+	return nullptr;
+}
+
+void RebuildUsageIndexSlots(UsageIndex* index, uxx numSlots)
+{
+	NotNull(index);
+	Assert(numSlots > 0 && (numSlots & (numSlots-1)) == 0);
+	VarArrayClear(&index->nameSlots);
+	u32* slots = VarArrayAddMulti(u32, &index->nameSlots, numSlots);
+	NotNull(slots);
+	MyMemSet(slots, 0x00, sizeof(u32) * numSlots);
+	VarArrayLoop(&index->names, nIndex)
+	{
+		VarArrayLoopGet(UsageIndexName, entry, &index->names, nIndex);
+		uxx slotIndex = entry->hash & (numSlots-1);
+		while (slots[slotIndex] != 0) { slotIndex = (slotIndex+1) & (numSlots-1); }
+		slots[slotIndex] = (u32)(nIndex+1);
+	}
+}
+
+u32 FindOrAddUsageIndexName(UsageIndex* index, Str8 name)
+{
+	NotNull(index);
+	UsageIndexName* existingEntry = FindUsageIndexName(index, name);
+	if (existingEntry != nullptr)
+	{
+		uxx existingIndex = 0;
+		bool foundIndex = VarArrayGetIndexOf(UsageIndexName, &index->names, existingEntry, &existingIndex);
+		Assert(foundIndex);
+		return (u32)existingIndex;
+	}
+	
+	UsageIndexName* newEntry = VarArrayAdd(UsageIndexName, &index->names);
+	NotNull(newEntry);
+	ClearPointer(newEntry);
+	newEntry->name = AllocStr8(index->arena, name);
+	newEntry->hash = (u32)HashStr8Fnv(name);
+	InitVarArray(UsageIndexRef, &newEntry->refs, index->arena);
+	//NOTE: Keep the table at most half full so probes stay short
+	if (index->names.length * 2 > index->nameSlots.length)
+	{
+		uxx numSlots = MaxUXX(index->nameSlots.length * 2, USAGE_INDEX_MIN_SLOTS);
+		while (index->names.length * 2 > numSlots) { numSlots *= 2; }
+		RebuildUsageIndexSlots(index, numSlots);
+	}
+	else
+	{
+		uxx slotMask = index->nameSlots.length-1;
+		uxx slotIndex = newEntry->hash & slotMask;
+		while (*VarArrayGetHard(u32, &index->nameSlots, slotIndex) != 0) { slotIndex = (slotIndex+1) & slotMask; }
+		*VarArrayGetHard(u32, &index->nameSlots, slotIndex) = (u32)index->names.length;
+	}
+	return (u32)(index->names.length-1);
+}
+
+// Replaces all the refs that a file has with the given mentions
+void SetUsageIndexFileMentions(UsageIndex* index, uxx fileIndex, const VarArray* mentions)
+{
+	NotNull(index);
+	UsageIndexFile* file = VarArrayGetHard(UsageIndexFile, &index->files, fileIndex);
+	VarArrayLoop(&file->nameIndices, iIndex)
+	{
+		VarArrayLoopGet(u32, nameIndex, &file->nameIndices, iIndex);
+		UsageIndexName* entry = VarArrayGetHard(UsageIndexName, &index->names, *nameIndex);
+		for (uxx rIndex = entry->refs.length; rIndex > 0; rIndex--)
+		{
+			if (VarArrayGetHard(UsageIndexRef, &entry->refs, rIndex-1)->fileIndex == (u32)fileIndex) { VarArrayRemoveAt(UsageIndexRef, &entry->refs, rIndex-1); }
+		}
+	}
+	VarArrayClear(&file->nameIndices);
+	
+	if (mentions != nullptr)
+	{
+		VarArrayLoop(mentions, mIndex)
+		{
+			VarArrayLoopGet(UsageIndexMention, mention, mentions, mIndex);
+			u32 nameIndex = FindOrAddUsageIndexName(index, mention->name);
+			UsageIndexName* entry = VarArrayGetHard(UsageIndexName, &index->names, nameIndex);
+			UsageIndexRef* newRef = VarArrayAdd(UsageIndexRef, &entry->refs);
+			NotNull(newRef);
+			newRef->fileIndex = (u32)fileIndex;
+			newRef->lineNum = mention->lineNum;
+			if (!VarArrayContains(u32, &file->nameIndices, &nameIndex)) { *VarArrayAdd(u32, &file->nameIndices) = nameIndex; }
+		}
+	}
+	index->isDirty = true;
+}
+
+// The includes are compared first so includesGeneration only changes when the include graph actually needs to be rebuilt
+void SetUsageIndexFileIncludes(UsageIndex* index, uxx fileIndex, const VarArray* includes)
+{
+	NotNull(index);
+	UsageIndexFile* file = VarArrayGetHard(UsageIndexFile, &index->files, fileIndex);
+	uxx numIncludes = (includes != nullptr) ? includes->length : 0;
+	bool isSame = (file->includes.length == numIncludes);
+	for (uxx iIndex = 0; isSame && iIndex < numIncludes; iIndex++)
+	{
+		if (!StrExactEquals(*VarArrayGetHard(Str8, &file->includes, iIndex), *VarArrayGetHard(Str8, includes, iIndex))) { isSame = false; }
+	}
+	if (isSame) { return; }
+	
+	VarArrayLoop(&file->includes, iIndex)
+	{
+		VarArrayLoopGet(Str8, include, &file->includes, iIndex);
+		FreeStr8(index->arena, include);
+	}
+	VarArrayClear(&file->includes);
+	for (uxx iIndex = 0; iIndex < numIncludes; iIndex++)
+	{
+		Str8* newInclude = VarArrayAdd(Str8, &file->includes);
+		NotNull(newInclude);
+		*newInclude = AllocStr8(index->arena, *VarArrayGetHard(Str8, includes, iIndex));
+	}
+	index->includesGeneration++;
+	index->isDirty = true;
+}
+
+// Returns false if nothing has been indexed, otherwise the number of lines that mention name (which can be 0)
+bool GetUsageIndexCount(const UsageIndex* index, Str8 name, uxx* countOut)
+{
+	NotNull(index);
+	if (index->files.length == 0) { return false; }
+	UsageIndexName* entry = FindUsageIndexName(index, name);
+	SetOptionalOutPntr(countOut, (entry != nullptr) ? entry->refs.length : 0);
+	return true;
+}
+
+Str8 GetUsageIndexCountStr(Arena* arena, const UsageIndex* index, Str8 name)
+{
+	uxx count = 0;
+	if (!GetUsageIndexCount(index, name, &count)) { return Str8_Empty; }
+	return PrintInArenaStr(arena, "%llu use%s", (u64)count, Plural(count, "s"));
+}
+
+// +--------------------------------------------------------------+
+// |                        Init and Free                         |
+// +--------------------------------------------------------------+
+FilePath GetUsageIndexSavePath(Arena* arena, bool createFolder)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath folderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), createFolder);
+	FilePath result = JoinStringsInArenaWithChar(arena, folderPath, '/', StrLit(USAGE_INDEX_FILENAME), false);
+	ScratchEnd(scratch);
+	return result;
+}
+
+void FreeUsageIndexJobFiles(UsageIndex* index)
+{
+	NotNull(index);
+	VarArrayLoop(&index->jobPaths, pIndex)
+	{
+		VarArrayLoopGet(FilePath, jobPath, &index->jobPaths, pIndex);
+		FreeStr8(&index->jobHeap, jobPath);
+	}
+	VarArrayClear(&index->jobPaths);
+	VarArrayLoop(&index->jobFiles, jIndex)
+	{
+		VarArrayLoopGet(UsageIndexJobFile, jobFile, &index->jobFiles, jIndex);
+		FreeStr8(&index->jobHeap, &jobFile->path);
+		VarArrayLoop(&jobFile->mentions, mIndex)
+		{
+			VarArrayLoopGet(UsageIndexMention, mention, &jobFile->mentions, mIndex);
+			FreeStr8(&index->jobHeap, &mention->name);
+		}
+		FreeVarArray(&jobFile->mentions);
+		VarArrayLoop(&jobFile->includes, iIndex)
+		{
+			VarArrayLoopGet(Str8, include, &jobFile->includes, iIndex);
+			FreeStr8(&index->jobHeap, include);
+		}
+		FreeVarArray(&jobFile->includes);
+	}
+	VarArrayClear(&index->jobFiles);
+}
+
+void ClearUsageIndex(UsageIndex* index)
+{
+	NotNull(index);
+	VarArrayLoop(&index->files, fIndex)
+	{
+		VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+		FreeStr8(index->arena, &file->path);
+		FreeVarArray(&file->nameIndices);
+		VarArrayLoop(&file->includes, iIndex)
+		{
+			VarArrayLoopGet(Str8, include, &file->includes, iIndex);
+			FreeStr8(index->arena, include);
+		}
+		FreeVarArray(&file->includes);
+	}
+	VarArrayClear(&index->files);
+	index->includesGeneration++;
+	VarArrayLoop(&index->names, nIndex)
+	{
+		VarArrayLoopGet(UsageIndexName, entry, &index->names, nIndex);
+		FreeStr8(index->arena, &entry->name);
+		FreeVarArray(&entry->refs);
+	}
+	VarArrayClear(&index->names);
+	VarArrayClear(&index->nameSlots);
+	VarArrayLoop(&index->queuedPaths, pIndex)
+	{
+		VarArrayLoopGet(FilePath, queuedPath, &index->queuedPaths, pIndex);
+		FreeStr8(index->arena, queuedPath);
+	}
+	VarArrayClear(&index->queuedPaths);
+	FreeStr8(index->arena, &index->rootPath);
+}
+
+bool FinishUsageIndexJob(UsageIndex* index, bool wait);
+void StopUsageIndexThread(UsageIndex* index);
+void FreeFolderScanList(Arena* arena, VarArray* list);
+
+void FreeUsageIndex(UsageIndex* index)
+{
+	NotNull(index);
+	if (index->arena != nullptr)
+	{
+		StopUsageIndexThread(index);
+		FreeUsageIndexJobFiles(index);
+		FreeVarArray(&index->jobPaths);
+		FreeVarArray(&index->jobFiles);
+		ClearUsageIndex(index);
+		FreeVarArray(&index->files);
+		FreeVarArray(&index->names);
+		FreeVarArray(&index->nameSlots);
+		FreeVarArray(&index->queuedPaths);
+		FreeFolderScanList(index->arena, &index->ignoreGlobs);
+		FreeFolderScanList(index->arena, &index->extensions);
+		FreeVarArray(&index->ignoreGlobs);
+		FreeVarArray(&index->extensions);
+	}
+	ClearPointer(index);
+}
+
+void InitUsageIndex(Arena* arena, UsageIndex* indexOut)
+{
+	NotNull(arena);
+	NotNull(indexOut);
+	ClearPointer(indexOut);
+	indexOut->arena = arena;
+	InitArenaStdHeap(&indexOut->jobHeap);
+	InitVarArray(UsageIndexFile, &indexOut->files, arena);
+	InitVarArray(UsageIndexName, &indexOut->names, arena);
+	InitVarArray(u32, &indexOut->nameSlots, arena);
+	InitVarArray(FilePath, &indexOut->queuedPaths, arena);
+	InitVarArray(Str8, &indexOut->ignoreGlobs, arena);
+	InitVarArray(Str8, &indexOut->extensions, arena);
+	InitVarArray(FilePath, &indexOut->jobPaths, &indexOut->jobHeap);
+	InitVarArray(UsageIndexJobFile, &indexOut->jobFiles, &indexOut->jobHeap);
+}
+
+// +--------------------------------------------------------------+
+// |                         Load and Save                        |
+// +--------------------------------------------------------------+
+void LoadUsageIndex(UsageIndex* index)
+{
+	NotNull(index);
+	NotNull(index->arena);
+	if (index->isLoaded) { return; }
+	index->isLoaded = true;
+	ProfZoneBegin(_funcZone, "LoadUsageIndex");
+	ScratchBegin1(scratch, index->arena);
+	FilePath savePath = GetUsageIndexSavePath(scratch, false);
+	SerialReader reader = ZEROED;
+	UsageIndexHeader header = ZEROED;
+	Str8 rootPath = Str8_Empty;
+	if (!OsDoesFileExist(savePath) || !AppReadBinFile(savePath, scratch, &reader.data) ||
+		!SerialRead(&reader, sizeof(header), &header) ||
+		header.magic != USAGE_INDEX_MAGIC || header.version != USAGE_INDEX_VERSION ||
+		header.writeTimeSize != sizeof(OsFileWriteTime) || header.refSize != sizeof(UsageIndexRef) ||
+		!SerialReadStr(&reader, (uxx)header.rootPathLength, &rootPath))
+	{
+		ScratchEnd(scratch);
+		ProfZoneEnd(_funcZone);
+		return;
+	}
+	
+	bool isValid = true;
+	index->rootPath = AllocStr8(index->arena, rootPath);
+	for (u64 fIndex = 0; fIndex < header.numFiles && isValid; fIndex++)
+	{
+		UsageIndexFileRecord fileRecord = ZEROED;
+		Str8 filePath = Str8_Empty;
+		if (!SerialRead(&reader, sizeof(fileRecord), &fileRecord) || !SerialReadStr(&reader, (uxx)fileRecord.pathLength, &filePath)) { isValid = false; break; }
+		UsageIndexFile* newFile = VarArrayAdd(UsageIndexFile, &index->files);
+		NotNull(newFile);
+		ClearPointer(newFile);
+		newFile->path = AllocStr8(index->arena, filePath);
+		newFile->writeTime = fileRecord.writeTime;
+		InitVarArray(u32, &newFile->nameIndices, index->arena);
+		InitVarArray(Str8, &newFile->includes, index->arena);
+		for (u64 iIndex = 0; iIndex < fileRecord.numIncludes; iIndex++)
+		{
+			u32 includeLength = 0;
+			Str8 include = Str8_Empty;
+			if (!SerialRead(&reader, sizeof(includeLength), &includeLength) || !SerialReadStr(&reader, includeLength, &include)) { isValid = false; break; }
+			*VarArrayAdd(Str8, &newFile->includes) = AllocStr8(index->arena, include);
+		}
+	}
+	for (u64 nIndex = 0; nIndex < header.numNames && isValid; nIndex++)
+	{
+		UsageIndexNameRecord nameRecord = ZEROED;
+		Str8 name = Str8_Empty;
+		if (!SerialRead(&reader, sizeof(nameRecord), &nameRecord) || !SerialReadStr(&reader, (uxx)nameRecord.nameLength, &name) ||
+			nameRecord.numRefs > (reader.data.length - reader.cursor) / sizeof(UsageIndexRef))
+		{
+			isValid = false;
+			break;
+		}
+		u32 nameIndex = FindOrAddUsageIndexName(index, name);
+		UsageIndexName* entry = VarArrayGetHard(UsageIndexName, &index->names, nameIndex);
+		UsageIndexRef* newRefs = VarArrayAddMulti(UsageIndexRef, &entry->refs, (uxx)nameRecord.numRefs);
+		if (nameRecord.numRefs > 0 && !SerialRead(&reader, sizeof(UsageIndexRef) * (uxx)nameRecord.numRefs, newRefs)) { isValid = false; break; }
+		for (u64 rIndex = 0; rIndex < nameRecord.numRefs; rIndex++)
+		{
+			if (newRefs[rIndex].fileIndex >= index->files.length) { isValid = false; break; }
+			UsageIndexFile* file = VarArrayGetHard(UsageIndexFile, &index->files, newRefs[rIndex].fileIndex);
+			if (!VarArrayContains(u32, &file->nameIndices, &nameIndex)) { *VarArrayAdd(u32, &file->nameIndices) = nameIndex; }
+		}
+	}
+	
+	if (!isValid)
+	{
+		WriteLine_W("Usage index file is malformed, it will be rebuilt by the next Open Folder");
+		ClearUsageIndex(index);
+	}
+	else
+	{
+		PrintLine_D("Loaded usage index: %llu files, %llu names", (u64)index->files.length, (u64)index->names.length);
+		index->sweepRequested = true; //files may have changed while we weren't running
+	}
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+void SaveUsageIndex(UsageIndex* index)
+{
+	NotNull(index);
+	if (index->arena == nullptr || !index->isDirty) { return; }
+	ProfZoneBegin(_funcZone, "SaveUsageIndex");
+	ScratchBegin1(scratch, index->arena);
+	SerialWriter writer = ZEROED;
+	for (uxx pass = 0; pass < 2; pass++)
+	{
+		writer.size = 0;
+		UsageIndexHeader header = ZEROED;
+		header.magic = USAGE_INDEX_MAGIC;
+		header.version = USAGE_INDEX_VERSION;
+		header.writeTimeSize = sizeof(OsFileWriteTime);
+		header.refSize = sizeof(UsageIndexRef);
+		header.rootPathLength = index->rootPath.length;
+		header.numFiles = index->files.length;
+		header.numNames = index->names.length;
+		SerialWrite(&writer, sizeof(header), &header);
+		SerialWrite(&writer, index->rootPath.length, index->rootPath.chars);
+		VarArrayLoop(&index->files, fIndex)
+		{
+			VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+			UsageIndexFileRecord fileRecord = ZEROED;
+			fileRecord.pathLength = file->path.length;
+			fileRecord.numIncludes = file->includes.length;
+			fileRecord.writeTime = file->writeTime;
+			SerialWrite(&writer, sizeof(fileRecord), &fileRecord);
+			SerialWrite(&writer, file->path.length, file->path.chars);
+			VarArrayLoop(&file->includes, iIndex)
+			{
+				VarArrayLoopGet(Str8, include, &file->includes, iIndex);
+				u32 includeLength = (u32)include->length;
+				SerialWrite(&writer, sizeof(includeLength), &includeLength);
+				SerialWrite(&writer, include->length, include->chars);
+			}
+		}
+		VarArrayLoop(&index->names, nIndex)
+		{
+			VarArrayLoopGet(UsageIndexName, entry, &index->names, nIndex);
+			UsageIndexNameRecord nameRecord = ZEROED;
+			nameRecord.nameLength = entry->name.length;
+			nameRecord.numRefs = entry->refs.length;
+			SerialWrite(&writer, sizeof(nameRecord), &nameRecord);
+			SerialWrite(&writer, entry->name.length, entry->name.chars);
+			if (entry->refs.length > 0) { SerialWrite(&writer, sizeof(UsageIndexRef) * entry->refs.length, VarArrayGetHard(UsageIndexRef, &entry->refs, 0)); }
+		}
+		if (pass == 0)
+		{
+			writer.bytes = (u8*)AllocMem(scratch, writer.size);
+			NotNull(writer.bytes);
+		}
+	}
+	
+	FilePath savePath = GetUsageIndexSavePath(scratch, true);
+	//NOTE: Like the parse cache, the index can always be rebuilt so we don't bother the user if this fails
+	if (!AppWriteBinFile(savePath, NewStr8(writer.size, writer.bytes))) { WriteLine_W("Failed to write usage index file"); }
+	else { index->isDirty = false; }
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// +--------------------------------------------------------------+
+// |                          Full Build                          |
+// +--------------------------------------------------------------+
+// Called when a folder scan starts. The old index is thrown away and the scan results are fed in with AddScannedFileToUsageIndex
+void BeginUsageIndexBuild(UsageIndex* index, FilePath rootPath)
+{
+	NotNull(index);
+	if (index->arena == nullptr) { return; }
+	FinishUsageIndexJob(index, true);
+	ClearUsageIndex(index);
+	index->rootPath = AllocStr8(index->arena, rootPath);
+	index->isBuilding = true;
+	index->isDirty = true;
+}
+
+void AddUsageIndexFile(UsageIndex* index, FilePath path, OsFileWriteTime writeTime, const VarArray* mentions, const VarArray* includes)
+{
+	NotNull(index);
+	UsageIndexFile* newFile = VarArrayAdd(UsageIndexFile, &index->files);
+	NotNull(newFile);
+	ClearPointer(newFile);
+	newFile->path = AllocStr8(index->arena, path);
+	newFile->writeTime = writeTime;
+	InitVarArray(u32, &newFile->nameIndices, index->arena);
+	InitVarArray(Str8, &newFile->includes, index->arena);
+	SetUsageIndexFileMentions(index, index->files.length-1, mentions);
+	SetUsageIndexFileIncludes(index, index->files.length-1, includes);
+}
+void AddScannedFileToUsageIndex(UsageIndex* index, FilePath path, OsFileWriteTime writeTime, const VarArray* mentions, const VarArray* includes)
+{
+	NotNull(index);
+	if (!index->isBuilding) { return; }
+	AddUsageIndexFile(index, path, writeTime, mentions, includes);
+}
+
+// A scan that was stopped early leaves a partial index, which is still better than nothing
+void EndUsageIndexBuild(UsageIndex* index)
+{
+	NotNull(index);
+	if (!index->isBuilding) { return; }
+	index->isBuilding = false;
+	index->lastSweepTime = (appIn != nullptr) ? appIn->programTime : 0;
+	PrintLine_D("Usage index built: %llu files, %llu names", (u64)index->files.length, (u64)index->names.length);
+	SaveUsageIndex(index);
+}
+
+// +--------------------------------------------------------------+
+// |                      Incremental Updates                     |
+// +--------------------------------------------------------------+
+Str8 GetPathRelativeToRoot(FilePath rootPath, FilePath fullPath);
+bool IsPathIgnoredByGlobs(const VarArray* ignoreGlobs, FilePath rootPath, FilePath fullPath);
+bool HasExtensionInList(const VarArray* extensions, FilePath fullPath);
+i32 CompareFolderScanPaths(Str8 left, Str8 right);
+void SplitFolderScanList(Arena* arena, Str8 listStr, VarArray* listOut);
+
+uxx FindUsageIndexFile(const UsageIndex* index, FilePath path)
+{
+	VarArrayLoop(&index->files, fIndex)
+	{
+		VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+		if (CompareFolderScanPaths(file->path, path) == 0) { return fIndex; }
+	}
+	return UINTXX_MAX;
+}
+
+// True if the folder scan wouldn't have found this file. The scan skips ignored folders as a whole so every folder on the way down is checked too
+bool IsUsageIndexPathFiltered(const UsageIndex* index, FilePath path)
+{
+	if (!StrAnyCaseStartsWith(path, index->rootPath) || !HasExtensionInList(&index->extensions, path)) { return true; }
+	Str8 relativePath = GetPathRelativeToRoot(index->rootPath, path);
+	uxx relativeStart = path.length - relativePath.length;
+	for (uxx cIndex = 0; cIndex <= relativePath.length; cIndex++)
+	{
+		if (cIndex == relativePath.length || relativePath.chars[cIndex] == '/' || relativePath.chars[cIndex] == '\\')
+		{
+			if (IsPathIgnoredByGlobs(&index->ignoreGlobs, index->rootPath, StrSlice(path, 0, relativeStart + cIndex))) { return true; }
+		}
+	}
+	return false;
+}
+
+// Adds a UsageIndexJobFile if the file's write time isn't oldWriteTime anymore. fileIndex is UINTXX_MAX for a file that isn't indexed yet
+void CheckUsageIndexFile(UsageIndex* index, Arena* scratch, uxx fileIndex, FilePath path, OsFileWriteTime oldWriteTime)
+{
+	OsFileWriteTime newWriteTime = ZEROED;
+	if (!OsDoesFileExist(path) || OsGetFileWriteTime(path, &newWriteTime) != Result_Success) { ClearStruct(newWriteTime); }
+	if (OsAreFileWriteTimesEqual(newWriteTime, oldWriteTime)) { return; }
+	
+	UsageIndexJobFile* jobFile = VarArrayAdd(UsageIndexJobFile, &index->jobFiles);
+	NotNull(jobFile);
+	ClearPointer(jobFile);
+	jobFile->fileIndex = fileIndex;
+	if (fileIndex == UINTXX_MAX) { jobFile->path = AllocStr8(&index->jobHeap, path); }
+	jobFile->writeTime = newWriteTime;
+	InitVarArray(UsageIndexMention, &jobFile->mentions, &index->jobHeap);
+	InitVarArray(Str8, &jobFile->includes, &index->jobHeap);
+	
+	uxx scratchMark = ArenaGetMark(scratch);
+	Str8 fileContents = Str8_Empty;
+	if (AppReadTextFile(path, scratch, &fileContents) && fileContents.length <= FOLDER_SCAN_MAX_FILE_SIZE)
+	{
+		TokenizePreprocessorLines(fileContents, &jobFile->mentions, &jobFile->includes);
+		VarArrayLoop(&jobFile->mentions, mIndex)
+		{
+			VarArrayLoopGet(UsageIndexMention, mention, &jobFile->mentions, mIndex);
+			mention->name = AllocStr8(&index->jobHeap, mention->name);
+		}
+		VarArrayLoop(&jobFile->includes, iIndex)
+		{
+			VarArrayLoopGet(Str8, include, &jobFile->includes, iIndex);
+			*include = AllocStr8(&index->jobHeap, *include);
+		}
+	}
+	ArenaResetToMark(scratch, scratchMark);
+}
+
+// Compares the write time of every indexed file, then walks rootPath for files that aren't indexed yet
+void SweepUsageIndexFolder(UsageIndex* index, Arena* scratch)
+{
+	VarArrayLoop(&index->files, fIndex)
+	{
+		if (AtomicRead(&index->stopRequested)) { return; }
+		VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+		CheckUsageIndexFile(index, scratch, fIndex, file->path, file->writeTime);
+	}
+	
+	//NOTE: The paths came from the same kind of walk so they compare exactly (apart from case) and we can look them up by hash
+	uxx numSlots = 16;
+	while (numSlots < index->files.length * 2) { numSlots *= 2; }
+	u32* slots = AllocArray(u32, scratch, numSlots);
+	NotNull(slots);
+	MyMemSet(slots, 0x00, sizeof(u32) * numSlots);
+	VarArrayLoop(&index->files, fIndex)
+	{
+		VarArrayLoopGet(UsageIndexFile, file, &index->files, fIndex);
+		uxx slotIndex = HashStr8FnvAnyCase(file->path) & (numSlots-1);
+		while (slots[slotIndex] != 0) { slotIndex = (slotIndex+1) & (numSlots-1); }
+		slots[slotIndex] = (u32)(fIndex+1);
+	}
+	
+	OsFileWriteTime noWriteTime = ZEROED;
+	VarArray folderPaths;
+	InitVarArray(FilePath, &folderPaths, scratch);
+	*VarArrayAdd(FilePath, &folderPaths) = index->rootPath;
+	while (folderPaths.length > 0 && !AtomicRead(&index->stopRequested))
+	{
+		FilePath folderPath = *VarArrayGetHard(FilePath, &folderPaths, folderPaths.length-1);
+		VarArrayRemoveAt(FilePath, &folderPaths, folderPaths.length-1);
+		OsFileIter fileIter = OsIterateFiles(scratch, folderPath, true, true);
+		bool isFolder = false;
+		FilePath childPath = Str8_Empty;
+		while (OsIterFileStepEx(&fileIter, &isFolder, &childPath, scratch, true))
+		{
+			if (IsPathIgnoredByGlobs(&index->ignoreGlobs, index->rootPath, childPath)) { continue; }
+			if (isFolder)
+			{
+				if (!AppIsSymbolicLink(childPath)) { *VarArrayAdd(FilePath, &folderPaths) = childPath; }
+				continue;
+			}
+			if (!HasExtensionInList(&index->extensions, childPath)) { continue; }
+			
+			bool isIndexed = false;
+			uxx slotIndex = HashStr8FnvAnyCase(childPath) & (numSlots-1);
+			while (slots[slotIndex] != 0)
+			{
+				if (StrAnyCaseEquals(VarArrayGetHard(UsageIndexFile, &index->files, slots[slotIndex]-1)->path, childPath)) { isIndexed = true; break; }
+				slotIndex = (slotIndex+1) & (numSlots-1);
+			}
+			if (!isIndexed) { CheckUsageIndexFile(index, scratch, UINTXX_MAX, childPath, noWriteTime); }
+		}
+	}
+}
+
+// Fills index->jobFiles with the files that changed. This is run on the worker thread while isWorking is true
+void RunUsageIndexJob(UsageIndex* index)
+{
+	NotNull(index);
+	ProfZoneBeginEx(_funcZone, index->jobIsSweep ? "SweepUsageIndex" : "CheckUsageIndexFiles", ProfilerCategory_Job);
+	//NOTE: The main thread doesn't touch index->files while hasJob is true so we can read it directly
+	ScratchBegin(scratch);
+	OsFileWriteTime noWriteTime = ZEROED;
+	if (index->jobIsSweep) { SweepUsageIndexFolder(index, scratch); }
+	else
+	{
+		VarArrayLoop(&index->jobPaths, pIndex)
+		{
+			VarArrayLoopGet(FilePath, jobPath, &index->jobPaths, pIndex);
+			uxx fileIndex = FindUsageIndexFile(index, *jobPath);
+			if (fileIndex != UINTXX_MAX) { CheckUsageIndexFile(index, scratch, fileIndex, *jobPath, VarArrayGetHard(UsageIndexFile, &index->files, fileIndex)->writeTime); }
+			else if (!IsUsageIndexPathFiltered(index, *jobPath)) { CheckUsageIndexFile(index, scratch, UINTXX_MAX, *jobPath, noWriteTime); }
+		}
+	}
+	ScratchEnd(scratch);
+	ProfZoneEnd(_funcZone);
+}
+
+// +==============================+
+// |     UsageIndexThreadMain     |
+// +==============================+
+// DWORD UsageIndexThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(UsageIndexThreadMain)
+{
+	NotNull(contextPntr);
+	UsageIndex* index = (UsageIndex*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	while (!AtomicRead(&index->stopRequested))
+	{
+		if (AtomicRead(&index->isWorking))
+		{
+			RunUsageIndexJob(index);
+			AtomicWrite(&index->isWorking, false);
+			SetWakeSignal(&index->doneSignal);
+		}
+		else { WaitForWakeSignal(&index->wakeSignal, TIMEOUT_FOREVER); }
+	}
+	//A job that was handed over just as we were stopped is dropped, StopUsageIndexThread is waiting on it in FinishUsageIndexJob
+	if (AtomicRead(&index->isWorking))
+	{
+		AtomicWrite(&index->isWorking, false);
+		SetWakeSignal(&index->doneSignal);
+	}
+	AtomicWrite(&index->isThreadRunning, false);
+	
+	ReleaseProfilerThread();
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	ReportWorkerScratchUsage();
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+void StartUsageIndexJob(UsageIndex* index, bool isSweep)
+{
+	NotNull(index);
+	if (index->hasJob || index->isBuilding || index->files.length == 0) { return; }
+	FreeUsageIndexJobFiles(index);
+	if (!index->thread.isFilled)
+	{
+		if (!InitWakeSignal(&index->wakeSignal) || !InitWakeSignal(&index->doneSignal))
+		{
+			WriteLine_W("Failed to create the usage index thread's wake signals!");
+			FreeWakeSignal(&index->wakeSignal);
+			FreeWakeSignal(&index->doneSignal);
+			return;
+		}
+		AtomicWrite(&index->isThreadRunning, true);
+		index->thread = OsCreateThread(UsageIndexThreadMain, index, true);
+		if (!index->thread.isFilled)
+		{
+			WriteLine_W("Failed to start usage index thread!");
+			AtomicWrite(&index->isThreadRunning, false);
+			FreeWakeSignal(&index->wakeSignal);
+			FreeWakeSignal(&index->doneSignal);
+			return;
+		}
+	}
+	
+	index->jobIsSweep = isSweep;
+	if (isSweep)
+	{
+		index->lastSweepTime = (appIn != nullptr) ? appIn->programTime : 0;
+		index->sweepRequested = false;
+	}
+	//NOTE: A sweep finds the queued files on its own, so they are only handed over for a targeted check
+	VarArrayLoop(&index->queuedPaths, pIndex)
+	{
+		VarArrayLoopGet(FilePath, queuedPath, &index->queuedPaths, pIndex);
+		if (!isSweep) { *VarArrayAdd(FilePath, &index->jobPaths) = AllocStr8(&index->jobHeap, *queuedPath); }
+		FreeStr8(index->arena, queuedPath);
+	}
+	VarArrayClear(&index->queuedPaths);
+	//The FolderScanIgnore setting may have changed since the index was built
+	FreeFolderScanList(index->arena, &index->ignoreGlobs);
+	FreeFolderScanList(index->arena, &index->extensions);
+	SplitFolderScanList(index->arena, app->settings.folderScanIgnore, &index->ignoreGlobs);
+	SplitFolderScanList(index->arena, StrLit(FOLDER_SCAN_EXTENSIONS), &index->extensions);
+	
+	index->hasJob = true;
+	AtomicWrite(&index->isWorking, true);
+	SetWakeSignal(&index->wakeSignal);
+}
+
+// Applies the changed files found by the thread. If wait is true we block until the thread is done. Returns true if any file changed
+bool FinishUsageIndexJob(UsageIndex* index, bool wait)
+{
+	NotNull(index);
+	if (!index->hasJob) { return false; }
+	if (wait)
+	{
+		ProfZoneBegin(Zone_WaitForUsageIndex, "WaitForUsageIndex");
+		while (AtomicRead(&index->isWorking)) { WaitForWakeSignal(&index->doneSignal, TIMEOUT_FOREVER); }
+		ProfZoneEnd(Zone_WaitForUsageIndex);
+	}
+	if (AtomicRead(&index->isWorking)) { return false; }
+	index->hasJob = false;
+	
+	bool anyChanged = (index->jobFiles.length > 0);
+	uxx numNewFiles = 0;
+	VarArrayLoop(&index->jobFiles, jIndex)
+	{
+		VarArrayLoopGet(UsageIndexJobFile, jobFile, &index->jobFiles, jIndex);
+		if (jobFile->fileIndex == UINTXX_MAX)
+		{
+			AddUsageIndexFile(index, jobFile->path, jobFile->writeTime, &jobFile->mentions, &jobFile->includes);
+			numNewFiles++;
+			continue;
+		}
+		UsageIndexFile* file = VarArrayGetHard(UsageIndexFile, &index->files, jobFile->fileIndex);
+		file->writeTime = jobFile->writeTime;
+		SetUsageIndexFileMentions(index, jobFile->fileIndex, &jobFile->mentions);
+		SetUsageIndexFileIncludes(index, jobFile->fileIndex, &jobFile->includes);
+	}
+	if (index->jobFiles.length > 0) { PrintLine_D("Usage index updated %llu file%s (%llu new)", (u64)index->jobFiles.length, Plural(index->jobFiles.length, "s"), (u64)numNewFiles); }
+	FreeUsageIndexJobFiles(index);
+	return anyChanged;
+}
+
+// Cuts short any job in progress, applies what it found, and then stops the thread. The next job starts a new one
+void StopUsageIndexThread(UsageIndex* index)
+{
+	NotNull(index);
+	if (!index->thread.isFilled) { FinishUsageIndexJob(index, true); return; }
+	AtomicWrite(&index->stopRequested, true);
+	SetWakeSignal(&index->wakeSignal);
+	FinishUsageIndexJob(index, true);
+	while (AtomicRead(&index->isThreadRunning)) { OsSleepMs(1); } //only waits for the thread to return, it's already past its last job
+	OsCloseThread(&index->thread);
+	ClearStruct(index->thread);
+	FreeWakeSignal(&index->wakeSignal);
+	FreeWakeSignal(&index->doneSignal);
+	AtomicWrite(&index->stopRequested, false);
+}
+
+// Queues a file that changed (or that we just wrote) to be re-tokenized by the next job. Files outside rootPath are ignored
+void QueueUsageIndexFileCheck(UsageIndex* index, FilePath path)
+{
+	NotNull(index);
+	if (index->arena == nullptr || index->files.length == 0) { return; }
+	ScratchBegin1(scratch, index->arena);
+	FilePath fullPath = OsGetFullPath(scratch, path);
+	if (StrAnyCaseStartsWith(fullPath, index->rootPath))
+	{
+		bool isQueued = false;
+		VarArrayLoop(&index->queuedPaths, pIndex)
+		{
+			VarArrayLoopGet(FilePath, queuedPath, &index->queuedPaths, pIndex);
+			if (CompareFolderScanPaths(*queuedPath, fullPath) == 0) { isQueued = true; break; }
+		}
+		if (!isQueued) { *VarArrayAdd(FilePath, &index->queuedPaths) = AllocStr8(index->arena, fullPath); }
+	}
+	ScratchEnd(scratch);
+}
+
+// Called once a frame, after UpdateFileWatches. Returns true if any counts changed
+bool UpdateUsageIndex(UsageIndex* index, const VarArray* fileWatches)
+{
+	NotNull(index);
+	if (index->arena == nullptr) { return false; }
+	u64 programTime = (appIn != nullptr) ? appIn->programTime : 0;
+	
+	//NOTE: Clearing a watch after we write the file ourselves doesn't move lastChangeTime, those writes call QueueUsageIndexFileCheck instead
+	if (fileWatches != nullptr)
+	{
+		VarArrayLoop(fileWatches, wIndex)
+		{
+			VarArrayLoopGet(FileWatch, watch, fileWatches, wIndex);
+			if (watch->id != 0 && watch->lastChangeTime > index->lastWatchFeedTime) { QueueUsageIndexFileCheck(index, watch->fullPath); }
+		}
+	}
+	index->lastWatchFeedTime = programTime;
+	if (appIn != nullptr && appIn->isFocusedChanged && appIn->isFocused && TimeSinceBy(programTime, index->lastSweepTime) >= USAGE_INDEX_SWEEP_PERIOD)
+	{
+		index->sweepRequested = true;
+	}
+	
+	bool countsChanged = false;
+	if (index->hasJob) { countsChanged = FinishUsageIndexJob(index, false); }
+	if (!index->hasJob && (index->sweepRequested || index->queuedPaths.length > 0)) { StartUsageIndexJob(index, index->sweepRequested); }
+	return countsChanged;
+}
@@ -16,7 +16,19 @@ Date:   02\25\2025
 #define RECENT_FILES_SAVE_FILEPATH "recent_files.txt"
 #define USER_BINDINGS_FILENAME     "bindings.txt"
 #define RECENT_FILES_MAX_LENGTH    16 //files
+#define RECENT_FILES_COMPACT_LENGTH (RECENT_FILES_MAX_LENGTH*4) //lines
 #define SETTINGS_FILENAME          "settings.txt"
+#define THEME_CACHE_FILENAME       "theme_cache.bin"
+#define SESSION_FILENAME           "session.bin"
+#define PARSE_CACHE_FILENAME       "parse_cache.bin"
+#define PARSE_CACHE_MAX_SIZE       Megabytes(8) //bytes of serialized option tables, least recently used entries are evicted past this
+#define PARSE_CACHE_MIN_NUM_BUCKETS 64 //must be a power of 2
+#define USAGE_INDEX_FILENAME       "usage_index.bin"
+#define COMPILE_COMMANDS_FILENAME  "compile_commands.json"
+#define PRESETS_FILENAME           "presets.txt"
+#define PRESET_JOURNAL_FILENAME    "preset_journal.txt"
+#define PRESET_TEMP_FILE_SUFFIX    ".cswitch_new"
+#define PRESET_BACKUP_FILE_SUFFIX  ".cswitch_old"
 
 #if 1
 #define UI_FONT_PATH  "resources/font/Geologica-Regular.ttf"
@@ -59,13 +71,22 @@ Date:   02\25\2025
 #define LINUX_SCROLL_WHEEL_SCALING       4 //multiplier TODO: Figure out how to ask the OS for the appropriate scroll speed scalar
 #define LINE_BREAK_EXTRA_UI_GAP          4 //px (at uiScale=1.0f)
 #define MAX_LINE_BREAKS_CONSIDERED       4 //lines
+#define OPTIONS_FILTER_MAX_LENGTH        128 //chars
+#define OPTION_SEARCH_BUCKET_BITS        12 //bits
+#define OPTION_SEARCH_NUM_BUCKETS        (1 << OPTION_SEARCH_BUCKET_BITS)
+#define INACTIVE_OPTION_ALPHA            0.4f //opacity of the text of options inside an #if branch that is turned off
+#define CONDITIONAL_MAX_EXPRESSION_DEPTH 64 //nested parentheses/ternaries in an #if expression
 
 #define CHECK_RECENT_FILES_WRITE_TIME_PERIOD 1000 //ms
 #define RECENT_FILES_RELOAD_DELAY            100 //ms
+#define CHECK_PRESETS_WRITE_TIME_PERIOD      1000 //ms
+#define PRESETS_RELOAD_DELAY                 100 //ms
 #define CHECK_DEFAULT_THEME_PERIOD              1000 //ms
 #define DEFAULT_THEME_RELOAD_DELAY              100 //ms
 #define CHECK_USER_THEME_PERIOD              1000 //ms
 #define USER_THEME_RELOAD_DELAY              100 //ms
+#define SETTINGS_SAVE_DELAY                  250 //ms
+#define SETTINGS_SAVE_MAX_DELAY              2000 //ms
 
 #define CHECK_FILE_WRITE_TIME_PERIOD 300 //ms
 #define FILE_RELOAD_DELAY            100 //ms
@@ -83,6 +104,45 @@ Date:   02\25\2025
 #define POPUP_MIN_WIDTH       300 //px
 #define POPUP_MIN_HEIGHT      100 //px
 
+#define PALETTE_MAX_QUERY_LENGTH  128 //chars
+#define PALETTE_MAX_RESULTS       50 //results
+#define PALETTE_MAX_VISIBLE       12 //results
+#define PALETTE_WIDTH_PERCENT     0.9f //percent of screen width
+
+#define FOLDER_SCAN_NUM_THREADS     8 //threads, the walk is mostly waiting on the file system so this doesn't need to match the core count
+#define FOLDER_SCAN_MAX_FILE_SIZE   Megabytes(2) //files larger than this are skipped
+#define FOLDER_SCAN_EXTENSIONS      "h;hh;hpp;hxx;inl;c;cc;cpp;cxx;jai" //only files with these extensions are parsed
+#define FOLDER_SCAN_DEFAULT_IGNORE  ".git;.svn;.hg;.vs;node_modules;_build" //globs, see the FolderScanIgnore setting
+#define FOLDER_SCAN_MAX_VISIBLE     20 //rows
+#define FOLDER_SCAN_WHEEL_ROWS      3 //rows per scroll wheel tick
+
+#define USAGE_INDEX_SWEEP_PERIOD    30000 //ms, regaining focus walks the folder again (for changes nothing watches, and new files) at most this often
+#define USAGE_INDEX_MIN_SLOTS       256 //slots in the name table, always a power of 2
+#define INCLUDE_GRAPH_TU_EXTENSIONS "c;cc;cpp;cxx" //without a compile_commands.json, files with these extensions are treated as translation units
+#define DEFINE_RESOLVER_NUM_THREADS 4 //threads
+#define DEFINE_RESOLVER_INCLUDE_CHECK_PERIOD 1000 //ms, how often the files a tab includes are checked for changes (the tab is resolved again when one changes)
+#define DEFINE_RESOLVER_CACHE_MAX_FILES 1024 //file contents, past this the ones that weren't part of the last resolve are dropped
+#define DEFINE_RESOLVER_MAX_INCLUDE_DEPTH 256 //files
+#define DEFINE_RESOLVER_MIN_NUM_BUCKETS 64 //must be a power of 2
+#define STARTUP_NUM_THREADS         3 //threads, decode and read the things AppInit needs while the main thread bakes fonts
+#define NUM_WINDOW_ICONS            6 //icons, 16 to 256px
+
+#define PROFILER_MAX_THREADS        32 //threads, each one that hits a zone claims a ring buffer
+#define PROFILER_RING_SIZE          8192 //events per thread, drained every frame
+#define PROFILER_MAX_ZONES          256 //zones, distinct ProfZoneBegin names
+#define PROFILER_MAX_DEPTH          32 //nested zones per thread
+#define PROFILER_HISTORY_LENGTH     240 //frames that each zone keeps timings for, p50/p95/max are taken over these
+#define PROFILER_MAX_FLAME_ZONES    1024 //zones drawn in the flame strip
+#define PROFILER_FLAME_ROWS         8 //rows, zones nested deeper than this aren't drawn
+#define PROFILER_TABLE_ROWS         10 //rows, the zones with the highest p95 are listed under the flame strip
+#define PROFILER_CALIBRATE_TIME     250 //ms, cycle counter ticks aren't converted to ms until we've measured this long
+#define PROFILER_CAPTURE_MAX_DETAILS      65536 //strings, like the paths of files being read, attached to zones in a capture
+#define PROFILER_CAPTURE_DEFAULT_FRAMES   120 //frames, see the CaptureFrameCount setting
+#define PROFILER_CAPTURE_DEFAULT_STALL    50.0f //ms, see the CaptureStallThreshold setting
+#define PROFILER_CAPTURE_FILENAME_FORMAT  "capture_%llu.json" //unix timestamp
+#define MEMORY_STATS_DUMP_FILENAME_FORMAT "memory_%llu.txt" //unix timestamp
+#define MEMORY_STATS_PANEL_WIDTH          720 //px
+
 #define MAX_NOTIFICATIONS                  16
 #define DEFAULT_NOTIFICATION_TIME          5*1000 //ms
 #define NOTIFICATION_BETWEEN_MARGIN        3 //px
@@ -97,5 +157,7 @@ Date:   02\25\2025
 
 #define NOTIFICATION_DEPTH -101
 #define POPUP_DEPTH        -100
+#define PALETTE_DEPTH      -99
+#define FOLDER_SCAN_DEPTH  -98
 
 #endif //  _DEFINES_H
@@ -142,3 +142,38 @@ SET_WINDOW_TOPMOST_DEF(Plat_SetWindowTopmost)
 }
 
 #endif //BUILD_WITH_SOKOL_APP
+
+// +==============================+
+// |      Plat_PopIpcRequest      |
+// +==============================+
+// IpcRequest* Plat_PopIpcRequest()
+POP_IPC_REQUEST_DEF(Plat_PopIpcRequest)
+{
+	NotNull(platformData);
+	if (!platformData->singleInstance.isListening) { return nullptr; }
+	return PopIpcRequest(&platformData->singleInstance.requests);
+}
+
+// +==============================+
+// |    Plat_FinishIpcRequest     |
+// +==============================+
+// void Plat_FinishIpcRequest(IpcRequest* request, Str8 response)
+FINISH_IPC_REQUEST_DEF(Plat_FinishIpcRequest)
+{
+	NotNull(request);
+	NotNull(request->arena);
+	//NOTE: The connection thread doesn't touch its heap while it's waiting on isDone, so we can allocate from it here
+	request->response = AllocStr8(request->arena, response);
+	AtomicWrite(&request->isDone, true);
+	SetWakeSignal(&request->doneSignal);
+}
+
+// +==============================+
+// |     Plat_PublishIpcEvent     |
+// +==============================+
+// void Plat_PublishIpcEvent(Str8 eventStr)
+PUBLISH_IPC_EVENT_DEF(Plat_PublishIpcEvent)
+{
+	NotNull(platformData);
+	PublishIpcEvent(&platformData->singleInstance, eventStr);
+}
@@ -17,4 +17,5 @@ void InitAppInput(AppInput* input)
 	input->isFocused = true; //we assume we are focused when we first present the window, I belive sokol_app will give us an unfocus event immediately after startup if that's not true
 	input->screenSize = MakeV2i((i32)sapp_width(), (i32)sapp_height());
 	InitVarArray(Str8, &input->droppedFilePaths, stdHeap);
+	InitVarArray(Str8, &input->forwardedPaths, stdHeap);
 }
\ No newline at end of file
@@ -46,6 +46,7 @@ struct AppInput
 	// v2i windowSize; //TODO: Can we somehow ask sokol_sapp for the window size (include title bar and border)?
 	
 	VarArray droppedFilePaths; //Str8
+	VarArray forwardedPaths; //Str8, full paths passed on the command line to another instance that found us running (see platform_single_instance.c)
 };
 
 typedef plex AppInputHandling AppInputHandling;
@@ -62,6 +63,19 @@ plex AppInputHandling
 	VarArray droppedFilePathsHandled; //bool
 };
 
+// A request from another process, received by the platform on a connection thread (see platform_single_instance.c).
+// The app gets these from PopIpcRequest on the main thread and has to answer every one with FinishIpcRequest
+typedef plex IpcRequest IpcRequest;
+plex IpcRequest
+{
+	ai64 next; //IpcRequest*, the link in the platform's lock-free queue
+	Arena* arena; //the connection's heap, response is allocated from here
+	Str8 message; //the request lines, including the empty line at the end
+	Str8 response; //filled by FinishIpcRequest
+	abool isDone; //set by FinishIpcRequest
+	WakeSignal doneSignal; //set right after isDone, the connection thread blocks on this
+};
+
 // +--------------------------------------------------------------+
 // |                         Platform API                         |
 // +--------------------------------------------------------------+
@@ -89,6 +103,15 @@ typedef SET_WINDOW_ICON_DEF(SetWindowIcon_f);
 #define SET_WINDOW_TOPMOST_DEF(functionName) void functionName(bool topmost)
 typedef SET_WINDOW_TOPMOST_DEF(SetWindowTopmost_f);
 
+#define POP_IPC_REQUEST_DEF(functionName) IpcRequest* functionName()
+typedef POP_IPC_REQUEST_DEF(PopIpcRequest_f);
+
+#define FINISH_IPC_REQUEST_DEF(functionName) void functionName(IpcRequest* request, Str8 response)
+typedef FINISH_IPC_REQUEST_DEF(FinishIpcRequest_f);
+
+#define PUBLISH_IPC_EVENT_DEF(functionName) void functionName(Str8 eventStr)
+typedef PUBLISH_IPC_EVENT_DEF(PublishIpcEvent_f);
+
 typedef struct PlatformApi PlatformApi;
 struct PlatformApi
 {
@@ -100,6 +123,9 @@ struct PlatformApi
 	SetWindowTitle_f* SetWindowTitle;
 	SetWindowIcon_f* SetWindowIcon;
 	SetWindowTopmost_f* SetWindowTopmost;
+	PopIpcRequest_f* PopIpcRequest;
+	FinishIpcRequest_f* FinishIpcRequest;
+	PublishIpcEvent_f* PublishIpcEvent;
 };
 
 // +--------------------------------------------------------------+
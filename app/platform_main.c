@@ -50,9 +50,18 @@ Description:
 #define TIME_SCALE_TARGET_FRAMERATE 60 //fps
 #define TIME_SCALE_ROUND_TOLERANCE 0.1
 
+#define SINGLE_INSTANCE_TIMEOUT          500 //ms, how long we wait on a running instance before giving up and starting our own
+#define SINGLE_INSTANCE_MAX_MESSAGE_SIZE Kilobytes(64) //bytes
+#define SINGLE_INSTANCE_BACKLOG          8 //connections
+#define IPC_MAX_CONNECTIONS              8 //connections served at once, the rest are told we're busy
+#define IPC_CONNECTION_IDLE_TIMEOUT      10000 //ms, a connection that doesn't send its next request in this long is closed
+#define IPC_MAX_PENDING_EVENTS           1024 //events, per subscriber, newer events are dropped past this
+#define IPC_EVENT_POLL_PERIOD            10 //ms, how often an idle subscriber is checked for new events (and whether it disconnected)
+
 // +--------------------------------------------------------------+
 // |                         Header Files                         |
 // +--------------------------------------------------------------+
+#include "wake_signal.h"
 #include "platform_interface.h"
 #include "platform_main.h"
 
@@ -73,6 +82,7 @@ ProgramArgs programArgs = ZEROED;
 // +--------------------------------------------------------------+
 // |                    Platform Source Files                     |
 // +--------------------------------------------------------------+
+#include "platform_single_instance.c"
 #include "platform_api.c"
 #include "platform_helpers.c"
 
@@ -222,6 +232,8 @@ bool PlatDoUpdate(void)
 	}
 	#endif
 	
+	UpdateSingleInstanceServer(&platformData->singleInstance, platformData->currentAppInput);
+	
 	//Swap which appInput is being written to and pass the static version to the application
 	AppInput* oldAppInput = platformData->currentAppInput;
 	AppInput* newAppInput = (platformData->currentAppInput == &platformData->appInputs[0]) ? &platformData->appInputs[1] : &platformData->appInputs[0];
@@ -251,8 +263,14 @@ bool PlatDoUpdate(void)
 		VarArrayLoopGet(Str8, filePathStr, &newAppInput->droppedFilePaths, fIndex);
 		FreeStr8(stdHeap, filePathStr);
 	}
+	VarArrayLoop(&newAppInput->forwardedPaths, fIndex)
+	{
+		VarArrayLoopGet(Str8, filePathStr, &newAppInput->forwardedPaths, fIndex);
+		FreeStr8(stdHeap, filePathStr);
+	}
 	MyMemCopy(newAppInput, oldAppInput, sizeof(AppInput));
 	VarArrayClear(&newAppInput->droppedFilePaths);
+	VarArrayClear(&newAppInput->forwardedPaths);
 	newAppInput->screenSizeChanged = false;
 	newAppInput->isFullscreenChanged = false;
 	newAppInput->isMinimizedChanged = false;
@@ -308,6 +326,9 @@ void PlatSappInit(void)
 	platform->SetWindowTitle = Plat_SetWindowTitle;
 	platform->SetWindowIcon = Plat_SetWindowIcon;
 	platform->SetWindowTopmost = Plat_SetWindowTopmost;
+	platform->PopIpcRequest = Plat_PopIpcRequest;
+	platform->FinishIpcRequest = Plat_FinishIpcRequest;
+	platform->PublishIpcEvent = Plat_PublishIpcEvent;
 	
 	#if BUILD_INTO_SINGLE_UNIT
 	{
@@ -389,6 +410,7 @@ void PlatSappInit(void)
 void PlatSappCleanup(void)
 {
 	platformData->appApi.AppClosing(platformInfo, platform, platformData->appMemoryPntr);
+	StopSingleInstanceServer(&platformData->singleInstance);
 	ShutdownSokolGraphics();
 }
 
@@ -587,6 +609,11 @@ sapp_desc sokol_main(int argc, char* argv[])
 	
 	InitScratchArenasVirtual(Gigabytes(4));
 	
+	//NOTE: This happens before the window, fonts and theme so a launch that just forwards its paths exits in a few milliseconds. Pass -new to always get a new window
+	bool forceNewInstance = FindNamedProgramArgBoolEx(&programArgs, StrLit("new"), StrLit("new_instance"), false, 0);
+	if (!forceNewInstance && TryForwardToRunningInstance(&programArgs)) { exit(0); }
+	StartSingleInstanceServer(&platformData->singleInstance);
+	
 	return (sapp_desc){
 		.init_cb = PlatSappInit,
 		.frame_cb = PlatDoUpdate,
@@ -7,6 +7,62 @@ Date:   02\25\2025
 #ifndef _PLATFORM_MAIN_H
 #define _PLATFORM_MAIN_H
 
+#if TARGET_IS_WINDOWS
+typedef HANDLE SingleInstanceConn;
+#define SINGLE_INSTANCE_CONN_INVALID INVALID_HANDLE_VALUE
+#else
+typedef int SingleInstanceConn;
+#define SINGLE_INSTANCE_CONN_INVALID (-1)
+#endif
+
+// A multi-producer single-consumer queue that doesn't take a lock (the intrusive kind from Dmitry Vyukov).
+// Connection threads push with one atomic exchange, and only the main thread pops
+typedef plex IpcRequestQueue IpcRequestQueue;
+plex IpcRequestQueue
+{
+	ai64 head; //IpcRequest*, the most recently pushed request
+	IpcRequest* tail; //the oldest request, only touched by the main thread
+	IpcRequest stub; //keeps the list from ever being empty, so push never has to touch tail
+};
+
+typedef plex SingleInstanceServer SingleInstanceServer;
+
+typedef plex IpcConnection IpcConnection;
+plex IpcConnection
+{
+	SingleInstanceServer* server;
+	SingleInstanceConn conn;
+	OsThreadHandle thread;
+	abool isRunning; //set by the accept thread when it hands out the slot, cleared by the connection thread when it's done
+	Arena heap; //only used by the connection thread, except for FinishIpcRequest while it waits
+	char* readBuffer; //SINGLE_INSTANCE_MAX_MESSAGE_SIZE bytes, allocated from heap the first time the slot is used
+	IpcRequest request;
+	
+	abool isSubscribed;
+	Mutex eventsMutex; //protects eventsHeap and events
+	Arena eventsHeap;
+	VarArray events; //Str8, allocated from eventsHeap, queued by PublishIpcEvent on the main thread
+};
+
+// See platform_single_instance.c
+plex SingleInstanceServer
+{
+	bool isListening;
+	Str8 address; //null-terminated pipe name on Windows, socket path everywhere else
+	SingleInstanceConn listenConn; //the listening socket, or on Windows the first pipe instance (the thread creates the rest)
+	OsThreadHandle thread; //accepts connections and hands each one to a slot in connections
+	abool isRunning;
+	abool stopRequested;
+	IpcConnection connections[IPC_MAX_CONNECTIONS];
+	IpcRequestQueue requests;
+	
+	Mutex mutex; //protects heap and pendingPaths
+	Arena heap; //the thread can't allocate from stdHeap
+	VarArray pendingPaths; //Str8, allocated from heap, moved into AppInput.forwardedPaths by PlatDoUpdate
+	abool hasPendingPaths;
+	abool focusRequested;
+};
+
 typedef struct PlatformData PlatformData;
 struct PlatformData
 {
@@ -27,6 +83,8 @@ struct PlatformData
 	AppInput* oldAppInput;
 	AppInput* currentAppInput;
 	AppInputHandling appInputHandling;
+	
+	SingleInstanceServer singleInstance;
 };
 
 #endif //  _PLATFORM_MAIN_H
@@ -0,0 +1,740 @@
+/*
+File:   platform_single_instance.c
+Description:
+	** Makes sure only one instance of CSwitch ends up with a window. Before we create anything
+	** sokol_main tries to connect to a running instance (a named pipe on Windows, a Unix domain socket
+	** everywhere else). If one answers we send it the command line paths and exit right away. Otherwise
+	** we become the instance that listens, and a thread hands any paths it receives to the app through
+	** AppInput.forwardedPaths so they get opened like a dropped file.
+	** Messages in both directions are lines of text that end with an empty line. Each client gets its own
+	** thread (up to IPC_MAX_CONNECTIONS) and can send any number of messages. Besides "focus"/"open" a client
+	** can send commands like "tabs" or "set NAME on PATH" that need the app's state. Those are pushed onto a
+	** lock-free queue that AppUpdate drains through PopIpcRequest/FinishIpcRequest (see app_ipc.c). A client
+	** that sends "subscribe" gets every event the app publishes until it disconnects.
+	** Every read gives up after a timeout so a client that goes quiet doesn't hold its slot forever. On Windows
+	** that means every pipe is opened with FILE_FLAG_OVERLAPPED and we wait on the OVERLAPPED event ourselves.
+	** The socket lives in a folder only we can write to, and both ends check that the other side is running as
+	** the same user before they trust it (see IsSingleInstancePeerUs).
+*/
+
+#if !TARGET_IS_WINDOWS
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#ifdef MSG_NOSIGNAL
+#define SINGLE_INSTANCE_SEND_FLAGS MSG_NOSIGNAL //a client that disconnects early shouldn't kill us with SIGPIPE
+#else
+#define SINGLE_INSTANCE_SEND_FLAGS 0
+#endif
+#endif //!TARGET_IS_WINDOWS
+
+// The pipe name has the session id in it so users logged into the same Windows machine don't find each other's instance
+Str8 GetSingleInstanceAddress(Arena* arena)
+{
+	#if TARGET_IS_WINDOWS
+	DWORD sessionId = 0;
+	ProcessIdToSessionId(GetCurrentProcessId(), &sessionId);
+	return PrintInArenaStr(arena, "\\\\.\\pipe\\%s_%u", PROJECT_FOLDER_NAME_STR, (u32)sessionId);
+	#else
+	const char* runtimeFolder = getenv("XDG_RUNTIME_DIR");
+	if (runtimeFolder != nullptr && runtimeFolder[0] != '\0') { return PrintInArenaStr(arena, "%s/%s.sock", runtimeFolder, PROJECT_FOLDER_NAME_STR); }
+	//NOTE: /tmp is shared by every user, so the socket goes in a folder of our own that nobody else can add files to (or swap the socket out of)
+	Str8 folderPath = PrintInArenaStr(arena, "/tmp/%s-%u", PROJECT_FOLDER_NAME_STR, (u32)getuid());
+	if (mkdir(folderPath.chars, S_IRWXU) != 0 && errno != EEXIST) { return Str8_Empty; }
+	struct stat folderInfo;
+	if (lstat(folderPath.chars, &folderInfo) != 0 || !S_ISDIR(folderInfo.st_mode) || folderInfo.st_uid != getuid() || (folderInfo.st_mode & (S_IRWXG|S_IRWXO)) != 0)
+	{
+		PrintLine_W("\"%.*s\" isn't a private folder owned by us, running without single instance", StrPrint(folderPath));
+		return Str8_Empty;
+	}
+	return PrintInArenaStr(arena, "%.*s/%s.sock", StrPrint(folderPath), PROJECT_FOLDER_NAME_STR);
+	#endif
+}
+
+#if !TARGET_IS_WINDOWS
+bool FillSingleInstanceSocketAddress(Str8 address, struct sockaddr_un* addrOut)
+{
+	ClearPointer(addrOut);
+	addrOut->sun_family = AF_UNIX;
+	if (address.length >= sizeof(addrOut->sun_path)) { return false; }
+	MyMemCopy(&addrOut->sun_path[0], address.chars, address.length);
+	return true;
+}
+struct timeval MakeSingleInstanceTimeval(uxx milliseconds)
+{
+	struct timeval result = ZEROED;
+	result.tv_sec = (time_t)(milliseconds / 1000);
+	result.tv_usec = (suseconds_t)((milliseconds % 1000) * 1000);
+	return result;
+}
+// True if the process on the other end of the socket is running as the same user as us
+bool IsSingleInstancePeerUs(int socketHandle)
+{
+	#if TARGET_IS_LINUX
+	//NOTE: struct ucred is only declared with _GNU_SOURCE, this is the same layout
+	struct { pid_t pid; uid_t uid; gid_t gid; } peerCredentials;
+	socklen_t credentialsSize = sizeof(peerCredentials);
+	if (getsockopt(socketHandle, SOL_SOCKET, SO_PEERCRED, &peerCredentials, &credentialsSize) != 0) { return false; }
+	return (peerCredentials.uid == getuid());
+	#else
+	uid_t peerUid = 0;
+	gid_t peerGid = 0;
+	if (getpeereid(socketHandle, &peerUid, &peerGid) != 0) { return false; }
+	return (peerUid == getuid());
+	#endif
+}
+//NOTE: Reads don't need a socket timeout, ReadSingleInstanceMessage polls with the timeout it's given
+void SetSingleInstanceSocketSendTimeout(int socketHandle)
+{
+	struct timeval sendTimeval = MakeSingleInstanceTimeval(SINGLE_INSTANCE_TIMEOUT);
+	setsockopt(socketHandle, SOL_SOCKET, SO_SNDTIMEO, &sendTimeval, sizeof(sendTimeval));
+}
+#endif //!TARGET_IS_WINDOWS
+
+#if TARGET_IS_WINDOWS
+// ioSucceeded is what ReadFile/WriteFile/ConnectNamedPipe returned when given this overlapped. If the operation is still pending
+// we wait up to timeout ms (or forever for TIMEOUT_FOREVER) and cancel it if it doesn't finish in time
+bool FinishSingleInstancePipeIo(HANDLE pipe, OVERLAPPED* overlapped, BOOL ioSucceeded, uxx timeout, DWORD* numBytesOut)
+{
+	DWORD numBytes = 0;
+	if (!ioSucceeded)
+	{
+		if (GetLastError() != ERROR_IO_PENDING) { return false; }
+		DWORD waitTimeout = (timeout == TIMEOUT_FOREVER) ? INFINITE : (DWORD)timeout;
+		if (WaitForSingleObject(overlapped->hEvent, waitTimeout) != WAIT_OBJECT_0)
+		{
+			CancelIoEx(pipe, overlapped);
+			GetOverlappedResult(pipe, overlapped, &numBytes, TRUE); //the buffer and overlapped are in use until the cancel lands
+			return false;
+		}
+	}
+	bool result = (GetOverlappedResult(pipe, overlapped, &numBytes, FALSE) != 0);
+	if (numBytesOut != nullptr) { *numBytesOut = numBytes; }
+	return result;
+}
+#endif //TARGET_IS_WINDOWS
+
+// +--------------------------------------------------------------+
+// |                         Connections                          |
+// +--------------------------------------------------------------+
+// Fails immediately if nobody is listening, which is the common case when launching the first instance
+SingleInstanceConn ConnectToSingleInstanceServer(Str8 address)
+{
+	#if TARGET_IS_WINDOWS
+	HANDLE pipe = CreateFileA(address.chars, GENERIC_READ|GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (pipe == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PIPE_BUSY)
+	{
+		//NOTE: The server is busy with another client, it will have the next pipe instance ready shortly
+		if (WaitNamedPipeA(address.chars, SINGLE_INSTANCE_TIMEOUT)) { pipe = CreateFileA(address.chars, GENERIC_READ|GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL); }
+	}
+	return pipe;
+	#else
+	struct sockaddr_un socketAddress;
+	if (!FillSingleInstanceSocketAddress(address, &socketAddress)) { return SINGLE_INSTANCE_CONN_INVALID; }
+	int socketHandle = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (socketHandle < 0) { return SINGLE_INSTANCE_CONN_INVALID; }
+	SetSingleInstanceSocketSendTimeout(socketHandle);
+	if (connect(socketHandle, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) != 0) { close(socketHandle); return SINGLE_INSTANCE_CONN_INVALID; }
+	//NOTE: Whoever is listening gets our command line paths, so it has to be us
+	if (!IsSingleInstancePeerUs(socketHandle)) { WriteLine_W("The single instance socket belongs to another user, ignoring it"); close(socketHandle); return SINGLE_INSTANCE_CONN_INVALID; }
+	return socketHandle;
+	#endif
+}
+
+void CloseSingleInstanceConn(SingleInstanceConn conn)
+{
+	#if TARGET_IS_WINDOWS
+	CloseHandle(conn);
+	#else
+	close(conn);
+	#endif
+}
+
+// Gives up if the other side doesn't take the data within SINGLE_INSTANCE_TIMEOUT
+bool WriteSingleInstanceConn(SingleInstanceConn conn, Str8 data)
+{
+	#if TARGET_IS_WINDOWS
+	OVERLAPPED overlapped = ZEROED;
+	overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if (overlapped.hEvent == NULL) { return false; }
+	#endif
+	bool result = true;
+	uxx numWritten = 0;
+	while (numWritten < data.length)
+	{
+		#if TARGET_IS_WINDOWS
+		DWORD chunkSize = 0;
+		BOOL writeResult = WriteFile(conn, &data.chars[numWritten], (DWORD)(data.length - numWritten), NULL, &overlapped);
+		if (!FinishSingleInstancePipeIo(conn, &overlapped, writeResult, SINGLE_INSTANCE_TIMEOUT, &chunkSize) || chunkSize == 0) { result = false; break; }
+		#else
+		ssize_t chunkSize = send(conn, &data.chars[numWritten], data.length - numWritten, SINGLE_INSTANCE_SEND_FLAGS);
+		if (chunkSize < 0 && errno == EINTR) { continue; }
+		if (chunkSize <= 0) { result = false; break; }
+		#endif
+		numWritten += (uxx)chunkSize;
+	}
+	#if TARGET_IS_WINDOWS
+	CloseHandle(overlapped.hEvent);
+	#endif
+	return result;
+}
+
+// Reads until the empty line that ends every message. Returns Str8_Empty if the other side closed early, sent more than bufferSize,
+// or didn't send anything for timeout ms
+Str8 ReadSingleInstanceMessage(SingleInstanceConn conn, char* buffer, uxx bufferSize, uxx timeout)
+{
+	#if TARGET_IS_WINDOWS
+	OVERLAPPED overlapped = ZEROED;
+	overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if (overlapped.hEvent == NULL) { return Str8_Empty; }
+	#endif
+	Str8 result = Str8_Empty;
+	uxx numRead = 0;
+	while (numRead < bufferSize)
+	{
+		#if TARGET_IS_WINDOWS
+		DWORD chunkSize = 0;
+		BOOL readResult = ReadFile(conn, &buffer[numRead], (DWORD)(bufferSize - numRead), NULL, &overlapped);
+		if (!FinishSingleInstancePipeIo(conn, &overlapped, readResult, timeout, &chunkSize) || chunkSize == 0) { break; }
+		#else
+		struct pollfd pollInfo = ZEROED;
+		pollInfo.fd = conn;
+		pollInfo.events = POLLIN;
+		int pollResult = poll(&pollInfo, 1, (int)timeout);
+		if (pollResult < 0 && errno == EINTR) { continue; }
+		if (pollResult <= 0) { break; }
+		ssize_t chunkSize = recv(conn, &buffer[numRead], bufferSize - numRead, 0);
+		if (chunkSize < 0 && errno == EINTR) { continue; }
+		if (chunkSize <= 0) { break; }
+		#endif
+		numRead += (uxx)chunkSize;
+		if (numRead >= 2 && buffer[numRead-2] == '\n' && buffer[numRead-1] == '\n') { result = NewStr8(numRead, buffer); break; }
+	}
+	#if TARGET_IS_WINDOWS
+	CloseHandle(overlapped.hEvent);
+	#endif
+	return result;
+}
+
+// True if the other side closed the connection. Doesn't block, and leaves anything the other side sent to be read
+bool HasSingleInstanceConnClosed(SingleInstanceConn conn)
+{
+	#if TARGET_IS_WINDOWS
+	DWORD numBytesAvailable = 0;
+	return (PeekNamedPipe(conn, NULL, 0, NULL, &numBytesAvailable, NULL) == 0); //fails with ERROR_BROKEN_PIPE once the client is gone
+	#else
+	char peekByte = 0;
+	ssize_t peekResult = recv(conn, &peekByte, 1, MSG_PEEK|MSG_DONTWAIT);
+	if (peekResult == 0) { return true; }
+	return (peekResult < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+	#endif
+}
+
+// +--------------------------------------------------------------+
+// |                            Client                            |
+// +--------------------------------------------------------------+
+// Returns true if a running instance took our paths, in which case this process should exit
+bool TryForwardToRunningInstance(ProgramArgs* args)
+{
+	ScratchBegin(scratch);
+	Str8 address = GetSingleInstanceAddress(scratch);
+	if (IsEmptyStr(address)) { ScratchEnd(scratch); return false; }
+	SingleInstanceConn conn = ConnectToSingleInstanceServer(address);
+	if (conn == SINGLE_INSTANCE_CONN_INVALID) { ScratchEnd(scratch); return false; }
+	
+	#if TARGET_IS_WINDOWS
+	//NOTE: Windows only lets a process bring its window to the front if the foreground process allows it, which right now is us
+	AllowSetForegroundWindow(ASFW_ANY);
+	#endif
+	
+	//NOTE: The other instance has a different working directory so relative paths are resolved here
+	uxx numPaths = 0;
+	TwoPassStr8Loop(message, scratch, false)
+	{
+		numPaths = 0;
+		TwoPassStrNt(&message, "focus\n"); //NOTE: Every message needs at least one line before the empty line that ends it
+		uxx argIndex = 0;
+		Str8 pathArgument = GetNamelessProgramArg(args, argIndex);
+		while (!IsEmptyStr(pathArgument))
+		{
+			FilePath fullPath = OsGetFullPath(scratch, pathArgument);
+			TwoPassPrint(&message, "open %.*s\n", StrPrint(fullPath));
+			numPaths++;
+			argIndex++;
+			pathArgument = GetNamelessProgramArg(args, argIndex);
+		}
+		TwoPassStrNt(&message, "\n");
+		TwoPassStr8LoopEnd(&message);
+	}
+	
+	char replyBuffer[64];
+	bool success = (WriteSingleInstanceConn(conn, message.str) && StrExactEquals(ReadSingleInstanceMessage(conn, &replyBuffer[0], ArrayCount(replyBuffer), SINGLE_INSTANCE_TIMEOUT), StrLit("ok\n\n")));
+	CloseSingleInstanceConn(conn);
+	if (success) { PrintLine_I("Forwarded %llu path%s to the running instance", (u64)numPaths, Plural(numPaths, "s")); }
+	else { WriteLine_W("Found a running instance but it didn't answer, starting a new one"); }
+	ScratchEnd(scratch);
+	return success;
+}
+
+// +--------------------------------------------------------------+
+// |                        Request Queue                         |
+// +--------------------------------------------------------------+
+void InitIpcRequestQueue(IpcRequestQueue* queue)
+{
+	NotNull(queue);
+	ClearPointer(queue);
+	AtomicWrite(&queue->stub.next, 0);
+	AtomicWrite(&queue->head, (i64)(uxx)&queue->stub);
+	queue->tail = &queue->stub;
+}
+
+// Safe to call from any number of threads at once
+void PushIpcRequest(IpcRequestQueue* queue, IpcRequest* request)
+{
+	AtomicWrite(&request->next, 0);
+	IpcRequest* prevHead = (IpcRequest*)(uxx)AtomicExchange(&queue->head, (i64)(uxx)request);
+	//NOTE: Until this write lands the consumer can't reach request yet, PopIpcRequest just returns nullptr and picks it up next frame
+	AtomicWrite(&prevHead->next, (i64)(uxx)request);
+}
+
+// Only the main thread calls this
+IpcRequest* PopIpcRequest(IpcRequestQueue* queue)
+{
+	IpcRequest* tail = queue->tail;
+	IpcRequest* next = (IpcRequest*)(uxx)AtomicRead(&tail->next);
+	if (tail == &queue->stub)
+	{
+		if (next == nullptr) { return nullptr; }
+		queue->tail = next;
+		tail = next;
+		next = (IpcRequest*)(uxx)AtomicRead(&tail->next);
+	}
+	if (next != nullptr) { queue->tail = next; return tail; }
+	
+	//NOTE: tail is the last request. We can only hand it out once the stub is behind it, otherwise the next push would link onto a request we gave away
+	IpcRequest* head = (IpcRequest*)(uxx)AtomicRead(&queue->head);
+	if (tail != head) { return nullptr; } //a push is halfway done
+	PushIpcRequest(queue, &queue->stub);
+	next = (IpcRequest*)(uxx)AtomicRead(&tail->next);
+	if (next != nullptr) { queue->tail = next; return tail; }
+	return nullptr;
+}
+
+// +--------------------------------------------------------------+
+// |                            Server                            |
+// +--------------------------------------------------------------+
+// Main thread only. Queues eventStr for every connection that sent "subscribe"
+void PublishIpcEvent(SingleInstanceServer* server, Str8 eventStr)
+{
+	NotNull(server);
+	if (!server->isListening) { return; }
+	for (uxx cIndex = 0; cIndex < IPC_MAX_CONNECTIONS; cIndex++)
+	{
+		IpcConnection* connection = &server->connections[cIndex];
+		if (!AtomicRead(&connection->isRunning) || !AtomicRead(&connection->isSubscribed)) { continue; }
+		LockMutex(&connection->eventsMutex, TIMEOUT_FOREVER);
+		if (connection->events.length < IPC_MAX_PENDING_EVENTS)
+		{
+			Str8* newEvent = VarArrayAdd(Str8, &connection->events);
+			NotNull(newEvent);
+			*newEvent = PrintInArenaStr(&connection->eventsHeap, "%.*s\n\n", StrPrint(eventStr));
+		}
+		UnlockMutex(&connection->eventsMutex);
+	}
+}
+
+// Handles the message a second launch sends us. Every line is either "focus" or "open [full path]"
+void HandleIpcForwardMessage(SingleInstanceServer* server, Str8 message)
+{
+	bool addedPaths = false;
+	LockMutex(&server->mutex, TIMEOUT_FOREVER);
+	LineParser lineParser = MakeLineParser(message);
+	Str8 line = Str8_Empty;
+	while (LineParserGetLine(&lineParser, &line))
+	{
+		if (StrExactStartsWith(line, StrLit("open ")))
+		{
+			Str8 path = TrimWhitespace(StrSliceFrom(line, 5));
+			if (IsEmptyStr(path)) { continue; }
+			Str8* newPath = VarArrayAdd(Str8, &server->pendingPaths);
+			NotNull(newPath);
+			*newPath = AllocStr8(&server->heap, path);
+			addedPaths = true;
+		}
+	}
+	UnlockMutex(&server->mutex);
+	
+	if (addedPaths) { AtomicWrite(&server->hasPendingPaths, true); }
+	AtomicWrite(&server->focusRequested, true);
+}
+
+// Sends every queued event until the subscriber goes away (or we are shutting down). While there's nothing to send we
+// check whether the subscriber disconnected so its slot is freed right away instead of on the next event
+void StreamIpcEvents(IpcConnection* connection)
+{
+	SingleInstanceServer* server = connection->server;
+	LockMutex(&connection->eventsMutex, TIMEOUT_FOREVER);
+	VarArrayClear(&connection->events);
+	UnlockMutex(&connection->eventsMutex);
+	AtomicWrite(&connection->isSubscribed, true);
+	if (!WriteSingleInstanceConn(connection->conn, StrLit("ok\n\n"))) { AtomicWrite(&connection->isSubscribed, false); return; }
+	
+	while (!AtomicRead(&server->stopRequested))
+	{
+		ScratchBegin(scratch);
+		LockMutex(&connection->eventsMutex, TIMEOUT_FOREVER);
+		TwoPassStr8Loop(eventsStr, scratch, false)
+		{
+			VarArrayLoop(&connection->events, eIndex)
+			{
+				VarArrayLoopGet(Str8, eventStr, &connection->events, eIndex);
+				TwoPassPrint(&eventsStr, "%.*s", StrPrint(*eventStr));
+			}
+			TwoPassStr8LoopEnd(&eventsStr);
+		}
+		VarArrayLoop(&connection->events, eIndex)
+		{
+			VarArrayLoopGet(Str8, eventStr, &connection->events, eIndex);
+			FreeStr8(&connection->eventsHeap, eventStr);
+		}
+		VarArrayClear(&connection->events);
+		UnlockMutex(&connection->eventsMutex);
+		
+		bool writeSuccess = (IsEmptyStr(eventsStr.str) || WriteSingleInstanceConn(connection->conn, eventsStr.str));
+		ScratchEnd(scratch);
+		if (!writeSuccess) { break; }
+		if (IsEmptyStr(eventsStr.str))
+		{
+			if (HasSingleInstanceConnClosed(connection->conn)) { break; }
+			OsSleepMs(IPC_EVENT_POLL_PERIOD);
+		}
+	}
+	AtomicWrite(&connection->isSubscribed, false);
+}
+
+// A connection can send any number of requests, one after the other. Requests that need the app's state are queued for the main thread and we wait for the answer
+void ServeIpcConnection(IpcConnection* connection)
+{
+	SingleInstanceServer* server = connection->server;
+	if (connection->readBuffer == nullptr)
+	{
+		connection->readBuffer = AllocArray(char, &connection->heap, SINGLE_INSTANCE_MAX_MESSAGE_SIZE);
+		NotNull(connection->readBuffer);
+	}
+	
+	while (!AtomicRead(&server->stopRequested))
+	{
+		Str8 message = ReadSingleInstanceMessage(connection->conn, connection->readBuffer, SINGLE_INSTANCE_MAX_MESSAGE_SIZE, IPC_CONNECTION_IDLE_TIMEOUT);
+		if (IsEmptyStr(message)) { break; }
+		Str8 firstLine = TrimWhitespace(StrSlice(message, 0, MinUXX(StrExactFind(message, StrLit("\n")), message.length)));
+		if (StrExactEquals(firstLine, StrLit("focus")) || StrExactStartsWith(firstLine, StrLit("open ")))
+		{
+			HandleIpcForwardMessage(server, message);
+			if (!WriteSingleInstanceConn(connection->conn, StrLit("ok\n\n"))) { break; }
+		}
+		else if (StrExactEquals(firstLine, StrLit("subscribe")))
+		{
+			StreamIpcEvents(connection);
+			break;
+		}
+		else
+		{
+			IpcRequest* request = &connection->request;
+			request->arena = &connection->heap;
+			request->message = message;
+			request->response = Str8_Empty;
+			AtomicWrite(&request->isDone, false);
+			PushIpcRequest(&server->requests, request);
+			//NOTE: If we're shutting down the main thread might never get to it, and the queue is thrown away along with us
+			while (!AtomicRead(&request->isDone))
+			{
+				if (AtomicRead(&server->stopRequested)) { return; }
+				if (!WaitForWakeSignal(&request->doneSignal, TIMEOUT_FOREVER)) { OsSleepMs(1); } //only fails if the signal couldn't be created
+			}
+			bool writeSuccess = WriteSingleInstanceConn(connection->conn, request->response);
+			FreeStr8(&connection->heap, &request->response);
+			if (!writeSuccess) { break; }
+		}
+	}
+}
+
+void CloseIpcConnection(IpcConnection* connection)
+{
+	#if TARGET_IS_WINDOWS
+	FlushFileBuffers(connection->conn); //DisconnectNamedPipe throws away anything the client hasn't read yet
+	DisconnectNamedPipe(connection->conn);
+	#endif
+	CloseSingleInstanceConn(connection->conn);
+	connection->conn = SINGLE_INSTANCE_CONN_INVALID;
+}
+
+// +==============================+
+// |   IpcConnectionThreadMain    |
+// +==============================+
+// DWORD IpcConnectionThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(IpcConnectionThreadMain)
+{
+	NotNull(contextPntr);
+	IpcConnection* connection = (IpcConnection*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	ServeIpcConnection(connection);
+	CloseIpcConnection(connection);
+	AtomicWrite(&connection->isRunning, false);
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+// Gives the connection to a free slot and its own thread. Returns false if every slot is busy
+bool StartIpcConnection(SingleInstanceServer* server, SingleInstanceConn conn)
+{
+	for (uxx cIndex = 0; cIndex < IPC_MAX_CONNECTIONS; cIndex++)
+	{
+		IpcConnection* connection = &server->connections[cIndex];
+		if (AtomicRead(&connection->isRunning)) { continue; }
+		if (connection->thread.isFilled) { OsCloseThread(&connection->thread); }
+		connection->conn = conn;
+		AtomicWrite(&connection->isSubscribed, false);
+		AtomicWrite(&connection->isRunning, true);
+		connection->thread = OsCreateThread(IpcConnectionThreadMain, connection, true);
+		if (!connection->thread.isFilled) { AtomicWrite(&connection->isRunning, false); connection->conn = SINGLE_INSTANCE_CONN_INVALID; return false; }
+		return true;
+	}
+	return false;
+}
+
+// +==============================+
+// |   SingleInstanceThreadMain   |
+// +==============================+
+// DWORD SingleInstanceThreadMain(LPVOID contextPntr)
+OS_THREAD_FUNC_DEF(SingleInstanceThreadMain)
+{
+	NotNull(contextPntr);
+	SingleInstanceServer* server = (SingleInstanceServer*)contextPntr;
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	InitScratchArenasVirtual(Megabytes(64));
+	#endif
+	
+	#if TARGET_IS_WINDOWS
+	HANDLE pipe = server->listenConn;
+	OVERLAPPED connectOverlapped = ZEROED;
+	connectOverlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if (connectOverlapped.hEvent == NULL) { CloseHandle(pipe); pipe = INVALID_HANDLE_VALUE; }
+	while (pipe != INVALID_HANDLE_VALUE)
+	{
+		ResetEvent(connectOverlapped.hEvent);
+		BOOL connectResult = ConnectNamedPipe(pipe, &connectOverlapped);
+		bool connected = (connectResult != 0 || GetLastError() == ERROR_PIPE_CONNECTED);
+		if (!connected) { connected = FinishSingleInstancePipeIo(pipe, &connectOverlapped, connectResult, TIMEOUT_FOREVER, nullptr); }
+		if (AtomicRead(&server->stopRequested)) { CloseHandle(pipe); break; }
+		if (!connected || !StartIpcConnection(server, pipe))
+		{
+			if (connected) { WriteSingleInstanceConn(pipe, StrLit("error busy\n\n")); FlushFileBuffers(pipe); }
+			DisconnectNamedPipe(pipe);
+			CloseHandle(pipe);
+		}
+		pipe = CreateNamedPipeA(server->address.chars,
+			PIPE_ACCESS_DUPLEX|FILE_FLAG_OVERLAPPED,
+			PIPE_TYPE_BYTE|PIPE_READMODE_BYTE|PIPE_WAIT|PIPE_REJECT_REMOTE_CLIENTS,
+			PIPE_UNLIMITED_INSTANCES, SINGLE_INSTANCE_MAX_MESSAGE_SIZE, SINGLE_INSTANCE_MAX_MESSAGE_SIZE, 0, NULL
+		);
+	}
+	if (connectOverlapped.hEvent != NULL) { CloseHandle(connectOverlapped.hEvent); }
+	#else
+	while (true)
+	{
+		int conn = accept(server->listenConn, NULL, NULL);
+		if (AtomicRead(&server->stopRequested)) { if (conn >= 0) { close(conn); } break; }
+		if (conn < 0)
+		{
+			if (errno == EINTR || errno == ECONNABORTED) { continue; }
+			break;
+		}
+		if (!IsSingleInstancePeerUs(conn)) { close(conn); continue; }
+		SetSingleInstanceSocketSendTimeout(conn);
+		if (!StartIpcConnection(server, conn))
+		{
+			WriteSingleInstanceConn(conn, StrLit("error busy\n\n"));
+			close(conn);
+		}
+	}
+	#endif
+	AtomicWrite(&server->isRunning, false);
+	
+	#if SCRATCH_ARENAS_THREAD_LOCAL
+	FreeScratchArenasVirtual();
+	#endif
+	
+	OsThreadReturn(0, nullptr);
+}
+
+// Claims the address and starts listening. Returns false if another instance got there first (or the OS said no), in which case we just run without it
+bool StartSingleInstanceServer(SingleInstanceServer* server)
+{
+	NotNull(server);
+	ClearPointer(server);
+	server->listenConn = SINGLE_INSTANCE_CONN_INVALID;
+	server->address = GetSingleInstanceAddress(stdHeap);
+	if (IsEmptyStr(server->address)) { return false; }
+	
+	#if TARGET_IS_WINDOWS
+	//NOTE: FILE_FLAG_FIRST_PIPE_INSTANCE makes this fail if another instance created the pipe between our connect attempt and now
+	server->listenConn = CreateNamedPipeA(server->address.chars,
+		PIPE_ACCESS_DUPLEX|FILE_FLAG_FIRST_PIPE_INSTANCE|FILE_FLAG_OVERLAPPED,
+		PIPE_TYPE_BYTE|PIPE_READMODE_BYTE|PIPE_WAIT|PIPE_REJECT_REMOTE_CLIENTS,
+		PIPE_UNLIMITED_INSTANCES, SINGLE_INSTANCE_MAX_MESSAGE_SIZE, SINGLE_INSTANCE_MAX_MESSAGE_SIZE, 0, NULL
+	);
+	if (server->listenConn == INVALID_HANDLE_VALUE) { PrintLine_W("Failed to create pipe \"%.*s\": %u", StrPrint(server->address), (u32)GetLastError()); return false; }
+	#else
+	struct sockaddr_un socketAddress;
+	if (!FillSingleInstanceSocketAddress(server->address, &socketAddress)) { PrintLine_W("Socket path is too long: \"%.*s\"", StrPrint(server->address)); return false; }
+	server->listenConn = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server->listenConn < 0) { return false; }
+	int bindResult = bind(server->listenConn, (struct sockaddr*)&socketAddress, sizeof(socketAddress));
+	if (bindResult != 0 && errno == EADDRINUSE)
+	{
+		//NOTE: Either the socket file was left behind by an instance that crashed, or another instance started listening after our connect attempt
+		SingleInstanceConn otherConn = ConnectToSingleInstanceServer(server->address);
+		if (otherConn != SINGLE_INSTANCE_CONN_INVALID) { CloseSingleInstanceConn(otherConn); }
+		else
+		{
+			//NOTE: Only a socket file of ours gets removed, anything else at that path is left alone and we run without single instance
+			struct stat fileInfo;
+			if (lstat(server->address.chars, &fileInfo) == 0 && S_ISSOCK(fileInfo.st_mode) && fileInfo.st_uid == getuid())
+			{
+				unlink(server->address.chars);
+				bindResult = bind(server->listenConn, (struct sockaddr*)&socketAddress, sizeof(socketAddress));
+			}
+		}
+	}
+	if (bindResult != 0 || listen(server->listenConn, SINGLE_INSTANCE_BACKLOG) != 0)
+	{
+		PrintLine_W("Failed to listen on \"%.*s\": %d", StrPrint(server->address), errno);
+		close(server->listenConn);
+		server->listenConn = SINGLE_INSTANCE_CONN_INVALID;
+		return false;
+	}
+	chmod(server->address.chars, S_IRUSR|S_IWUSR);
+	#endif
+	
+	InitMutex(&server->mutex);
+	InitArenaStdHeap(&server->heap);
+	InitVarArray(Str8, &server->pendingPaths, &server->heap);
+	InitIpcRequestQueue(&server->requests);
+	for (uxx cIndex = 0; cIndex < IPC_MAX_CONNECTIONS; cIndex++)
+	{
+		IpcConnection* connection = &server->connections[cIndex];
+		connection->server = server;
+		connection->conn = SINGLE_INSTANCE_CONN_INVALID;
+		InitArenaStdHeap(&connection->heap);
+		InitWakeSignal(&connection->request.doneSignal);
+		InitMutex(&connection->eventsMutex);
+		InitArenaStdHeap(&connection->eventsHeap);
+		InitVarArray(Str8, &connection->events, &connection->eventsHeap);
+	}
+	AtomicWrite(&server->isRunning, true);
+	server->thread = OsCreateThread(SingleInstanceThreadMain, server, true);
+	if (!server->thread.isFilled)
+	{
+		WriteLine_W("Failed to start the single instance thread");
+		AtomicWrite(&server->isRunning, false);
+		CloseSingleInstanceConn(server->listenConn);
+		#if !TARGET_IS_WINDOWS
+		unlink(server->address.chars);
+		#endif
+		server->listenConn = SINGLE_INSTANCE_CONN_INVALID;
+		return false;
+	}
+	server->isListening = true;
+	return true;
+}
+
+void StopSingleInstanceServer(SingleInstanceServer* server)
+{
+	NotNull(server);
+	if (!server->isListening) { return; }
+	AtomicWrite(&server->stopRequested, true);
+	//NOTE: The thread is blocked waiting for a client, so we connect to ourselves to wake it up
+	SingleInstanceConn wakeConn = ConnectToSingleInstanceServer(server->address);
+	if (wakeConn != SINGLE_INSTANCE_CONN_INVALID) { CloseSingleInstanceConn(wakeConn); }
+	//NOTE: Connection threads are blocked reading from an idle client, streaming events or waiting on the app to answer a request, all of which check stopRequested once we unblock them
+	for (uxx cIndex = 0; cIndex < IPC_MAX_CONNECTIONS; cIndex++)
+	{
+		IpcConnection* connection = &server->connections[cIndex];
+		if (!AtomicRead(&connection->isRunning)) { continue; }
+		#if TARGET_IS_WINDOWS
+		CancelIoEx(connection->conn, NULL);
+		#else
+		shutdown(connection->conn, SHUT_RDWR);
+		#endif
+		SetWakeSignal(&connection->request.doneSignal); //in case it's waiting on the main thread to answer a request
+	}
+	for (uxx waitIndex = 0; waitIndex < SINGLE_INSTANCE_TIMEOUT && AtomicRead(&server->isRunning); waitIndex++) { OsSleepMs(1); }
+	if (!AtomicRead(&server->isRunning)) { OsCloseThread(&server->thread); }
+	for (uxx cIndex = 0; cIndex < IPC_MAX_CONNECTIONS; cIndex++)
+	{
+		IpcConnection* connection = &server->connections[cIndex];
+		for (uxx waitIndex = 0; waitIndex < SINGLE_INSTANCE_TIMEOUT && AtomicRead(&connection->isRunning); waitIndex++) { OsSleepMs(1); }
+		if (!AtomicRead(&connection->isRunning))
+		{
+			if (connection->thread.isFilled) { OsCloseThread(&connection->thread); }
+			FreeWakeSignal(&connection->request.doneSignal);
+		}
+	}
+	#if !TARGET_IS_WINDOWS
+	close(server->listenConn);
+	unlink(server->address.chars);
+	#endif
+	server->isListening = false;
+}
+
+void BringWindowToFront()
+{
+	#if (TARGET_IS_WINDOWS && BUILD_WITH_SOKOL_APP)
+	HWND windowHandle = (HWND)sapp_win32_get_hwnd();
+	if (IsIconic(windowHandle)) { ShowWindow(windowHandle, SW_RESTORE); }
+	SetForegroundWindow(windowHandle);
+	#elif (TARGET_IS_LINUX && BUILD_WITH_SOKOL_APP)
+	XMapRaised(_sapp.x11.display, _sapp.x11.window);
+	XFlush(_sapp.x11.display);
+	#endif
+}
+
+// Moves any paths the thread received into appInput and raises the window if someone tried to launch us again. Called on the main thread every frame
+void UpdateSingleInstanceServer(SingleInstanceServer* server, AppInput* appInput)
+{
+	NotNull(server);
+	NotNull(appInput);
+	if (!server->isListening) { return; }
+	if (AtomicRead(&server->hasPendingPaths))
+	{
+		LockMutex(&server->mutex, TIMEOUT_FOREVER);
+		VarArrayLoop(&server->pendingPaths, pIndex)
+		{
+			VarArrayLoopGet(Str8, pendingPath, &server->pendingPaths, pIndex);
+			Str8* newPath = VarArrayAdd(Str8, &appInput->forwardedPaths);
+			NotNull(newPath);
+			*newPath = AllocStr8(stdHeap, *pendingPath);
+			FreeStr8(&server->heap, pendingPath);
+		}
+		VarArrayClear(&server->pendingPaths);
+		AtomicWrite(&server->hasPendingPaths, false);
+		UnlockMutex(&server->mutex);
+	}
+	if (AtomicRead(&server->focusRequested))
+	{
+		AtomicWrite(&server->focusRequested, false);
+		BringWindowToFront();
+	}
+}
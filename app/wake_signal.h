@@ -0,0 +1,104 @@
+/*
+File:   wake_signal.h
+Description:
+	** A WakeSignal lets a thread block until another thread has something for it, instead of waking up on a timer
+	** to check. It's an auto-reset event on Windows and a mutex + condition variable everywhere else.
+	** Setting the signal while nobody is waiting isn't lost, the next WaitForWakeSignal returns right away.
+	** Waiting consumes the signal, so it's meant for a single waiter that re-checks its own flags after every wake.
+*/
+
+#ifndef _WAKE_SIGNAL_H
+#define _WAKE_SIGNAL_H
+
+#if !TARGET_IS_WINDOWS
+#include <pthread.h>
+#include <time.h>
+#endif
+
+typedef plex WakeSignal WakeSignal;
+plex WakeSignal
+{
+	bool isInitialized;
+	#if TARGET_IS_WINDOWS
+	HANDLE event; //auto-reset
+	#else
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	bool isSet;
+	#endif
+};
+
+bool InitWakeSignal(WakeSignal* signal)
+{
+	NotNull(signal);
+	ClearPointer(signal);
+	#if TARGET_IS_WINDOWS
+	signal->event = CreateEventA(NULL, FALSE, FALSE, NULL);
+	signal->isInitialized = (signal->event != NULL);
+	#else
+	if (pthread_mutex_init(&signal->mutex, NULL) != 0) { return false; }
+	if (pthread_cond_init(&signal->condition, NULL) != 0) { pthread_mutex_destroy(&signal->mutex); return false; }
+	signal->isInitialized = true;
+	#endif
+	return signal->isInitialized;
+}
+
+void FreeWakeSignal(WakeSignal* signal)
+{
+	NotNull(signal);
+	if (signal->isInitialized)
+	{
+		#if TARGET_IS_WINDOWS
+		CloseHandle(signal->event);
+		#else
+		pthread_cond_destroy(&signal->condition);
+		pthread_mutex_destroy(&signal->mutex);
+		#endif
+	}
+	ClearPointer(signal);
+}
+
+void SetWakeSignal(WakeSignal* signal)
+{
+	NotNull(signal);
+	if (!signal->isInitialized) { return; }
+	#if TARGET_IS_WINDOWS
+	SetEvent(signal->event);
+	#else
+	pthread_mutex_lock(&signal->mutex);
+	signal->isSet = true;
+	pthread_cond_signal(&signal->condition);
+	pthread_mutex_unlock(&signal->mutex);
+	#endif
+}
+
+// Blocks until the signal is set or timeoutMs passes (TIMEOUT_FOREVER waits as long as it takes). Returns true if the signal was set
+bool WaitForWakeSignal(WakeSignal* signal, uxx timeoutMs)
+{
+	NotNull(signal);
+	if (!signal->isInitialized) { return false; }
+	#if TARGET_IS_WINDOWS
+	return (WaitForSingleObject(signal->event, (timeoutMs == TIMEOUT_FOREVER) ? INFINITE : (DWORD)timeoutMs) == WAIT_OBJECT_0);
+	#else
+	struct timespec deadline = ZEROED;
+	if (timeoutMs != TIMEOUT_FOREVER)
+	{
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += (time_t)(timeoutMs / 1000);
+		deadline.tv_nsec += (long)((timeoutMs % 1000) * 1000000);
+		if (deadline.tv_nsec >= 1000000000) { deadline.tv_sec++; deadline.tv_nsec -= 1000000000; }
+	}
+	pthread_mutex_lock(&signal->mutex);
+	while (!signal->isSet)
+	{
+		if (timeoutMs == TIMEOUT_FOREVER) { pthread_cond_wait(&signal->condition, &signal->mutex); }
+		else if (pthread_cond_timedwait(&signal->condition, &signal->mutex, &deadline) != 0) { break; }
+	}
+	bool result = signal->isSet;
+	signal->isSet = false;
+	pthread_mutex_unlock(&signal->mutex);
+	return result;
+	#endif
+}
+
+#endif //  _WAKE_SIGNAL_H